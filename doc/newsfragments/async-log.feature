@@ -0,0 +1 @@
+Added the `--async-log` option, which writes log messages from a background thread so that verbose logging doesn't slow down input handling.
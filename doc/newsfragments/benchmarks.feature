@@ -0,0 +1 @@
+Added an optional micro-benchmark target covering the protocol, stream, event queue, key mapping, screen routing and Unicode hot paths.
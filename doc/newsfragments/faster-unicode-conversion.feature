@@ -0,0 +1 @@
+Text clipboard conversion between UTF-8 and UTF-16/UCS encodings is much faster for mostly-ASCII text, and UTF-16 surrogate pairs (e.g. emoji) now decode correctly.
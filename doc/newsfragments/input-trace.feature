@@ -0,0 +1 @@
+Added `--record-trace` to record the input the server gets to a compact binary file and `--replay-trace` to replay it on a virtual screen at any speed.
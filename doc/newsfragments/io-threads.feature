@@ -0,0 +1 @@
+The server reads, writes and encrypts client connections on several threads, set with `--io-threads`. It also marshals clipboards for each client off the main thread, so one busy client no longer delays input to the others.
@@ -0,0 +1 @@
+Added the `--trace-latency` option to measure and periodically log how long input takes to get from the server's screen to the client's.  The stages are also served as the `inputleap_latency_seconds` histogram when `--metrics-port` is given.
@@ -0,0 +1 @@
+The server now pings clients to measure round trip time and clock offset, logs and exports them as metrics, and lengthens the keep alive interval on slow or lossy links.
@@ -0,0 +1 @@
+Added `loadtest`, a headless tool that drives a server with many synthetic clients over loopback and reports per-client latency and throughput.
@@ -0,0 +1 @@
+Log levels can now be set per subsystem, e.g. `--debug INFO,protocol=DEBUG2`, and log messages that are filtered out no longer cost anything beyond a comparison.
@@ -0,0 +1 @@
+Added the `--metrics-port` option, which serves traffic, queue and transfer metrics in the Prometheus text format on localhost, along with histograms of TLS handshake times and, with `--trace-latency`, of input latency by stage.
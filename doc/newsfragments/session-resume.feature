@@ -0,0 +1 @@
+Clients that reconnect within 30 seconds of losing their connection now resume their session, keeping their options, clipboards and the cursor, instead of starting over.
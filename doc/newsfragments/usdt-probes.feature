@@ -0,0 +1 @@
+Added USDT probes for tracing the event loop, sockets, protocol messages, screen switches, transfers and TLS handshakes with perf or bpftrace on Linux, plus example bpftrace scripts in `doc/bpftrace`.
@@ -0,0 +1 @@
+Added the `--virtual-screen`, `--virtual-script` and `--virtual-record` options, which run the server or client on an in-memory screen without a display, replay scripted input and record the input a client is asked to synthesize.
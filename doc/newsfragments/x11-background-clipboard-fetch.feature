@@ -0,0 +1 @@
+The X11 clipboard is now fetched from the application that owns it in the background, with a timeout for each format, so a slow or large selection owner no longer stalls input. Data that arrives after the screen was left is sent on when the fetch finishes.
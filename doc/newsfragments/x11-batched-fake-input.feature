@@ -0,0 +1 @@
+X11 clients now flush synthesized input to the X server once per batch of messages received from the server instead of once per event.
@@ -0,0 +1 @@
+Pasting large clipboard contents into X11 applications is faster: replies use the largest request size the X server allows and converted data is shared between requestors.
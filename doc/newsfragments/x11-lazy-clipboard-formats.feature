@@ -0,0 +1 @@
+Clipboard formats on X11 are now fetched from the selection owner and converted only when they're actually used.
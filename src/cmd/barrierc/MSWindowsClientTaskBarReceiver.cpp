@@ -153,9 +153,11 @@ MSWindowsClientTaskBarReceiver::runMenu(int x, int y)
     SetForegroundWindow(m_window);
     HMENU menu = GetSubMenu(m_menu, 0);
     SetMenuDefaultItem(menu, IDC_TASKBAR_STATUS, FALSE);
+    // categories may be filtered differently.  show the most verbose;
+    // picking a level sets every category to it.
     HMENU logLevelMenu = GetSubMenu(menu, 3);
     CheckMenuRadioItem(logLevelMenu, 0, 6,
-                            CLOG->getFilter() - kERROR, MF_BYPOSITION);
+                            CLOG->getMaxFilter() - kERROR, MF_BYPOSITION);
     int n = TrackPopupMenu(menu,
                             TPM_NONOTIFY |
                             TPM_RETURNCMD |
@@ -404,6 +404,7 @@ void MainWindow::updateFromLogLine(const QString &line)
     // TODO: this code makes Andrew cry
     checkConnected(line);
     checkFingerprint(line);
+    checkLinkQuality(line);
 }
 
 void MainWindow::checkConnected(const QString& line)
@@ -428,6 +429,17 @@ void MainWindow::checkConnected(const QString& line)
     }
 }
 
+void MainWindow::checkLinkQuality(const QString& line)
+{
+    QRegExp linkRegex(".*link to \"(.+)\": round trip ([0-9.]+) ms.*");
+    if (!linkRegex.exactMatch(line) || m_BarrierState != barrierConnected) {
+        return;
+    }
+
+    setStatus(tr("Barrier is running. Round trip to %1: %2 ms.")
+                .arg(linkRegex.cap(1)).arg(linkRegex.cap(2)));
+}
+
 void MainWindow::checkFingerprint(const QString& line)
 {
     QRegExp fingerprintRegex(".*peer fingerprint \\(SHA1\\): ([A-F0-9:]+) \\(SHA256\\): ([A-F0-9:]+)");
@@ -238,6 +238,13 @@ public:
     */
     virtual bool        setReuseAddrOnSocket(ArchSocket, bool reuse) = 0;
 
+    //! Set send buffer size of socket
+    /*!
+    Limits how much written data the system queues for sending on the
+    socket to about \c size bytes.  Returns the previous size.
+    */
+    virtual int         setSendBufferSizeOnSocket(ArchSocket, int size) = 0;
+
     //! Return local host's name
     virtual std::string        getHostName() = 0;
 
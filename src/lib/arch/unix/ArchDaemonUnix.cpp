@@ -98,9 +98,10 @@ ArchDaemonUnix::daemonize(const char* name, DaemonFunc func)
     // chdir to root so we don't keep mounted filesystems points busy
     // TODO: this is a bit of a hack - can we find a better solution?
     int chdirErr = chdir("/");
-    if (chdirErr)
+    if (chdirErr) {
         // NB: file logging actually isn't working at this point!
         LOG((CLOG_ERR "chdir error: %i", chdirErr));
+    }
 #endif
 
     // mask off permissions for any but owner
@@ -210,8 +210,10 @@ ArchNetworkBSD::listenOnSocket(ArchSocket s)
 {
     assert(s != NULL);
 
-    // hardcoding backlog
-    if (listen(s->m_fd, 3) == -1) {
+    // let the kernel pick the backlog.  a tiny backlog makes clients
+    // that connect at the same moment (say, after the server restarts)
+    // wait for SYN retries or time out.
+    if (listen(s->m_fd, SOMAXCONN) == -1) {
         throwError(errno);
     }
 }
@@ -633,6 +635,28 @@ ArchNetworkBSD::setReuseAddrOnSocket(ArchSocket s, bool reuse)
     return (oflag != 0);
 }
 
+int
+ArchNetworkBSD::setSendBufferSizeOnSocket(ArchSocket s, int size)
+{
+    assert(s != NULL);
+
+    // get old size
+    int osize;
+    socklen_t len = static_cast<socklen_t>(sizeof(osize));
+    if (getsockopt(s->m_fd, SOL_SOCKET, SO_SNDBUF,
+                            reinterpret_cast<optval_t*>(&osize), &len) == -1) {
+        throwError(errno);
+    }
+
+    len = static_cast<socklen_t>(sizeof(size));
+    if (setsockopt(s->m_fd, SOL_SOCKET, SO_SNDBUF,
+                            reinterpret_cast<optval_t*>(&size), len) == -1) {
+        throwError(errno);
+    }
+
+    return osize;
+}
+
 std::string
 ArchNetworkBSD::getHostName()
 {
@@ -83,6 +83,7 @@ public:
     void throwErrorOnSocket(ArchSocket) override;
     bool setNoDelayOnSocket(ArchSocket, bool noDelay) override;
     bool setReuseAddrOnSocket(ArchSocket, bool reuse) override;
+    int setSendBufferSizeOnSocket(ArchSocket, int size) override;
     std::string getHostName() override;
     ArchNetAddress newAnyAddr(EAddressFamily) override;
     ArchNetAddress copyAddr(ArchNetAddress) override;
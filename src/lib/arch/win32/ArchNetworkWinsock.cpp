@@ -304,8 +304,8 @@ ArchNetworkWinsock::listenOnSocket(ArchSocket s)
 {
     assert(s != NULL);
 
-    // hardcoding backlog
-    if (listen_winsock(s->m_socket, 3) == SOCKET_ERROR) {
+    // let winsock pick the backlog, same as on unix
+    if (listen_winsock(s->m_socket, SOMAXCONN) == SOCKET_ERROR) {
         throwError(getsockerror_winsock());
     }
 }
@@ -658,6 +658,29 @@ ArchNetworkWinsock::setReuseAddrOnSocket(ArchSocket s, bool reuse)
     return (oflag != 0);
 }
 
+int
+ArchNetworkWinsock::setSendBufferSizeOnSocket(ArchSocket s, int size)
+{
+    assert(s != NULL);
+
+    // get old size
+    int osize;
+    int len = sizeof(osize);
+    if (getsockopt_winsock(s->m_socket, SOL_SOCKET,
+                                SO_SNDBUF, &osize, &len) == SOCKET_ERROR) {
+        throwError(getsockerror_winsock());
+    }
+
+    // set new size
+    len = sizeof(size);
+    if (setsockopt_winsock(s->m_socket, SOL_SOCKET,
+                                SO_SNDBUF, &size, len) == SOCKET_ERROR) {
+        throwError(getsockerror_winsock());
+    }
+
+    return osize;
+}
+
 std::string
 ArchNetworkWinsock::getHostName()
 {
@@ -84,6 +84,7 @@ public:
     virtual void        throwErrorOnSocket(ArchSocket);
     virtual bool        setNoDelayOnSocket(ArchSocket, bool noDelay);
     virtual bool        setReuseAddrOnSocket(ArchSocket, bool reuse);
+    virtual int         setSendBufferSizeOnSocket(ArchSocket, int size);
     virtual std::string        getHostName();
     virtual ArchNetAddress    newAnyAddr(EAddressFamily);
     virtual ArchNetAddress    copyAddr(ArchNetAddress);
@@ -24,6 +24,8 @@
 #include "base/IEventJob.h"
 #include "base/EventTypes.h"
 #include "base/Log.h"
+#include "base/Metrics.h"
+#include "base/Probes.h"
 #include "base/XBase.h"
 #include "../gui/src/ShutdownCh.h"
 
@@ -48,6 +50,11 @@ EVENT_TYPE_ACCESSOR(IScreen)
 EVENT_TYPE_ACCESSOR(Clipboard)
 EVENT_TYPE_ACCESSOR(File)
 
+static MetricGauge&        s_eventQueueDepth = Metrics::getInstance().getGauge(
+    "inputleap_event_queue_depth", "Events waiting to be dispatched.");
+static MetricGauge&        s_timerCount = Metrics::getInstance().getGauge(
+    "inputleap_timers", "Event queue timers.");
+
 // interrupt handler.  this just adds a quit event to the queue.
 static
 void
@@ -132,6 +139,7 @@ EventQueue::registerTypeOnce(Event::Type& type, const char* name)
         m_typeMap.insert(std::make_pair(m_nextType, name));
         m_nameMap.insert(std::make_pair(name, m_nextType));
         LOG((CLOG_DEBUG1 "registered event type %s as %d", name, m_nextType));
+        INPUTLEAP_PROBE2(event_register, m_nextType, name);
         type = m_nextType++;
     }
     return type;
@@ -272,7 +280,9 @@ EventQueue::dispatchEvent(const Event& event)
         job = getHandler(Event::kUnknown, target);
     }
     if (job != NULL) {
+        INPUTLEAP_PROBE2(event_dispatch_start, event.getType(), target);
         job->run(event);
+        INPUTLEAP_PROBE1(event_dispatch_end, event.getType());
         return true;
     }
     return false;
@@ -292,6 +302,7 @@ EventQueue::addEvent(const Event& event)
         break;
     }
 
+    INPUTLEAP_PROBE2(event_add, event.getType(), event.getTarget());
     if ((event.getFlags() & Event::kDeliverImmediately) != 0) {
         dispatchEvent(event);
         Event::deleteData(event);
@@ -331,6 +342,7 @@ EventQueue::newTimer(double duration, void* target)
     }
     std::lock_guard<std::mutex> lock(mutex_);
     m_timers.insert(timer);
+    s_timerCount.set(static_cast<std::int64_t>(m_timers.size()));
     // initial duration is requested duration plus whatever's on
     // the clock currently because the latter will be subtracted
     // the next time we check for timers.
@@ -350,6 +362,7 @@ EventQueue::newOneShotTimer(double duration, void* target)
     }
     std::lock_guard<std::mutex> lock(mutex_);
     m_timers.insert(timer);
+    s_timerCount.set(static_cast<std::int64_t>(m_timers.size()));
     // initial duration is requested duration plus whatever's on
     // the clock currently because the latter will be subtracted
     // the next time we check for timers.
@@ -373,6 +386,7 @@ EventQueue::deleteTimer(EventQueueTimer* timer)
     if (index != m_timers.end()) {
         m_timers.erase(index);
     }
+    s_timerCount.set(static_cast<std::int64_t>(m_timers.size()));
     m_buffer->deleteTimer(timer);
 }
 
@@ -460,6 +474,7 @@ std::uint32_t EventQueue::saveEvent(const Event& event)
 
     // save data
     m_events[id] = event;
+    s_eventQueueDepth.set(static_cast<std::int64_t>(m_events.size()));
     return id;
 }
 
@@ -474,6 +489,7 @@ Event EventQueue::removeEvent(std::uint32_t eventID)
     // get data
     Event event = index->second;
     m_events.erase(index);
+    s_eventQueueDepth.set(static_cast<std::int64_t>(m_events.size()));
 
     // save old id for reuse
     m_oldEventIDs.push_back(eventID);
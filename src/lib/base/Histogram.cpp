@@ -0,0 +1,161 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "base/Histogram.h"
+
+//
+// Histogram
+//
+// values below 2^kSubBucketBits get a bucket each.  above that each
+// power of two range [2^e, 2^(e+1)) is split into kSubBuckets equal
+// buckets, indexed by the bits just below the leading one.
+//
+
+Histogram::Histogram() :
+    m_count(0),
+    m_sum(0),
+    m_max(0)
+{
+    for (std::size_t i = 0; i < kNumBuckets; ++i) {
+        m_buckets[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void
+Histogram::record(std::uint64_t value)
+{
+    m_buckets[getBucket(value)].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(value, std::memory_order_relaxed);
+
+    std::uint64_t max = m_max.load(std::memory_order_relaxed);
+    while (value > max &&
+            !m_max.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+        // max was reloaded, try again
+    }
+}
+
+void
+Histogram::reset()
+{
+    for (std::size_t i = 0; i < kNumBuckets; ++i) {
+        m_buckets[i].store(0, std::memory_order_relaxed);
+    }
+    m_count.store(0, std::memory_order_relaxed);
+    m_sum.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+std::uint64_t
+Histogram::getCount() const
+{
+    return m_count.load(std::memory_order_relaxed);
+}
+
+std::uint64_t
+Histogram::getSum() const
+{
+    return m_sum.load(std::memory_order_relaxed);
+}
+
+std::uint64_t
+Histogram::getMax() const
+{
+    return m_max.load(std::memory_order_relaxed);
+}
+
+std::uint64_t
+Histogram::getPercentile(double percentile) const
+{
+    // count the buckets rather than trusting m_count so the answer is
+    // consistent with the buckets even while other threads record
+    std::uint64_t total = 0;
+    for (std::size_t i = 0; i < kNumBuckets; ++i) {
+        total += m_buckets[i].load(std::memory_order_relaxed);
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    // rank of the value we want, 1 based
+    if (percentile < 0.0) {
+        percentile = 0.0;
+    }
+    else if (percentile > 100.0) {
+        percentile = 100.0;
+    }
+    std::uint64_t rank = static_cast<std::uint64_t>(
+                            percentile / 100.0 * static_cast<double>(total) + 0.5);
+    if (rank < 1) {
+        rank = 1;
+    }
+
+    std::uint64_t max = getMax();
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < kNumBuckets; ++i) {
+        seen += m_buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            std::uint64_t limit = getBucketLimit(i);
+            return (limit < max) ? limit : max;
+        }
+    }
+    return max;
+}
+
+std::size_t
+Histogram::getNumBuckets()
+{
+    return kNumBuckets;
+}
+
+std::uint64_t
+Histogram::getBucketCount(std::size_t index) const
+{
+    return m_buckets[index].load(std::memory_order_relaxed);
+}
+
+std::uint64_t
+Histogram::getBucketLimit(std::size_t index)
+{
+    if (index < kSubBuckets) {
+        return index;
+    }
+
+    // bucket index = (exponent - kSubBucketBits + 1) * kSubBuckets + sub
+    std::size_t shift = index / kSubBuckets - 1;
+    std::uint64_t sub = index % kSubBuckets;
+    std::uint64_t first = (kSubBuckets + sub) << shift;
+    return first + ((std::uint64_t(1) << shift) - 1);
+}
+
+std::size_t
+Histogram::getBucket(std::uint64_t value)
+{
+    if (value < kSubBuckets) {
+        return static_cast<std::size_t>(value);
+    }
+
+    // find the leading one
+    int exponent = 0;
+    for (std::uint64_t v = value >> 1; v != 0; v >>= 1) {
+        ++exponent;
+    }
+
+    std::size_t shift = static_cast<std::size_t>(exponent - kSubBucketBits);
+    std::size_t sub = static_cast<std::size_t>(value >> shift) - kSubBuckets;
+    return (shift + 1) * kSubBuckets + sub;
+}
@@ -0,0 +1,96 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+//! Histogram of non-negative values
+/*!
+Counts values in buckets whose width grows with the value so that any
+value is recorded to within about 6% over the whole range of a 64-bit
+integer, in the manner of an HDR histogram.  Recording is lock-free and
+may happen on any number of threads while another thread reads the
+histogram.
+*/
+class Histogram {
+public:
+    Histogram();
+    Histogram(const Histogram&) = delete;
+    Histogram& operator=(const Histogram&) = delete;
+
+    //! @name manipulators
+    //@{
+
+    //! Add a value
+    void                record(std::uint64_t value);
+
+    //! Remove all values
+    /*!
+    Values recorded on other threads while resetting may or may not
+    be kept.
+    */
+    void                reset();
+
+    //@}
+    //! @name accessors
+    //@{
+
+    //! Get the number of values
+    std::uint64_t        getCount() const;
+
+    //! Get the sum of the values
+    std::uint64_t        getSum() const;
+
+    //! Get the largest value
+    std::uint64_t        getMax() const;
+
+    //! Get a percentile
+    /*!
+    Returns the value that \p percentile percent of the values are less
+    than or equal to, rounded up to the end of its bucket but never more
+    than getMax().  Returns 0 if the histogram is empty.
+    */
+    std::uint64_t        getPercentile(double percentile) const;
+
+    //! Get the number of buckets
+    static std::size_t    getNumBuckets();
+
+    //! Get the number of values in a bucket
+    std::uint64_t        getBucketCount(std::size_t index) const;
+
+    //! Get the largest value that falls in a bucket
+    static std::uint64_t getBucketLimit(std::size_t index);
+
+    //@}
+
+private:
+    static std::size_t    getBucket(std::uint64_t value);
+
+private:
+    // each power of two is split into 2^kSubBucketBits buckets
+    static const int    kSubBucketBits = 4;
+    static const std::size_t kSubBuckets = std::size_t(1) << kSubBucketBits;
+    static const std::size_t kNumBuckets = (64 - kSubBucketBits + 1) * kSubBuckets;
+
+    std::atomic<std::uint64_t> m_buckets[kNumBuckets];
+    std::atomic<std::uint64_t> m_count;
+    std::atomic<std::uint64_t> m_sum;
+    std::atomic<std::uint64_t> m_max;
+};
@@ -66,5 +66,21 @@ public:
     */
     virtual bool        write(ELevel level, const char* message) = 0;
 
+    //@}
+    //! @name accessors
+    //@{
+
+    //! Get a descriptor to write to after a crash
+    /*!
+    Returns a file descriptor that a message with the given \c level can
+    be written to with \c write() from a signal handler, or -1 if the
+    outputter can't be written to that way.
+    */
+    virtual int         getCrashDescriptor(ELevel level) const
+    {
+        (void) level;
+        return -1;
+    }
+
     //@}
 };
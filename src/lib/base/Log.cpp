@@ -19,14 +19,24 @@
 #include "arch/Arch.h"
 #include "arch/XArch.h"
 #include "base/Log.h"
+#include "base/LogQueue.h"
+#include "base/String.h"
 #include "base/log_outputters.h"
 #include "common/Version.h"
 
+#include <algorithm>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <exception>
 #include <iostream>
 #include <ctime>
 
+#if SYSAPI_UNIX
+#include <csignal>
+#include <unistd.h>
+#endif
+
 // names of priorities
 static const char*        g_priority[] = {
     "FATAL",
@@ -45,6 +55,18 @@ static const char*        g_priority[] = {
 // number of priorities
 static const int g_numPriority = static_cast<int>(sizeof(g_priority) / sizeof(g_priority[0]));
 
+// names of categories, as used in filters
+static const char*        g_category[] = {
+    "general",
+    "net",
+    "protocol",
+    "clipboard",
+    "x11",
+    "server"
+};
+static_assert(sizeof(g_category) / sizeof(g_category[0]) == kNumLogCategories,
+              "missing log category name");
+
 // the default priority
 #ifndef NDEBUG
 static const int        g_defaultMaxPriority = kDEBUG;
@@ -52,31 +74,93 @@ static const int        g_defaultMaxPriority = kDEBUG;
 static const int        g_defaultMaxPriority = kINFO;
 #endif
 
+// number of messages asynchronous output can queue
+static const std::size_t g_asyncQueueSize = 8192;
+
+// the terminate handler in place before we installed ours
+static bool                g_terminateHandlerInstalled = false;
+static std::terminate_handler g_prevTerminateHandler = NULL;
+
+#if SYSAPI_UNIX
+// signals that kill us before the queue can be written normally and
+// the handlers in place before we installed ours
+static const int        g_fatalSignals[] = {
+    SIGSEGV, SIGBUS, SIGABRT, SIGFPE, SIGILL
+};
+static const int        g_numFatalSignals =
+    sizeof(g_fatalSignals) / sizeof(g_fatalSignals[0]);
+static struct sigaction g_prevFatalActions[g_numFatalSignals];
+
+// try to lock a mutex from a signal handler.  the lock may be held by
+// a thread that's about to release it, so try for a little while, or
+// by the thread that crashed, which never will.
+static bool
+tryLockAfterCrash(std::mutex& mutex)
+{
+    for (int i = 0; i < 50; ++i) {
+        if (mutex.try_lock()) {
+            return true;
+        }
+        struct timespec delay = { 0, 10000000 };
+        nanosleep(&delay, NULL);
+    }
+    return false;
+}
+
+static void
+writeAll(int fd, const char* data, std::size_t size)
+{
+    while (size > 0) {
+        ssize_t n = ::write(fd, data, size);
+        if (n <= 0) {
+            return;
+        }
+        data += n;
+        size -= static_cast<std::size_t>(n);
+    }
+}
+#endif
+
 //
 // Log
 //
 
 Log*                 Log::s_log = NULL;
-
-Log::Log()
+std::atomic<int>     Log::s_filter[kNumLogCategories];
+std::atomic<int>     Log::s_maxFilter(0);
+
+Log::Log() :
+    m_async(false),
+    m_asyncThread(NULL),
+    m_asyncRunning(false),
+    m_asyncWaiting(false),
+    m_asyncDropped(0)
 {
     assert(s_log == NULL);
 
     // other initialization
-    m_maxPriority = g_defaultMaxPriority;
+    setFilter(g_defaultMaxPriority);
     m_maxNewlineLength = 0;
     insert(new ConsoleLogOutputter);
 
     s_log = this;
 }
 
-Log::Log(Log* src)
+Log::Log(Log* src) :
+    m_async(false),
+    m_asyncThread(NULL),
+    m_asyncRunning(false),
+    m_asyncWaiting(false),
+    m_asyncDropped(0)
 {
     s_log = src;
 }
 
 Log::~Log()
 {
+    // write anything still queued
+    setAsync(false);
+
     // clean up
     for (OutputterList::iterator index    = m_outputters.begin();
                                     index != m_outputters.end(); ++index) {
@@ -126,8 +210,9 @@ Log::print(const char* file, int line, const char* fmt, ...)
         fmt += 3;
     }
 
-    // done if below priority threshold
-    if (priority > getFilter()) {
+    // done if below priority threshold.  LOG() has already checked
+    // the filter of the message's category.
+    if (priority > s_maxFilter.load(std::memory_order_relaxed)) {
         return;
     }
 
@@ -163,39 +248,18 @@ Log::print(const char* file, int line, const char* fmt, ...)
         }
     }
 
-    // print the prefix to the buffer.    leave space for priority label.
-    // do not prefix time and file for kPRINT (CLOG_PRINT)
-    if (priority != kPRINT) {
-
-        struct tm *tm;
-        char timestamp[50];
-        time_t t;
-        time(&t);
-        tm = localtime(&t);
-        sprintf(timestamp, "%04i-%02i-%02iT%02i:%02i:%02i", tm->tm_year + 1900, tm->tm_mon+1, tm->tm_mday, tm->tm_hour, tm->tm_min, tm->tm_sec);
-
-        // square brackets, spaces, comma and null terminator take about 10
-        size_t size = 10;
-        size += strlen(timestamp);
-        size += strlen(g_priority[priority]);
-        size += strlen(buffer);
-#ifndef NDEBUG
-        size += strlen(file);
-        // assume there is no file contains over 100k lines of code
-        size += 6;
-#endif
-        char* message = new char[size];
-
-#ifndef NDEBUG
-        sprintf(message, "[%s] %s: %s\n\t%s,%d", timestamp, g_priority[priority], buffer, file, line);
-#else
-        sprintf(message, "[%s] %s: %s", timestamp, g_priority[priority], buffer);
-#endif
-
-        output(priority, message);
-        delete[] message;
-    } else {
-        output(priority, buffer);
+    // queue the message or write it now.  errors and worse are written
+    // right away in case we're about to exit.
+    if (m_async.load(std::memory_order_acquire) && priority > kERROR) {
+        m_asyncQueue->push(priority, time(NULL), file, line,
+                            buffer, strlen(buffer));
+        if (m_asyncWaiting.load(std::memory_order_relaxed)) {
+            m_asyncCond.notify_one();
+        }
+    }
+    else {
+        flush();
+        output(priority, time(NULL), file, line, buffer);
     }
 
     // clean up
@@ -248,18 +312,57 @@ Log::pop_front(bool alwaysAtHead)
     }
 }
 
+static int
+findName(const char* const* names, int numNames, const std::string& name)
+{
+    for (int i = 0; i < numNames; ++i) {
+        if (name == names[i]) {
+            return i;
+        }
+    }
+    return -1;
+}
+
 bool
 Log::setFilter(const char* maxPriority)
 {
-    if (maxPriority != NULL) {
-        for (int i = 0; i < g_numPriority; ++i) {
-            if (strcmp(maxPriority, g_priority[i]) == 0) {
-                setFilter(i);
-                return true;
+    if (maxPriority == NULL) {
+        return true;
+    }
+
+    // parse the whole filter before changing anything.  a priority on
+    // its own applies to every category.
+    int filter[kNumLogCategories];
+    for (int i = 0; i < kNumLogCategories; ++i) {
+        filter[i] = getFilter(static_cast<ELogCategory>(i));
+    }
+    for (const std::string& item : inputleap::string::splitString(maxPriority, ',')) {
+        std::string::size_type equals = item.find('=');
+        int priority = findName(g_priority, g_numPriority,
+                            equals == std::string::npos ? item : item.substr(equals + 1));
+        if (priority == -1) {
+            return false;
+        }
+        if (equals == std::string::npos) {
+            for (int i = 0; i < kNumLogCategories; ++i) {
+                filter[i] = priority;
+            }
+        }
+        else {
+            int category = findName(g_category, kNumLogCategories,
+                            item.substr(0, equals));
+            if (category == -1) {
+                return false;
             }
+            filter[category] = priority;
         }
-        return false;
     }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (int i = 0; i < kNumLogCategories; ++i) {
+        s_filter[i].store(filter[i], std::memory_order_relaxed);
+    }
+    updateMaxFilter();
     return true;
 }
 
@@ -267,18 +370,293 @@ void
 Log::setFilter(int maxPriority)
 {
     std::lock_guard<std::mutex> lock(m_mutex);
-    m_maxPriority = maxPriority;
+    for (int i = 0; i < kNumLogCategories; ++i) {
+        s_filter[i].store(maxPriority, std::memory_order_relaxed);
+    }
+    updateMaxFilter();
+}
+
+void
+Log::setFilter(ELogCategory category, int maxPriority)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    s_filter[category].store(maxPriority, std::memory_order_relaxed);
+    updateMaxFilter();
 }
 
 int
 Log::getFilter() const
 {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    return m_maxPriority;
+    return getFilter(kLogGeneral);
+}
+
+int
+Log::getFilter(ELogCategory category) const
+{
+    return s_filter[category].load(std::memory_order_relaxed);
+}
+
+int
+Log::getMaxFilter() const
+{
+    return s_maxFilter.load(std::memory_order_relaxed);
+}
+
+void
+Log::updateMaxFilter()
+{
+    int maxFilter = s_filter[0].load(std::memory_order_relaxed);
+    for (int i = 1; i < kNumLogCategories; ++i) {
+        maxFilter = std::max(maxFilter, s_filter[i].load(std::memory_order_relaxed));
+    }
+    s_maxFilter.store(maxFilter, std::memory_order_relaxed);
+}
+
+void
+Log::setAsync(bool enabled)
+{
+    if (enabled == m_async.load()) {
+        return;
+    }
+
+    if (enabled) {
+        if (!m_asyncQueue) {
+            m_asyncQueue.reset(new LogQueue(g_asyncQueueSize));
+        }
+
+        // write queued messages if we die from an uncaught exception
+        // or a fatal signal
+        if (!g_terminateHandlerInstalled) {
+            g_prevTerminateHandler = std::set_terminate(&Log::flushOnTerminate);
+#if SYSAPI_UNIX
+            struct sigaction act;
+            act.sa_handler = &Log::flushOnSignal;
+            sigemptyset(&act.sa_mask);
+            act.sa_flags = 0;
+            for (int i = 0; i < g_numFatalSignals; ++i) {
+                sigaction(g_fatalSignals[i], &act, &g_prevFatalActions[i]);
+            }
+#endif
+            g_terminateHandlerInstalled = true;
+        }
+
+        m_asyncRunning = true;
+        m_asyncThread  = ARCH->newThread([this]() { asyncThread(); });
+        m_async.store(true, std::memory_order_release);
+    }
+    else {
+        m_async.store(false, std::memory_order_release);
+
+        // stop the writer thread then write whatever it left behind
+        {
+            std::lock_guard<std::mutex> lock(m_asyncMutex);
+            m_asyncRunning = false;
+        }
+        m_asyncCond.notify_one();
+        ARCH->wait(m_asyncThread, -1.0);
+        ARCH->closeThread(m_asyncThread);
+        m_asyncThread = NULL;
+        asyncFlush();
+    }
+}
+
+void
+Log::flush()
+{
+    // nothing is queued while asynchronous output is off.  setAsync()
+    // writes what's left when turning it off.
+    if (m_async.load(std::memory_order_acquire)) {
+        asyncFlush();
+    }
+}
+
+void
+Log::asyncThread()
+{
+    std::unique_lock<std::mutex> lock(m_asyncMutex);
+    while (m_asyncRunning) {
+        lock.unlock();
+        asyncFlush();
+        lock.lock();
+
+        // wait for more messages.  print() only wakes us if we're
+        // waiting so don't wait too long in case we missed one.
+        if (m_asyncRunning) {
+            m_asyncWaiting = true;
+            ARCH->wait_cond_var(m_asyncCond, lock, 0.1);
+            m_asyncWaiting = false;
+        }
+    }
+}
+
+void
+Log::asyncFlush()
+{
+    std::lock_guard<std::mutex> lock(m_asyncFlushMutex);
+    asyncWrite();
+}
+
+void
+Log::asyncWrite()
+{
+    LogQueue::Record record;
+    while (m_asyncQueue->pop(record)) {
+        output(record.m_priority, record.m_time,
+                record.m_file, record.m_line, record.m_message.c_str());
+
+        // don't let an unusually long message pin its buffer
+        if (record.m_message.capacity() > 4096) {
+            std::string().swap(record.m_message);
+        }
+    }
+
+    // report messages that didn't fit in the queue
+    std::uint64_t dropped = m_asyncQueue->getDropped();
+    if (dropped != m_asyncDropped) {
+        char msg[64];
+        sprintf(msg, "%llu log messages dropped",
+                static_cast<unsigned long long>(dropped - m_asyncDropped));
+        output(kWARNING, time(NULL), NULL, 0, msg);
+        m_asyncDropped = dropped;
+    }
+}
+
+void
+Log::crashWrite()
+{
+#if SYSAPI_UNIX
+    // we may have crashed while writing the queue, possibly on this
+    // thread, so don't wait long for it.  we can't format a timestamp or
+    // call the outputters either so the messages go straight to the
+    // outputters' descriptors, or to stderr if the outputters are busy.
+    if (!m_async.load(std::memory_order_acquire) ||
+        !tryLockAfterCrash(m_asyncFlushMutex)) {
+        return;
+    }
+    bool outputters = tryLockAfterCrash(m_mutex);
+
+    LogQueue::Record record;
+    while (m_asyncQueue->pop(record)) {
+        const char* priority = (record.m_priority == kPRINT) ?
+                                NULL : g_priority[record.m_priority];
+        int fds[8];
+        int numFds = 0;
+        if (outputters) {
+            for (OutputterList::const_iterator index = m_outputters.begin();
+                                index != m_outputters.end() && numFds < 8; ++index) {
+                int fd = (*index)->getCrashDescriptor(record.m_priority);
+                if (fd != -1) {
+                    fds[numFds++] = fd;
+                }
+            }
+        }
+        else {
+            fds[numFds++] = 2;
+        }
+        for (int i = 0; i < numFds; ++i) {
+            if (priority != NULL) {
+                writeAll(fds[i], priority, strlen(priority));
+                writeAll(fds[i], ": ", 2);
+            }
+            writeAll(fds[i], record.m_message.data(), record.m_message.size());
+            writeAll(fds[i], "\n", 1);
+        }
+    }
+
+    if (outputters) {
+        m_mutex.unlock();
+    }
+    m_asyncFlushMutex.unlock();
+#endif
+}
+
+void
+Log::flushOnTerminate()
+{
+    // we may be terminating because an outputter threw, in which case
+    // this thread holds the outputter lock and maybe the queue's.  don't
+    // wait for either;  if the outputters are busy then write the queue
+    // as if we'd crashed.
+    if (s_log != NULL && s_log->m_async.load(std::memory_order_acquire)) {
+        if (s_log->m_mutex.try_lock()) {
+            s_log->m_mutex.unlock();
+            if (s_log->m_asyncFlushMutex.try_lock()) {
+                s_log->asyncWrite();
+                s_log->m_asyncFlushMutex.unlock();
+            }
+        }
+        else {
+            s_log->crashWrite();
+        }
+    }
+    if (g_prevTerminateHandler != NULL) {
+        g_prevTerminateHandler();
+    }
+    std::abort();
+}
+
+void
+Log::flushOnSignal(int signal)
+{
+#if SYSAPI_UNIX
+    if (s_log != NULL) {
+        s_log->crashWrite();
+    }
+
+    // put back the previous handler.  it gets the signal when we return
+    // (or, for a fault, when the instruction runs again).
+    for (int i = 0; i < g_numFatalSignals; ++i) {
+        if (g_fatalSignals[i] == signal) {
+            sigaction(signal, &g_prevFatalActions[i], NULL);
+        }
+    }
+    raise(signal);
+#else
+    (void) signal;
+#endif
+}
+
+void
+Log::output(ELevel priority, std::time_t t, const char* file, int line,
+                const char* buffer)
+{
+    // print the prefix to the buffer.    leave space for priority label.
+    // do not prefix time and file for kPRINT (CLOG_PRINT)
+    if (priority != kPRINT) {
+
+        struct tm *tm;
+        char timestamp[50];
+        tm = localtime(&t);
+        sprintf(timestamp, "%04i-%02i-%02iT%02i:%02i:%02i", tm->tm_year + 1900, tm->tm_mon+1, tm->tm_mday, tm->tm_hour, tm->tm_min, tm->tm_sec);
+
+        // square brackets, spaces, comma and null terminator take about 10
+        size_t size = 10;
+        size += strlen(timestamp);
+        size += strlen(g_priority[priority]);
+        size += strlen(buffer);
+        if (file != NULL) {
+            size += strlen(file);
+            // assume there is no file contains over 100k lines of code
+            size += 6;
+        }
+        char* message = new char[size];
+
+        if (file != NULL) {
+            sprintf(message, "[%s] %s: %s\n\t%s,%d", timestamp, g_priority[priority], buffer, file, line);
+        }
+        else {
+            sprintf(message, "[%s] %s: %s", timestamp, g_priority[priority], buffer);
+        }
+
+        output(priority, message);
+        delete[] message;
+    } else {
+        output(priority, buffer);
+    }
 }
 
 void
-Log::output(ELevel priority, char* msg)
+Log::output(ELevel priority, const char* msg)
 {
     assert(priority >= -1 && priority < g_numPriority);
     assert(msg != NULL);
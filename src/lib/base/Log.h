@@ -24,14 +24,37 @@
 #include "common/stdlist.h"
 
 #include <stdarg.h>
+#include <atomic>
+#include <condition_variable>
+#include <ctime>
+#include <memory>
 #include <mutex>
 
 #define CLOG (Log::getInstance())
 #define BYE "\nTry `%s --help' for more information."
 
 class ILogOutputter;
+class LogQueue;
 class Thread;
 
+//! Log message categories
+/*!
+Every log message belongs to a category and each category has its own
+priority filter, so a subsystem can log at a higher verbosity than the
+rest.  The category of a message is \c INPUTLEAP_LOG_CATEGORY where the
+LOG() is written;  the build sets it for each library and for the
+protocol and clipboard sources.
+*/
+enum ELogCategory {
+    kLogGeneral,
+    kLogNet,
+    kLogProtocol,
+    kLogClipboard,
+    kLogX11,
+    kLogServer,
+    kNumLogCategories
+};
+
 //! Logging facility
 /*!
 The logging class;  all console output should go through this class.
@@ -86,15 +109,43 @@ public:
     /*!
     Set the filter.  Messages below this priority are discarded.
     The default priority is 4 (INFO) (unless built without NDEBUG
-    in which case it's 5 (DEBUG)).   setFilter(const char*) returns
-    true if the priority \c name was recognized;  if \c name is NULL
-    then it simply returns true.
+    in which case it's 5 (DEBUG)).  The priority name may be followed
+    by a comma separated list of \c category=priority pairs to filter
+    those categories differently, e.g. \c INFO,protocol=DEBUG2.
+    setFilter(const char*) returns true if every priority and category
+    in \c name was recognized;  if \c name is NULL then it simply
+    returns true.
     */
     bool                setFilter(const char* name);
 
     //! Set the minimum priority filter (by ordinal).
+    /*!
+    Sets the filter of every category.
+    */
     void                setFilter(int);
 
+    //! Set the minimum priority filter of one category
+    void                setFilter(ELogCategory, int);
+
+    //! Enable or disable asynchronous output
+    /*!
+    When enabled, print() only formats the message and queues it.  A
+    background thread adds the timestamp and passes it to the outputters,
+    so a slow outputter doesn't hold up the thread that's logging.  The
+    queue is bounded;  messages that don't fit are dropped and a warning
+    with the number dropped is logged once there's room.  Errors and
+    worse, and CLOG_PRINT messages, flush the queue and are written
+    before print() returns.  Disabling flushes the queue.
+    */
+    void                setAsync(bool enabled);
+
+    //! Write all queued messages
+    /*!
+    Writes any messages queued by asynchronous output on the calling
+    thread.  It does nothing if asynchronous output is disabled.
+    */
+    void                flush();
+
     //@}
     //! @name accessors
     //@{
@@ -109,8 +160,42 @@ public:
                             const char* format, ...);
 
     //! Get the minimum priority level.
+    /*!
+    Returns the filter of the general category.
+    */
     int                    getFilter() const;
 
+    //! Get the minimum priority level of a category
+    int                    getFilter(ELogCategory) const;
+
+    //! Get the least restrictive priority level
+    /*!
+    Returns the highest filter of any category, i.e. the most verbose
+    messages that can be logged.
+    */
+    int                    getMaxFilter() const;
+
+    //! Test if a message would be logged
+    /*!
+    Returns true iff a message of the given priority in the given
+    category passes the filter.  This is cheap enough to call before
+    doing any work to compute a message.
+    */
+    static bool            isEnabled(ELogCategory category, int priority)
+    {
+        return priority <= s_filter[category].load(std::memory_order_relaxed);
+    }
+
+    //! Get the priority of a message format
+    /*!
+    Returns the priority encoded at the start of a format built with
+    one of the \c CLOG_XXX macros.
+    */
+    static constexpr int getPriority(const char* fmt)
+    {
+        return (fmt[0] == '%' && fmt[1] == 'z') ? fmt[2] - '\060' : kINFO;
+    }
+
     //! Get the filter name of the current filter level.
     const char*            getFilterName() const;
 
@@ -126,18 +211,44 @@ public:
     //@}
 
 private:
-    void                output(ELevel priority, char* msg);
+    void                updateMaxFilter();
+    void                output(ELevel priority, const char* msg);
+    void                output(ELevel priority, std::time_t time,
+                            const char* file, int line, const char* msg);
+
+    // asynchronous output
+    void                asyncThread();
+    void                asyncFlush();
+    void                asyncWrite();
+    void                crashWrite();
+    static void            flushOnTerminate();
+    static void            flushOnSignal(int signal);
 
 private:
     typedef std::list<ILogOutputter*> OutputterList;
 
     static Log*        s_log;
 
+    // the filter of each category and the least restrictive of them
+    static std::atomic<int> s_filter[kNumLogCategories];
+    static std::atomic<int> s_maxFilter;
+
     mutable std::mutex m_mutex;
     OutputterList        m_outputters;
     OutputterList        m_alwaysOutputters;
     int                    m_maxNewlineLength;
-    int                    m_maxPriority;
+
+    // asynchronous output.  m_asyncFlushMutex is held by whichever
+    // thread is emptying the queue.
+    std::unique_ptr<LogQueue> m_asyncQueue;
+    std::atomic<bool>    m_async;
+    ArchThread            m_asyncThread;
+    bool                m_asyncRunning;
+    std::atomic<bool>    m_asyncWaiting;
+    std::mutex            m_asyncMutex;
+    std::condition_variable m_asyncCond;
+    std::mutex            m_asyncFlushMutex;
+    std::uint64_t        m_asyncDropped;
 };
 
 /*!
@@ -153,6 +264,10 @@ replaced by one of enumerants in \c Log::ELevel without the leading
 \c k.  For example, \c CLOG_INFO.  The special \c CLOG_PRINT level will
 not be filtered and is never prefixed by the filename and line number.
 
+The priority is checked against the filter of the category before the
+arguments are evaluated, so a filtered message costs a compare.  Messages
+with a priority above \c INPUTLEAP_LOG_MAX_LEVEL aren't compiled in.
+
 If \c NOLOGGING is defined during the build then this macro expands to
 nothing.  If \c NDEBUG is defined during the build then it expands to a
 call to Log::print.  Otherwise it expands to a call to Log::printt,
@@ -179,17 +294,37 @@ to a call to Log::print that prints the filename and line number,
 otherwise it expands to a call that doesn't.
 */
 
+// the category of messages logged from the including file
+#ifndef INPUTLEAP_LOG_CATEGORY
+#define INPUTLEAP_LOG_CATEGORY kLogGeneral
+#endif
+
+// the most verbose priority compiled in
+#ifndef INPUTLEAP_LOG_MAX_LEVEL
+#define INPUTLEAP_LOG_MAX_LEVEL kDEBUG5
+#endif
+
+// LOG_FORMAT((file, line, fmt, ...)) picks out fmt.  LOG_EXPAND forces
+// __VA_ARGS__ to be split into arguments on compilers that don't.
+#define LOG_EXPAND(x)    x
+#define LOG_FIRST(first, ...)    first
+#define LOG_FORMAT_(file, line, ...)    LOG_EXPAND(LOG_FIRST(__VA_ARGS__, 0))
+#define LOG_FORMAT(...)    LOG_EXPAND(LOG_FORMAT_(__VA_ARGS__))
+#define LOG_ENABLED(_a1) \
+    (Log::getPriority(LOG_FORMAT _a1) <= INPUTLEAP_LOG_MAX_LEVEL && \
+     Log::isEnabled(INPUTLEAP_LOG_CATEGORY, Log::getPriority(LOG_FORMAT _a1)))
+
 #if defined(NOLOGGING)
 #define LOG(_a1)
 #define LOGC(_a1, _a2)
 #define CLOG_TRACE
 #elif defined(NDEBUG)
-#define LOG(_a1)        CLOG->print _a1
-#define LOGC(_a1, _a2)    if (_a1) CLOG->print _a2
+#define LOG(_a1)        if (!LOG_ENABLED(_a1)) { } else CLOG->print _a1
+#define LOGC(_a1, _a2)    if (!((_a1) && LOG_ENABLED(_a2))) { } else CLOG->print _a2
 #define CLOG_TRACE        NULL, 0,
 #else
-#define LOG(_a1)        CLOG->print _a1
-#define LOGC(_a1, _a2)    if (_a1) CLOG->print _a2
+#define LOG(_a1)        if (!LOG_ENABLED(_a1)) { } else CLOG->print _a1
+#define LOGC(_a1, _a2)    if (!((_a1) && LOG_ENABLED(_a2))) { } else CLOG->print _a2
 #define CLOG_TRACE        __FILE__, __LINE__,
 #endif
 
@@ -0,0 +1,110 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "base/LogQueue.h"
+
+#include <utility>
+
+//
+// LogQueue
+//
+// each slot's sequence number says whose turn it is:  a slot is free
+// for the push at position p when its sequence is p and holds a record
+// for the pop at position p when its sequence is p + 1.
+//
+
+static std::size_t
+roundUpToPowerOfTwo(std::size_t size)
+{
+    std::size_t result = 1;
+    while (result < size) {
+        result <<= 1;
+    }
+    return result;
+}
+
+LogQueue::LogQueue(std::size_t size) :
+    m_slots(roundUpToPowerOfTwo(size < 2 ? 2 : size)),
+    m_mask(m_slots.size() - 1),
+    m_pushPos(0),
+    m_popPos(0),
+    m_dropped(0)
+{
+    for (std::size_t i = 0; i < m_slots.size(); ++i) {
+        m_slots[i].m_sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+bool
+LogQueue::push(ELevel priority, std::time_t time,
+                const char* file, int line,
+                const char* message, std::size_t length)
+{
+    // claim a slot
+    Slot* slot;
+    std::size_t pos = m_pushPos.load(std::memory_order_relaxed);
+    for (;;) {
+        slot = &m_slots[pos & m_mask];
+        std::size_t sequence = slot->m_sequence.load(std::memory_order_acquire);
+        std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(sequence - pos);
+        if (diff == 0) {
+            if (m_pushPos.compare_exchange_weak(pos, pos + 1,
+                                                std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        else if (diff < 0) {
+            // full
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        else {
+            pos = m_pushPos.load(std::memory_order_relaxed);
+        }
+    }
+
+    // fill it in and hand it to the reader
+    Record& record   = slot->m_record;
+    record.m_priority = priority;
+    record.m_time     = time;
+    record.m_file     = file;
+    record.m_line     = line;
+    record.m_message.assign(message, length);
+    slot->m_sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool
+LogQueue::pop(Record& record)
+{
+    Slot& slot = m_slots[m_popPos & m_mask];
+    if (slot.m_sequence.load(std::memory_order_acquire) != m_popPos + 1) {
+        return false;
+    }
+
+    // swap rather than copy so the message buffers get reused
+    std::swap(record, slot.m_record);
+    slot.m_sequence.store(m_popPos + m_mask + 1, std::memory_order_release);
+    ++m_popPos;
+    return true;
+}
+
+std::uint64_t
+LogQueue::getDropped() const
+{
+    return m_dropped.load(std::memory_order_relaxed);
+}
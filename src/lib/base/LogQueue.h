@@ -0,0 +1,97 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "base/ELevel.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <vector>
+
+//! Bounded queue of log records
+/*!
+A fixed size ring of log records.  Any number of threads may push
+records without locking while a single thread pops them.  When the
+ring is full new records are dropped and counted instead of blocking
+the thread that's logging.
+*/
+class LogQueue {
+public:
+    //! A log message that hasn't been written yet
+    class Record {
+    public:
+        Record() : m_priority(kINFO), m_time(0), m_file(NULL), m_line(0) { }
+
+    public:
+        ELevel            m_priority;
+        std::time_t        m_time;
+        const char*        m_file;
+        int                m_line;
+        std::string        m_message;
+    };
+
+    //! Create a queue with room for at least \c size records
+    explicit LogQueue(std::size_t size);
+    LogQueue(const LogQueue&) = delete;
+    LogQueue& operator=(const LogQueue&) = delete;
+
+    //! @name manipulators
+    //@{
+
+    //! Add a record
+    /*!
+    Copies the message into the next free slot.  Returns false and
+    counts the record as dropped if the queue is full.  Safe to call
+    from any thread.
+    */
+    bool                push(ELevel priority, std::time_t time,
+                            const char* file, int line,
+                            const char* message, std::size_t length);
+
+    //! Remove the oldest record
+    /*!
+    Swaps the oldest record into \c record and returns true, or returns
+    false if the queue is empty.  Only one thread may pop at a time.
+    */
+    bool                pop(Record& record);
+
+    //@}
+    //! @name accessors
+    //@{
+
+    //! Get the number of records dropped because the queue was full
+    std::uint64_t        getDropped() const;
+
+    //@}
+
+private:
+    class Slot {
+    public:
+        std::atomic<std::size_t> m_sequence;
+        Record            m_record;
+    };
+
+    std::vector<Slot>    m_slots;
+    std::size_t            m_mask;
+    std::atomic<std::size_t> m_pushPos;
+    std::size_t            m_popPos;
+    std::atomic<std::uint64_t> m_dropped;
+};
@@ -0,0 +1,217 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "base/Metrics.h"
+
+#include <cassert>
+#include <cstdio>
+
+// histograms are reported with a bucket for each power of two up to this
+static const int        kMaxHistogramExponent = 32;
+
+static void
+appendNumber(std::string& dst, double value)
+{
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.9g", value);
+    dst += buffer;
+}
+
+static void
+appendSeries(std::string& dst, const std::string& name, const char* suffix,
+                const std::string& labels, const std::string& extraLabel)
+{
+    dst += name;
+    dst += suffix;
+    if (!labels.empty() || !extraLabel.empty()) {
+        dst += '{';
+        dst += labels;
+        if (!labels.empty() && !extraLabel.empty()) {
+            dst += ',';
+        }
+        dst += extraLabel;
+        dst += '}';
+    }
+    dst += ' ';
+}
+
+//
+// Metrics
+//
+
+Metrics::Metrics()
+{
+    // do nothing
+}
+
+Metrics::~Metrics()
+{
+    // do nothing
+}
+
+MetricCounter&
+Metrics::getCounter(const char* name, const char* help, const std::string& labels)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::unique_ptr<MetricCounter>& metric =
+        getFamily(name, help, kCounter, 1.0).m_counters[labels];
+    if (!metric) {
+        metric.reset(new MetricCounter);
+    }
+    return *metric;
+}
+
+MetricGauge&
+Metrics::getGauge(const char* name, const char* help, const std::string& labels)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::unique_ptr<MetricGauge>& metric =
+        getFamily(name, help, kGauge, 1.0).m_gauges[labels];
+    if (!metric) {
+        metric.reset(new MetricGauge);
+    }
+    return *metric;
+}
+
+Histogram&
+Metrics::getHistogram(const char* name, const char* help, double scale,
+                const std::string& labels)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::unique_ptr<Histogram>& metric =
+        getFamily(name, help, kHistogram, scale).m_histograms[labels];
+    if (!metric) {
+        metric.reset(new Histogram);
+    }
+    return *metric;
+}
+
+std::string
+Metrics::format() const
+{
+    static const char* s_types[] = { "counter", "gauge", "histogram" };
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::string result;
+    for (FamilyMap::const_iterator index = m_families.begin();
+                                index != m_families.end(); ++index) {
+        const std::string& name = index->first;
+        const Family& family    = index->second;
+        result += "# HELP " + name + " " + family.m_help + "\n";
+        result += "# TYPE " + name + " " + s_types[family.m_type] + "\n";
+
+        for (const auto& counter : family.m_counters) {
+            appendSeries(result, name, "", counter.first, "");
+            appendNumber(result, static_cast<double>(counter.second->get()));
+            result += '\n';
+        }
+        for (const auto& gauge : family.m_gauges) {
+            appendSeries(result, name, "", gauge.first, "");
+            appendNumber(result, static_cast<double>(gauge.second->get()));
+            result += '\n';
+        }
+        for (const auto& entry : family.m_histograms) {
+            // cumulative counts at each power of two.  bucket i holds
+            // values up to getBucketLimit(i) so it's below 2^exponent
+            // when its limit is.
+            const Histogram& histogram = *entry.second;
+            std::size_t bucket  = 0;
+            std::uint64_t count = 0;
+            for (int exponent = 0; exponent <= kMaxHistogramExponent; ++exponent) {
+                std::uint64_t bound = std::uint64_t(1) << exponent;
+                for (; bucket < Histogram::getNumBuckets() &&
+                        Histogram::getBucketLimit(bucket) < bound; ++bucket) {
+                    count += histogram.getBucketCount(bucket);
+                }
+                std::string le = "le=\"";
+                appendNumber(le, family.m_scale * static_cast<double>(bound));
+                le += '"';
+                appendSeries(result, name, "_bucket", entry.first, le);
+                appendNumber(result, static_cast<double>(count));
+                result += '\n';
+            }
+            for (; bucket < Histogram::getNumBuckets(); ++bucket) {
+                count += histogram.getBucketCount(bucket);
+            }
+            appendSeries(result, name, "_bucket", entry.first, "le=\"+Inf\"");
+            appendNumber(result, static_cast<double>(count));
+            result += '\n';
+            appendSeries(result, name, "_sum", entry.first, "");
+            appendNumber(result, family.m_scale * static_cast<double>(histogram.getSum()));
+            result += '\n';
+            appendSeries(result, name, "_count", entry.first, "");
+            appendNumber(result, static_cast<double>(count));
+            result += '\n';
+        }
+    }
+    return result;
+}
+
+std::string
+Metrics::label(const char* key, const std::string& value)
+{
+    std::string result = key;
+    result += "=\"";
+    for (char c : value) {
+        switch (c) {
+        case '\\':
+            result += "\\\\";
+            break;
+
+        case '"':
+            result += "\\\"";
+            break;
+
+        case '\n':
+            result += "\\n";
+            break;
+
+        default:
+            result += c;
+            break;
+        }
+    }
+    result += '"';
+    return result;
+}
+
+Metrics&
+Metrics::getInstance()
+{
+    // never destroyed so that metrics can be updated while the
+    // process is exiting
+    static Metrics* s_metrics = new Metrics;
+    return *s_metrics;
+}
+
+Metrics::Family&
+Metrics::getFamily(const char* name, const char* help, EType type, double scale)
+{
+    // note -- m_mutex must be locked on entry
+    FamilyMap::iterator index = m_families.find(name);
+    if (index == m_families.end()) {
+        Family& family = m_families[name];
+        family.m_type  = type;
+        family.m_help  = help;
+        family.m_scale = scale;
+        return family;
+    }
+
+    // a name means the same thing everywhere it's used
+    assert(index->second.m_type == type);
+    return index->second;
+}
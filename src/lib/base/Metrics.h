@@ -0,0 +1,152 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "base/Histogram.h"
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+//! Counter metric
+/*!
+A value that only goes up, like the number of bytes sent.  Lock-free.
+*/
+class MetricCounter {
+public:
+    MetricCounter() : m_value(0) { }
+    MetricCounter(const MetricCounter&) = delete;
+    MetricCounter& operator=(const MetricCounter&) = delete;
+
+    //! Add to the counter
+    void                add(std::uint64_t n = 1)
+                        { m_value.fetch_add(n, std::memory_order_relaxed); }
+
+    //! Get the counter
+    std::uint64_t        get() const
+                        { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<std::uint64_t> m_value;
+};
+
+//! Gauge metric
+/*!
+A value that goes up and down, like the depth of a queue.  Lock-free.
+*/
+class MetricGauge {
+public:
+    MetricGauge() : m_value(0) { }
+    MetricGauge(const MetricGauge&) = delete;
+    MetricGauge& operator=(const MetricGauge&) = delete;
+
+    //! Set the gauge
+    void                set(std::int64_t value)
+                        { m_value.store(value, std::memory_order_relaxed); }
+
+    //! Add to (or with a negative \p n subtract from) the gauge
+    void                add(std::int64_t n)
+                        { m_value.fetch_add(n, std::memory_order_relaxed); }
+
+    //! Get the gauge
+    std::int64_t        get() const
+                        { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<std::int64_t> m_value;
+};
+
+//! Metrics registry
+/*!
+The process wide set of counters, gauges and histograms.  A metric is
+identified by its name and its labels, which are given in Prometheus
+syntax without the braces (e.g. \c peer="laptop", see label()).  Looking
+up a metric takes a lock so callers should look a metric up once and
+keep the reference, which stays valid for the life of the process.
+Updating a metric never locks.
+*/
+class Metrics {
+public:
+    Metrics();
+    Metrics(const Metrics&) = delete;
+    Metrics& operator=(const Metrics&) = delete;
+    ~Metrics();
+
+    //! @name manipulators
+    //@{
+
+    //! Get a counter, creating it if necessary
+    MetricCounter&        getCounter(const char* name, const char* help,
+                            const std::string& labels = std::string());
+
+    //! Get a gauge, creating it if necessary
+    MetricGauge&        getGauge(const char* name, const char* help,
+                            const std::string& labels = std::string());
+
+    //! Get a histogram, creating it if necessary
+    /*!
+    Values are recorded as integers and multiplied by \p scale when
+    reported, e.g. record microseconds with a scale of 1.0e-6 to report
+    seconds as Prometheus expects.
+    */
+    Histogram&            getHistogram(const char* name, const char* help,
+                            double scale,
+                            const std::string& labels = std::string());
+
+    //@}
+    //! @name accessors
+    //@{
+
+    //! Get the metrics in the Prometheus text format
+    std::string            format() const;
+
+    //! Make a label
+    /*!
+    Returns \c key="value" with \p value escaped as necessary.
+    */
+    static std::string    label(const char* key, const std::string& value);
+
+    //! Get the registry
+    static Metrics&        getInstance();
+
+    //@}
+
+private:
+    enum EType { kCounter, kGauge, kHistogram };
+
+    class Family {
+    public:
+        EType            m_type;
+        std::string        m_help;
+        double            m_scale;
+        std::map<std::string, std::unique_ptr<MetricCounter>> m_counters;
+        std::map<std::string, std::unique_ptr<MetricGauge>> m_gauges;
+        std::map<std::string, std::unique_ptr<Histogram>> m_histograms;
+    };
+    typedef std::map<std::string, Family> FamilyMap;
+
+    Family&                getFamily(const char* name, const char* help,
+                            EType type, double scale);
+
+private:
+    mutable std::mutex    m_mutex;
+    FamilyMap            m_families;
+};
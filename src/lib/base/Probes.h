@@ -0,0 +1,63 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "config.h"
+
+//! @name USDT probes
+/*!
+Static tracepoints for perf and bpftrace.  Each probe compiles to a
+single nop plus a note in the binary saying where its arguments live,
+so a probe costs nothing measurable until a tracer attaches to it.
+Arguments must be integers or pointers and should already be at hand;
+they're evaluated whether or not anything is tracing.
+
+Probes are compiled in when the build finds <sys/sdt.h> and the
+INPUTLEAP_USE_USDT CMake option is on (the default).  Otherwise they
+compile to nothing.  All probes belong to the \c inputleap provider;
+list them with bpftrace -l 'usdt:/path/to/barriers:inputleap:*'.
+See doc/bpftrace for example scripts.
+*/
+//@{
+
+#if INPUTLEAP_USDT
+
+#include <sys/sdt.h>
+
+#define INPUTLEAP_PROBE0(name) \
+    DTRACE_PROBE(inputleap, name)
+#define INPUTLEAP_PROBE1(name, a1) \
+    DTRACE_PROBE1(inputleap, name, a1)
+#define INPUTLEAP_PROBE2(name, a1, a2) \
+    DTRACE_PROBE2(inputleap, name, a1, a2)
+#define INPUTLEAP_PROBE3(name, a1, a2, a3) \
+    DTRACE_PROBE3(inputleap, name, a1, a2, a3)
+#define INPUTLEAP_PROBE4(name, a1, a2, a3, a4) \
+    DTRACE_PROBE4(inputleap, name, a1, a2, a3, a4)
+
+#else
+
+#define INPUTLEAP_PROBE0(name) ((void)0)
+#define INPUTLEAP_PROBE1(name, a1) ((void)0)
+#define INPUTLEAP_PROBE2(name, a1, a2) ((void)0)
+#define INPUTLEAP_PROBE3(name, a1, a2, a3) ((void)0)
+#define INPUTLEAP_PROBE4(name, a1, a2, a3, a4) ((void)0)
+
+#endif
+
+//@}
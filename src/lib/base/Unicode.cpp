@@ -22,6 +22,11 @@
 #include <climits>
 #include <cstring>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define INPUTLEAP_UNICODE_SSE2 1
+#include <emmintrin.h>
+#endif
+
 namespace {
 
 enum EWideCharEncoding {
@@ -103,6 +108,186 @@ setError(bool* errors)
     }
 }
 
+//
+// ASCII runs
+//
+// text is mostly ASCII and ASCII is the same in every encoding we
+// handle, just wider or narrower.  these find runs of ASCII characters
+// and copy them as a block instead of one character at a time.  they
+// use SSE2 where it's available (it always is on x86-64) and plain
+// loops otherwise.
+//
+
+namespace {
+
+// returns the number of leading bytes below 0x80
+std::uint32_t count_ascii8(const std::uint8_t* data, std::uint32_t n)
+{
+    std::uint32_t i = 0;
+#if INPUTLEAP_UNICODE_SSE2
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        if (_mm_movemask_epi8(v) != 0) {
+            break;
+        }
+    }
+#endif
+    for (; i + 8 <= n; i += 8) {
+        std::uint64_t w;
+        std::memcpy(&w, data + i, 8);
+        if ((w & 0x8080808080808080ull) != 0) {
+            break;
+        }
+    }
+    while (i < n && data[i] < 0x80) {
+        ++i;
+    }
+    return i;
+}
+
+// returns the number of leading 16-bit characters below 0x80
+std::uint32_t count_ascii16(const std::uint8_t* data, std::uint32_t n, bool byteSwapped)
+{
+    std::uint32_t i = 0;
+#if INPUTLEAP_UNICODE_SSE2
+    const __m128i mask = _mm_set1_epi16(static_cast<short>(byteSwapped ? 0x80ff : 0xff80));
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 8 <= n; i += 8) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 2 * i));
+        v = _mm_cmpeq_epi16(_mm_and_si128(v, mask), zero);
+        if (_mm_movemask_epi8(v) != 0xffff) {
+            break;
+        }
+    }
+#endif
+    while (i < n && decode16(data + 2 * i, byteSwapped) < 0x80) {
+        ++i;
+    }
+    return i;
+}
+
+// returns the number of leading 32-bit characters below 0x80
+std::uint32_t count_ascii32(const std::uint8_t* data, std::uint32_t n, bool byteSwapped)
+{
+    std::uint32_t i = 0;
+#if INPUTLEAP_UNICODE_SSE2
+    const __m128i mask = _mm_set1_epi32(static_cast<int>(byteSwapped ? 0x80ffffffu : 0xffffff80u));
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 4 <= n; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 4 * i));
+        v = _mm_cmpeq_epi32(_mm_and_si128(v, mask), zero);
+        if (_mm_movemask_epi8(v) != 0xffff) {
+            break;
+        }
+    }
+#endif
+    while (i < n && decode32(data + 4 * i, byteSwapped) < 0x80) {
+        ++i;
+    }
+    return i;
+}
+
+// appends n ASCII bytes as native 16-bit characters
+void append_ascii_as16(std::string& dst, const std::uint8_t* data, std::uint32_t n)
+{
+    const std::size_t pos = dst.size();
+    dst.resize(pos + 2 * n);
+    std::uint8_t* out = reinterpret_cast<std::uint8_t*>(&dst[pos]);
+    std::uint32_t i = 0;
+#if INPUTLEAP_UNICODE_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i),
+                            _mm_unpacklo_epi8(v, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i + 16),
+                            _mm_unpackhi_epi8(v, zero));
+    }
+#endif
+    for (; i < n; ++i) {
+        std::uint16_t c = data[i];
+        std::memcpy(out + 2 * i, &c, 2);
+    }
+}
+
+// appends n ASCII bytes as native 32-bit characters
+void append_ascii_as32(std::string& dst, const std::uint8_t* data, std::uint32_t n)
+{
+    const std::size_t pos = dst.size();
+    dst.resize(pos + 4 * n);
+    std::uint8_t* out = reinterpret_cast<std::uint8_t*>(&dst[pos]);
+    std::uint32_t i = 0;
+#if INPUTLEAP_UNICODE_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= n; i += 16) {
+        __m128i v  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i lo = _mm_unpacklo_epi8(v, zero);
+        __m128i hi = _mm_unpackhi_epi8(v, zero);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4 * i),
+                            _mm_unpacklo_epi16(lo, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4 * i + 16),
+                            _mm_unpackhi_epi16(lo, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4 * i + 32),
+                            _mm_unpacklo_epi16(hi, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4 * i + 48),
+                            _mm_unpackhi_epi16(hi, zero));
+    }
+#endif
+    for (; i < n; ++i) {
+        std::uint32_t c = data[i];
+        std::memcpy(out + 4 * i, &c, 4);
+    }
+}
+
+// appends n 16-bit characters, all below 0x80, as bytes
+void append_ascii_from16(std::string& dst, const std::uint8_t* data, std::uint32_t n, bool byteSwapped)
+{
+    const std::size_t pos = dst.size();
+    dst.resize(pos + n);
+    std::uint8_t* out = reinterpret_cast<std::uint8_t*>(&dst[pos]);
+    std::uint32_t i = 0;
+#if INPUTLEAP_UNICODE_SSE2
+    for (; i + 16 <= n; i += 16) {
+        __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 2 * i));
+        __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 2 * i + 16));
+        if (byteSwapped) {
+            lo = _mm_srli_epi16(lo, 8);
+            hi = _mm_srli_epi16(hi, 8);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(lo, hi));
+    }
+#endif
+    for (; i < n; ++i) {
+        out[i] = static_cast<std::uint8_t>(decode16(data + 2 * i, byteSwapped));
+    }
+}
+
+// appends n 32-bit characters, all below 0x80, as bytes
+void append_ascii_from32(std::string& dst, const std::uint8_t* data, std::uint32_t n, bool byteSwapped)
+{
+    const std::size_t pos = dst.size();
+    dst.resize(pos + n);
+    std::uint8_t* out = reinterpret_cast<std::uint8_t*>(&dst[pos]);
+    std::uint32_t i = 0;
+#if INPUTLEAP_UNICODE_SSE2
+    for (; i + 8 <= n; i += 8) {
+        __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 4 * i));
+        __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 4 * i + 16));
+        if (byteSwapped) {
+            lo = _mm_srli_epi32(lo, 24);
+            hi = _mm_srli_epi32(hi, 24);
+        }
+        __m128i v = _mm_packs_epi32(lo, hi);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(v, v));
+    }
+#endif
+    for (; i < n; ++i) {
+        out[i] = static_cast<std::uint8_t>(decode32(data + 4 * i, byteSwapped));
+    }
+}
+
+} // namespace
+
 
 //
 // Unicode
@@ -116,7 +301,10 @@ bool Unicode::isUTF8(const std::string& src)
     // convert and test each character
     const std::uint8_t* data = reinterpret_cast<const std::uint8_t*>(src.c_str());
     for (std::uint32_t n = static_cast<std::uint32_t>(src.size()); n > 0; ) {
-        if (fromUTF8(data, n) == s_invalid) {
+        std::uint32_t ascii = count_ascii8(data, n);
+        data += ascii;
+        n    -= ascii;
+        if (n > 0 && fromUTF8(data, n) == s_invalid) {
             return false;
         }
     }
@@ -136,6 +324,15 @@ std::string Unicode::UTF8ToUCS2(const std::string& src, bool* errors)
     // convert each character
     const std::uint8_t* data = reinterpret_cast<const std::uint8_t*>(src.c_str());
     while (n > 0) {
+        // copy runs of ASCII characters as a block
+        std::uint32_t ascii = count_ascii8(data, n);
+        if (ascii > 0) {
+            append_ascii_as16(dst, data, ascii);
+            data += ascii;
+            n    -= ascii;
+            continue;
+        }
+
         std::uint32_t c = fromUTF8(data, n);
         if (c == s_invalid) {
             c = s_replacement;
@@ -165,6 +362,15 @@ Unicode::UTF8ToUCS4(const std::string& src, bool* errors)
     // convert each character
     const std::uint8_t* data = reinterpret_cast<const std::uint8_t*>(src.c_str());
     while (n > 0) {
+        // copy runs of ASCII characters as a block
+        std::uint32_t ascii = count_ascii8(data, n);
+        if (ascii > 0) {
+            append_ascii_as32(dst, data, ascii);
+            data += ascii;
+            n    -= ascii;
+            continue;
+        }
+
         std::uint32_t c = fromUTF8(data, n);
         if (c == s_invalid) {
             c = s_replacement;
@@ -189,6 +395,15 @@ Unicode::UTF8ToUTF16(const std::string& src, bool* errors)
     // convert each character
     const std::uint8_t* data = reinterpret_cast<const std::uint8_t*>(src.c_str());
     while (n > 0) {
+        // copy runs of ASCII characters as a block
+        std::uint32_t ascii = count_ascii8(data, n);
+        if (ascii > 0) {
+            append_ascii_as16(dst, data, ascii);
+            data += ascii;
+            n    -= ascii;
+            continue;
+        }
+
         std::uint32_t c = fromUTF8(data, n);
         if (c == s_invalid) {
             c = s_replacement;
@@ -227,6 +442,15 @@ Unicode::UTF8ToUTF32(const std::string& src, bool* errors)
     // convert each character
     const std::uint8_t* data = reinterpret_cast<const std::uint8_t*>(src.c_str());
     while (n > 0) {
+        // copy runs of ASCII characters as a block
+        std::uint32_t ascii = count_ascii8(data, n);
+        if (ascii > 0) {
+            append_ascii_as32(dst, data, ascii);
+            data += ascii;
+            n    -= ascii;
+            continue;
+        }
+
         std::uint32_t c = fromUTF8(data, n);
         if (c == s_invalid) {
             c = s_replacement;
@@ -482,8 +706,18 @@ std::string Unicode::doUCS2ToUTF8(const std::uint8_t* data, std::uint32_t n, boo
         }
     }
 
-    // convert each character
+    // convert each character, copying runs of ASCII characters as a block
     for (; n > 0; data += 2, --n) {
+        std::uint32_t ascii = count_ascii16(data, n, byteSwapped);
+        if (ascii > 0) {
+            append_ascii_from16(dst, data, ascii, byteSwapped);
+            data += 2 * ascii;
+            n    -= ascii;
+            if (n == 0) {
+                break;
+            }
+        }
+
         std::uint32_t c = decode16(data, byteSwapped);
         toUTF8(dst, c, errors);
     }
@@ -517,8 +751,18 @@ std::string Unicode::doUCS4ToUTF8(const std::uint8_t* data, std::uint32_t n, boo
         }
     }
 
-    // convert each character
+    // convert each character, copying runs of ASCII characters as a block
     for (; n > 0; data += 4, --n) {
+        std::uint32_t ascii = count_ascii32(data, n, byteSwapped);
+        if (ascii > 0) {
+            append_ascii_from32(dst, data, ascii, byteSwapped);
+            data += 4 * ascii;
+            n    -= ascii;
+            if (n == 0) {
+                break;
+            }
+        }
+
         std::uint32_t c = decode32(data, byteSwapped);
         toUTF8(dst, c, errors);
     }
@@ -552,8 +796,18 @@ std::string Unicode::doUTF16ToUTF8(const std::uint8_t* data, std::uint32_t n, bo
         }
     }
 
-    // convert each character
+    // convert each character, copying runs of ASCII characters as a block
     for (; n > 0; data += 2, --n) {
+        std::uint32_t ascii = count_ascii16(data, n, byteSwapped);
+        if (ascii > 0) {
+            append_ascii_from16(dst, data, ascii, byteSwapped);
+            data += 2 * ascii;
+            n    -= ascii;
+            if (n == 0) {
+                break;
+            }
+        }
+
         std::uint32_t c = decode16(data, byteSwapped);
         if (c < 0x0000d800 || c > 0x0000dfff) {
             toUTF8(dst, c, errors);
@@ -564,15 +818,16 @@ std::string Unicode::doUTF16ToUTF8(const std::uint8_t* data, std::uint32_t n, bo
             toUTF8(dst, s_replacement, NULL);
         }
         else if (c >= 0x0000d800 && c <= 0x0000dbff) {
-            std::uint32_t c2 = decode16(data, byteSwapped);
-            data += 2;
-            --n;
+            std::uint32_t c2 = decode16(data + 2, byteSwapped);
             if (c2 < 0x0000dc00 || c2 > 0x0000dfff) {
-                // error -- [d800,dbff] not followed by [dc00,dfff]
+                // error -- [d800,dbff] not followed by [dc00,dfff].  the
+                // second word is converted on its own.
                 setError(errors);
                 toUTF8(dst, s_replacement, NULL);
             }
             else {
+                data += 2;
+                --n;
                 c = (((c - 0x0000d800) << 10) | (c2 - 0x0000dc00)) + 0x00010000;
                 toUTF8(dst, c, errors);
             }
@@ -613,8 +868,18 @@ std::string Unicode::doUTF32ToUTF8(const std::uint8_t* data, std::uint32_t n, bo
         }
     }
 
-    // convert each character
+    // convert each character, copying runs of ASCII characters as a block
     for (; n > 0; data += 4, --n) {
+        std::uint32_t ascii = count_ascii32(data, n, byteSwapped);
+        if (ascii > 0) {
+            append_ascii_from32(dst, data, ascii, byteSwapped);
+            data += 4 * ascii;
+            n    -= ascii;
+            if (n == 0) {
+                break;
+            }
+        }
+
         std::uint32_t c = decode32(data, byteSwapped);
         if (c >= 0x00110000) {
             setError(errors);
@@ -23,6 +23,11 @@
 #include <fstream>
 #include <iostream>
 
+#if SYSAPI_UNIX
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 enum EFileLogOutputter {
     kFileSizeLimit = 1024 // kb
 };
@@ -105,6 +110,16 @@ ConsoleLogOutputter::write(ELevel level, const char* msg)
     return true;
 }
 
+int
+ConsoleLogOutputter::getCrashDescriptor(ELevel level) const
+{
+    // the same streams as write()
+    if ((level >= kFATAL) && (level <= kWARNING))
+        return 2;
+    else
+        return 1;
+}
+
 void
 ConsoleLogOutputter::flush()
 {
@@ -240,13 +255,19 @@ BufferedLogOutputter::write(ELevel, const char* message)
 // FileLogOutputter
 //
 
-FileLogOutputter::FileLogOutputter(const char* logFile)
+FileLogOutputter::FileLogOutputter(const char* logFile) :
+    m_crashFd(-1)
 {
     setLogFilename(logFile);
 }
 
 FileLogOutputter::~FileLogOutputter()
 {
+#if SYSAPI_UNIX
+    if (m_crashFd != -1) {
+        ::close(m_crashFd);
+    }
+#endif
 }
 
 void
@@ -254,6 +275,7 @@ FileLogOutputter::setLogFilename(const char* logFile)
 {
     assert(logFile != NULL);
     m_fileName = logFile;
+    openCrashDescriptor();
 }
 
 bool
@@ -280,11 +302,31 @@ FileLogOutputter::write(ELevel level, const char *message)
         std::string oldLogFilename = inputleap::string::sprintf("%s.1", m_fileName.c_str());
         remove(oldLogFilename.c_str());
         rename(m_fileName.c_str(), oldLogFilename.c_str());
+        openCrashDescriptor();
     }
 
     return true;
 }
 
+int
+FileLogOutputter::getCrashDescriptor(ELevel level) const
+{
+    (void) level;
+    return m_crashFd;
+}
+
+void
+FileLogOutputter::openCrashDescriptor()
+{
+    // a signal handler can't open the file so keep it open
+#if SYSAPI_UNIX
+    if (m_crashFd != -1) {
+        ::close(m_crashFd);
+    }
+    m_crashFd = ::open(m_fileName.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+#endif
+}
+
 void FileLogOutputter::open(const char *title) { (void) title; }
 
 void
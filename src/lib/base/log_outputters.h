@@ -60,6 +60,7 @@ public:
     void close() override;
     void show(bool showIfEmpty) override;
     bool write(ELevel level, const char* message) override;
+    int getCrashDescriptor(ELevel level) const override;
     virtual void        flush();
 };
 
@@ -79,11 +80,18 @@ public:
     void close() override;
     void show(bool showIfEmpty) override;
     bool write(ELevel level, const char* message) override;
+    int getCrashDescriptor(ELevel level) const override;
 
     void                setLogFilename(const char* title);
 
+private:
+    void                openCrashDescriptor();
+
 private:
     std::string            m_fileName;
+
+    // the log file kept open for writing after a crash
+    int                    m_crashFd;
 };
 
 //! Write log to system log
@@ -71,7 +71,9 @@ Client::Client(IEventQueue* events, const std::string& name, const NetworkAddres
     m_socket(NULL),
     m_useSecureNetwork(args.m_enableCrypto),
     m_args(args),
-    m_enableClipboard(true)
+    m_enableClipboard(true),
+    m_sessionToken(0),
+    m_sessionSeqNum(0)
 {
     assert(m_socketFactory != NULL);
     assert(m_screen        != NULL);
@@ -157,7 +159,9 @@ Client::connect()
 
         // filter socket messages, including a packetizing filter
         m_stream = socket;
-        m_stream = new PacketStreamFilter(m_events, m_stream, true);
+        PacketStreamFilter* filter = new PacketStreamFilter(m_events, m_stream, true);
+        filter->setMetricsPeer(m_serverAddress.getHostname());
+        m_stream = filter;
 
         // connect
         LOG((CLOG_DEBUG1 "connecting to server"));
@@ -199,6 +203,19 @@ Client::handshakeComplete()
     sendEvent(m_events->forClient().connected(), NULL);
 }
 
+void
+Client::resetSession()
+{
+    m_sessionToken  = 0;
+    m_sessionSeqNum = 0;
+    m_sessionOptions.clear();
+    for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
+        m_ownClipboard[id]  = false;
+        m_sentClipboard[id] = false;
+        m_timeClipboard[id] = 0;
+    }
+}
+
 bool
 Client::isConnected() const
 {
@@ -211,6 +228,24 @@ Client::isConnecting() const
     return (m_timer != NULL);
 }
 
+std::uint64_t
+Client::getSessionToken() const
+{
+    return m_sessionToken;
+}
+
+const OptionsList&
+Client::getSessionOptions() const
+{
+    return m_sessionOptions;
+}
+
+std::uint32_t
+Client::getSessionSeqNum() const
+{
+    return m_sessionSeqNum;
+}
+
 NetworkAddress
 Client::getServerAddress() const
 {
@@ -239,9 +274,11 @@ void Client::getCursorPos(std::int32_t& x, std::int32_t& y) const
     m_screen->getCursorPos(x, y);
 }
 
-void Client::enter(std::int32_t xAbs, std::int32_t yAbs, std::uint32_t, KeyModifierMask mask, bool)
+void Client::enter(std::int32_t xAbs, std::int32_t yAbs, std::uint32_t seqNum,
+                   KeyModifierMask mask, bool)
 {
-    m_active = true;
+    m_active        = true;
+    m_sessionSeqNum = seqNum;
     m_screen->mouseMove(xAbs, yAbs);
     m_screen->enter(mask);
 
@@ -292,6 +329,18 @@ Client::setClipboardDirty(ClipboardID, bool)
     assert(0 && "shouldn't be called");
 }
 
+void
+Client::fakeInputBegin()
+{
+    m_screen->fakeInputBegin();
+}
+
+void
+Client::fakeInputEnd()
+{
+    m_screen->fakeInputEnd();
+}
+
 void
 Client::keyDown(KeyID id, KeyModifierMask mask, KeyButton button)
 {
@@ -345,6 +394,7 @@ Client::screensaver(bool activate)
 void
 Client::resetOptions()
 {
+    m_sessionOptions.clear();
     m_screen->resetOptions();
 }
 
@@ -365,6 +415,19 @@ Client::setOptions(const OptionsList& options)
         }
     }
 
+    // keep the options in case the session resumes on a new connection
+    m_sessionOptions.insert(m_sessionOptions.end(), options.begin(), options.end());
+    for (std::size_t i = 0; i + 1 < options.size(); i += 2) {
+        if (options[i] == kOptionSessionHigh) {
+            m_sessionToken = (m_sessionToken & 0xffffffffu) |
+                             (static_cast<std::uint64_t>(options[i + 1]) << 32);
+        }
+        else if (options[i] == kOptionSessionLow) {
+            m_sessionToken = (m_sessionToken & ~std::uint64_t(0xffffffffu)) |
+                             options[i + 1];
+        }
+    }
+
     m_screen->setOptions(options);
 }
 
@@ -505,6 +568,10 @@ Client::setupScreen()
                             getEventTarget(),
                             new TMethodEventJob<Client>(this,
                                 &Client::handleClipboardGrabbed));
+    m_events->adoptHandler(m_events->forClipboard().clipboardChanged(),
+                            getEventTarget(),
+                            new TMethodEventJob<Client>(this,
+                                &Client::handleClipboardChanged));
 }
 
 void
@@ -557,10 +624,16 @@ Client::cleanupScreen()
             m_screen->disable();
             m_ready = false;
         }
+        else {
+            // the server didn't take us so don't ask it to resume
+            resetSession();
+        }
         m_events->removeHandler(m_events->forIScreen().shapeChanged(),
                             getEventTarget());
         m_events->removeHandler(m_events->forClipboard().clipboardGrabbed(),
                             getEventTarget());
+        m_events->removeHandler(m_events->forClipboard().clipboardChanged(),
+                            getEventTarget());
         delete m_server;
         m_server = NULL;
     }
@@ -590,11 +663,9 @@ Client::handleConnected(const Event&, void*)
     cleanupConnecting();
     setupConnection();
 
-    // reset clipboard state
-    for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
-        m_ownClipboard[id]  = false;
-        m_sentClipboard[id] = false;
-        m_timeClipboard[id] = 0;
+    // reset clipboard state unless we'll try to resume the session
+    if (m_sessionToken == 0) {
+        resetSession();
     }
 }
 
@@ -675,6 +746,25 @@ Client::handleClipboardGrabbed(const Event& event, void*)
     }
 }
 
+void
+Client::handleClipboardChanged(const Event& event, void*)
+{
+    if (!m_enableClipboard) {
+        return;
+    }
+
+    const IScreen::ClipboardInfo* info =
+        static_cast<const IScreen::ClipboardInfo*>(event.getData());
+
+    // the screen got more of a clipboard we own after we sent it.  the
+    // time doesn't change so forget it to send the data again.  if we're
+    // the active screen then it's sent when we leave.
+    if (m_ownClipboard[info->m_id] && !m_active) {
+        m_timeClipboard[info->m_id] = 0;
+        sendClipboard(info->m_id);
+    }
+}
+
 void
 Client::handleHello(const Event&, void*)
 {
@@ -93,6 +93,22 @@ public:
     //! Send dragging file information back to server
     void sendDragInfo(std::uint32_t fileCount, std::string& info, size_t size);
 
+    //! Begin a batch of synthesized input
+    /*!
+    Input synthesized on the local screen until \c fakeInputEnd() may be
+    held back and delivered to the platform in one go.
+    */
+    void                fakeInputBegin();
+
+    //! End a batch of synthesized input
+    void                fakeInputEnd();
+
+    //! Forget the session
+    /*!
+    Drops the session token and what the client kept to resume the
+    session, and resets the clipboard state as for a new connection.
+    */
+    void                resetSession();
 
     //@}
     //! @name accessors
@@ -130,6 +146,26 @@ public:
     //! Return drag file list
     DragFileList        getDragFileList() { return m_dragFileList; }
 
+    //! Get session token
+    /*!
+    Returns the token the server issued for the session, or 0 if there's
+    no session to resume.
+    */
+    std::uint64_t        getSessionToken() const;
+
+    //! Get session options
+    /*!
+    Returns the options the server has set since it last reset them.
+    */
+    const OptionsList&    getSessionOptions() const;
+
+    //! Get session sequence number
+    /*!
+    Returns the sequence number of the last time the server entered the
+    screen.
+    */
+    std::uint32_t        getSessionSeqNum() const;
+
     //@}
 
     // IScreen overrides
@@ -182,6 +218,7 @@ private:
     void                handleDisconnected(const Event&, void*);
     void                handleShapeChanged(const Event&, void*);
     void                handleClipboardGrabbed(const Event&, void*);
+    void                handleClipboardChanged(const Event&, void*);
     void                handleHello(const Event&, void*);
     void                handleSuspend(const Event& event, void*);
     void                handleResume(const Event& event, void*);
@@ -221,4 +258,7 @@ private:
     bool                m_useSecureNetwork;
     ClientArgs            m_args;
     bool                m_enableClipboard;
+    std::uint64_t        m_sessionToken;
+    OptionsList            m_sessionOptions;
+    std::uint32_t        m_sessionSeqNum;
 };
@@ -21,6 +21,8 @@
 #include "client/Client.h"
 #include "inputleap/FileChunk.h"
 #include "inputleap/ClipboardChunk.h"
+#include "inputleap/LatencyTrace.h"
+#include "inputleap/LinkQuality.h"
 #include "inputleap/StreamChunker.h"
 #include "inputleap/Clipboard.h"
 #include "inputleap/ProtocolUtil.h"
@@ -29,9 +31,12 @@
 #include "inputleap/XBarrier.h"
 #include "io/IStream.h"
 #include "base/Log.h"
+#include "base/Probes.h"
 #include "base/IEventQueue.h"
 #include "base/TMethodEventJob.h"
 #include "base/XBase.h"
+#include "base/Time.h"
+#include "base/finally.h"
 
 #include <memory>
 
@@ -52,6 +57,9 @@ ServerProxy::ServerProxy(Client* client, inputleap::IStream* stream, IEventQueue
     m_ignoreMouse(false),
     m_keepAliveAlarm(0.0),
     m_keepAliveAlarmTimer(NULL),
+    m_traceID(0),
+    m_traceReceived(0.0),
+    m_traceInput(false),
     m_parser(&ServerProxy::parseHandshakeMessage),
     m_events(events)
 {
@@ -112,6 +120,12 @@ ServerProxy::setKeepAliveRate(double rate)
 void
 ServerProxy::handleData(const Event&, void*)
 {
+    // deliver all input decoded from this read to the screen as a single
+    // batch.  the client outlives us even if a message disconnects it.
+    Client* client = m_client;
+    client->fakeInputBegin();
+    auto batch_end = inputleap::finally([client]() { client->fakeInputEnd(); });
+
     // handle messages until there are no more.  first read message code.
     std::uint8_t code[4];
     std::uint32_t n = m_stream->read(code, 4);
@@ -125,9 +139,14 @@ ServerProxy::handleData(const Event&, void*)
 
         // parse message
         LOG((CLOG_DEBUG2 "msg from server: %c%c%c%c", code[0], code[1], code[2], code[3]));
+        INPUTLEAP_PROBE2(message_receive, m_stream, code);
         try {
             switch ((this->*m_parser)(code)) {
             case kOkay:
+                // the message after a trace mark is the one being traced
+                if (m_traceID != 0 && memcmp(code, kMsgDLatencyTrace, 4) != 0) {
+                    m_traceInput = true;
+                }
                 break;
 
             case kUnknown:
@@ -155,11 +174,20 @@ ServerProxy::handleData(const Event&, void*)
     }
 
     flushCompressedMouse();
+    sendLatencyTraceAck();
 }
 
 ServerProxy::EResult ServerProxy::parseHandshakeMessage(const std::uint8_t* code)
 {
     if (memcmp(code, kMsgQInfo, 4) == 0) {
+        // ask to resume our session before answering
+        std::uint64_t token = m_client->getSessionToken();
+        if (token != 0) {
+            LOG((CLOG_DEBUG1 "ask to resume session"));
+            ProtocolUtil::writef(m_stream, kMsgCResume,
+                                 static_cast<std::uint32_t>(token >> 32),
+                                 static_cast<std::uint32_t>(token));
+        }
         queryInfo();
     }
 
@@ -167,6 +195,12 @@ ServerProxy::EResult ServerProxy::parseHandshakeMessage(const std::uint8_t* code
         infoAcknowledgment();
     }
 
+    else if (memcmp(code, kMsgCResume, 4) == 0) {
+        if (!resume()) {
+            return kDisconnect;
+        }
+    }
+
     else if (memcmp(code, kMsgDSetOptions, 4) == 0) {
         setOptions();
 
@@ -185,6 +219,10 @@ ServerProxy::EResult ServerProxy::parseHandshakeMessage(const std::uint8_t* code
         resetKeepAliveAlarm();
     }
 
+    else if (memcmp(code, kMsgCPing, 4) == 0) {
+        ping();
+    }
+
     else if (memcmp(code, kMsgCNoop, 4) == 0) {
         // accept and discard no-op
     }
@@ -269,6 +307,10 @@ ServerProxy::EResult ServerProxy::parseMessage(const std::uint8_t* code)
         resetKeepAliveAlarm();
     }
 
+    else if (memcmp(code, kMsgCPing, 4) == 0) {
+        ping();
+    }
+
     else if (memcmp(code, kMsgCNoop, 4) == 0) {
         // accept and discard no-op
     }
@@ -316,6 +358,12 @@ ServerProxy::EResult ServerProxy::parseMessage(const std::uint8_t* code)
         dragInfoReceived();
     }
 
+    else if (memcmp(code, kMsgDLatencyTrace, 4) == 0) {
+        if (!latencyTraceReceived()) {
+            return kDisconnect;
+        }
+    }
+
     else if (memcmp(code, kMsgCClose, 4) == 0) {
         // server wants us to hangup
         LOG((CLOG_DEBUG1 "recv close"));
@@ -619,8 +667,9 @@ ServerProxy::keyDown()
     KeyModifierMask mask2 = translateModifierMask(
                                 static_cast<KeyModifierMask>(mask));
     if (id2   != static_cast<KeyID>(id) ||
-        mask2 != static_cast<KeyModifierMask>(mask))
+        mask2 != static_cast<KeyModifierMask>(mask)) {
         LOG((CLOG_DEBUG1 "key down translated to id=0x%08x, mask=0x%04x", id2, mask2));
+    }
 
     // forward
     m_client->keyDown(id2, mask2, button);
@@ -643,8 +692,9 @@ ServerProxy::keyRepeat()
     KeyModifierMask mask2 = translateModifierMask(
                                 static_cast<KeyModifierMask>(mask));
     if (id2   != static_cast<KeyID>(id) ||
-        mask2 != static_cast<KeyModifierMask>(mask))
+        mask2 != static_cast<KeyModifierMask>(mask)) {
         LOG((CLOG_DEBUG1 "key repeat translated to id=0x%08x, mask=0x%04x", id2, mask2));
+    }
 
     // forward
     m_client->keyRepeat(id2, mask2, count, button);
@@ -666,8 +716,9 @@ ServerProxy::keyUp()
     KeyModifierMask mask2 = translateModifierMask(
                                 static_cast<KeyModifierMask>(mask));
     if (id2   != static_cast<KeyID>(id) ||
-        mask2 != static_cast<KeyModifierMask>(mask))
+        mask2 != static_cast<KeyModifierMask>(mask)) {
         LOG((CLOG_DEBUG1 "key up translated to id=0x%08x, mask=0x%04x", id2, mask2));
+    }
 
     // forward
     m_client->keyUp(id2, mask2, button);
@@ -821,7 +872,12 @@ ServerProxy::setOptions()
 
     // forward
     m_client->setOptions(options);
+    applyOptions(options);
+}
 
+void
+ServerProxy::applyOptions(const OptionsList& options)
+{
     // update modifier table
     for (std::uint32_t i = 0, n = static_cast<std::uint32_t>(options.size()); i < n; i += 2) {
         KeyModifierID id = kKeyModifierIDNull;
@@ -847,6 +903,16 @@ ServerProxy::setOptions()
             // update keep alive
             setKeepAliveRate(1.0e-3 * static_cast<double>(options[i + 1]));
         }
+        else if (options[i] == kOptionLatencyTrace && options[i + 1] != 0) {
+            // tell the server we can help trace latency
+            LOG((CLOG_DEBUG1 "latency tracing requested"));
+            ProtocolUtil::writef(m_stream, kMsgDLatencyTraceAck, 0, 0);
+        }
+        else if (options[i] == kOptionPing && options[i + 1] != 0) {
+            // tell the server we answer pings
+            LOG((CLOG_DEBUG1 "pings requested"));
+            ProtocolUtil::writef(m_stream, kMsgCPong, 0, 0, 0);
+        }
 
         if (id != kKeyModifierIDNull) {
             m_modifierTranslationTable[id] =
@@ -856,6 +922,83 @@ ServerProxy::setOptions()
     }
 }
 
+void
+ServerProxy::ping()
+{
+    // answer right away, the server is timing us
+    std::uint32_t id, serverMicros;
+    ProtocolUtil::readf(m_stream, kMsgCPing + 4, &id, &serverMicros);
+    ProtocolUtil::writef(m_stream, kMsgCPong, id, serverMicros,
+                            LinkQuality::getClockMicros());
+    LOG((CLOG_DEBUG2 "recv ping %u", id));
+    resetKeepAliveAlarm();
+}
+
+bool
+ServerProxy::resume()
+{
+    // parse
+    std::uint32_t high, low;
+    if (!ProtocolUtil::readf(m_stream, kMsgCResume + 4, &high, &low)) {
+        LOG((CLOG_ERR "invalid resume session message from server"));
+        m_client->disconnect("invalid message from server");
+        return false;
+    }
+
+    if (high == 0 && low == 0) {
+        // the server will send options to start a new session
+        LOG((CLOG_NOTE "server started a new session"));
+        m_client->resetSession();
+        return true;
+    }
+
+    // the screen kept its options but we're new
+    LOG((CLOG_NOTE "resumed session"));
+    m_seqNum = m_client->getSessionSeqNum();
+    applyOptions(m_client->getSessionOptions());
+
+    // handshake is complete
+    m_parser = &ServerProxy::parseMessage;
+    m_client->handshakeComplete();
+    return true;
+}
+
+bool
+ServerProxy::latencyTraceReceived()
+{
+    // parse
+    std::uint32_t serverMicros;
+    if (!ProtocolUtil::readf(m_stream, kMsgDLatencyTrace + 4, &m_traceID, &serverMicros)) {
+        LOG((CLOG_ERR "invalid latency trace message from server"));
+        m_client->disconnect("invalid message from server");
+        return false;
+    }
+    LOG((CLOG_DEBUG2 "recv latency trace %u, %uus on server", m_traceID, serverMicros));
+
+    // time from here until the next input message is injected
+    m_traceReceived = inputleap::current_time_seconds();
+    m_traceInput    = false;
+    return true;
+}
+
+void
+ServerProxy::sendLatencyTraceAck()
+{
+    if (m_traceID == 0 || !m_traceInput) {
+        return;
+    }
+
+    double elapsed = inputleap::current_time_seconds() - m_traceReceived;
+    std::uint32_t clientMicros = static_cast<std::uint32_t>(elapsed * 1.0e+6);
+    ProtocolUtil::writef(m_stream, kMsgDLatencyTraceAck, m_traceID, clientMicros);
+    if (LatencyTrace* trace = LatencyTrace::getInstance()) {
+        trace->injected(clientMicros);
+    }
+
+    m_traceID    = 0;
+    m_traceInput = false;
+}
+
 void
 ServerProxy::queryInfo()
 {
@@ -20,6 +20,7 @@
 
 #include "inputleap/clipboard_types.h"
 #include "inputleap/key_types.h"
+#include "inputleap/option_types.h"
 #include "base/Event.h"
 
 class Client;
@@ -73,9 +74,15 @@ private:
 
     void                sendInfo(const ClientInfo&);
 
+    // act on options the server set
+    void                applyOptions(const OptionsList& options);
+
     void                resetKeepAliveAlarm();
     void                setKeepAliveRate(double);
 
+    // acknowledge a traced input message once it's been injected
+    void                sendLatencyTraceAck();
+
     // modifier key translation
     KeyID                translateKey(KeyID) const;
     KeyModifierMask            translateModifierMask(KeyModifierMask) const;
@@ -104,6 +111,9 @@ private:
     void                infoAcknowledgment();
     void                fileChunkReceived();
     void                dragInfoReceived();
+    bool                latencyTraceReceived();
+    void                ping();
+    bool                resume();
     void                handleClipboardSendingEvent(const Event&, void*);
 
 private:
@@ -126,6 +136,11 @@ private:
     double                m_keepAliveAlarm;
     EventQueueTimer*    m_keepAliveAlarmTimer;
 
+    // the input message being traced, if any
+    std::uint32_t        m_traceID;
+    double                m_traceReceived;
+    bool                m_traceInput;
+
     MessageParser        m_parser;
     IEventQueue*        m_events;
 };
@@ -25,7 +25,13 @@
 #include "base/log_outputters.h"
 #include "inputleap/XBarrier.h"
 #include "inputleap/ArgsBase.h"
+#include "inputleap/LatencyTrace.h"
+#include "inputleap/Screen.h"
+#include "inputleap/XScreen.h"
+#include "platform/VirtualScreen.h"
 #include "ipc/IpcServerProxy.h"
+#include "net/MetricsServer.h"
+#include "net/XSocket.h"
 #include "base/TMethodEventJob.h"
 #include "ipc/IpcMessage.h"
 #include "ipc/Ipc.h"
@@ -146,10 +152,18 @@ App::setupFileLogging()
     }
 }
 
+void
+App::setupAsyncLogging()
+{
+    if (argsBase().m_asyncLog) {
+        CLOG->setAsync(true);
+    }
+}
+
 void
 App::loggingFilterWarning()
 {
-    if (CLOG->getFilter() > CLOG->getConsoleMaxLevel()) {
+    if (CLOG->getMaxFilter() > CLOG->getConsoleMaxLevel()) {
         if (argsBase().m_logFile == NULL) {
             LOG((CLOG_WARN "log messages above %s are NOT sent to console (use file logging)",
                 CLOG->getFilterName(CLOG->getConsoleMaxLevel())));
@@ -182,6 +196,9 @@ App::initApp(int argc, const char** argv)
 
     // setup file logging after parsing args
     setupFileLogging();
+    if (argsBase().m_traceLatency) {
+        m_latencyTrace.reset(new LatencyTrace);
+    }
 
     // load configuration
     loadConfig();
@@ -218,6 +235,26 @@ App::cleanupIpcClient()
     delete m_ipcClient;
 }
 
+void
+App::initMetricsServer()
+{
+    m_metricsServer.reset(new MetricsServer(m_events, m_socketMultiplexer.get(),
+                            NetworkAddress("127.0.0.1", argsBase().m_metricsPort)));
+    try {
+        m_metricsServer->listen();
+    }
+    catch (XSocket& e) {
+        LOG((CLOG_WARN "cannot serve metrics: %s", e.what()));
+        m_metricsServer.reset();
+    }
+}
+
+void
+App::cleanupMetricsServer()
+{
+    m_metricsServer.reset();
+}
+
 void
 App::handleIpcMessage(const Event& e, void*)
 {
@@ -239,6 +276,35 @@ void App::run_events_loop()
 #endif
 }
 
+VirtualScreen*
+App::createVirtualScreen(bool isPrimary)
+{
+    const ArgsBase& args = argsBase();
+    std::unique_ptr<VirtualScreen> screen(new VirtualScreen(m_events, isPrimary,
+                            args.m_virtualX, args.m_virtualY,
+                            args.m_virtualWidth, args.m_virtualHeight));
+
+    if (!args.m_virtualScript.empty()) {
+        if (!isPrimary) {
+            LOG((CLOG_WARN "ignoring --virtual-script, only the server reports input"));
+        }
+        else {
+            VirtualInputScript script;
+            std::string error;
+            if (!script.load(args.m_virtualScript, error)) {
+                throw XScreenOpenFailure(args.m_virtualScript + ": " + error);
+            }
+            screen->setScript(script);
+        }
+    }
+    if (!args.m_virtualRecord.empty() &&
+            !screen->openRecordFile(args.m_virtualRecord)) {
+        throw XScreenOpenFailure("can't create " + args.m_virtualRecord);
+    }
+
+    return screen.release();
+}
+
 //
 // MinimalApp
 //
@@ -36,9 +36,12 @@ class IArchTaskBarReceiver;
 class BufferedLogOutputter;
 class ILogOutputter;
 class FileLogOutputter;
+class LatencyTrace;
+class MetricsServer;
 namespace inputleap { class Screen; }
 class IEventQueue;
 class SocketMultiplexer;
+class VirtualScreen;
 
 typedef IArchTaskBarReceiver* (*CreateTaskBarReceiverFunc)(const BufferedLogOutputter*, IEventQueue* events);
 
@@ -78,6 +81,10 @@ public:
     // If --log was specified in args, then add a file logger.
     void setupFileLogging();
 
+    // If --async-log was specified in args, then start the log writer
+    // thread.  Call after daemonizing since threads don't survive fork().
+    void setupAsyncLogging();
+
     // If messages will be hidden (to improve performance), warn user.
     void loggingFilterWarning();
 
@@ -107,8 +114,13 @@ private:
 protected:
     void                initIpcClient();
     void                cleanupIpcClient();
+    void                initMetricsServer();
+    void                cleanupMetricsServer();
     void run_events_loop();
 
+    // Creates the screen asked for with --virtual-screen.
+    VirtualScreen*        createVirtualScreen(bool isPrimary);
+
     IArchTaskBarReceiver* m_taskBarReceiver;
     bool m_suspended;
     IEventQueue*        m_events;
@@ -121,6 +133,8 @@ private:
     ARCH_APP_UTIL m_appUtil;
     IpcClient*            m_ipcClient;
     std::unique_ptr<SocketMultiplexer> m_socketMultiplexer;
+    std::unique_ptr<LatencyTrace> m_latencyTrace;
+    std::unique_ptr<MetricsServer> m_metricsServer;
 };
 
 class MinimalApp : public App {
@@ -156,12 +170,22 @@ private:
 #define HELP_COMMON_INFO_1 \
     "  -d, --debug <level>      filter out log messages with priority below level.\n" \
     "                             level may be: FATAL, ERROR, WARNING, NOTE, INFO,\n" \
-    "                             DEBUG, DEBUG1, DEBUG2.\n" \
+    "                             DEBUG, DEBUG1, DEBUG2.  it may be followed by\n" \
+    "                             ,category=level to filter the net, protocol,\n" \
+    "                             clipboard, x11 or server messages differently.\n" \
     "  -n, --name <screen-name> use screen-name instead the hostname to identify\n" \
     "                             this screen in the configuration.\n" \
     "  -1, --no-restart         do not try to restart on failure.\n" \
     "      --restart            restart the server automatically if it fails. (*)\n" \
     "  -l  --log <file>         write log messages to file.\n" \
+    "      --async-log          write log messages from a background thread.\n" \
+    "      --trace-latency      log how long input takes to reach the client.\n" \
+    "      --metrics-port <port> serve metrics for Prometheus on localhost:port.\n" \
+    "      --virtual-screen <width>x<height>[+<x>+<y>]\n" \
+    "                           use a screen with no display behind it.\n" \
+    "      --virtual-script <file> report the input in file (server only).\n" \
+    "      --virtual-record <file> write the input synthesized on the virtual\n" \
+    "                             screen to file.\n" \
     "      --no-tray            disable the system tray icon.\n" \
     "      --enable-drag-drop   enable file drag & drop.\n" \
     "      --enable-crypto      enable the crypto (ssl) plugin (default, deprecated).\n" \
@@ -26,6 +26,9 @@
 #include "base/String.h"
 #include "io/filesystem.h"
 
+#include <cstdio>
+#include <cstring>
+
 #ifdef WINAPI_MSWINDOWS
 #include <VersionHelpers.h>
 #endif
@@ -67,6 +70,33 @@ ArgParser::parseServerArgs(ServerArgs& args, int argc, const char* const* argv)
         }
         else if (isArg(i, argc, argv, nullptr, "--disable-client-cert-checking")) {
             args.check_client_certificates = false;
+        }
+        else if (isArg(i, argc, argv, NULL, "--record-trace", 1)) {
+            args.m_recordTrace = argv[++i];
+        }
+        else if (isArg(i, argc, argv, NULL, "--replay-trace", 1)) {
+            args.m_replayTrace = argv[++i];
+        }
+        else if (isArg(i, argc, argv, NULL, "--replay-speed", 1)) {
+            const char* speed = argv[++i];
+            if (strcmp(speed, "max") == 0) {
+                args.m_replaySpeed = 0.0;
+            }
+            else if (sscanf(speed, "%lf", &args.m_replaySpeed) != 1 ||
+                        args.m_replaySpeed <= 0.0) {
+                LOG((CLOG_PRINT "%s: invalid replay speed `%s'" BYE,
+                    args.m_exename.c_str(), speed, args.m_exename.c_str()));
+                return false;
+            }
+        }
+        else if (isArg(i, argc, argv, NULL, "--io-threads", 1)) {
+            const char* threads = argv[++i];
+            if (sscanf(threads, "%d", &args.m_ioThreads) != 1 ||
+                        args.m_ioThreads < 0) {
+                LOG((CLOG_PRINT "%s: invalid number of threads `%s'" BYE,
+                    args.m_exename.c_str(), threads, args.m_exename.c_str()));
+                return false;
+            }
         } else {
             LOG((CLOG_PRINT "%s: unrecognized option `%s'" BYE, args.m_exename.c_str(), argv[i], args.m_exename.c_str()));
             return false;
@@ -76,6 +106,10 @@ ArgParser::parseServerArgs(ServerArgs& args, int argc, const char* const* argv)
     if (checkUnexpectedArgs()) {
         return false;
     }
+    if (!args.m_replayTrace.empty() && !args.m_virtualScreen) {
+        LOG((CLOG_ERR "--replay-trace needs --virtual-screen"));
+        return false;
+    }
 
     return true;
 }
@@ -208,6 +242,33 @@ ArgParser::parseGenericArgs(int argc, const char* const* argv, int& i)
     else if (isArg(i, argc, argv, "-l", "--log", 1)) {
         argsBase().m_logFile = argv[++i];
     }
+    else if (isArg(i, argc, argv, NULL, "--async-log")) {
+        argsBase().m_asyncLog = true;
+    }
+    else if (isArg(i, argc, argv, NULL, "--trace-latency")) {
+        argsBase().m_traceLatency = true;
+    }
+    else if (isArg(i, argc, argv, NULL, "--metrics-port", 1)) {
+        argsBase().m_metricsPort = atoi(argv[++i]);
+    }
+    else if (isArg(i, argc, argv, NULL, "--virtual-screen", 1)) {
+        // <width>x<height>, optionally followed by +<x>+<y>
+        ArgsBase& args = argsBase();
+        args.m_virtualScreen = true;
+        args.m_virtualX      = 0;
+        args.m_virtualY      = 0;
+        int n = sscanf(argv[++i], "%dx%d+%d+%d", &args.m_virtualWidth,
+                        &args.m_virtualHeight, &args.m_virtualX, &args.m_virtualY);
+        if (n != 2 && n != 4) {
+            args.m_virtualWidth = 0;
+        }
+    }
+    else if (isArg(i, argc, argv, NULL, "--virtual-script", 1)) {
+        argsBase().m_virtualScript = argv[++i];
+    }
+    else if (isArg(i, argc, argv, NULL, "--virtual-record", 1)) {
+        argsBase().m_virtualRecord = argv[++i];
+    }
     else if (isArg(i, argc, argv, "-f", "--no-daemon")) {
         // not a daemon
         argsBase().m_daemon = false;
@@ -510,5 +571,16 @@ ArgParser::checkUnexpectedArgs()
     }
 #endif
 
+    if (argsBase().m_virtualScreen &&
+            (argsBase().m_virtualWidth <= 0 || argsBase().m_virtualHeight <= 0)) {
+        LOG((CLOG_ERR "--virtual-screen needs a size like 1920x1080"));
+        return true;
+    }
+    if (!argsBase().m_virtualScreen &&
+            (!argsBase().m_virtualScript.empty() || !argsBase().m_virtualRecord.empty())) {
+        LOG((CLOG_ERR "--virtual-script and --virtual-record need --virtual-screen"));
+        return true;
+    }
+
     return false;
 }
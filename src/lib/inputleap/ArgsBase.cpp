@@ -32,6 +32,14 @@ m_restartable(true),
 m_noHooks(false),
 m_logFilter(NULL),
 m_logFile(NULL),
+m_asyncLog(false),
+m_traceLatency(false),
+m_metricsPort(0),
+m_virtualScreen(false),
+m_virtualX(0),
+m_virtualY(0),
+m_virtualWidth(0),
+m_virtualHeight(0),
 m_display(NULL),
 m_disableTray(false),
 m_enableIpc(false),
@@ -20,6 +20,8 @@
 
 #include "io/filesystem.h"
 
+#include <cstdint>
+
 class ArgsBase {
 public:
     ArgsBase();
@@ -33,6 +35,16 @@ public:
     std::string            m_exename;
     const char*            m_logFilter;
     const char*            m_logFile;
+    bool                m_asyncLog;
+    bool                m_traceLatency;
+    int                    m_metricsPort;
+    bool                m_virtualScreen;
+    std::int32_t        m_virtualX;
+    std::int32_t        m_virtualY;
+    std::int32_t        m_virtualWidth;
+    std::int32_t        m_virtualHeight;
+    std::string            m_virtualScript;
+    std::string            m_virtualRecord;
     const char*            m_display;
     std::string m_name;
     bool                m_disableTray;
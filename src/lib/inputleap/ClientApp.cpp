@@ -23,6 +23,7 @@
 #include "inputleap/protocol_types.h"
 #include "inputleap/Screen.h"
 #include "inputleap/XScreen.h"
+#include "platform/VirtualScreen.h"
 #include "inputleap/ClientArgs.h"
 #include "net/NetworkAddress.h"
 #include "net/TCPSocketFactory.h"
@@ -160,6 +161,10 @@ ClientApp::daemonInfo() const
 inputleap::Screen*
 ClientApp::createScreen()
 {
+    if (args().m_virtualScreen) {
+        return new inputleap::Screen(createVirtualScreen(false), m_events);
+    }
+
 #if WINAPI_MSWINDOWS
     return new inputleap::Screen(new MSWindowsScreen(
         false, args().m_noHooks, args().m_stopOnDeskSwitch, m_events), m_events);
@@ -442,9 +447,10 @@ ClientApp::stopClient()
 int
 ClientApp::mainLoop()
 {
-    // create socket multiplexer.  this must happen after daemonization
-    // on unix because threads evaporate across a fork().
+    // create socket multiplexer and log writer.  this must happen after
+    // daemonization on unix because threads evaporate across a fork().
     setSocketMultiplexer(std::make_unique<SocketMultiplexer>());
+    setupAsyncLogging();
 
     // start client, etc
     appUtil().startNode();
@@ -454,6 +460,9 @@ ClientApp::mainLoop()
     if (argsBase().m_enableIpc) {
         initIpcClient();
     }
+    if (argsBase().m_metricsPort != 0) {
+        initMetricsServer();
+    }
 
     // run event loop.  if startClient() failed we're supposed to retry
     // later.  the timer installed by startClient() will take care of
@@ -485,6 +494,7 @@ ClientApp::mainLoop()
     if (argsBase().m_enableIpc) {
         cleanupIpcClient();
     }
+    cleanupMetricsServer();
 
     return kExitSuccess;
 }
@@ -21,11 +21,18 @@
 #include "inputleap/protocol_types.h"
 #include "io/IStream.h"
 #include "base/Log.h"
+#include "base/Metrics.h"
+#include "base/Probes.h"
 #include "base/String.h"
 #include <cstring>
 
 size_t ClipboardChunk::s_expectedSize = 0;
 
+static MetricCounter&    s_bytesSent = Metrics::getInstance().getCounter(
+    "inputleap_clipboard_bytes_sent_total", "Clipboard data sent.");
+static MetricCounter&    s_bytesReceived = Metrics::getInstance().getCounter(
+    "inputleap_clipboard_bytes_received_total", "Clipboard data received.");
+
 ClipboardChunk::ClipboardChunk(size_t size) :
     Chunk(size)
 {
@@ -90,11 +97,13 @@ int ClipboardChunk::assemble(inputleap::IStream* stream, std::string& dataCached
     if (mark == kDataStart) {
         s_expectedSize = inputleap::string::stringToSizeType(data);
         LOG((CLOG_DEBUG "start receiving clipboard data"));
+        INPUTLEAP_PROBE3(clipboard_receive_start, id, sequence, s_expectedSize);
         dataCached.clear();
         return kStart;
     }
     else if (mark == kDataChunk) {
         dataCached.append(data);
+        s_bytesReceived.add(data.size());
         return kNotFinish;
     }
     else if (mark == kDataEnd) {
@@ -106,6 +115,7 @@ int ClipboardChunk::assemble(inputleap::IStream* stream, std::string& dataCached
             LOG((CLOG_ERR "corrupted clipboard data, expected size=%d actual size=%d", s_expectedSize, dataCached.size()));
             return kError;
         }
+        INPUTLEAP_PROBE3(clipboard_receive_end, id, sequence, dataCached.size());
         return kFinish;
     }
 
@@ -130,14 +140,17 @@ ClipboardChunk::send(inputleap::IStream* stream, void* data)
     switch (mark) {
     case kDataStart:
         LOG((CLOG_DEBUG2 "sending clipboard chunk start: size=%s", dataChunk.c_str()));
+        INPUTLEAP_PROBE2(clipboard_send_start, id, sequence);
         break;
 
     case kDataChunk:
         LOG((CLOG_DEBUG2 "sending clipboard chunk data: size=%i", dataChunk.size()));
+        s_bytesSent.add(dataChunk.size());
         break;
 
     case kDataEnd:
         LOG((CLOG_DEBUG2 "sending clipboard finished"));
+        INPUTLEAP_PROBE2(clipboard_send_end, id, sequence);
         break;
     default:
         break;
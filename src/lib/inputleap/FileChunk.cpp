@@ -23,9 +23,16 @@
 #include "base/Stopwatch.h"
 #include "base/String.h"
 #include "base/Log.h"
+#include "base/Metrics.h"
+#include "base/Probes.h"
 
 static const std::uint16_t kIntervalThreshold = 1;
 
+static MetricCounter&    s_bytesSent = Metrics::getInstance().getCounter(
+    "inputleap_file_transfer_bytes_sent_total", "File transfer data sent.");
+static MetricCounter&    s_bytesReceived = Metrics::getInstance().getCounter(
+    "inputleap_file_transfer_bytes_received_total", "File transfer data received.");
+
 FileChunk::FileChunk(size_t size) :
     Chunk(size)
 {
@@ -86,8 +93,9 @@ int FileChunk::assemble(inputleap::IStream* stream, std::string& dataReceived, s
         receivedDataSize = 0;
         elapsedTime = 0;
         stopwatch.reset();
+        INPUTLEAP_PROBE1(file_receive_start, expectedSize);
 
-        if (CLOG->getFilter() >= kDEBUG2) {
+        if (Log::isEnabled(INPUTLEAP_LOG_CATEGORY, kDEBUG2)) {
             LOG((CLOG_DEBUG2 "recv file size=%s", content.c_str()));
             stopwatch.start();
         }
@@ -95,7 +103,8 @@ int FileChunk::assemble(inputleap::IStream* stream, std::string& dataReceived, s
 
     case kDataChunk:
         dataReceived.append(content);
-        if (CLOG->getFilter() >= kDEBUG2) {
+        s_bytesReceived.add(content.size());
+        if (Log::isEnabled(INPUTLEAP_LOG_CATEGORY, kDEBUG2)) {
                 LOG((CLOG_DEBUG2 "recv file chunk size=%i", content.size()));
                 double interval = stopwatch.getTime();
                 receivedDataSize += content.size();
@@ -116,8 +125,9 @@ int FileChunk::assemble(inputleap::IStream* stream, std::string& dataReceived, s
             LOG((CLOG_ERR "corrupted clipboard data, expected size=%d actual size=%d", expectedSize, dataReceived.size()));
             return kError;
         }
+        INPUTLEAP_PROBE1(file_receive_end, dataReceived.size());
 
-        if (CLOG->getFilter() >= kDEBUG2) {
+        if (Log::isEnabled(INPUTLEAP_LOG_CATEGORY, kDEBUG2)) {
             LOG((CLOG_DEBUG2 "file transfer finished"));
             elapsedTime += stopwatch.getTime();
             double averageSpeed = expectedSize / elapsedTime / 1000;
@@ -140,14 +150,17 @@ void FileChunk::send(inputleap::IStream* stream, std::uint8_t mark, char* data,
     switch (mark) {
     case kDataStart:
         LOG((CLOG_DEBUG2 "sending file chunk start: size=%s", data));
+        INPUTLEAP_PROBE1(file_send_start, data);
         break;
 
     case kDataChunk:
         LOG((CLOG_DEBUG2 "sending file chunk: size=%i", chunk.size()));
+        s_bytesSent.add(chunk.size());
         break;
 
     case kDataEnd:
         LOG((CLOG_DEBUG2 "sending file finished"));
+        INPUTLEAP_PROBE0(file_send_end);
         break;
     default:
         break;
@@ -0,0 +1,89 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "inputleap/key_types.h"
+#include "inputleap/mouse_types.h"
+
+#include <cstdint>
+#include <string>
+
+//! Input trace file format
+/*!
+An input trace holds the input a server's primary screen reported, in
+order and with the time of each.  The file starts with kMagic and a
+version byte.  Each record is then a type byte, the microseconds since
+the previous record (or the start of recording) as a varint, and the type's fields.  Integers are
+LEB128 varints;  signed ones are zigzag encoded first.
+
+\verbatim
+kMotionPrimary      x, y (signed)
+kMotionSecondary    dx, dy (signed)
+kWheel              xDelta, yDelta (signed)
+kButtonDown/Up      button, mask
+kKeyDown/Up         key, mask, button
+kKeyRepeat          key, mask, button, count
+kHotKeyDown/Up      hot key id
+kSwitch             x, y (signed), screen name length, screen name
+\endverbatim
+
+kSwitch records note where the server switched screens.  They aren't
+input;  they're there to check a replay against.
+*/
+class InputTrace {
+public:
+    enum EType {
+        kMotionPrimary = 1,
+        kMotionSecondary,
+        kWheel,
+        kButtonDown,
+        kButtonUp,
+        kKeyDown,
+        kKeyUp,
+        kKeyRepeat,
+        kHotKeyDown,
+        kHotKeyUp,
+        kSwitch
+    };
+
+    //! A single input or screen switch
+    class Record {
+    public:
+        Record() : m_type(kMotionPrimary), m_time(0), m_x(0), m_y(0),
+            m_button(0), m_key(kKeyNone), m_mask(0), m_count(0), m_id(0) { }
+
+    public:
+        EType                m_type;
+        //! Microseconds since recording started
+        std::uint64_t        m_time;
+        std::int32_t        m_x;
+        std::int32_t        m_y;
+        //! Mouse button for button records, key button for key records
+        std::uint16_t        m_button;
+        KeyID                m_key;
+        KeyModifierMask        m_mask;
+        std::int32_t        m_count;
+        //! Hot key id
+        std::uint32_t        m_id;
+        //! Screen switched to
+        std::string            m_screen;
+    };
+
+    static const char        kMagic[8];
+    static const std::uint8_t kVersion = 1;
+};
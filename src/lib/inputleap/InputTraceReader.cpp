@@ -0,0 +1,196 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "inputleap/InputTraceReader.h"
+#include "base/Log.h"
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+//
+// InputTraceReader
+//
+
+namespace {
+
+class Decoder {
+public:
+    Decoder(const std::string& data, std::size_t pos) : m_data(data), m_pos(pos) { }
+
+    bool atEnd() const { return m_pos == m_data.size(); }
+
+    bool getByte(std::uint8_t& value)
+    {
+        if (atEnd()) {
+            return false;
+        }
+        value = static_cast<std::uint8_t>(m_data[m_pos++]);
+        return true;
+    }
+
+    bool getUnsigned(std::uint64_t& value)
+    {
+        value = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            std::uint8_t byte;
+            if (!getByte(byte)) {
+                return false;
+            }
+            value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool getSigned(std::int32_t& value)
+    {
+        std::uint64_t raw;
+        if (!getUnsigned(raw)) {
+            return false;
+        }
+        value = static_cast<std::int32_t>(static_cast<std::int64_t>(raw >> 1) ^
+                                          -static_cast<std::int64_t>(raw & 1));
+        return true;
+    }
+
+    template <typename T>
+    bool get(T& value)
+    {
+        std::uint64_t raw;
+        if (!getUnsigned(raw)) {
+            return false;
+        }
+        value = static_cast<T>(raw);
+        return true;
+    }
+
+    bool getString(std::string& value, std::size_t size)
+    {
+        if (m_data.size() - m_pos < size) {
+            return false;
+        }
+        value.assign(m_data, m_pos, size);
+        m_pos += size;
+        return true;
+    }
+
+private:
+    const std::string&    m_data;
+    std::size_t            m_pos;
+};
+
+} // namespace
+
+bool
+InputTraceReader::load(const std::string& path, std::string& error)
+{
+    std::ifstream file(path.c_str(), std::ios::in | std::ios::binary);
+    if (!file.is_open()) {
+        error = "can't open " + path;
+        return false;
+    }
+    std::ostringstream data;
+    data << file.rdbuf();
+    return parse(data.str(), error);
+}
+
+bool
+InputTraceReader::parse(const std::string& data, std::string& error)
+{
+    m_records.clear();
+
+    const std::size_t headerSize = sizeof(InputTrace::kMagic) + 1;
+    if (data.size() < headerSize ||
+        std::memcmp(data.data(), InputTrace::kMagic, sizeof(InputTrace::kMagic)) != 0) {
+        error = "not an input trace";
+        return false;
+    }
+    if (static_cast<std::uint8_t>(data[headerSize - 1]) != InputTrace::kVersion) {
+        error = "unsupported input trace version";
+        return false;
+    }
+
+    Decoder decoder(data, headerSize);
+    std::uint64_t time = 0;
+    while (!decoder.atEnd()) {
+        InputTrace::Record record;
+        std::uint8_t type;
+        std::uint64_t delta;
+        bool ok = decoder.getByte(type) && decoder.getUnsigned(delta);
+        if (ok) {
+            time         += delta;
+            record.m_type = static_cast<InputTrace::EType>(type);
+            record.m_time = time;
+            switch (record.m_type) {
+            case InputTrace::kMotionPrimary:
+            case InputTrace::kMotionSecondary:
+            case InputTrace::kWheel:
+                ok = decoder.getSigned(record.m_x) && decoder.getSigned(record.m_y);
+                break;
+
+            case InputTrace::kButtonDown:
+            case InputTrace::kButtonUp:
+                ok = decoder.get(record.m_button) && decoder.get(record.m_mask);
+                break;
+
+            case InputTrace::kKeyDown:
+            case InputTrace::kKeyUp:
+                ok = decoder.get(record.m_key) && decoder.get(record.m_mask) &&
+                     decoder.get(record.m_button);
+                break;
+
+            case InputTrace::kKeyRepeat:
+                ok = decoder.get(record.m_key) && decoder.get(record.m_mask) &&
+                     decoder.get(record.m_button) && decoder.get(record.m_count);
+                break;
+
+            case InputTrace::kHotKeyDown:
+            case InputTrace::kHotKeyUp:
+                ok = decoder.get(record.m_id);
+                break;
+
+            case InputTrace::kSwitch: {
+                std::size_t size;
+                ok = decoder.getSigned(record.m_x) && decoder.getSigned(record.m_y) &&
+                     decoder.get(size) && decoder.getString(record.m_screen, size);
+                break;
+            }
+
+            default:
+                error = "unknown input trace record type " + std::to_string(type);
+                m_records.clear();
+                return false;
+            }
+        }
+        if (!ok) {
+            LOG((CLOG_WARN "input trace is truncated after %d records",
+                                static_cast<int>(m_records.size())));
+            break;
+        }
+        m_records.push_back(record);
+    }
+    return true;
+}
+
+const InputTraceReader::RecordList&
+InputTraceReader::getRecords() const
+{
+    return m_records;
+}
@@ -0,0 +1,60 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "inputleap/InputTrace.h"
+
+#include <vector>
+
+//! Input trace loader
+/*!
+Reads a trace file written by InputTraceWriter.
+*/
+class InputTraceReader {
+public:
+    typedef std::vector<InputTrace::Record> RecordList;
+
+    //! @name manipulators
+    //@{
+
+    //! Load a trace
+    /*!
+    Reads the trace file at \p path.  Returns false and sets \p error if
+    the file can't be read or isn't a trace.  A trace cut short, as when
+    the recording server was killed, loads up to its last whole record.
+    */
+    bool                load(const std::string& path, std::string& error);
+
+    //! Parse a trace
+    /*!
+    Like load() but reads the trace from \p data.
+    */
+    bool                parse(const std::string& data, std::string& error);
+
+    //@}
+    //! @name accessors
+    //@{
+
+    //! Get the loaded records
+    const RecordList&    getRecords() const;
+
+    //@}
+
+private:
+    RecordList            m_records;
+};
@@ -0,0 +1,287 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "inputleap/InputTraceWriter.h"
+#include "inputleap/IPlatformScreen.h"
+#include "arch/Arch.h"
+#include "base/IEventQueue.h"
+#include "base/Log.h"
+#include "base/Time.h"
+
+#include <algorithm>
+#include <cassert>
+
+//
+// InputTraceWriter
+//
+
+namespace {
+
+// big enough that the flush thread wakes rarely
+const std::size_t kBufferSize = 64 * 1024;
+
+// the most a record other than a switch can take
+const std::size_t kMaxRecordSize = 64;
+
+// the longest screen name recorded
+const std::size_t kMaxScreenName = 256;
+
+// write buffers at least this often (microseconds) so a trace isn't
+// lost if the server dies
+const std::uint64_t kHandOffInterval = 1000000;
+
+std::uint64_t
+now()
+{
+    return static_cast<std::uint64_t>(inputleap::current_time_seconds() * 1.0e6);
+}
+
+} // namespace
+
+InputTraceWriter* InputTraceWriter::s_instance = NULL;
+
+InputTraceWriter::InputTraceWriter() :
+    m_file(NULL),
+    m_last(0),
+    m_lastHandOff(0),
+    m_flushPending(false),
+    m_running(false),
+    m_thread(NULL)
+{
+    assert(s_instance == NULL);
+    s_instance = this;
+    m_buffer.reserve(kBufferSize);
+    m_flushBuffer.reserve(kBufferSize);
+}
+
+InputTraceWriter::~InputTraceWriter()
+{
+    close();
+    s_instance = NULL;
+}
+
+bool
+InputTraceWriter::open(const std::string& path)
+{
+    close();
+
+    m_file = std::fopen(path.c_str(), "wb");
+    if (m_file == NULL) {
+        return false;
+    }
+
+    m_buffer.insert(m_buffer.end(), InputTrace::kMagic,
+                    InputTrace::kMagic + sizeof(InputTrace::kMagic));
+    m_buffer.push_back(InputTrace::kVersion);
+    m_last        = now();
+    m_lastHandOff = m_last;
+
+    m_running = true;
+    m_thread  = ARCH->newThread([this]() { flushThread(); });
+    LOG((CLOG_NOTE "recording input to %s", path.c_str()));
+    return true;
+}
+
+void
+InputTraceWriter::recordEvent(IEventQueue* events, const Event& event)
+{
+    if (m_file == NULL) {
+        return;
+    }
+
+    Event::Type type = event.getType();
+    if (type == events->forIPrimaryScreen().motionOnPrimary() ||
+        type == events->forIPrimaryScreen().motionOnSecondary()) {
+        const IPlatformScreen::MotionInfo* info =
+            static_cast<const IPlatformScreen::MotionInfo*>(event.getData());
+        beginRecord(type == events->forIPrimaryScreen().motionOnPrimary() ?
+                    InputTrace::kMotionPrimary : InputTrace::kMotionSecondary);
+        putSigned(info->m_x);
+        putSigned(info->m_y);
+    }
+    else if (type == events->forIPrimaryScreen().wheel()) {
+        const IPlatformScreen::WheelInfo* info =
+            static_cast<const IPlatformScreen::WheelInfo*>(event.getData());
+        beginRecord(InputTrace::kWheel);
+        putSigned(info->m_xDelta);
+        putSigned(info->m_yDelta);
+    }
+    else if (type == events->forIPrimaryScreen().buttonDown() ||
+             type == events->forIPrimaryScreen().buttonUp()) {
+        const IPlatformScreen::ButtonInfo* info =
+            static_cast<const IPlatformScreen::ButtonInfo*>(event.getData());
+        beginRecord(type == events->forIPrimaryScreen().buttonDown() ?
+                    InputTrace::kButtonDown : InputTrace::kButtonUp);
+        putUnsigned(info->m_button);
+        putUnsigned(info->m_mask);
+    }
+    else if (type == events->forIKeyState().keyDown() ||
+             type == events->forIKeyState().keyUp() ||
+             type == events->forIKeyState().keyRepeat()) {
+        const IPlatformScreen::KeyInfo* info =
+            static_cast<const IPlatformScreen::KeyInfo*>(event.getData());
+        bool repeat = (type == events->forIKeyState().keyRepeat());
+        beginRecord(repeat ? InputTrace::kKeyRepeat :
+                    (type == events->forIKeyState().keyDown()) ?
+                    InputTrace::kKeyDown : InputTrace::kKeyUp);
+        putUnsigned(info->m_key);
+        putUnsigned(info->m_mask);
+        putUnsigned(info->m_button);
+        if (repeat) {
+            putUnsigned(static_cast<std::uint32_t>(info->m_count));
+        }
+    }
+    else if (type == events->forIPrimaryScreen().hotKeyDown() ||
+             type == events->forIPrimaryScreen().hotKeyUp()) {
+        const IPlatformScreen::HotKeyInfo* info =
+            static_cast<const IPlatformScreen::HotKeyInfo*>(event.getData());
+        beginRecord(type == events->forIPrimaryScreen().hotKeyDown() ?
+                    InputTrace::kHotKeyDown : InputTrace::kHotKeyUp);
+        putUnsigned(info->m_id);
+    }
+    else {
+        return;
+    }
+    endRecord();
+}
+
+void
+InputTraceWriter::recordSwitch(const std::string& screen,
+                std::int32_t x, std::int32_t y)
+{
+    if (m_file == NULL) {
+        return;
+    }
+
+    std::size_t size = std::min(screen.size(), kMaxScreenName);
+    beginRecord(InputTrace::kSwitch, size);
+    putSigned(x);
+    putSigned(y);
+    putUnsigned(size);
+    m_buffer.insert(m_buffer.end(), screen.begin(), screen.begin() + size);
+    endRecord();
+}
+
+InputTraceWriter*
+InputTraceWriter::getInstance()
+{
+    return s_instance;
+}
+
+void
+InputTraceWriter::beginRecord(InputTrace::EType type, std::size_t extra)
+{
+    if (m_buffer.size() + kMaxRecordSize + extra > kBufferSize) {
+        handOff(true);
+    }
+
+    std::uint64_t time = now();
+    m_buffer.push_back(static_cast<std::uint8_t>(type));
+    putUnsigned(time - m_last);
+    m_last = time;
+}
+
+void
+InputTraceWriter::putUnsigned(std::uint64_t value)
+{
+    while (value >= 0x80) {
+        m_buffer.push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    m_buffer.push_back(static_cast<std::uint8_t>(value));
+}
+
+void
+InputTraceWriter::putSigned(std::int64_t value)
+{
+    putUnsigned((static_cast<std::uint64_t>(value) << 1) ^
+                static_cast<std::uint64_t>(value >> 63));
+}
+
+void
+InputTraceWriter::endRecord()
+{
+    if (m_last - m_lastHandOff >= kHandOffInterval) {
+        handOff(false);
+    }
+}
+
+void
+InputTraceWriter::handOff(bool wait)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_flushPending) {
+        if (!wait) {
+            // try again with the next record
+            return;
+        }
+        m_cond.wait(lock, [this]() { return !m_flushPending; });
+    }
+    m_buffer.swap(m_flushBuffer);
+    m_flushPending = true;
+    m_lastHandOff  = m_last;
+    m_cond.notify_all();
+}
+
+void
+InputTraceWriter::close()
+{
+    if (m_file == NULL) {
+        return;
+    }
+
+    // write what's left then stop the flush thread
+    if (!m_buffer.empty()) {
+        handOff(true);
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = false;
+    }
+    m_cond.notify_all();
+    ARCH->wait(m_thread, -1.0);
+    ARCH->closeThread(m_thread);
+    m_thread = NULL;
+
+    std::fclose(m_file);
+    m_file = NULL;
+}
+
+void
+InputTraceWriter::flushThread()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_cond.wait(lock, [this]() { return m_flushPending || !m_running; });
+        if (!m_flushPending) {
+            break;
+        }
+
+        // m_flushBuffer is ours until we clear m_flushPending
+        lock.unlock();
+        if (std::fwrite(m_flushBuffer.data(), 1, m_flushBuffer.size(), m_file) !=
+                m_flushBuffer.size()) {
+            LOG((CLOG_WARN "failed to write input trace"));
+        }
+        std::fflush(m_file);
+        m_flushBuffer.clear();
+        lock.lock();
+
+        m_flushPending = false;
+        m_cond.notify_all();
+    }
+}
@@ -0,0 +1,107 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "inputleap/InputTrace.h"
+#include "arch/IArchMultithread.h"
+
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+class Event;
+class IEventQueue;
+
+//! Input trace recorder
+/*!
+Writes the input the server gets from its primary screen to a trace
+file (see InputTrace).  Records are encoded into a preallocated buffer
+on the thread running the event loop;  full buffers are written to the
+file by a thread of their own so recording never waits on the disk
+unless the disk falls a whole buffer behind.
+
+At most one recorder exists at a time.  All record methods must be
+called on the thread running the event loop.
+*/
+class InputTraceWriter {
+public:
+    InputTraceWriter();
+    InputTraceWriter(const InputTraceWriter&) = delete;
+    InputTraceWriter& operator=(const InputTraceWriter&) = delete;
+    ~InputTraceWriter();
+
+    //! @name manipulators
+    //@{
+
+    //! Start recording
+    /*!
+    Creates the trace file at \p path.  Returns false if it can't be
+    created.
+    */
+    bool                open(const std::string& path);
+
+    //! Record an input event
+    /*!
+    Records \p event if it's input from the primary screen and ignores
+    it otherwise.
+    */
+    void                recordEvent(IEventQueue* events, const Event& event);
+
+    //! Record a screen switch
+    void                recordSwitch(const std::string& screen,
+                            std::int32_t x, std::int32_t y);
+
+    //@}
+    //! @name accessors
+    //@{
+
+    //! Get the recorder
+    /*!
+    Returns the recorder or NULL if input isn't being recorded.
+    */
+    static InputTraceWriter* getInstance();
+
+    //@}
+
+private:
+    void                beginRecord(InputTrace::EType type, std::size_t extra = 0);
+    void                putUnsigned(std::uint64_t value);
+    void                putSigned(std::int64_t value);
+    void                endRecord();
+    void                handOff(bool wait);
+    void                close();
+    void                flushThread();
+
+private:
+    static InputTraceWriter* s_instance;
+
+    std::FILE*            m_file;
+    std::uint64_t        m_last;
+    std::uint64_t        m_lastHandOff;
+
+    // m_buffer is filled on the event loop thread while the flush
+    // thread writes m_flushBuffer.  neither ever grows.
+    std::vector<std::uint8_t> m_buffer;
+    std::vector<std::uint8_t> m_flushBuffer;
+    std::mutex            m_mutex;
+    std::condition_variable m_cond;
+    bool                m_flushPending;
+    bool                m_running;
+    ArchThread            m_thread;
+};
@@ -26,6 +26,9 @@
 
 namespace inputleap {
 
+// forget every remembered mapKey() result after this many
+static const std::size_t s_maxMapKeyCacheSize = 1024;
+
 KeyMap::NameToKeyMap*            KeyMap::s_nameToKeyMap      = NULL;
 KeyMap::NameToModifierMap*        KeyMap::s_nameToModifierMap = NULL;
 KeyMap::KeyToNameMap*            KeyMap::s_keyToNameMap      = NULL;
@@ -64,11 +67,15 @@ KeyMap::swap(KeyMap& x)
     bool tmp2               = m_composeAcrossGroups;
     m_composeAcrossGroups   = x.m_composeAcrossGroups;
     x.m_composeAcrossGroups = tmp2;
+    m_mapKeyCache.clear();
+    x.m_mapKeyCache.clear();
 }
 
 void
 KeyMap::addKeyEntry(const KeyItem& item)
 {
+    m_mapKeyCache.clear();
+
     // ignore kKeyNone
     if (item.m_id == kKeyNone) {
         return;
@@ -197,30 +204,35 @@ bool KeyMap::addKeyCombinationEntry(KeyID id, std::int32_t group, const KeyID* k
 void
 KeyMap::allowGroupSwitchDuringCompose()
 {
+    m_mapKeyCache.clear();
     m_composeAcrossGroups = true;
 }
 
 void
 KeyMap::addHalfDuplexButton(KeyButton button)
 {
+    m_mapKeyCache.clear();
     m_halfDuplex.insert(button);
 }
 
 void
 KeyMap::clearHalfDuplexModifiers()
 {
+    m_mapKeyCache.clear();
     m_halfDuplexMods.clear();
 }
 
 void
 KeyMap::addHalfDuplexModifier(KeyID key)
 {
+    m_mapKeyCache.clear();
     m_halfDuplexMods.insert(key);
 }
 
 void
 KeyMap::finish()
 {
+    m_mapKeyCache.clear();
     m_numGroups = findNumGroups();
 
     // make sure every key has the same number of groups
@@ -236,6 +248,9 @@ KeyMap::finish()
 void
 KeyMap::foreachKey(ForeachKeyCallback cb, void* userData)
 {
+    // the callback may change the items
+    m_mapKeyCache.clear();
+
     for (KeyIDMap::iterator i = m_keyIDMap.begin();
                                 i != m_keyIDMap.end(); ++i) {
         KeyGroupTable& groupTable = i->second;
@@ -269,6 +284,22 @@ const KeyMap::KeyItem* KeyMap::mapKey(Keystrokes& keys, KeyID id, std::int32_t g
         return NULL;
     }
 
+    // replay the keystrokes from the last time we mapped this key from
+    // the same state
+    MapKeyInput input = { id, group, currentState, desiredMask, isAutoRepeat };
+    MapKeyCache::const_iterator cached = m_mapKeyCache.find(input);
+    if (cached != m_mapKeyCache.end() &&
+        cached->second.m_activeModifiers == activeModifiers) {
+        const MapKeyResult& result = cached->second;
+        keys.insert(keys.end(), result.m_keys.begin(), result.m_keys.end());
+        activeModifiers = result.m_newModifiers;
+        currentState    = result.m_newState;
+        LOG((CLOG_DEBUG1 "mapped to %03x, new state %04x (cached)", result.m_item->m_button, currentState));
+        return result.m_item;
+    }
+    std::size_t firstKey        = keys.size();
+    ModifierToKeys oldModifiers = activeModifiers;
+
     const KeyItem* item;
     switch (id) {
     case kKeyShift_L:
@@ -320,6 +351,17 @@ const KeyMap::KeyItem* KeyMap::mapKey(Keystrokes& keys, KeyID id, std::int32_t g
 
     if (item != NULL) {
         LOG((CLOG_DEBUG1 "mapped to %03x, new state %04x", item->m_button, currentState));
+
+        // remember the result
+        if (m_mapKeyCache.size() >= s_maxMapKeyCacheSize) {
+            m_mapKeyCache.clear();
+        }
+        MapKeyResult& result     = m_mapKeyCache[input];
+        result.m_activeModifiers = std::move(oldModifiers);
+        result.m_keys.assign(keys.begin() + firstKey, keys.end());
+        result.m_newModifiers    = activeModifiers;
+        result.m_newState        = currentState;
+        result.m_item            = item;
     }
     return item;
 }
@@ -1276,6 +1318,26 @@ KeyMap::initKeyNameMaps()
 // KeyMap::KeyItem
 //
 
+bool
+KeyMap::MapKeyInput::operator==(const MapKeyInput& x) const
+{
+    return (m_id           == x.m_id &&
+            m_group        == x.m_group &&
+            m_state        == x.m_state &&
+            m_desired      == x.m_desired &&
+            m_isAutoRepeat == x.m_isAutoRepeat);
+}
+
+std::size_t
+KeyMap::MapKeyInputHash::operator()(const MapKeyInput& x) const
+{
+    std::uint64_t h = (static_cast<std::uint64_t>(x.m_id) << 32) ^
+                      (static_cast<std::uint64_t>(x.m_state) << 16) ^
+                      x.m_desired;
+    h ^= (static_cast<std::uint64_t>(x.m_group) << 1) | (x.m_isAutoRepeat ? 1 : 0);
+    return std::hash<std::uint64_t>()(h);
+}
+
 bool
 KeyMap::KeyItem::operator==(const KeyItem& x) const
 {
@@ -24,6 +24,8 @@
 #include "common/stdset.h"
 #include "common/stdvector.h"
 
+#include <unordered_map>
+
 #ifdef INPUTLEAP_TEST_ENV
 #include <gtest/gtest_prod.h>
 #endif
@@ -215,6 +217,10 @@ public:
     \p desiredMask into the keystrokes necessary to synthesize that key
     event in \p keys.  It returns the \c KeyItem of the key being
     pressed/repeated, or NULL if the key cannot be mapped.
+
+    Successful mappings are remembered, so mapping the same key again
+    from the same modifier state just replays the keystrokes.  Changing
+    the map forgets them.
     */
     virtual const KeyItem* mapKey(Keystrokes& keys, KeyID id, std::int32_t group,
                                   ModifierToKeys& activeModifiers, KeyModifierMask& currentState,
@@ -352,6 +358,36 @@ private:
     // A list of ways to synthesize a KeyID
     typedef std::vector<KeyItemList> KeyEntryList;
 
+    // The arguments to mapKey() that its result depends on, other than
+    // the active modifiers
+    struct MapKeyInput {
+    public:
+        bool            operator==(const MapKeyInput&) const;
+
+    public:
+        KeyID            m_id;
+        std::int32_t m_group;
+        KeyModifierMask    m_state;
+        KeyModifierMask    m_desired;
+        bool            m_isAutoRepeat;
+    };
+    struct MapKeyInputHash {
+    public:
+        std::size_t        operator()(const MapKeyInput&) const;
+    };
+
+    // A remembered result of mapKey()
+    struct MapKeyResult {
+    public:
+        ModifierToKeys    m_activeModifiers;    // active modifiers going in
+        Keystrokes        m_keys;
+        ModifierToKeys    m_newModifiers;
+        KeyModifierMask    m_newState;
+        const KeyItem*    m_item;
+    };
+    typedef std::unordered_map<MapKeyInput, MapKeyResult,
+                            MapKeyInputHash> MapKeyCache;
+
     // computes the number of groups
     std::int32_t findNumGroups() const;
 
@@ -484,6 +520,9 @@ private:
     // dummy KeyItem for changing modifiers
     KeyItem                m_modifierKeyItem;
 
+    // results of mapKey().  anything that changes the map must clear this.
+    mutable MapKeyCache    m_mapKeyCache;
+
     // parsing/formatting tables
     static NameToKeyMap*        s_nameToKeyMap;
     static NameToModifierMap*    s_nameToModifierMap;
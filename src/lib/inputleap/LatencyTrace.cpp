@@ -0,0 +1,232 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "inputleap/LatencyTrace.h"
+
+#include "base/Log.h"
+#include "base/Metrics.h"
+#include "base/Time.h"
+
+#include <cassert>
+
+// a trace that hasn't reached a client within this many seconds was
+// for an event that stayed on the server
+static const double        kPendingTimeout = 1.0;
+
+static std::uint32_t
+toMicros(double seconds)
+{
+    if (seconds <= 0.0) {
+        return 0;
+    }
+    if (seconds >= 4000.0) {
+        return 4000000000u;
+    }
+    return static_cast<std::uint32_t>(seconds * 1.0e+6 + 0.5);
+}
+
+//
+// LatencyTrace
+//
+
+LatencyTrace* LatencyTrace::s_instance = NULL;
+
+LatencyTrace::LatencyTrace(double sampleInterval, double reportInterval) :
+    m_sampleInterval(sampleInterval),
+    m_reportInterval(reportInterval),
+    m_lastReport(inputleap::current_time_seconds()),
+    m_pending(false),
+    m_dispatched(false),
+    m_captured(0.0),
+    m_dispatchedTime(0.0),
+    m_nextID(0)
+{
+    assert(s_instance == NULL);
+    s_instance = this;
+
+    for (int i = 0; i < kNumStages; ++i) {
+        EStage stage = static_cast<EStage>(i);
+        m_exported[i] = &Metrics::getInstance().getHistogram(
+                            "inputleap_latency_seconds",
+                            "Time taken by traced input events, by stage.", 1.0e-6,
+                            Metrics::label("stage", getStageName(stage)));
+    }
+}
+
+LatencyTrace::~LatencyTrace()
+{
+    report();
+    s_instance = NULL;
+}
+
+LatencyTrace*
+LatencyTrace::getInstance()
+{
+    return s_instance;
+}
+
+void
+LatencyTrace::captured()
+{
+    double now = inputleap::current_time_seconds();
+    if (m_pending && now - m_captured < kPendingTimeout) {
+        // still waiting on the last one
+        return;
+    }
+    if (!m_pending && now - m_captured < m_sampleInterval) {
+        // too soon
+        return;
+    }
+
+    m_pending    = true;
+    m_dispatched = false;
+    m_captured   = now;
+}
+
+void
+LatencyTrace::dispatched()
+{
+    if (m_pending && !m_dispatched) {
+        m_dispatched     = true;
+        m_dispatchedTime = inputleap::current_time_seconds();
+    }
+}
+
+bool
+LatencyTrace::sending(std::uint32_t& id, std::uint32_t& serverMicros)
+{
+    if (!m_pending || !m_dispatched) {
+        return false;
+    }
+    m_pending = false;
+
+    double now = inputleap::current_time_seconds();
+    record(kQueued, toMicros(m_dispatchedTime - m_captured));
+    record(kServer, toMicros(now - m_dispatchedTime));
+
+    // zero is reserved for the client's acknowledgement of the option
+    if (++m_nextID == 0) {
+        ++m_nextID;
+    }
+    id           = m_nextID;
+    serverMicros = toMicros(now - m_captured);
+
+    InFlight& flight      = m_inFlight[id];
+    flight.m_sent         = now;
+    flight.m_serverMicros = serverMicros;
+
+    reportIfDue(now);
+    return true;
+}
+
+void
+LatencyTrace::acknowledged(std::uint32_t id, std::uint32_t clientMicros)
+{
+    InFlightMap::iterator index = m_inFlight.find(id);
+    if (index == m_inFlight.end()) {
+        return;
+    }
+
+    // the round trip includes the client's time.  the rest is split
+    // evenly between the two directions.
+    double now = inputleap::current_time_seconds();
+    std::uint32_t roundTrip = toMicros(now - index->second.m_sent);
+    std::uint32_t network   = 0;
+    if (roundTrip > clientMicros) {
+        network = (roundTrip - clientMicros) / 2;
+    }
+    record(kNetwork, network);
+    record(kClient, clientMicros);
+    record(kTotal, static_cast<std::uint64_t>(
+                            index->second.m_serverMicros) + network + clientMicros);
+    m_inFlight.erase(index);
+
+    reportIfDue(now);
+}
+
+void
+LatencyTrace::injected(std::uint32_t clientMicros)
+{
+    record(kClient, clientMicros);
+    reportIfDue(inputleap::current_time_seconds());
+}
+
+void
+LatencyTrace::report()
+{
+    m_lastReport = inputleap::current_time_seconds();
+
+    for (int i = 0; i < kNumStages; ++i) {
+        Histogram& histogram = m_histograms[i];
+        std::uint64_t count = histogram.getCount();
+        if (count == 0) {
+            continue;
+        }
+        LOG((CLOG_INFO "latency %s: p50=%.3fms p99=%.3fms max=%.3fms samples=%u",
+            getStageName(static_cast<EStage>(i)),
+            1.0e-3 * static_cast<double>(histogram.getPercentile(50.0)),
+            1.0e-3 * static_cast<double>(histogram.getPercentile(99.0)),
+            1.0e-3 * static_cast<double>(histogram.getMax()),
+            static_cast<unsigned int>(count)));
+        histogram.reset();
+    }
+
+    // forget traces the client never acknowledged
+    for (InFlightMap::iterator index = m_inFlight.begin();
+                                index != m_inFlight.end(); ) {
+        if (m_lastReport - index->second.m_sent > m_reportInterval) {
+            index = m_inFlight.erase(index);
+        }
+        else {
+            ++index;
+        }
+    }
+}
+
+const Histogram&
+LatencyTrace::getHistogram(EStage stage) const
+{
+    return m_histograms[stage];
+}
+
+const char*
+LatencyTrace::getStageName(EStage stage)
+{
+    static const char* s_names[] = {
+        "queued",
+        "server",
+        "network",
+        "client",
+        "total"
+    };
+    return s_names[stage];
+}
+
+void
+LatencyTrace::record(EStage stage, std::uint64_t micros)
+{
+    m_histograms[stage].record(micros);
+    m_exported[stage]->record(micros);
+}
+
+void
+LatencyTrace::reportIfDue(double now)
+{
+    if (now - m_lastReport >= m_reportInterval) {
+        report();
+    }
+}
@@ -0,0 +1,149 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "base/Histogram.h"
+
+#include <cstdint>
+#include <map>
+
+//! Input latency tracer
+/*!
+Measures how long input takes to get from the server's screen to the
+client's screen.  A sample of the input events is traced:  the server
+screen notes when an event is captured, the server notes when it picks
+the event up to route it and when the event is written to the client.
+The client proxy sends the trace id and the time spent on the server
+ahead of the traced message (see kMsgDLatencyTrace) and the client
+replies with the time it spent decoding and injecting the event (see
+kMsgDLatencyTraceAck).  The time on the wire is estimated as half of the
+round trip less the client's time, so the clocks on the two machines
+need not agree.
+
+At most one tracer exists at a time.  All methods must be called on the
+thread running the event loop.  Each stage's p50, p99 and maximum are
+logged periodically and the histograms are then cleared.  The stages are
+also exported, cumulatively, as the \c inputleap_latency_seconds metric
+with a \c stage label (see Metrics).
+*/
+class LatencyTrace {
+public:
+    //! Stages of an event's trip
+    enum EStage {
+        kQueued,                //!< Captured until picked up by the server
+        kServer,                //!< Picked up until written to the client
+        kNetwork,                //!< Written until received (one way estimate)
+        kClient,                //!< Received until injected on the client
+        kTotal,                    //!< Captured until injected
+        kNumStages
+    };
+
+    //! Create the tracer
+    /*!
+    Starts a trace at most every \p sampleInterval seconds and logs the
+    histograms every \p reportInterval seconds.
+    */
+    LatencyTrace(double sampleInterval = 0.05, double reportInterval = 10.0);
+    LatencyTrace(const LatencyTrace&) = delete;
+    LatencyTrace& operator=(const LatencyTrace&) = delete;
+    ~LatencyTrace();
+
+    //! @name manipulators
+    //@{
+
+    //! Note that the primary screen captured an input event
+    /*!
+    Starts a trace if the last one is old enough and none is pending.
+    */
+    void                captured();
+
+    //! Note that the server picked up an event to route it
+    void                dispatched();
+
+    //! Note that a traced event is being written to a client
+    /*!
+    Returns true, the trace id and the microseconds spent on the server
+    if an event is being traced.  The caller should send those to the
+    client before the event.  Otherwise returns false.
+    */
+    bool                sending(std::uint32_t& id, std::uint32_t& serverMicros);
+
+    //! Note that a client acknowledged a traced event
+    /*!
+    \p clientMicros is the time the client spent decoding and injecting
+    the event.  Unknown ids are ignored.
+    */
+    void                acknowledged(std::uint32_t id, std::uint32_t clientMicros);
+
+    //! Note that a traced event was injected on this client
+    void                injected(std::uint32_t clientMicros);
+
+    //! Log and clear the histograms
+    void                report();
+
+    //@}
+    //! @name accessors
+    //@{
+
+    //! Get the tracer
+    /*!
+    Returns the tracer or NULL if tracing is off.
+    */
+    static LatencyTrace* getInstance();
+
+    //! Get the histogram of a stage, in microseconds
+    const Histogram&    getHistogram(EStage stage) const;
+
+    //! Get the name of a stage
+    static const char*    getStageName(EStage stage);
+
+    //@}
+
+private:
+    void                record(EStage stage, std::uint64_t micros);
+    void                reportIfDue(double now);
+
+private:
+    class InFlight {
+    public:
+        double            m_sent;
+        std::uint32_t    m_serverMicros;
+    };
+    typedef std::map<std::uint32_t, InFlight> InFlightMap;
+
+    static LatencyTrace* s_instance;
+
+    double                m_sampleInterval;
+    double                m_reportInterval;
+    double                m_lastReport;
+
+    // the trace being captured, if any
+    bool                m_pending;
+    bool                m_dispatched;
+    double                m_captured;
+    double                m_dispatchedTime;
+
+    // traces waiting for the client
+    std::uint32_t        m_nextID;
+    InFlightMap            m_inFlight;
+
+    Histogram            m_histograms[kNumStages];
+
+    // the cumulative histograms in the metrics registry
+    Histogram*            m_exported[kNumStages];
+};
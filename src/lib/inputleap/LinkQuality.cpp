@@ -0,0 +1,148 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "inputleap/LinkQuality.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+//
+// LinkQuality
+//
+
+LinkQuality::LinkQuality(double baseRate) :
+    m_baseRate(baseRate),
+    m_nextID(1),
+    m_pendingID(0),
+    m_pendingSent(0.0),
+    m_samples(0),
+    m_lost(0),
+    m_consecutiveLost(0),
+    m_lastRTT(0.0),
+    m_rtt(0.0),
+    m_rttVariation(0.0),
+    m_clockOffset(0.0)
+{
+    // do nothing
+}
+
+std::uint32_t
+LinkQuality::sending(double now)
+{
+    if (m_pendingID != 0) {
+        ++m_lost;
+        ++m_consecutiveLost;
+    }
+
+    m_pendingID   = m_nextID;
+    m_pendingSent = now;
+    if (++m_nextID == 0) {
+        m_nextID = 1;
+    }
+    return m_pendingID;
+}
+
+bool
+LinkQuality::received(std::uint32_t id, double now, std::int32_t clockDelta)
+{
+    if (id == 0 || id != m_pendingID) {
+        return false;
+    }
+    m_pendingID       = 0;
+    m_consecutiveLost = 0;
+
+    double rtt = std::max(0.0, now - m_pendingSent);
+    double offset = 1.0e-6 * static_cast<double>(clockDelta) - 0.5 * rtt;
+    if (m_samples == 0) {
+        m_rtt          = rtt;
+        m_rttVariation = 0.5 * rtt;
+        m_clockOffset  = offset;
+    }
+    else {
+        m_rttVariation = 0.75 * m_rttVariation + 0.25 * std::fabs(m_rtt - rtt);
+        m_rtt          = 0.875 * m_rtt + 0.125 * rtt;
+        m_clockOffset  = 0.875 * m_clockOffset + 0.125 * offset;
+    }
+    m_lastRTT = rtt;
+    ++m_samples;
+    return true;
+}
+
+std::uint32_t
+LinkQuality::getSamples() const
+{
+    return m_samples;
+}
+
+std::uint32_t
+LinkQuality::getLost() const
+{
+    return m_lost;
+}
+
+double
+LinkQuality::getLastRTT() const
+{
+    return m_lastRTT;
+}
+
+double
+LinkQuality::getRTT() const
+{
+    return m_rtt;
+}
+
+double
+LinkQuality::getRTTVariation() const
+{
+    return m_rttVariation;
+}
+
+double
+LinkQuality::getClockOffset() const
+{
+    return m_clockOffset;
+}
+
+double
+LinkQuality::getKeepAliveRate() const
+{
+    if (m_baseRate <= 0.0) {
+        return m_baseRate;
+    }
+
+    // leave room for a few of the slowest round trips we expect in
+    // each keep alive interval
+    double rate = m_baseRate;
+    if (m_samples > 0) {
+        rate = std::max(rate, 4.0 * (m_rtt + 4.0 * m_rttVariation));
+    }
+
+    // back off while pings go unanswered
+    rate *= static_cast<double>(1u << std::min(m_consecutiveLost, 2u));
+
+    return std::min(rate, 4.0 * m_baseRate);
+}
+
+std::uint32_t
+LinkQuality::getClockMicros()
+{
+    auto since_epoch = std::chrono::system_clock::now().time_since_epoch();
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(since_epoch).count();
+    return static_cast<std::uint32_t>(us);
+}
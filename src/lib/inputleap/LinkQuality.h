@@ -0,0 +1,115 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstdint>
+
+//! Link quality estimator
+/*!
+Estimates the round trip time to a peer and the offset between its clock
+and ours from ping messages (see kMsgCPing and kMsgCPong).  The round
+trip time is smoothed the way TCP smooths it (RFC 6298) and the clock
+offset is a moving average of the peer's clock at the time it answered
+less our clock half a round trip earlier.
+
+The estimator also recommends a keep alive rate.  The peer is declared
+dead after kKeepAlivesUntilDeath keep alives go unanswered so on a slow
+or jittery link, or one where pings go unanswered, the rate is lengthened
+to avoid dropping a peer that's merely slow.  It never recommends less
+than the base rate nor more than four times it.
+
+Times are in seconds and are passed in so the estimator can be tested.
+*/
+class LinkQuality {
+public:
+    //! Create an estimator for a link with keep alive rate \p baseRate
+    explicit LinkQuality(double baseRate);
+
+    //! @name manipulators
+    //@{
+
+    //! Note that a ping is being sent at time \p now
+    /*!
+    Returns the id to send with the ping, never 0.  A ping still waiting
+    for its pong is counted as lost.
+    */
+    std::uint32_t        sending(double now);
+
+    //! Note that a pong arrived at time \p now
+    /*!
+    \p clockDelta is the peer's clock when it answered less our clock
+    when we sent the ping, in microseconds.  Returns false and ignores
+    the pong if \p id isn't the ping we're waiting for.
+    */
+    bool                received(std::uint32_t id, double now,
+                            std::int32_t clockDelta);
+
+    //@}
+    //! @name accessors
+    //@{
+
+    //! Get the number of round trips measured
+    std::uint32_t        getSamples() const;
+
+    //! Get the number of pings that went unanswered
+    std::uint32_t        getLost() const;
+
+    //! Get the last round trip time measured
+    double                getLastRTT() const;
+
+    //! Get the smoothed round trip time
+    double                getRTT() const;
+
+    //! Get the round trip time variation
+    double                getRTTVariation() const;
+
+    //! Get the estimated clock offset
+    /*!
+    Returns the peer's clock less ours.
+    */
+    double                getClockOffset() const;
+
+    //! Get the recommended keep alive rate
+    double                getKeepAliveRate() const;
+
+    //! Get the wall clock for ping messages
+    /*!
+    Returns microseconds since the epoch modulo 2^32.  Differences of
+    these are valid while the clocks on the two machines are within half
+    an hour or so of each other.
+    */
+    static std::uint32_t getClockMicros();
+
+    //@}
+
+private:
+    double                m_baseRate;
+    std::uint32_t        m_nextID;
+
+    // the ping waiting for its pong, if any
+    std::uint32_t        m_pendingID;
+    double                m_pendingSent;
+
+    std::uint32_t        m_samples;
+    std::uint32_t        m_lost;
+    std::uint32_t        m_consecutiveLost;
+    double                m_lastRTT;
+    double                m_rtt;
+    double                m_rttVariation;
+    double                m_clockOffset;
+};
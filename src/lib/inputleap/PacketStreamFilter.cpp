@@ -19,6 +19,8 @@
 #include "inputleap/PacketStreamFilter.h"
 #include "inputleap/protocol_types.h"
 #include "base/IEventQueue.h"
+#include "base/Metrics.h"
+#include "base/Probes.h"
 #include "base/TMethodEventJob.h"
 
 #include <cstring>
@@ -32,7 +34,11 @@ PacketStreamFilter::PacketStreamFilter(IEventQueue* events, inputleap::IStream*
     StreamFilter(events, stream, adoptStream),
     m_size(0),
     m_inputShutdown(false),
-    m_events(events)
+    m_events(events),
+    m_messagesIn(NULL),
+    m_messagesOut(NULL),
+    m_bytesIn(NULL),
+    m_bytesOut(NULL)
 {
     // do nothing
 }
@@ -42,6 +48,21 @@ PacketStreamFilter::~PacketStreamFilter()
     // do nothing
 }
 
+void
+PacketStreamFilter::setMetricsPeer(const std::string& peer)
+{
+    Metrics& metrics  = Metrics::getInstance();
+    std::string label = Metrics::label("peer", peer);
+    m_messagesIn  = &metrics.getCounter("inputleap_messages_received_total",
+                            "Protocol messages received.", label);
+    m_messagesOut = &metrics.getCounter("inputleap_messages_sent_total",
+                            "Protocol messages sent.", label);
+    m_bytesIn     = &metrics.getCounter("inputleap_bytes_received_total",
+                            "Protocol bytes received, including framing.", label);
+    m_bytesOut    = &metrics.getCounter("inputleap_bytes_sent_total",
+                            "Protocol bytes sent, including framing.", label);
+}
+
 void
 PacketStreamFilter::close()
 {
@@ -100,6 +121,11 @@ void PacketStreamFilter::write(const void* buffer, std::uint32_t count)
 
     // write the payload
     getStream()->write(buffer, count);
+
+    if (m_messagesOut != NULL) {
+        m_messagesOut->add();
+        m_bytesOut->add(sizeof(length) + count);
+    }
 }
 
 void
@@ -147,6 +173,11 @@ bool PacketStreamFilter::readPacketSize()
             m_events->addEvent(Event(m_events->forIStream().inputFormatError(), getEventTarget()));
             return false;
         }
+
+        if (m_messagesIn != NULL) {
+            m_messagesIn->add();
+            m_bytesIn->add(sizeof(buffer) + m_size);
+        }
     }
     return true;
 }
@@ -175,6 +206,9 @@ PacketStreamFilter::readMore()
 
     // note if we now have a whole packet
     bool isReady = isReadyNoLock();
+    if (isReady && !wasReady) {
+        INPUTLEAP_PROBE2(packet_complete, this, m_size);
+    }
 
     // if we weren't ready before but now we are then send a
     // input ready event apparently from the filtered stream.
@@ -22,8 +22,10 @@
 #include "io/StreamBuffer.h"
 
 #include <mutex>
+#include <string>
 
 class IEventQueue;
+class MetricCounter;
 
 //! Packetizing stream filter
 /*!
@@ -34,6 +36,13 @@ public:
     PacketStreamFilter(IEventQueue* events, inputleap::IStream* stream, bool adoptStream = true);
     ~PacketStreamFilter() override;
 
+    //! Count traffic
+    /*!
+    Counts the messages and bytes sent and received from now on in the
+    metrics labelled with \p peer.
+    */
+    void                setMetricsPeer(const std::string& peer);
+
     // IStream overrides
     virtual void close() override;
     virtual std::uint32_t read(void* buffer, std::uint32_t n) override;
@@ -59,4 +68,8 @@ private:
     StreamBuffer        m_buffer;
     bool                m_inputShutdown;
     IEventQueue*        m_events;
+    MetricCounter*        m_messagesIn;
+    MetricCounter*        m_messagesOut;
+    MetricCounter*        m_bytesIn;
+    MetricCounter*        m_bytesOut;
 };
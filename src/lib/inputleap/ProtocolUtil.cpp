@@ -19,6 +19,7 @@
 #include "inputleap/ProtocolUtil.h"
 #include "io/IStream.h"
 #include "base/Log.h"
+#include "base/Probes.h"
 #include "inputleap/protocol_types.h"
 #include "inputleap/XBarrier.h"
 #include "common/stdvector.h"
@@ -41,11 +42,41 @@ ProtocolUtil::writef(inputleap::IStream* stream, const char* fmt, ...)
     va_start(args, fmt);
     std::uint32_t size = getLength(fmt, args);
     va_end(args);
+    INPUTLEAP_PROBE3(message_send, stream, fmt, size);
     va_start(args, fmt);
     vwritef(stream, fmt, size, args);
     va_end(args);
 }
 
+void
+ProtocolUtil::encodef(std::vector<std::uint8_t>& buffer, const char* fmt, ...)
+{
+    assert(fmt != NULL);
+
+    va_list args;
+    va_start(args, fmt);
+    std::uint32_t size = getLength(fmt, args);
+    va_end(args);
+    buffer.resize(size);
+    if (size != 0) {
+        va_start(args, fmt);
+        writef_void(buffer.data(), fmt, args);
+        va_end(args);
+    }
+}
+
+void
+ProtocolUtil::write(inputleap::IStream* stream, const std::vector<std::uint8_t>& buffer)
+{
+    assert(stream != NULL);
+
+    const std::uint32_t size = static_cast<std::uint32_t>(buffer.size());
+    INPUTLEAP_PROBE3(message_send, stream, buffer.data(), size);
+    if (size != 0) {
+        stream->write(buffer.data(), size);
+    }
+}
+
 bool
 ProtocolUtil::readf(inputleap::IStream* stream, const char* fmt, ...)
 {
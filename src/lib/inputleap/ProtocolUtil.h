@@ -21,7 +21,9 @@
 #include "io/XIO.h"
 #include "base/EventTypes.h"
 
+#include <cstdint>
 #include <stdarg.h>
+#include <vector>
 
 namespace inputleap { class IStream; }
 
@@ -52,6 +54,20 @@ public:
     */
     static void writef(inputleap::IStream*, const char* fmt, ...);
 
+    //! Encode formatted data
+    /*!
+    Formats data as writef() does but into \c buffer, replacing its
+    contents, so the same message can be written to many streams with
+    write() without formatting it for each.
+    */
+    static void encodef(std::vector<std::uint8_t>& buffer, const char* fmt, ...);
+
+    //! Write encoded data
+    /*!
+    Write a message encoded by encodef() to a stream.
+    */
+    static void write(inputleap::IStream*, const std::vector<std::uint8_t>& buffer);
+
     //! Read formatted data
     /*!
     Read formatted binary data from a buffer.  This performs the
@@ -204,20 +204,21 @@ public:
     */
     void unregisterHotKey(std::uint32_t id);
 
-    //! Prepare to synthesize input on primary screen
+    //! Prepare to synthesize input
     /*!
     Prepares the primary screen to receive synthesized input.  We do not
     want to receive this synthesized input as user input so this method
-    ensures that we ignore it.  Calls to \c fakeInputBegin() may not be
-    nested.
+    ensures that we ignore it.  On a secondary screen this starts a batch
+    of synthesized input that the platform may hold back until
+    \c fakeInputEnd().  Calls to \c fakeInputBegin() may not be nested.
     */
-    void                fakeInputBegin();
+    virtual void        fakeInputBegin();
 
-    //! Done synthesizing input on primary screen
+    //! Done synthesizing input
     /*!
     Undoes whatever \c fakeInputBegin() did.
     */
-    void                fakeInputEnd();
+    virtual void        fakeInputEnd();
 
     //! Change dragging status
     void                setDraggingStarted(bool started);
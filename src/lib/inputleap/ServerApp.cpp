@@ -25,9 +25,13 @@
 #include "inputleap/ArgParser.h"
 #include "inputleap/Screen.h"
 #include "inputleap/XScreen.h"
+#include "inputleap/InputTraceReader.h"
+#include "inputleap/InputTraceWriter.h"
 #include "inputleap/ServerTaskBarReceiver.h"
 #include "inputleap/ServerArgs.h"
+#include "platform/VirtualScreen.h"
 #include "net/SocketMultiplexer.h"
+#include "net/SocketMultiplexerPool.h"
 #include "net/TCPSocketFactory.h"
 #include "net/XSocket.h"
 #include "arch/Arch.h"
@@ -152,6 +156,14 @@ ServerApp::help()
            << HELP_COMMON_INFO_1
            << "      --disable-client-cert-checking disable client SSL certificate \n"
               "                                     checking (deprecated)\n"
+           << "      --record-trace <file> record the input from this computer to file.\n"
+           << "      --replay-trace <file> replay the input recorded in file on the\n"
+           << "                             virtual screen, then quit.\n"
+           << "      --replay-speed <factor|max>\n"
+           << "                           replay at factor times the recorded speed\n"
+           << "                             or as fast as possible.\n"
+           << "      --io-threads <n>     read, write and encrypt client connections\n"
+           << "                             on n threads, 0 to share one thread.\n"
            << WINAPI_INFO << HELP_SYS_INFO << HELP_COMMON_INFO_2 << "\n"
            << "Default options are marked with a *\n"
            << "\n"
@@ -610,6 +622,21 @@ ServerApp::startServer()
 inputleap::Screen*
 ServerApp::createScreen()
 {
+    if (args().m_virtualScreen) {
+        std::unique_ptr<VirtualScreen> screen(createVirtualScreen(true));
+        if (!args().m_replayTrace.empty()) {
+            InputTraceReader trace;
+            std::string error;
+            if (!trace.load(args().m_replayTrace, error)) {
+                throw XScreenOpenFailure(args().m_replayTrace + ": " + error);
+            }
+            LOG((CLOG_NOTE "replaying %d input records from %s",
+                static_cast<int>(trace.getRecords().size()), args().m_replayTrace.c_str()));
+            screen->setTrace(trace.getRecords(), args().m_replaySpeed);
+        }
+        return new inputleap::Screen(screen.release(), m_events);
+    }
+
 #if WINAPI_MSWINDOWS
     return new inputleap::Screen(new MSWindowsScreen(
         true, args().m_noHooks, args().m_stopOnDeskSwitch, m_events), m_events);
@@ -669,7 +696,7 @@ ServerApp::openClientListener(const NetworkAddress& address)
 
     ClientListener* listen = new ClientListener(
         address,
-        new TCPSocketFactory(m_events, getSocketMultiplexer()),
+        new TCPSocketFactory(m_events, getSocketMultiplexer(), m_ioThreads.get()),
         m_events, security_level);
 
     m_events->adoptHandler(
@@ -737,9 +764,20 @@ ServerApp::handleScreenSwitched(const Event& e, void*)
 int
 ServerApp::mainLoop()
 {
-    // create socket multiplexer.  this must happen after daemonization
-    // on unix because threads evaporate across a fork().
+    // create socket multiplexer and log writer.  this must happen after
+    // daemonization on unix because threads evaporate across a fork().
     setSocketMultiplexer(std::make_unique<SocketMultiplexer>());
+    setupAsyncLogging();
+
+    // client connections get threads of their own so one client's TLS
+    // or large writes don't hold up the rest
+    std::size_t ioThreads = args().m_ioThreads < 0 ?
+                            SocketMultiplexerPool::getDefaultSize() :
+                            static_cast<std::size_t>(args().m_ioThreads);
+    if (ioThreads > 0) {
+        LOG((CLOG_DEBUG "servicing clients on %d socket threads", static_cast<int>(ioThreads)));
+        m_ioThreads.reset(new SocketMultiplexerPool(ioThreads));
+    }
 
     // if configuration has no screens then add this system
     // as the default
@@ -764,6 +802,15 @@ ServerApp::mainLoop()
         return kExitFailed;
     }
 
+    // start recording before the server sees any input
+    if (!args().m_recordTrace.empty()) {
+        m_inputTrace = std::make_unique<InputTraceWriter>();
+        if (!m_inputTrace->open(args().m_recordTrace)) {
+            LOG((CLOG_WARN "can't record input to %s", args().m_recordTrace.c_str()));
+            m_inputTrace.reset();
+        }
+    }
+
     // start server, etc
     appUtil().startNode();
 
@@ -772,6 +819,9 @@ ServerApp::mainLoop()
     if (argsBase().m_enableIpc) {
         initIpcClient();
     }
+    if (argsBase().m_metricsPort != 0) {
+        initMetricsServer();
+    }
 
     // handle hangup signal by reloading the server's configuration
     ARCH->setSignalHandler(Arch::kHANGUP, &reloadSignalHandler, NULL);
@@ -819,12 +869,15 @@ ServerApp::mainLoop()
     m_events->removeHandler(m_events->forServerApp().reloadConfig(),
         m_events->getSystemTarget());
     cleanupServer();
+    m_ioThreads.reset();
     updateStatus();
     LOG((CLOG_NOTE "stopped server"));
+    m_inputTrace.reset();
 
     if (argsBase().m_enableIpc) {
         cleanupIpcClient();
     }
+    cleanupMetricsServer();
 
     return kExitSuccess;
 }
@@ -28,6 +28,7 @@
 #include "ServerArgs.h"
 
 #include <map>
+#include <memory>
 
 enum EServerState {
     kUninitialized,
@@ -42,9 +43,11 @@ class Server;
 namespace inputleap { class Screen; }
 class ClientListener;
 class EventQueueTimer;
+class InputTraceWriter;
 class ILogOutputter;
 class IEventQueue;
 class ServerArgs;
+class SocketMultiplexerPool;
 
 class ServerApp : public App {
 public:
@@ -114,6 +117,9 @@ public:
 
 private:
     void handleScreenSwitched(const Event&, void*  data);
+
+    std::unique_ptr<InputTraceWriter> m_inputTrace;
+    std::unique_ptr<SocketMultiplexerPool> m_ioThreads;
 };
 
 // configuration file name
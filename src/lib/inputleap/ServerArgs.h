@@ -31,4 +31,11 @@ public:
     Config*                m_config;
     std::string m_screenChangeScript;
     bool check_client_certificates = true;
+    std::string m_recordTrace;
+    std::string m_replayTrace;
+    // 0 replays as fast as possible
+    double m_replaySpeed = 1.0;
+    // threads servicing client sockets.  0 services them on the main
+    // socket thread and -1 picks a number for this computer.
+    int m_ioThreads = -1;
 };
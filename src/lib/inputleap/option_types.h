@@ -68,6 +68,10 @@ static const OptionID    kOptionScreenPreserveFocus        = OPTION_CODE("SFOC")
 static const OptionID    kOptionRelativeMouseMoves        = OPTION_CODE("MDLT");
 static const OptionID    kOptionWin32KeepForeground        = OPTION_CODE("_KFW");
 static const OptionID    kOptionClipboardSharing            = OPTION_CODE("CLPS");
+static const OptionID    kOptionLatencyTrace                = OPTION_CODE("LTRC");
+static const OptionID    kOptionPing                        = OPTION_CODE("PING");
+static const OptionID    kOptionSessionHigh                = OPTION_CODE("SESH");
+static const OptionID    kOptionSessionLow                 = OPTION_CODE("SESL");
 //@}
 
 //! @name Screen switch corner enumeration
@@ -29,6 +29,9 @@ const char*                kMsgCScreenSaver     = "CSEC%1i";
 const char*                kMsgCResetOptions    = "CROP";
 const char*                kMsgCInfoAck        = "CIAK";
 const char*                kMsgCKeepAlive        = "CALV";
+const char*                kMsgCPing            = "CPIN%4i%4i";
+const char*                kMsgCPong            = "CPON%4i%4i%4i";
+const char*                kMsgCResume            = "CRSM%4i%4i";
 const char*                kMsgDKeyDown        = "DKDN%2i%2i%2i";
 const char*                kMsgDKeyDown1_0        = "DKDN%2i%2i";
 const char*                kMsgDKeyRepeat        = "DKRP%2i%2i%2i%2i";
@@ -46,6 +49,8 @@ const char*                kMsgDInfo            = "DINF%2i%2i%2i%2i%2i%2i%2i";
 const char*                kMsgDSetOptions        = "DSOP%4I";
 const char*                kMsgDFileTransfer    = "DFTR%1i%s";
 const char*                kMsgDDragInfo        = "DDRG%2i%s";
+const char*                kMsgDLatencyTrace    = "DLTR%4i%4i";
+const char*                kMsgDLatencyTraceAck = "DLTA%4i%4i";
 const char*                kMsgQInfo            = "QINF";
 const char*                kMsgEIncompatible    = "EICV%2i%2i";
 const char*                kMsgEBusy             = "EBSY";
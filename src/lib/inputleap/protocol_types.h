@@ -49,6 +49,10 @@ static const double        kKeepAliveRate = 3.0;
 // number of skipped kMsgCKeepAlive messages that indicates a problem
 static const double        kKeepAlivesUntilDeath = 3.0;
 
+// time a server holds on to a disconnected client's session (in seconds)
+// so the client can resume it after reconnecting.  see kMsgCResume.
+static const double        kResumeGracePeriod = 30.0;
+
 // obsolete heartbeat stuff
 static const double        kHeartRate = -1.0;
 static const double        kHeartBeatsUntilDeath = 3.0;
@@ -180,6 +184,34 @@ extern const char*        kMsgCInfoAck;
 // defined by an option.
 extern const char*        kMsgCKeepAlive;
 
+// ping:  primary -> secondary
+// measure the round trip time and clock offset.  $1 = ping id, $2 =
+// server's wall clock in microseconds since the epoch modulo 2^32.
+// only sent to clients that acknowledged the kOptionPing option and
+// usually sent along with kMsgCKeepAlive.
+extern const char*        kMsgCPing;
+
+// pong:  secondary -> primary
+// reply to kMsgCPing, sent as soon as the ping is read.  $1 and $2 are
+// the ping's id and timestamp, $3 = client's wall clock in microseconds
+// since the epoch modulo 2^32.  a client that supports pings sends
+// $1 = $2 = $3 = 0 in reply to the kOptionPing option;  it must not
+// send this message otherwise.
+extern const char*        kMsgCPong;
+
+// resume session:  primary <-> secondary
+// pick up a session after the previous connection dropped.  the
+// primary issues each session a 64-bit token, its high and low halves
+// in the kOptionSessionHigh and kOptionSessionLow options.  a secondary
+// holding a token sends its halves as $1 and $2 just before the
+// kMsgDInfo that answers the handshake's kMsgQInfo;  it must not send
+// this message otherwise.  the primary answers with the same $1 and $2
+// if the session resumed, in which case the handshake is complete and
+// the primary only sends options and clipboards that changed meanwhile.
+// otherwise the primary answers with $1 = $2 = 0 and the handshake
+// continues as for a new connection.
+extern const char*        kMsgCResume;
+
 //
 // data codes
 //
@@ -281,6 +313,20 @@ extern const char*        kMsgDFileTransfer;
 // of each object's directory.
 extern const char*        kMsgDDragInfo;
 
+// latency trace:  primary -> secondary
+// the next input message is being traced.  $1 = trace id, $2 =
+// microseconds between capturing the input on the primary screen and
+// sending it.  only sent to clients that acknowledged the
+// kOptionLatencyTrace option.
+extern const char*        kMsgDLatencyTrace;
+
+// latency trace acknowledgement:  secondary -> primary
+// the input message traced by kMsgDLatencyTrace with trace id $1 has
+// been injected.  $2 = microseconds between receiving and injecting it.
+// a client that supports tracing sends $1 = $2 = 0 in reply to the
+// kOptionLatencyTrace option;  it must not send this message otherwise.
+extern const char*        kMsgDLatencyTraceAck;
+
 //
 // query codes
 //
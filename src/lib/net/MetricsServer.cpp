@@ -0,0 +1,176 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "net/MetricsServer.h"
+
+#include "net/IDataSocket.h"
+#include "net/TCPListenSocket.h"
+#include "arch/Arch.h"
+#include "base/IEventQueue.h"
+#include "base/Log.h"
+#include "base/Metrics.h"
+#include "base/TMethodEventJob.h"
+
+// requests longer than this are refused
+static const std::size_t kMaxRequestSize = 8192;
+
+//
+// MetricsServer
+//
+
+MetricsServer::MetricsServer(IEventQueue* events,
+                SocketMultiplexer* socketMultiplexer,
+                const NetworkAddress& address) :
+    m_events(events),
+    m_socketMultiplexer(socketMultiplexer),
+    m_address(address),
+    m_listen(NULL)
+{
+    // do nothing
+}
+
+MetricsServer::~MetricsServer()
+{
+    while (!m_connections.empty()) {
+        deleteConnection(m_connections.begin()->first);
+    }
+    if (m_listen != NULL) {
+        m_events->removeHandler(m_events->forIListenSocket().connecting(), m_listen);
+        delete m_listen;
+    }
+}
+
+void
+MetricsServer::listen()
+{
+    m_address.resolve();
+    m_listen = new TCPListenSocket(m_events, m_socketMultiplexer,
+                            ARCH->getAddrFamily(m_address.getAddress()));
+    m_events->adoptHandler(m_events->forIListenSocket().connecting(), m_listen,
+                            new TMethodEventJob<MetricsServer>(this,
+                                &MetricsServer::handleConnecting));
+    m_listen->bind(m_address);
+    LOG((CLOG_NOTE "serving metrics on %s:%d",
+        m_address.getHostname().c_str(), m_address.getPort()));
+}
+
+void
+MetricsServer::handleConnecting(const Event&, void*)
+{
+    IDataSocket* socket = m_listen->accept();
+    if (socket == NULL) {
+        return;
+    }
+
+    LOG((CLOG_DEBUG1 "accepted metrics connection"));
+    m_connections[socket];
+
+    void* target = socket->getEventTarget();
+    m_events->adoptHandler(m_events->forIStream().inputReady(), target,
+                            new TMethodEventJob<MetricsServer>(this,
+                                &MetricsServer::handleInput, socket));
+    m_events->adoptHandler(m_events->forIStream().outputFlushed(), target,
+                            new TMethodEventJob<MetricsServer>(this,
+                                &MetricsServer::handleFlushed, socket));
+    m_events->adoptHandler(m_events->forIStream().inputShutdown(), target,
+                            new TMethodEventJob<MetricsServer>(this,
+                                &MetricsServer::handleDisconnected, socket));
+    m_events->adoptHandler(m_events->forISocket().disconnected(), target,
+                            new TMethodEventJob<MetricsServer>(this,
+                                &MetricsServer::handleDisconnected, socket));
+}
+
+void
+MetricsServer::handleInput(const Event&, void* vsocket)
+{
+    IDataSocket* socket = static_cast<IDataSocket*>(vsocket);
+    ConnectionMap::iterator index = m_connections.find(socket);
+    if (index == m_connections.end()) {
+        return;
+    }
+
+    // collect the request up to the blank line that ends its header
+    std::string& request = index->second;
+    char buffer[1024];
+    std::uint32_t n;
+    while ((n = socket->read(buffer, sizeof(buffer))) > 0) {
+        request.append(buffer, n);
+    }
+    if (request.find("\r\n\r\n") != std::string::npos ||
+        request.find("\n\n") != std::string::npos ||
+        request.size() > kMaxRequestSize) {
+        respond(socket, request);
+    }
+}
+
+void
+MetricsServer::handleFlushed(const Event&, void* vsocket)
+{
+    // the response has been sent
+    IDataSocket* socket = static_cast<IDataSocket*>(vsocket);
+    if (m_connections.count(socket) != 0) {
+        deleteConnection(socket);
+    }
+}
+
+void
+MetricsServer::handleDisconnected(const Event&, void* vsocket)
+{
+    IDataSocket* socket = static_cast<IDataSocket*>(vsocket);
+    if (m_connections.count(socket) != 0) {
+        deleteConnection(socket);
+    }
+}
+
+void
+MetricsServer::respond(IDataSocket* socket, const std::string& request)
+{
+    // stop reading.  the connection goes away once the response is out.
+    m_events->removeHandler(m_events->forIStream().inputReady(),
+                            socket->getEventTarget());
+
+    std::string status;
+    std::string body;
+    if (request.compare(0, 13, "GET /metrics ") == 0) {
+        status = "200 OK";
+        body   = Metrics::getInstance().format();
+    }
+    else if (request.compare(0, 4, "GET ") == 0) {
+        status = "404 Not Found";
+        body   = "not found\n";
+    }
+    else {
+        status = "400 Bad Request";
+        body   = "bad request\n";
+    }
+    LOG((CLOG_DEBUG1 "metrics request: %s", status.c_str()));
+
+    std::string response = "HTTP/1.0 " + status + "\r\n"
+        "Content-Type: text/plain; version=0.0.4\r\n"
+        "Content-Length: " + std::to_string(body.size()) + "\r\n"
+        "Connection: close\r\n"
+        "\r\n" + body;
+    socket->write(response.data(), static_cast<std::uint32_t>(response.size()));
+}
+
+void
+MetricsServer::deleteConnection(IDataSocket* socket)
+{
+    m_events->removeHandlers(socket->getEventTarget());
+    m_connections.erase(socket);
+    delete socket;
+}
@@ -0,0 +1,76 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "net/NetworkAddress.h"
+
+#include <map>
+#include <string>
+
+class Event;
+class IDataSocket;
+class IEventQueue;
+class SocketMultiplexer;
+class TCPListenSocket;
+
+//! Metrics endpoint
+/*!
+Serves the contents of the metrics registry (see Metrics) over HTTP in
+the Prometheus text format.  Only plain HTTP/1.0 GET requests for
+\c /metrics are supported; each response closes the connection.  The
+server is meant to listen on localhost.
+*/
+class MetricsServer {
+public:
+    MetricsServer(IEventQueue* events, SocketMultiplexer* socketMultiplexer,
+                    const NetworkAddress& address);
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+    ~MetricsServer();
+
+    //! @name manipulators
+    //@{
+
+    //! Start listening
+    /*!
+    Throws XSocket if the address can't be bound.
+    */
+    void                listen();
+
+    //@}
+
+private:
+    void                handleConnecting(const Event&, void*);
+    void                handleInput(const Event&, void*);
+    void                handleFlushed(const Event&, void*);
+    void                handleDisconnected(const Event&, void*);
+
+    void                respond(IDataSocket* socket, const std::string& request);
+    void                deleteConnection(IDataSocket* socket);
+
+private:
+    typedef std::map<IDataSocket*, std::string> ConnectionMap;
+
+    IEventQueue*        m_events;
+    SocketMultiplexer*    m_socketMultiplexer;
+    NetworkAddress        m_address;
+    TCPListenSocket*    m_listen;
+
+    // connections and the part of the request read so far
+    ConnectionMap        m_connections;
+};
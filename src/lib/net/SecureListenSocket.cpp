@@ -38,8 +38,8 @@ SecureListenSocket::accept()
 {
     SecureSocket* socket = NULL;
     try {
-        socket = new SecureSocket(m_events, m_socketMultiplexer,
-                                  ARCH->acceptSocket(m_socket, NULL), security_level_);
+        socket = new SecureSocket(m_events, getAcceptMultiplexer(),
+                                  acceptArchSocket(), security_level_);
         socket->initSsl(true);
 
         if (socket != NULL) {
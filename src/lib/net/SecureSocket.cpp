@@ -23,6 +23,8 @@
 #include "net/TCPSocket.h"
 #include "arch/XArch.h"
 #include "base/Log.h"
+#include "base/Metrics.h"
+#include "base/Probes.h"
 #include "base/String.h"
 #include "base/finally.h"
 #include "base/Time.h"
@@ -388,7 +390,7 @@ SecureSocket::initContext(bool server)
     // load all error messages
     SSL_load_error_strings();
 
-    if (CLOG->getFilter() >= kINFO) {
+    if (Log::isEnabled(INPUTLEAP_LOG_CATEGORY, kINFO)) {
         showSecureLibInfo();
     }
 
@@ -444,6 +446,10 @@ SecureSocket::secureAccept(int socket)
     SSL_set_fd(m_ssl->m_ssl, socket);
 
     LOG((CLOG_DEBUG2 "accepting secure socket"));
+    if (handshake_start_ == 0.0) {
+        handshake_start_ = inputleap::current_time_seconds();
+        INPUTLEAP_PROBE2(tls_handshake_start, this, "accept");
+    }
     int r = SSL_accept(m_ssl->m_ssl);
 
     checkResult(r, secure_accept_retry_);
@@ -452,6 +458,7 @@ SecureSocket::secureAccept(int socket)
         // tell user and sleep so the socket isn't hammered.
         LOG((CLOG_ERR "failed to accept secure socket"));
         LOG((CLOG_INFO "client connection may not be secure"));
+        INPUTLEAP_PROBE3(tls_handshake_end, this, "accept", 0);
         m_secureReady = false;
         inputleap::this_thread_sleep(1);
         secure_accept_retry_ = 0;
@@ -474,8 +481,9 @@ SecureSocket::secureAccept(int socket)
         }
 
         m_secureReady = true;
+        recordHandshake("accept");
         LOG((CLOG_INFO "accepted secure socket"));
-        if (CLOG->getFilter() >= kDEBUG1) {
+        if (Log::isEnabled(INPUTLEAP_LOG_CATEGORY, kDEBUG1)) {
             showSecureCipherInfo();
         }
         showSecureConnectInfo();
@@ -513,12 +521,17 @@ SecureSocket::secureConnect(int socket)
     SSL_set_fd(m_ssl->m_ssl, socket);
 
     LOG((CLOG_DEBUG2 "connecting secure socket"));
+    if (handshake_start_ == 0.0) {
+        handshake_start_ = inputleap::current_time_seconds();
+        INPUTLEAP_PROBE2(tls_handshake_start, this, "connect");
+    }
     int r = SSL_connect(m_ssl->m_ssl);
 
     checkResult(r, secure_connect_retry_);
 
     if (isFatal()) {
         LOG((CLOG_ERR "failed to connect secure socket"));
+        INPUTLEAP_PROBE3(tls_handshake_end, this, "connect", 0);
         secure_connect_retry_ = 0;
         return -1;
     }
@@ -534,6 +547,7 @@ SecureSocket::secureConnect(int socket)
     secure_connect_retry_ = 0;
     // No error, set ready, process and return ok
     m_secureReady = true;
+    recordHandshake("connect");
     if (verify_peer_certificate(inputleap::DataDirectories::trusted_servers_ssl_fingerprints_path())) {
         LOG((CLOG_INFO "connected to secure socket"));
     }
@@ -543,7 +557,7 @@ SecureSocket::secureConnect(int socket)
         return -1; // Fingerprint failed, error
     }
     LOG((CLOG_DEBUG2 "connected secure socket"));
-    if (CLOG->getFilter() >= kDEBUG1) {
+    if (Log::isEnabled(INPUTLEAP_LOG_CATEGORY, kDEBUG1)) {
         showSecureCipherInfo();
     }
     showSecureConnectInfo();
@@ -874,6 +888,18 @@ SecureSocket::showSecureConnectInfo()
     return;
 }
 
+void
+SecureSocket::recordHandshake(const char* role)
+{
+    double elapsed = inputleap::current_time_seconds() - handshake_start_;
+    Metrics::getInstance().getHistogram("inputleap_tls_handshake_seconds",
+                            "Time taken by TLS handshakes.", 1.0e-6,
+                            Metrics::label("role", role))
+        .record(static_cast<std::uint64_t>(elapsed * 1.0e+6));
+    handshake_start_ = 0.0;
+    INPUTLEAP_PROBE3(tls_handshake_end, this, role, 1);
+}
+
 void
 SecureSocket::handleTCPConnected(const Event& event, void*)
 {
@@ -82,6 +82,7 @@ private:
     void showSecureConnectInfo(); // may only be called with ssl_mutex_ acquired
     void showSecureLibInfo();
     void showSecureCipherInfo(); // may only be called with ssl_mutex_ acquired
+    void recordHandshake(const char* role);
 
     void                handleTCPConnected(const Event& event, void*);
 
@@ -100,6 +101,7 @@ private:
 
     int secure_accept_retry_ = 0; // used only in secureAccept()
     int secure_connect_retry_ = 0; // used only in secureConnect()
+    double handshake_start_ = 0.0; // when secureAccept() or secureConnect() first ran
     int secure_read_retry_ = 0; // used only in secureRead()
     int secure_write_retry_ = 0; // used only in secureWrite()
 
@@ -60,6 +60,13 @@ SocketMultiplexer::SocketMultiplexer() :
 SocketMultiplexer::~SocketMultiplexer()
 {
     m_thread->cancel();
+
+    // wake the thread if it's waiting for jobs so it sees the cancel
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        are_jobs_ready_ = true;
+        cv_jobs_ready_.notify_one();
+    }
     m_thread->unblockPollSocket();
     m_thread->wait();
     delete m_thread;
@@ -0,0 +1,70 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "net/SocketMultiplexerPool.h"
+
+#include "net/SocketMultiplexer.h"
+
+#include <algorithm>
+#include <thread>
+
+// more threads than this only add context switches for the handful of
+// connections a server has
+static const std::size_t kMaxDefaultSize = 4;
+
+//
+// SocketMultiplexerPool
+//
+
+SocketMultiplexerPool::SocketMultiplexerPool(std::size_t size) :
+    m_next(0)
+{
+    for (std::size_t i = 0; i < size; ++i) {
+        m_multiplexers.push_back(std::make_unique<SocketMultiplexer>());
+    }
+}
+
+SocketMultiplexerPool::~SocketMultiplexerPool()
+{
+    // do nothing
+}
+
+SocketMultiplexer*
+SocketMultiplexerPool::next()
+{
+    if (m_multiplexers.empty()) {
+        return NULL;
+    }
+    std::size_t i = m_next.fetch_add(1, std::memory_order_relaxed);
+    return m_multiplexers[i % m_multiplexers.size()].get();
+}
+
+std::size_t
+SocketMultiplexerPool::getSize() const
+{
+    return m_multiplexers.size();
+}
+
+std::size_t
+SocketMultiplexerPool::getDefaultSize()
+{
+    std::size_t cores = std::thread::hardware_concurrency();
+    if (cores <= 1) {
+        return 0;
+    }
+    return std::min(cores, kMaxDefaultSize);
+}
@@ -0,0 +1,69 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+class SocketMultiplexer;
+
+//! Socket multiplexers for accepted connections
+/*!
+A fixed set of socket multiplexers, each with its own thread, handed
+out in turn to accepted sockets.  Reading, writing and TLS for each
+connection then run on its multiplexer's thread, so a slow or busy
+connection only holds up the others sharing that thread.
+*/
+class SocketMultiplexerPool {
+public:
+    //! Start \p size multiplexers
+    explicit SocketMultiplexerPool(std::size_t size);
+    SocketMultiplexerPool(const SocketMultiplexerPool&) = delete;
+    SocketMultiplexerPool& operator=(const SocketMultiplexerPool&) = delete;
+    ~SocketMultiplexerPool();
+
+    //! @name manipulators
+    //@{
+
+    //! Get the multiplexer for the next socket
+    /*!
+    Returns the multiplexers in turn.  Safe to call from any thread.
+    */
+    SocketMultiplexer*    next();
+
+    //@}
+    //! @name accessors
+    //@{
+
+    //! Get the number of multiplexers
+    std::size_t            getSize() const;
+
+    //! Get a sensible number of multiplexers for this computer
+    /*!
+    Returns 0, meaning one thread is enough, on a single core.
+    */
+    static std::size_t    getDefaultSize();
+
+    //@}
+
+private:
+    std::vector<std::unique_ptr<SocketMultiplexer>> m_multiplexers;
+    std::atomic<std::size_t> m_next;
+};
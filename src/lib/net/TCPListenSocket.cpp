@@ -20,6 +20,7 @@
 
 #include "net/NetworkAddress.h"
 #include "net/SocketMultiplexer.h"
+#include "net/SocketMultiplexerPool.h"
 #include "net/TCPSocket.h"
 #include "net/TSocketMultiplexerMethodJob.h"
 #include "net/XSocket.h"
@@ -27,6 +28,7 @@
 #include "arch/Arch.h"
 #include "arch/XArch.h"
 #include "base/IEventQueue.h"
+#include "base/Log.h"
 
 //
 // TCPListenSocket
@@ -34,7 +36,9 @@
 
 TCPListenSocket::TCPListenSocket(IEventQueue* events, SocketMultiplexer* socketMultiplexer, IArchNetwork::EAddressFamily family) :
     m_events(events),
-    m_socketMultiplexer(socketMultiplexer)
+    m_socketMultiplexer(socketMultiplexer),
+    m_acceptPool(NULL),
+    m_acceptSendBufferSize(0)
 {
     try {
         m_socket = ARCH->newSocket(family, IArchNetwork::kSTREAM);
@@ -57,6 +61,18 @@ TCPListenSocket::~TCPListenSocket()
     }
 }
 
+void
+TCPListenSocket::setAcceptPool(SocketMultiplexerPool* pool)
+{
+    m_acceptPool = pool;
+}
+
+void
+TCPListenSocket::setAcceptSendBufferSize(int size)
+{
+    m_acceptSendBufferSize = size;
+}
+
 void
 TCPListenSocket::bind(const NetworkAddress& addr)
 {
@@ -109,7 +125,7 @@ TCPListenSocket::accept()
 {
     IDataSocket* socket = NULL;
     try {
-        socket = new TCPSocket(m_events, m_socketMultiplexer, ARCH->acceptSocket(m_socket, NULL));
+        socket = new TCPSocket(m_events, getAcceptMultiplexer(), acceptArchSocket());
         if (socket != NULL) {
             setListeningJob();
         }
@@ -141,6 +157,30 @@ TCPListenSocket::setListeningJob()
     m_socketMultiplexer->addSocket(this, std::move(new_job));
 }
 
+SocketMultiplexer*
+TCPListenSocket::getAcceptMultiplexer()
+{
+    if (m_acceptPool != NULL && m_acceptPool->getSize() > 0) {
+        return m_acceptPool->next();
+    }
+    return m_socketMultiplexer;
+}
+
+ArchSocket
+TCPListenSocket::acceptArchSocket()
+{
+    ArchSocket socket = ARCH->acceptSocket(m_socket, NULL);
+    if (socket != NULL && m_acceptSendBufferSize > 0) {
+        try {
+            ARCH->setSendBufferSizeOnSocket(socket, m_acceptSendBufferSize);
+        }
+        catch (XArchNetwork& e) {
+            LOG((CLOG_WARN "cannot set send buffer size: %s", e.what()));
+        }
+    }
+    return socket;
+}
+
 MultiplexerJobStatus TCPListenSocket::serviceListening(ISocketMultiplexerJob* job,
                                                        bool read, bool, bool error)
 {
@@ -26,6 +26,7 @@
 
 class IEventQueue;
 class SocketMultiplexer;
+class SocketMultiplexerPool;
 
 //! TCP listen socket
 /*!
@@ -36,6 +37,20 @@ public:
     TCPListenSocket(IEventQueue* events, SocketMultiplexer* socketMultiplexer, IArchNetwork::EAddressFamily family);
     virtual ~TCPListenSocket();
 
+    //! Service accepted sockets elsewhere
+    /*!
+    Accepted sockets use the multiplexers in \p pool in turn instead
+    of this socket's multiplexer.  \p pool must outlive them.
+    */
+    void                setAcceptPool(SocketMultiplexerPool* pool);
+
+    //! Limit the send buffer of accepted sockets
+    /*!
+    Accepted sockets have their system send buffer set to \p size bytes,
+    or left alone if \p size is 0, the default.
+    */
+    void                setAcceptSendBufferSize(int size);
+
     // ISocket overrides
     void bind(const NetworkAddress&) override;
     void close() override;
@@ -46,6 +61,8 @@ public:
 
 protected:
     void                setListeningJob();
+    SocketMultiplexer*    getAcceptMultiplexer();
+    ArchSocket            acceptArchSocket();
 
 public:
     MultiplexerJobStatus serviceListening(ISocketMultiplexerJob*, bool, bool, bool);
@@ -55,4 +72,6 @@ protected:
     std::mutex mutex_;
     IEventQueue*        m_events;
     SocketMultiplexer*    m_socketMultiplexer;
+    SocketMultiplexerPool* m_acceptPool;
+    int                    m_acceptSendBufferSize;
 };
@@ -27,6 +27,8 @@
 #include "base/Log.h"
 #include "base/IEventQueue.h"
 #include "base/IEventJob.h"
+#include "base/Metrics.h"
+#include "base/Probes.h"
 
 #include <cstring>
 #include <cstdlib>
@@ -34,6 +36,13 @@
 
 static const std::size_t MAX_INPUT_BUFFER_SIZE = 1024 * 1024;
 
+static MetricGauge&        s_outputBuffered = Metrics::getInstance().getGauge(
+    "inputleap_socket_output_buffer_bytes",
+    "Bytes waiting to be sent, summed over all sockets.");
+static Histogram&        s_outputDepth = Metrics::getInstance().getHistogram(
+    "inputleap_socket_output_buffer_depth_bytes",
+    "Bytes waiting to be sent on a socket after each write.", 1.0);
+
 TCPSocket::TCPSocket(IEventQueue* events, SocketMultiplexer* socketMultiplexer, IArchNetwork::EAddressFamily family) :
     IDataSocket(events),
     m_events(events),
@@ -169,6 +178,8 @@ void TCPSocket::write(const void* buffer, std::uint32_t n)
         // copy data to the output buffer
         wasEmpty = (m_outputBuffer.getSize() == 0);
         m_outputBuffer.write(buffer, n);
+        s_outputBuffered.add(n);
+        s_outputDepth.record(m_outputBuffer.getSize());
 
         // there's data to write
         is_flushed_ = false;
@@ -331,6 +342,7 @@ TCPSocket::doRead()
 
         // slurp up as much as possible
         do {
+            INPUTLEAP_PROBE2(socket_read, this, bytesRead);
             m_inputBuffer.write(buffer, static_cast<std::uint32_t>(bytesRead));
 
             if (m_inputBuffer.getSize() > MAX_INPUT_BUFFER_SIZE) {
@@ -373,6 +385,7 @@ TCPSocket::doWrite()
     bytesWrote = static_cast<std::uint32_t>(ARCH->writeSocket(m_socket, buffer, bufferSize));
 
     if (bytesWrote > 0) {
+        INPUTLEAP_PROBE2(socket_write, this, bytesWrote);
         discardWrittenData(bytesWrote);
         return kNew;
     }
@@ -451,6 +464,7 @@ void
 TCPSocket::discardWrittenData(int bytesWrote)
 {
     m_outputBuffer.pop(bytesWrote);
+    s_outputBuffered.add(-bytesWrote);
     if (m_outputBuffer.getSize() == 0) {
         sendEvent(m_events->forIStream().outputFlushed());
         is_flushed_ = true;
@@ -476,6 +490,7 @@ TCPSocket::onInputShutdown()
 void
 TCPSocket::onOutputShutdown()
 {
+    s_outputBuffered.add(-static_cast<std::int64_t>(m_outputBuffer.getSize()));
     m_outputBuffer.pop(m_outputBuffer.getSize());
     m_writable = false;
 
@@ -24,13 +24,21 @@
 #include "arch/Arch.h"
 #include "base/Log.h"
 
+// sockets accepted by a listen socket carry messages to clients.  the
+// server only merges stale mouse moves once the stream stops keeping up,
+// and with the system's (often multi-megabyte) default send buffer it
+// keeps up long after the client stopped reading.
+static const int kAcceptSendBufferSize = 32 * 1024;
+
 //
 // TCPSocketFactory
 //
 
-TCPSocketFactory::TCPSocketFactory(IEventQueue* events, SocketMultiplexer* socketMultiplexer) :
+TCPSocketFactory::TCPSocketFactory(IEventQueue* events, SocketMultiplexer* socketMultiplexer,
+                                   SocketMultiplexerPool* acceptPool) :
     m_events(events),
-    m_socketMultiplexer(socketMultiplexer)
+    m_socketMultiplexer(socketMultiplexer),
+    m_acceptPool(acceptPool)
 {
     // do nothing
 }
@@ -57,13 +65,15 @@ IDataSocket* TCPSocketFactory::create(IArchNetwork::EAddressFamily family,
 IListenSocket* TCPSocketFactory::createListen(IArchNetwork::EAddressFamily family,
                                               ConnectionSecurityLevel security_level) const
 {
-    IListenSocket* socket = NULL;
+    TCPListenSocket* socket = NULL;
     if (security_level != ConnectionSecurityLevel::PLAINTEXT) {
         socket = new SecureListenSocket(m_events, m_socketMultiplexer, family, security_level);
     }
     else {
         socket = new TCPListenSocket(m_events, m_socketMultiplexer, family);
     }
+    socket->setAcceptPool(m_acceptPool);
+    socket->setAcceptSendBufferSize(kAcceptSendBufferSize);
 
     return socket;
 }
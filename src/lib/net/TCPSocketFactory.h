@@ -23,11 +23,17 @@
 
 class IEventQueue;
 class SocketMultiplexer;
+class SocketMultiplexerPool;
 
 //! Socket factory for TCP sockets
+/*!
+Sockets accepted by the listen sockets this creates use the
+multiplexers in \c acceptPool, if given, instead of \c socketMultiplexer.
+*/
 class TCPSocketFactory : public ISocketFactory {
 public:
-    TCPSocketFactory(IEventQueue* events, SocketMultiplexer* socketMultiplexer);
+    TCPSocketFactory(IEventQueue* events, SocketMultiplexer* socketMultiplexer,
+                     SocketMultiplexerPool* acceptPool = NULL);
     virtual ~TCPSocketFactory();
 
     // ISocketFactory overrides
@@ -40,4 +46,5 @@ public:
 private:
     IEventQueue*        m_events;
     SocketMultiplexer*    m_socketMultiplexer;
+    SocketMultiplexerPool* m_acceptPool;
 };
@@ -62,8 +62,9 @@ static std::vector<DWORD> immune_keys_list()
 {
     std::vector<DWORD> keys;
     std::string badLine;
-    if (!ImmuneKeysReader::get_list(g_immuneKeysPath.c_str(), keys, badLine))
+    if (!ImmuneKeysReader::get_list(g_immuneKeysPath.c_str(), keys, badLine)) {
         LOG((CLOG_ERR "Reading immune keys stopped at: %s", badLine.c_str()));
+    }
     return keys;
 }
 
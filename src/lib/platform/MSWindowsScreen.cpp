@@ -652,7 +652,11 @@ void MSWindowsScreen::unregisterHotKey(std::uint32_t id)
 void
 MSWindowsScreen::fakeInputBegin()
 {
-    assert(m_isPrimary);
+    if (!m_isPrimary) {
+        // secondary screens inject through SendInput() right away so
+        // there is nothing to batch
+        return;
+    }
 
     if (!m_isOnScreen) {
         m_keyState->useSavedModifiers(true);
@@ -663,7 +667,9 @@ MSWindowsScreen::fakeInputBegin()
 void
 MSWindowsScreen::fakeInputEnd()
 {
-    assert(m_isPrimary);
+    if (!m_isPrimary) {
+        return;
+    }
 
     m_desks->fakeInputEnd();
     if (!m_isOnScreen) {
@@ -0,0 +1,164 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "platform/VirtualInputScript.h"
+#include "inputleap/KeyMap.h"
+#include "base/String.h"
+
+#include <fstream>
+#include <sstream>
+
+//
+// VirtualInputScript
+//
+
+namespace {
+
+// parses a keystroke like Control+Shift+a
+bool
+parseKeystroke(std::string text, KeyID& key, KeyModifierMask& mask)
+{
+    if (!inputleap::KeyMap::parseModifiers(text, mask)) {
+        return false;
+    }
+    return inputleap::KeyMap::parseKey(text, key) && key != kKeyNone;
+}
+
+} // namespace
+
+VirtualInputScript::VirtualInputScript()
+{
+    // do nothing
+}
+
+bool
+VirtualInputScript::parse(std::istream& input, std::string& error)
+{
+    StepList steps;
+    std::string line;
+    for (int lineNumber = 1; std::getline(input, line); ++lineNumber) {
+        if (!parseLine(line, steps, error)) {
+            error = inputleap::string::sprintf("line %d: %s", lineNumber, error.c_str());
+            m_steps.clear();
+            return false;
+        }
+    }
+    m_steps.swap(steps);
+    return true;
+}
+
+bool
+VirtualInputScript::load(const std::string& path, std::string& error)
+{
+    std::ifstream input(path.c_str());
+    if (!input.is_open()) {
+        error = "can't open " + path;
+        m_steps.clear();
+        return false;
+    }
+    return parse(input, error);
+}
+
+const VirtualInputScript::StepList&
+VirtualInputScript::getSteps() const
+{
+    return m_steps;
+}
+
+bool
+VirtualInputScript::parseLine(const std::string& line, StepList& steps,
+                std::string& error)
+{
+    std::istringstream words(line);
+    std::string command;
+    if (!(words >> command) || command[0] == '#') {
+        return true;
+    }
+
+    // the rest of the line, without the separating whitespace
+    std::string rest;
+    std::getline(words >> std::ws, rest);
+    while (!rest.empty() && (rest.back() == '\r' || rest.back() == ' ')) {
+        rest.pop_back();
+    }
+    std::istringstream args(rest);
+
+    // click and key are a press followed by a release
+    Step step;
+    bool andRelease = false;
+    if (command == "wait") {
+        step.m_type = kWait;
+        if (!(args >> step.m_seconds) || step.m_seconds < 0.0) {
+            error = "wait needs a duration in seconds";
+            return false;
+        }
+    }
+    else if (command == "move" || command == "moveby" || command == "wheel") {
+        step.m_type = (command == "move") ? kMove :
+                      (command == "moveby") ? kMoveBy : kWheel;
+        if (!(args >> step.m_x >> step.m_y)) {
+            error = command + " needs two numbers";
+            return false;
+        }
+    }
+    else if (command == "buttondown" || command == "buttonup" || command == "click") {
+        int button;
+        if (!(args >> button) || button <= kButtonNone || button >= NumButtonIDs) {
+            error = command + " needs a button number";
+            return false;
+        }
+        step.m_type   = (command == "buttonup") ? kButtonUp : kButtonDown;
+        step.m_button = static_cast<ButtonID>(button);
+        andRelease    = (command == "click");
+    }
+    else if (command == "keydown" || command == "keyup" || command == "key") {
+        if (!parseKeystroke(rest, step.m_key, step.m_mask)) {
+            error = "bad keystroke `" + rest + "'";
+            return false;
+        }
+        step.m_type = (command == "keyup") ? kKeyUp : kKeyDown;
+        andRelease  = (command == "key");
+        args.str("");
+    }
+    else if (command == "clipboard") {
+        step.m_type = kClipboard;
+        step.m_text = rest;
+        args.str("");
+    }
+    else if (command == "loop") {
+        step.m_type = kLoop;
+    }
+    else if (command == "quit") {
+        step.m_type = kQuit;
+    }
+    else {
+        error = "unknown step `" + command + "'";
+        return false;
+    }
+
+    std::string extra;
+    if (args >> extra) {
+        error = "unexpected " + extra;
+        return false;
+    }
+    steps.push_back(step);
+    if (andRelease) {
+        step.m_type = (step.m_type == kKeyDown) ? kKeyUp : kButtonUp;
+        steps.push_back(step);
+    }
+    return true;
+}
@@ -0,0 +1,120 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "inputleap/key_types.h"
+#include "inputleap/mouse_types.h"
+
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+
+//! Input for a virtual screen to replay
+/*!
+A list of input steps read from a text file, one step per line.  Blank
+lines and lines starting with \c # are ignored.  The steps are:
+
+\verbatim
+wait <seconds>            pause before the next step
+move <x> <y>              move the pointer to x,y
+moveby <dx> <dy>          move the pointer by dx,dy
+buttondown <button>       press a mouse button (1 is the left button)
+buttonup <button>         release a mouse button
+click <button>            press and release a mouse button
+wheel <dx> <dy>           turn the mouse wheel
+keydown <keystroke>       press a key, e.g. Control+a
+keyup <keystroke>         release a key
+key <keystroke>           press and release a key
+clipboard <text>          copy the rest of the line to the clipboard
+loop                      start over from the first step
+quit                      stop the program
+\endverbatim
+
+Keystrokes use the same syntax as keystroke actions in the configuration
+file.
+*/
+class VirtualInputScript {
+public:
+    enum EType {
+        kWait,
+        kMove,
+        kMoveBy,
+        kButtonDown,
+        kButtonUp,
+        kWheel,
+        kKeyDown,
+        kKeyUp,
+        kClipboard,
+        kLoop,
+        kQuit
+    };
+
+    //! A single scripted input
+    class Step {
+    public:
+        Step() : m_type(kWait), m_seconds(0.0), m_x(0), m_y(0),
+            m_button(kButtonNone), m_key(kKeyNone), m_mask(0) { }
+
+    public:
+        EType                m_type;
+        double                m_seconds;
+        std::int32_t        m_x;
+        std::int32_t        m_y;
+        ButtonID            m_button;
+        KeyID                m_key;
+        KeyModifierMask        m_mask;
+        std::string            m_text;
+    };
+    typedef std::vector<Step> StepList;
+
+    VirtualInputScript();
+
+    //! @name manipulators
+    //@{
+
+    //! Read a script
+    /*!
+    Replaces the steps with those read from \p input.  Returns false and
+    leaves the steps empty if any line can't be parsed;  \p error then
+    says which line and why.
+    */
+    bool                parse(std::istream& input, std::string& error);
+
+    //! Read a script from a file
+    /*!
+    Like parse() but reads the file at \p path.
+    */
+    bool                load(const std::string& path, std::string& error);
+
+    //@}
+    //! @name accessors
+    //@{
+
+    //! Get the steps
+    const StepList&        getSteps() const;
+
+    //@}
+
+private:
+    static bool            parseLine(const std::string& line, StepList& steps,
+                            std::string& error);
+
+private:
+    StepList            m_steps;
+};
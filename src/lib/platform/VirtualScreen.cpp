@@ -0,0 +1,771 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "platform/VirtualScreen.h"
+#include "inputleap/KeyMap.h"
+#include "base/IEventQueue.h"
+#include "base/Log.h"
+#include "base/String.h"
+#include "base/TMethodEventJob.h"
+#include "base/Time.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+//
+// VirtualScreen
+//
+
+namespace {
+
+// the time between script steps that don't wait
+const double kStepDelay = 0.000001;
+
+// scripted keys have no physical key so make one up from the key id
+KeyButton
+scriptButton(KeyID key)
+{
+    KeyButton button = static_cast<KeyButton>(key & 0xffffu);
+    return (button == 0) ? 1 : button;
+}
+
+} // namespace
+
+VirtualScreen::VirtualScreen(IEventQueue* events, bool isPrimary,
+                std::int32_t x, std::int32_t y,
+                std::int32_t width, std::int32_t height) :
+    PlatformScreen(events),
+    m_events(events),
+    m_isPrimary(isPrimary),
+    m_isOnScreen(isPrimary),
+    m_x(x),
+    m_y(y),
+    m_w(width),
+    m_h(height),
+    m_xCursor(x + width / 2),
+    m_yCursor(y + height / 2),
+    m_sequenceNumber(0),
+    m_nextHotKeyID(0),
+    m_modifiers(0),
+    m_step(0),
+    m_scriptTimer(NULL),
+    m_traceRecord(0),
+    m_traceSpeed(1.0),
+    m_traceStart(0.0),
+    m_recorder(NULL)
+{
+    std::fill(m_buttons, m_buttons + NumButtonIDs, false);
+    LOG((CLOG_DEBUG "virtual screen shape=%d,%d %dx%d", m_x, m_y, m_w, m_h));
+}
+
+VirtualScreen::~VirtualScreen()
+{
+    stopScript();
+}
+
+void
+VirtualScreen::setScript(const VirtualInputScript& script)
+{
+    stopScript();
+    m_script = script;
+}
+
+void
+VirtualScreen::setTrace(const InputTraceReader::RecordList& records, double speed)
+{
+    stopScript();
+    m_trace      = records;
+    m_traceSpeed = speed;
+}
+
+void
+VirtualScreen::setRecorder(std::ostream* recorder)
+{
+    m_recorder = recorder;
+}
+
+bool
+VirtualScreen::openRecordFile(const std::string& path)
+{
+    m_recordFile.open(path.c_str(), std::ios::out | std::ios::trunc);
+    if (!m_recordFile.is_open()) {
+        return false;
+    }
+    m_recorder = &m_recordFile;
+    return true;
+}
+
+void*
+VirtualScreen::getEventTarget() const
+{
+    return const_cast<VirtualScreen*>(this);
+}
+
+bool
+VirtualScreen::getClipboard(ClipboardID id, IClipboard* clipboard) const
+{
+    return IClipboard::copy(clipboard, &m_clipboard[id]);
+}
+
+void
+VirtualScreen::getShape(std::int32_t& x, std::int32_t& y,
+                std::int32_t& width, std::int32_t& height) const
+{
+    x      = m_x;
+    y      = m_y;
+    width  = m_w;
+    height = m_h;
+}
+
+void
+VirtualScreen::getCursorPos(std::int32_t& x, std::int32_t& y) const
+{
+    x = m_xCursor;
+    y = m_yCursor;
+}
+
+void
+VirtualScreen::reconfigure(std::uint32_t)
+{
+    // do nothing
+}
+
+void
+VirtualScreen::warpCursor(std::int32_t x, std::int32_t y)
+{
+    m_xCursor = x;
+    m_yCursor = y;
+}
+
+std::uint32_t
+VirtualScreen::registerHotKey(KeyID, KeyModifierMask)
+{
+    // scripts can't press hot keys but traces replay the ids they
+    // recorded, which were handed out in the order they're asked for
+    return ++m_nextHotKeyID;
+}
+
+void
+VirtualScreen::unregisterHotKey(std::uint32_t)
+{
+    // do nothing
+}
+
+void
+VirtualScreen::fakeInputBegin()
+{
+    // do nothing
+}
+
+void
+VirtualScreen::fakeInputEnd()
+{
+    // do nothing
+}
+
+std::int32_t
+VirtualScreen::getJumpZoneSize() const
+{
+    return 1;
+}
+
+bool
+VirtualScreen::isAnyMouseButtonDown(std::uint32_t& buttonID) const
+{
+    for (ButtonID id = kButtonLeft; id < NumButtonIDs; ++id) {
+        if (m_buttons[id]) {
+            buttonID = id;
+            return true;
+        }
+    }
+    buttonID = kButtonNone;
+    return false;
+}
+
+void
+VirtualScreen::getCursorCenter(std::int32_t& x, std::int32_t& y) const
+{
+    x = m_x + m_w / 2;
+    y = m_y + m_h / 2;
+}
+
+void
+VirtualScreen::fakeMouseButton(ButtonID id, bool press)
+{
+    if (id < NumButtonIDs) {
+        m_buttons[id] = press;
+    }
+    record(inputleap::string::sprintf("%s %d", press ? "buttondown" : "buttonup", id));
+}
+
+void
+VirtualScreen::fakeMouseMove(std::int32_t x, std::int32_t y)
+{
+    m_xCursor = x;
+    m_yCursor = y;
+    record(inputleap::string::sprintf("move %d %d", x, y));
+}
+
+void
+VirtualScreen::fakeMouseRelativeMove(std::int32_t dx, std::int32_t dy) const
+{
+    record(inputleap::string::sprintf("moveby %d %d", dx, dy));
+}
+
+void
+VirtualScreen::fakeMouseWheel(std::int32_t xDelta, std::int32_t yDelta) const
+{
+    record(inputleap::string::sprintf("wheel %d %d", xDelta, yDelta));
+}
+
+void
+VirtualScreen::updateKeyMap()
+{
+    // do nothing
+}
+
+void
+VirtualScreen::updateKeyState()
+{
+    // do nothing
+}
+
+void
+VirtualScreen::setHalfDuplexMask(KeyModifierMask)
+{
+    // do nothing
+}
+
+void
+VirtualScreen::fakeKeyDown(KeyID id, KeyModifierMask mask, KeyButton button)
+{
+    m_keys[button] = id;
+    m_modifiers    = mask;
+    record("keydown " + inputleap::KeyMap::formatKey(id, mask));
+}
+
+bool
+VirtualScreen::fakeKeyRepeat(KeyID id, KeyModifierMask mask,
+                std::int32_t count, KeyButton)
+{
+    record(inputleap::string::sprintf("keyrepeat %s %d",
+                inputleap::KeyMap::formatKey(id, mask).c_str(), count));
+    return true;
+}
+
+bool
+VirtualScreen::fakeKeyUp(KeyButton button)
+{
+    auto i = m_keys.find(button);
+    if (i == m_keys.end()) {
+        return false;
+    }
+    record("keyup " + inputleap::KeyMap::formatKey(i->second, m_modifiers));
+    m_keys.erase(i);
+    if (m_keys.empty()) {
+        m_modifiers = 0;
+    }
+    return true;
+}
+
+void
+VirtualScreen::fakeAllKeysUp()
+{
+    m_keys.clear();
+    m_modifiers = 0;
+    record("allkeysup");
+}
+
+bool
+VirtualScreen::fakeCtrlAltDel()
+{
+    record("ctrlaltdel");
+    return true;
+}
+
+bool
+VirtualScreen::isKeyDown(KeyButton button) const
+{
+    return m_keys.count(button) > 0;
+}
+
+KeyModifierMask
+VirtualScreen::getActiveModifiers() const
+{
+    return m_modifiers;
+}
+
+KeyModifierMask
+VirtualScreen::pollActiveModifiers() const
+{
+    return m_modifiers;
+}
+
+std::int32_t
+VirtualScreen::pollActiveGroup() const
+{
+    return 0;
+}
+
+void
+VirtualScreen::pollPressedKeys(KeyButtonSet& pressedKeys) const
+{
+    for (const auto& key : m_keys) {
+        pressedKeys.insert(key.first);
+    }
+}
+
+void
+VirtualScreen::enable()
+{
+    if (m_isPrimary && !m_trace.empty()) {
+        m_traceRecord = 0;
+        m_traceStart  = inputleap::current_time_seconds();
+        startTimer(std::max(1.0e-6 * static_cast<double>(m_trace[0].m_time) /
+                            (m_traceSpeed > 0.0 ? m_traceSpeed : 1.0), kStepDelay),
+                   &VirtualScreen::handleTraceTimer);
+    }
+    else if (m_isPrimary && !m_script.getSteps().empty()) {
+        m_step = 0;
+        runScript();
+    }
+}
+
+void
+VirtualScreen::disable()
+{
+    stopScript();
+    if (m_recorder != NULL) {
+        m_recorder->flush();
+    }
+}
+
+void
+VirtualScreen::enter()
+{
+    m_isOnScreen = true;
+    record("enter");
+}
+
+bool
+VirtualScreen::leave()
+{
+    m_isOnScreen = false;
+    if (m_isPrimary) {
+        // a real primary screen hides the cursor in the middle of the
+        // screen while it's on a secondary screen
+        getCursorCenter(m_xCursor, m_yCursor);
+    }
+    record("leave");
+
+    // write out what happened on this screen while it was active
+    if (m_recorder != NULL) {
+        m_recorder->flush();
+    }
+    return true;
+}
+
+bool
+VirtualScreen::setClipboard(ClipboardID id, const IClipboard* clipboard)
+{
+    if (clipboard == NULL) {
+        // we never own the clipboard
+        return true;
+    }
+    IClipboard::copy(&m_clipboard[id], clipboard);
+
+    if (m_recorder != NULL) {
+        std::size_t size = 0;
+        const Clipboard& copy = m_clipboard[id];
+        if (copy.open(0)) {
+            if (copy.has(IClipboard::kText)) {
+                size = copy.get(IClipboard::kText).size();
+            }
+            copy.close();
+        }
+        record(inputleap::string::sprintf("clipboard %d %u", id,
+                static_cast<unsigned int>(size)));
+    }
+    return true;
+}
+
+void
+VirtualScreen::checkClipboards()
+{
+    // do nothing
+}
+
+void
+VirtualScreen::openScreensaver(bool)
+{
+    // do nothing
+}
+
+void
+VirtualScreen::closeScreensaver()
+{
+    // do nothing
+}
+
+void
+VirtualScreen::screensaver(bool activate)
+{
+    record(activate ? "screensaver on" : "screensaver off");
+}
+
+void
+VirtualScreen::resetOptions()
+{
+    // do nothing
+}
+
+void
+VirtualScreen::setOptions(const OptionsList&)
+{
+    // do nothing
+}
+
+void
+VirtualScreen::setSequenceNumber(std::uint32_t seqNum)
+{
+    m_sequenceNumber = seqNum;
+}
+
+bool
+VirtualScreen::isPrimary() const
+{
+    return m_isPrimary;
+}
+
+bool
+VirtualScreen::isDraggingStarted()
+{
+    return m_draggingStarted;
+}
+
+void
+VirtualScreen::fakeDraggingFiles(DragFileList fileList)
+{
+    record(inputleap::string::sprintf("dragfiles %u",
+                static_cast<unsigned int>(fileList.size())));
+}
+
+const std::string&
+VirtualScreen::getDropTarget() const
+{
+    return m_dropTarget;
+}
+
+void
+VirtualScreen::setDropTarget(const std::string& target)
+{
+    m_dropTarget = target;
+}
+
+void
+VirtualScreen::handleSystemEvent(const Event&, void*)
+{
+    // do nothing
+}
+
+void
+VirtualScreen::updateButtons()
+{
+    // do nothing
+}
+
+IKeyState*
+VirtualScreen::getKeyState() const
+{
+    // every IKeyState method is overridden
+    return NULL;
+}
+
+void
+VirtualScreen::record(const std::string& line) const
+{
+    if (m_recorder != NULL) {
+        *m_recorder << line << '\n';
+    }
+}
+
+void
+VirtualScreen::sendClipboardEvent(Event::Type type, ClipboardID id)
+{
+    ClipboardInfo* info = static_cast<ClipboardInfo*>(malloc(sizeof(ClipboardInfo)));
+    info->m_id             = id;
+    info->m_sequenceNumber = m_sequenceNumber;
+    m_events->addEvent(Event(type, getEventTarget(), info));
+}
+
+void
+VirtualScreen::handleScriptTimer(const Event&, void*)
+{
+    runScript();
+}
+
+void
+VirtualScreen::runScript()
+{
+    stopScript();
+
+    const VirtualInputScript::StepList& steps = m_script.getSteps();
+    if (m_step >= steps.size()) {
+        LOG((CLOG_DEBUG "input script finished"));
+        return;
+    }
+
+    // run one step per turn of the event loop, like real input, so
+    // whatever a step causes (such as leaving the screen) happens
+    // before the next step.  timers only fire once the queue is
+    // empty so the shortest timer is enough.
+    const VirtualInputScript::Step& step = steps[m_step++];
+    double delay = kStepDelay;
+    switch (step.m_type) {
+    case VirtualInputScript::kWait:
+        delay = std::max(step.m_seconds, kStepDelay);
+        break;
+
+    case VirtualInputScript::kLoop:
+        m_step = 0;
+        break;
+
+    case VirtualInputScript::kQuit:
+        LOG((CLOG_NOTE "input script quit"));
+        m_events->addEvent(Event(Event::kQuit));
+        return;
+
+    default:
+        runStep(step);
+        break;
+    }
+
+    startTimer(delay, &VirtualScreen::handleScriptTimer);
+}
+
+void
+VirtualScreen::runStep(const VirtualInputScript::Step& step)
+{
+    KeyButton button;
+    switch (step.m_type) {
+    case VirtualInputScript::kMove:
+        moveTo(step.m_x, step.m_y);
+        break;
+
+    case VirtualInputScript::kMoveBy:
+        moveTo(m_xCursor + step.m_x, m_yCursor + step.m_y);
+        break;
+
+    case VirtualInputScript::kButtonDown:
+    case VirtualInputScript::kButtonUp:
+        m_buttons[step.m_button] = (step.m_type == VirtualInputScript::kButtonDown);
+        m_events->addEvent(Event(m_buttons[step.m_button] ?
+                            m_events->forIPrimaryScreen().buttonDown() :
+                            m_events->forIPrimaryScreen().buttonUp(),
+                            getEventTarget(),
+                            ButtonInfo::alloc(step.m_button, m_modifiers)));
+        break;
+
+    case VirtualInputScript::kWheel:
+        m_events->addEvent(Event(m_events->forIPrimaryScreen().wheel(),
+                            getEventTarget(),
+                            WheelInfo::alloc(step.m_x, step.m_y)));
+        break;
+
+    case VirtualInputScript::kKeyDown:
+        button = scriptButton(step.m_key);
+        m_keys[button] = step.m_key;
+        m_modifiers    = step.m_mask;
+        m_events->addEvent(Event(m_events->forIKeyState().keyDown(),
+                            getEventTarget(),
+                            KeyInfo::alloc(step.m_key, step.m_mask, button, 1)));
+        break;
+
+    case VirtualInputScript::kKeyUp:
+        button = scriptButton(step.m_key);
+        m_keys.erase(button);
+        m_events->addEvent(Event(m_events->forIKeyState().keyUp(),
+                            getEventTarget(),
+                            KeyInfo::alloc(step.m_key, step.m_mask, button, 1)));
+        if (m_keys.empty()) {
+            m_modifiers = 0;
+        }
+        break;
+
+    case VirtualInputScript::kClipboard: {
+        Clipboard& clipboard = m_clipboard[kClipboardClipboard];
+        clipboard.open(0);
+        clipboard.empty();
+        clipboard.add(IClipboard::kText, step.m_text);
+        clipboard.close();
+        sendClipboardEvent(m_events->forClipboard().clipboardGrabbed(), kClipboardClipboard);
+        sendClipboardEvent(m_events->forClipboard().clipboardChanged(), kClipboardClipboard);
+        break;
+    }
+
+    default:
+        break;
+    }
+}
+
+void
+VirtualScreen::moveTo(std::int32_t x, std::int32_t y)
+{
+    if (m_isOnScreen) {
+        // the pointer can't leave the screen
+        x = std::max(m_x, std::min(x, m_x + m_w - 1));
+        y = std::max(m_y, std::min(y, m_y + m_h - 1));
+        m_xCursor = x;
+        m_yCursor = y;
+        m_events->addEvent(Event(m_events->forIPrimaryScreen().motionOnPrimary(),
+                            getEventTarget(), MotionInfo::alloc(x, y)));
+    }
+    else {
+        std::int32_t dx = x - m_xCursor;
+        std::int32_t dy = y - m_yCursor;
+        m_xCursor = x;
+        m_yCursor = y;
+        m_events->addEvent(Event(m_events->forIPrimaryScreen().motionOnSecondary(),
+                            getEventTarget(), MotionInfo::alloc(dx, dy)));
+    }
+}
+
+void
+VirtualScreen::stopScript()
+{
+    if (m_scriptTimer != NULL) {
+        m_events->removeHandler(Event::kTimer, m_scriptTimer);
+        m_events->deleteTimer(m_scriptTimer);
+        m_scriptTimer = NULL;
+    }
+}
+
+void
+VirtualScreen::handleTraceTimer(const Event&, void*)
+{
+    runTrace();
+}
+
+void
+VirtualScreen::runTrace()
+{
+    stopScript();
+
+    if (m_traceRecord >= m_trace.size()) {
+        LOG((CLOG_NOTE "input trace replay finished in %.3f s",
+                            inputleap::current_time_seconds() - m_traceStart));
+        m_events->addEvent(Event(Event::kQuit));
+        return;
+    }
+
+    // one record per turn of the event loop, like the script
+    replayRecord(m_trace[m_traceRecord++]);
+    if (m_traceRecord == m_trace.size()) {
+        startTimer(kStepDelay, &VirtualScreen::handleTraceTimer);
+        return;
+    }
+
+    // wait until the next record is due.  times are relative to the
+    // start so the replay doesn't drift when the server falls behind.
+    double delay = kStepDelay;
+    if (m_traceSpeed > 0.0) {
+        double due = m_traceStart +
+                        1.0e-6 * static_cast<double>(m_trace[m_traceRecord].m_time) /
+                        m_traceSpeed;
+        delay = std::max(due - inputleap::current_time_seconds(), kStepDelay);
+    }
+    startTimer(delay, &VirtualScreen::handleTraceTimer);
+}
+
+void
+VirtualScreen::replayRecord(const InputTrace::Record& record)
+{
+    switch (record.m_type) {
+    case InputTrace::kMotionPrimary:
+        m_xCursor = record.m_x;
+        m_yCursor = record.m_y;
+        m_events->addEvent(Event(m_events->forIPrimaryScreen().motionOnPrimary(),
+                            getEventTarget(), MotionInfo::alloc(record.m_x, record.m_y)));
+        break;
+
+    case InputTrace::kMotionSecondary:
+        m_events->addEvent(Event(m_events->forIPrimaryScreen().motionOnSecondary(),
+                            getEventTarget(), MotionInfo::alloc(record.m_x, record.m_y)));
+        break;
+
+    case InputTrace::kWheel:
+        m_events->addEvent(Event(m_events->forIPrimaryScreen().wheel(),
+                            getEventTarget(), WheelInfo::alloc(record.m_x, record.m_y)));
+        break;
+
+    case InputTrace::kButtonDown:
+    case InputTrace::kButtonUp:
+        if (record.m_button < NumButtonIDs) {
+            m_buttons[record.m_button] = (record.m_type == InputTrace::kButtonDown);
+        }
+        m_events->addEvent(Event(record.m_type == InputTrace::kButtonDown ?
+                            m_events->forIPrimaryScreen().buttonDown() :
+                            m_events->forIPrimaryScreen().buttonUp(),
+                            getEventTarget(),
+                            ButtonInfo::alloc(static_cast<ButtonID>(record.m_button),
+                                                record.m_mask)));
+        break;
+
+    case InputTrace::kKeyDown:
+    case InputTrace::kKeyRepeat:
+        m_keys[record.m_button] = record.m_key;
+        m_modifiers = record.m_mask;
+        m_events->addEvent(Event(record.m_type == InputTrace::kKeyDown ?
+                            m_events->forIKeyState().keyDown() :
+                            m_events->forIKeyState().keyRepeat(),
+                            getEventTarget(),
+                            KeyInfo::alloc(record.m_key, record.m_mask, record.m_button,
+                                            record.m_type == InputTrace::kKeyDown ?
+                                            1 : record.m_count)));
+        break;
+
+    case InputTrace::kKeyUp:
+        m_keys.erase(record.m_button);
+        m_modifiers = record.m_mask;
+        m_events->addEvent(Event(m_events->forIKeyState().keyUp(),
+                            getEventTarget(),
+                            KeyInfo::alloc(record.m_key, record.m_mask, record.m_button, 1)));
+        break;
+
+    case InputTrace::kHotKeyDown:
+    case InputTrace::kHotKeyUp:
+        m_events->addEvent(Event(record.m_type == InputTrace::kHotKeyDown ?
+                            m_events->forIPrimaryScreen().hotKeyDown() :
+                            m_events->forIPrimaryScreen().hotKeyUp(),
+                            getEventTarget(), HotKeyInfo::alloc(record.m_id)));
+        break;
+
+    case InputTrace::kSwitch:
+        LOG((CLOG_DEBUG "trace switched to \"%s\" at %d,%d",
+                            record.m_screen.c_str(), record.m_x, record.m_y));
+        break;
+    }
+}
+
+void
+VirtualScreen::startTimer(double delay,
+                void (VirtualScreen::*handler)(const Event&, void*))
+{
+    m_scriptTimer = m_events->newOneShotTimer(delay, NULL);
+    m_events->adoptHandler(Event::kTimer, m_scriptTimer,
+                        new TMethodEventJob<VirtualScreen>(this, handler));
+}
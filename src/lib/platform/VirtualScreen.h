@@ -0,0 +1,206 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "platform/VirtualInputScript.h"
+#include "inputleap/InputTraceReader.h"
+#include "inputleap/PlatformScreen.h"
+#include "inputleap/Clipboard.h"
+
+#include <fstream>
+#include <map>
+#include <ostream>
+
+class EventQueueTimer;
+
+//! Screen that exists only in memory
+/*!
+A screen with no display behind it, for running the server and client
+where there's no display and for measuring them without a display
+server adding noise.  It has whatever shape it's given and keeps its
+key state and clipboards in memory.
+
+As a primary screen it reports the input in its script or input trace,
+if any.  As either kind of screen it can write a line to a recorder for
+each input it's asked to synthesize and each clipboard it's given.
+*/
+class VirtualScreen : public PlatformScreen {
+public:
+    VirtualScreen(IEventQueue* events, bool isPrimary,
+                  std::int32_t x, std::int32_t y,
+                  std::int32_t width, std::int32_t height);
+    ~VirtualScreen() override;
+
+    //! @name manipulators
+    //@{
+
+    //! Set the input to report
+    /*!
+    Starts reporting the steps in \p script when the screen is enabled.
+    Only primary screens report input.
+    */
+    void                setScript(const VirtualInputScript& script);
+
+    //! Set an input trace to replay
+    /*!
+    Starts reporting the input in \p records when the screen is enabled,
+    at \p speed times the speed it was recorded at or as fast as the
+    server takes it if \p speed is 0, then quits the app.  Even as fast
+    as possible the replay waits as long before the first record as the
+    recording did, which gives clients time to connect.  Screen
+    switches in the trace are skipped;  the server makes its own.  Hot
+    keys are reported with the ids they were recorded with so the
+    server should have the same configuration it had when recording.
+    Only primary screens report input.
+    */
+    void                setTrace(const InputTraceReader::RecordList& records,
+                            double speed);
+
+    //! Set the recorder
+    /*!
+    Writes a line to \p recorder for each synthesized input and each
+    clipboard set on the screen.  \p recorder must outlive the screen.
+    Pass NULL to stop recording.
+    */
+    void                setRecorder(std::ostream* recorder);
+
+    //! Record to a file
+    /*!
+    Like setRecorder() with a file the screen owns.  Returns false if
+    the file can't be created.
+    */
+    bool                openRecordFile(const std::string& path);
+
+    //@}
+
+    // IScreen overrides
+    void* getEventTarget() const override;
+    bool getClipboard(ClipboardID id, IClipboard*) const override;
+    void getShape(std::int32_t& x, std::int32_t& y, std::int32_t& width,
+                  std::int32_t& height) const override;
+    void getCursorPos(std::int32_t& x, std::int32_t& y) const override;
+
+    // IPrimaryScreen overrides
+    void reconfigure(std::uint32_t activeSides) override;
+    void warpCursor(std::int32_t x, std::int32_t y) override;
+    std::uint32_t registerHotKey(KeyID key, KeyModifierMask mask) override;
+    void unregisterHotKey(std::uint32_t id) override;
+    void fakeInputBegin() override;
+    void fakeInputEnd() override;
+    std::int32_t getJumpZoneSize() const override;
+    bool isAnyMouseButtonDown(std::uint32_t& buttonID) const override;
+    void getCursorCenter(std::int32_t& x, std::int32_t& y) const override;
+
+    // ISecondaryScreen overrides
+    void fakeMouseButton(ButtonID id, bool press) override;
+    void fakeMouseMove(std::int32_t x, std::int32_t y) override;
+    void fakeMouseRelativeMove(std::int32_t dx, std::int32_t dy) const override;
+    void fakeMouseWheel(std::int32_t xDelta, std::int32_t yDelta) const override;
+
+    // IKeyState overrides
+    void updateKeyMap() override;
+    void updateKeyState() override;
+    void setHalfDuplexMask(KeyModifierMask) override;
+    void fakeKeyDown(KeyID id, KeyModifierMask mask, KeyButton button) override;
+    bool fakeKeyRepeat(KeyID id, KeyModifierMask mask, std::int32_t count,
+                       KeyButton button) override;
+    bool fakeKeyUp(KeyButton button) override;
+    void fakeAllKeysUp() override;
+    bool fakeCtrlAltDel() override;
+    bool isKeyDown(KeyButton) const override;
+    KeyModifierMask getActiveModifiers() const override;
+    KeyModifierMask pollActiveModifiers() const override;
+    std::int32_t pollActiveGroup() const override;
+    void pollPressedKeys(KeyButtonSet& pressedKeys) const override;
+
+    // IPlatformScreen overrides
+    void enable() override;
+    void disable() override;
+    void enter() override;
+    bool leave() override;
+    bool setClipboard(ClipboardID, const IClipboard*) override;
+    void checkClipboards() override;
+    void openScreensaver(bool notify) override;
+    void closeScreensaver() override;
+    void screensaver(bool activate) override;
+    void resetOptions() override;
+    void setOptions(const OptionsList& options) override;
+    void setSequenceNumber(std::uint32_t) override;
+    bool isPrimary() const override;
+    bool isDraggingStarted() override;
+    void fakeDraggingFiles(DragFileList fileList) override;
+    const std::string& getDropTarget() const override;
+    void setDropTarget(const std::string&) override;
+
+protected:
+    // IPlatformScreen overrides
+    void handleSystemEvent(const Event& event, void*) override;
+    void updateButtons() override;
+    IKeyState* getKeyState() const override;
+
+    //! Write a line to the recorder, if there is one
+    void                record(const std::string& line) const;
+
+    //! Report a clipboard change to the server
+    void                sendClipboardEvent(Event::Type type, ClipboardID id);
+
+private:
+    void                handleScriptTimer(const Event&, void*);
+    void                runScript();
+    void                runStep(const VirtualInputScript::Step& step);
+    void                moveTo(std::int32_t x, std::int32_t y);
+    void                stopScript();
+    void                handleTraceTimer(const Event&, void*);
+    void                runTrace();
+    void                replayRecord(const InputTrace::Record& record);
+    void                startTimer(double delay,
+                            void (VirtualScreen::*handler)(const Event&, void*));
+
+protected:
+    IEventQueue*        m_events;
+
+private:
+    bool                m_isPrimary;
+    bool                m_isOnScreen;
+    std::int32_t        m_x, m_y, m_w, m_h;
+    std::int32_t        m_xCursor, m_yCursor;
+    std::uint32_t        m_sequenceNumber;
+    Clipboard            m_clipboard[kClipboardEnd];
+    std::string            m_dropTarget;
+    std::uint32_t        m_nextHotKeyID;
+
+    // input state
+    std::map<KeyButton, KeyID> m_keys;
+    KeyModifierMask        m_modifiers;
+    bool                m_buttons[NumButtonIDs];
+
+    // script
+    VirtualInputScript    m_script;
+    std::size_t            m_step;
+    EventQueueTimer*    m_scriptTimer;
+
+    // trace
+    InputTraceReader::RecordList m_trace;
+    std::size_t            m_traceRecord;
+    double                m_traceSpeed;
+    double                m_traceStart;
+
+    // recorder
+    std::ostream*        m_recorder;
+    std::ofstream        m_recordFile;
+};
@@ -31,6 +31,7 @@
 #include "base/Stopwatch.h"
 #include "common/stdvector.h"
 
+#include <algorithm>
 #include <cstdio>
 #include <cstring>
 #include <X11/Xatom.h>
@@ -48,7 +49,16 @@ XWindowsClipboard::XWindowsClipboard(IXWindowsImpl* impl, Display* display,
     m_time(0),
     m_owner(false),
     m_timeOwned(0),
-    m_timeLost(0)
+    m_timeLost(0),
+    m_cacheTime(0),
+    m_haveTargets(false),
+    m_fetch(NULL),
+    m_fetchTimeout(5.0),
+    m_fetchTime(0),
+    m_fetchIndex(0),
+    m_fetchTarget(None),
+    m_fetchChanged(false),
+    m_fetchEnded(false)
 {
     m_impl = impl;
     // get some atoms
@@ -58,8 +68,6 @@ XWindowsClipboard::XWindowsClipboard(IXWindowsImpl* impl, Display* display,
     m_atomInteger         = m_impl->XInternAtom(m_display, "INTEGER", False);
     m_atomAtom            = m_impl->XInternAtom(m_display, "ATOM", False);
     m_atomAtomPair        = m_impl->XInternAtom(m_display, "ATOM_PAIR", False);
-    m_atomData            = m_impl->XInternAtom(m_display, "CLIP_TEMPORARY",
-                                                False);
     m_atomINCR            = m_impl->XInternAtom(m_display, "INCR", False);
     m_atomMotifClipLock   = m_impl->XInternAtom(m_display, "_MOTIF_CLIP_LOCK",
                                                 False);
@@ -82,6 +90,15 @@ XWindowsClipboard::XWindowsClipboard(IXWindowsImpl* impl, Display* display,
         break;
     }
 
+    // the clipboards share a window so each converts into properties of
+    // its own.  background fetches get another so they can't be confused
+    // with a synchronous read.
+    char name[18 + 20];
+    sprintf(name, "CLIP_TEMPORARY_%d", id);
+    m_atomData            = m_impl->XInternAtom(m_display, name, False);
+    sprintf(name, "CLIP_FETCH_%d", id);
+    m_atomFetchData       = m_impl->XInternAtom(m_display, name, False);
+
     // add converters, most desired first
     m_converters.push_back(new XWindowsClipboardHTMLConverter(m_display,
                                 "text/html"));
@@ -109,6 +126,7 @@ XWindowsClipboard::XWindowsClipboard(IXWindowsImpl* impl, Display* display,
 
 XWindowsClipboard::~XWindowsClipboard()
 {
+    cancelFetch();
     clearReplies();
     clearConverters();
 }
@@ -122,6 +140,7 @@ XWindowsClipboard::lost(Time time)
         m_timeLost = time;
         clearCache();
     }
+    cancelFetch();
 }
 
 void
@@ -175,14 +194,18 @@ XWindowsClipboard::addSimpleRequest(Window requestor,
     }
 
     // handle targets
-    std::string data;
+    std::shared_ptr<const std::string> data;
     Atom type  = None;
     int format = 0;
     if (target == m_atomTargets) {
-        type = getTargetsData(data, &format);
+        std::string targets;
+        type = getTargetsData(targets, &format);
+        data = std::make_shared<const std::string>(std::move(targets));
     }
     else if (target == m_atomTimestamp) {
-        type = getTimestampData(data, &format);
+        std::string timestamp;
+        type = getTimestampData(timestamp, &format);
+        data = std::make_shared<const std::string>(std::move(timestamp));
     }
     else {
         IXWindowsClipboardConverter* converter = getConverter(target);
@@ -190,7 +213,15 @@ XWindowsClipboard::addSimpleRequest(Window requestor,
             IClipboard::EFormat clipboardFormat = converter->getFormat();
             if (m_added[clipboardFormat]) {
                 try {
-                    data   = converter->fromIClipboard(m_data[clipboardFormat]);
+                    // convert only on the first request for the target
+                    ConvertedMap::iterator index = m_converted.find(target);
+                    if (index == m_converted.end()) {
+                        index = m_converted.insert(std::make_pair(target,
+                                    std::make_shared<const std::string>(
+                                        converter->fromIClipboard(
+                                            m_data[clipboardFormat])))).first;
+                    }
+                    data   = index->second;
                     format = converter->getDataSize();
                     type   = converter->getAtom();
                 }
@@ -263,6 +294,72 @@ XWindowsClipboard::destroyRequest(Window requestor)
     return true;
 }
 
+void
+XWindowsClipboard::fetch(Time time)
+{
+    cancelFetch();
+
+    // nothing to fetch if we own the selection
+    if (m_owner) {
+        return;
+    }
+
+    // motif clipboards are read from the root window when opened
+    if (m_id == kClipboardClipboard && motifOwnsClipboard()) {
+        return;
+    }
+
+    LOG((CLOG_DEBUG "fetch clipboard %d in background", m_id));
+    m_fetchTime    = time;
+    m_fetchIndex   = 0;
+    m_fetchChanged = false;
+    startFetch(m_atomTimestamp);
+}
+
+bool
+XWindowsClipboard::processFetchEvent(XEvent* event)
+{
+    if (m_fetch == NULL || !m_fetch->processEvent(m_display, event)) {
+        return false;
+    }
+    if (m_fetch->isFinished()) {
+        continueFetch();
+    }
+    return true;
+}
+
+bool
+XWindowsClipboard::checkFetch()
+{
+    if (m_fetch != NULL && m_fetch->checkTimeout(m_fetchTimeout)) {
+        // the owner is too slow.  keep what we've got so far and don't
+        // ask for this format again.  the owner may still be writing
+        // to our property so the remaining formats have to wait for
+        // the next fetch.
+        LOG((CLOG_DEBUG "background fetch of clipboard %d timed out", m_id));
+        if (m_fetchIndex >= 2) {
+            m_fetched[m_fetchConverters[m_fetchIndex - 2]->getFormat()] = true;
+        }
+        cancelFetch();
+        endFetch();
+    }
+    return (m_fetch != NULL);
+}
+
+bool
+XWindowsClipboard::checkFetched()
+{
+    const bool ended = m_fetchEnded;
+    m_fetchEnded     = false;
+    return ended;
+}
+
+void
+XWindowsClipboard::setFetchTimeout(double seconds)
+{
+    m_fetchTimeout = seconds;
+}
+
 Window
 XWindowsClipboard::getWindow() const
 {
@@ -282,6 +379,9 @@ XWindowsClipboard::empty()
 
     LOG((CLOG_DEBUG "empty clipboard %d", m_id));
 
+    // we're about to replace the data so there's no point in fetching it
+    cancelFetch();
+
     // assert ownership of clipboard
     m_impl->XSetSelectionOwner(m_display, m_selection, m_window, m_time);
     if (m_impl->XGetSelectionOwner(m_display, m_selection) != m_window) {
@@ -292,7 +392,9 @@ XWindowsClipboard::empty()
     // clear all data.  since we own the data now, the cache is up
     // to date.
     clearCache();
-    m_cached = true;
+    for (std::int32_t index = 0; index < kNumFormats; ++index) {
+        m_fetched[index] = true;
+    }
 
     // FIXME -- actually delete motif clipboard items?
     // FIXME -- do anything to motif clipboard properties?
@@ -315,8 +417,11 @@ void XWindowsClipboard::add(EFormat format, const std::string& data)
 
     LOG((CLOG_DEBUG "add %d bytes to clipboard %d format: %d", data.size(), m_id, format));
 
-    m_data[format]  = data;
-    m_added[format] = true;
+    m_data[format]            = data;
+    m_added[format]           = true;
+    m_targetConverter[format] = NULL;
+    m_targetData[format].clear();
+    m_converted.clear();
 
     // FIXME -- set motif clipboard item?
 }
@@ -387,7 +492,7 @@ XWindowsClipboard::has(EFormat format) const
 {
     assert(m_open);
 
-    fillCache();
+    fillCache(format);
     return m_added[format];
 }
 
@@ -395,7 +500,8 @@ std::string XWindowsClipboard::get(EFormat format) const
 {
     assert(m_open);
 
-    fillCache();
+    fillCache(format);
+    convertCache(format);
     return m_data[format];
 }
 
@@ -444,16 +550,22 @@ XWindowsClipboard::checkCache() const
     }
     m_checkCache = false;
 
-    // get the time the clipboard ownership was taken by the current
-    // owner.
-    if (m_motif) {
-        m_timeOwned = motifGetTime();
+    // our own data is always up to date
+    if (m_owner) {
+        return;
     }
-    else {
-        m_timeOwned = icccmGetTime();
+
+    // a background fetch finds out when the owner took the selection
+    // and flushes the cache if it's changed hands.  we only have to
+    // ask for motif clipboards.
+    if (!m_motif) {
+        m_timeOwned = (m_cacheTime != 0) ? m_cacheTime : m_time;
+        return;
     }
 
-    // if we can't get the time then use the time passed to us
+    // get the time the clipboard ownership was taken by the current
+    // owner.  if we can't get the time then use the time passed to us.
+    m_timeOwned = motifGetTime();
     if (m_timeOwned == 0) {
         m_timeOwned = m_time;
     }
@@ -474,103 +586,239 @@ void
 XWindowsClipboard::doClearCache()
 {
     m_checkCache = false;
-    m_cached     = false;
     for (std::int32_t index = 0; index < kNumFormats; ++index) {
-        m_data[index]  = "";
-        m_added[index] = false;
-    }
+        m_data[index]            = "";
+        m_added[index]           = false;
+        m_fetched[index]         = false;
+        m_targetData[index]      = "";
+        m_targetConverter[index] = NULL;
+    }
+    m_haveTargets = false;
+    m_targets.clear();
+    m_converted.clear();
 }
 
 void
-XWindowsClipboard::fillCache() const
+XWindowsClipboard::fillCache(EFormat format) const
 {
-    // get the selection data if not already cached
+    // get the motif selection data for the format if not already cached.
+    // other selections are only fetched in the background so reading
+    // doesn't wait for the selection owner.
     checkCache();
-    if (!m_cached) {
-        const_cast<XWindowsClipboard*>(this)->doFillCache();
+    if (m_motif && !m_fetched[format]) {
+        const_cast<XWindowsClipboard*>(this)->doFillCache(format);
     }
 }
 
 void
-XWindowsClipboard::doFillCache()
+XWindowsClipboard::doFillCache(EFormat format)
 {
-    if (m_motif) {
-        motifFillCache();
-    }
-    else {
-        icccmFillCache();
+    motifFillCache(format);
+    m_checkCache      = false;
+    m_fetched[format] = true;
+    m_cacheTime       = m_timeOwned;
+}
+
+void
+XWindowsClipboard::addTargetData(IXWindowsClipboardConverter* converter,
+                const std::string& data)
+{
+    IClipboard::EFormat format = converter->getFormat();
+    m_targetData[format]      = data;
+    m_targetConverter[format] = converter;
+    m_added[format]           = true;
+}
+
+void
+XWindowsClipboard::convertCache(EFormat format) const
+{
+    if (m_targetConverter[format] != NULL) {
+        const_cast<XWindowsClipboard*>(this)->doConvertCache(format);
     }
-    m_checkCache = false;
-    m_cached     = true;
-    m_cacheTime  = m_timeOwned;
 }
 
 void
-XWindowsClipboard::icccmFillCache()
+XWindowsClipboard::doConvertCache(EFormat format)
 {
-    LOG((CLOG_DEBUG "ICCCM fill clipboard %d", m_id));
+    m_data[format] = m_targetConverter[format]->toIClipboard(m_targetData[format]);
+    m_targetConverter[format] = NULL;
+    m_targetData[format].clear();
+}
 
-    // see if we can get the list of available formats from the selection.
-    // if not then use a default list of formats.  note that some clipboard
-    // owners are broken and report TARGETS as the type of the TARGETS data
-    // instead of the correct type ATOM;  allow either.
-    const Atom atomTargets = m_atomTargets;
-    Atom target;
-    std::string data;
-    if (!icccmGetSelection(atomTargets, &target, &data) ||
-        (target != m_atomAtom && target != m_atomTargets)) {
-        LOG((CLOG_DEBUG1 "selection doesn't support TARGETS"));
-        data = "";
-        XWindowsUtil::appendAtomData(data, XA_STRING);
+void
+XWindowsClipboard::startFetch(Atom target)
+{
+    assert(m_fetch == NULL);
+
+    m_fetch = new CICCCMGetClipboard(m_window, m_fetchTime, m_atomFetchData);
+    m_fetch->start(m_display, m_selection, target, &m_fetchTarget, &m_fetchData);
+}
+
+void
+XWindowsClipboard::continueFetch()
+{
+    assert(m_fetch != NULL);
+    assert(m_fetch->isFinished());
+
+    // collect the result of the conversion that just finished
+    const bool success = (m_fetch->finish(m_display) && m_fetchTarget != None);
+    LOGC(m_fetch->m_error, (CLOG_WARN "ICCCM violation by clipboard owner"));
+    delete m_fetch;
+    m_fetch = NULL;
+
+    if (m_fetchIndex == 0) {
+        // the timestamp tells us if the cache already holds this
+        // selection.  if it doesn't then start over.
+        Time timeOwned = icccmGetTime(success ? m_fetchTarget : None, m_fetchData);
+        if (timeOwned == 0) {
+            timeOwned = m_fetchTime;
+        }
+        if (timeOwned != m_cacheTime) {
+            doClearCache();
+            m_cacheTime    = timeOwned;
+            m_fetchChanged = true;
+        }
+        m_fetchData.clear();
+
+        // find out which targets the owner has unless we already know
+        if (!m_haveTargets) {
+            m_fetchIndex = 1;
+            startFetch(m_atomTargets);
+            return;
+        }
+    }
+    else if (m_fetchIndex == 1) {
+        icccmSetTargets(success ? m_fetchTarget : None, m_fetchData);
+        m_fetchData.clear();
+    }
+    else {
+        // add to clipboard and note we've done it
+        IXWindowsClipboardConverter* converter =
+                                m_fetchConverters[m_fetchIndex - 2];
+        Atom target = converter->getAtom();
+        if (success) {
+            LOG((CLOG_DEBUG "added format %d for target %s (%u %s)", converter->getFormat(), XWindowsUtil::atomToString(m_display, target).c_str(), m_fetchData.size(), m_fetchData.size() == 1 ? "byte" : "bytes"));
+            addTargetData(converter, m_fetchData);
+            m_fetchChanged = true;
+        }
+        else {
+            LOG((CLOG_DEBUG1 "  no data for target %s", XWindowsUtil::atomToString(m_display, target).c_str()));
+        }
+        m_fetchData.clear();
+        fetchNextData();
+        return;
     }
 
-    XWindowsUtil::convertAtomProperty(data);
-    const Atom* targets = reinterpret_cast<const Atom*>(data.data()); // TODO: Safe?
-    const std::uint32_t numTargets = data.size() / sizeof(Atom);
-    LOG((CLOG_DEBUG "  available targets: %s", XWindowsUtil::atomsToString(m_display, targets, numTargets).c_str()));
+    startFetchData();
+}
 
-    // try each converter in order (because they're in order of
-    // preference).
+void
+XWindowsClipboard::startFetchData()
+{
+    // i've seen clipboard owners that don't report all the targets they
+    // support so only rule a target out if the owner reported any of
+    // the targets we know.
+    bool knownTargets = false;
     for (ConverterList::const_iterator index = m_converters.begin();
                                 index != m_converters.end(); ++index) {
-        IXWindowsClipboardConverter* converter = *index;
+        if (std::find(m_targets.begin(), m_targets.end(),
+                                (*index)->getAtom()) != m_targets.end()) {
+            knownTargets = true;
+            break;
+        }
+    }
 
-        // skip already handled targets
-        if (m_added[converter->getFormat()]) {
+    // queue the targets of each format we haven't fetched, in order of
+    // preference.  formats are fetched in order so a slow bitmap can't
+    // keep us from getting the text.
+    m_fetchConverters.clear();
+    for (std::int32_t format = 0; format < kNumFormats; ++format) {
+        if (m_fetched[format]) {
             continue;
         }
+        for (ConverterList::const_iterator index = m_converters.begin();
+                                index != m_converters.end(); ++index) {
+            IXWindowsClipboardConverter* converter = *index;
+            if (converter->getFormat() != format) {
+                continue;
+            }
 
-        // see if atom is in target list
-        // XXX -- just ask for the converter's target to see if it's
-        // available rather than checking TARGETS.  i've seen clipboard
-        // owners that don't report all the targets they support.
-        target = converter->getAtom();
-        /*
-        for (std::uint32_t i = 0; i < numTargets; ++i) {
-            if (converter->getAtom() == targets[i]) {
-                target = targets[i];
-                break;
+            // skip targets the owner doesn't have
+            Atom target = converter->getAtom();
+            if (knownTargets && std::find(m_targets.begin(), m_targets.end(),
+                                target) == m_targets.end()) {
+                LOG((CLOG_DEBUG1 "  target %s not available", XWindowsUtil::atomToString(m_display, target).c_str()));
+                continue;
             }
+            m_fetchConverters.push_back(converter);
         }
-        */
-        if (target == None) {
-            continue;
-        }
+    }
 
-        // get the data
-        Atom actualTarget;
-        std::string targetData;
-        if (!icccmGetSelection(target, &actualTarget, &targetData)) {
-            LOG((CLOG_DEBUG1 "  no data for target %s", XWindowsUtil::atomToString(m_display, target).c_str()));
-            continue;
+    m_fetchIndex = 1;
+    fetchNextData();
+}
+
+void
+XWindowsClipboard::fetchNextData()
+{
+    // convert the next target of a format we don't have yet
+    while (++m_fetchIndex - 2 < m_fetchConverters.size()) {
+        IXWindowsClipboardConverter* converter =
+                                m_fetchConverters[m_fetchIndex - 2];
+        if (!m_added[converter->getFormat()]) {
+            startFetch(converter->getAtom());
+            return;
         }
+    }
 
-        // add to clipboard and note we've done it
-        IClipboard::EFormat format = converter->getFormat();
-        m_data[format]  = converter->toIClipboard(targetData);
-        m_added[format] = true;
-        LOG((CLOG_DEBUG "added format %d for target %s (%u %s)", format, XWindowsUtil::atomToString(m_display, target).c_str(), targetData.size(), targetData.size() == 1 ? "byte" : "bytes"));
+    // every format has been tried
+    for (std::int32_t format = 0; format < kNumFormats; ++format) {
+        m_fetched[format] = true;
+    }
+    endFetch();
+}
+
+void
+XWindowsClipboard::endFetch()
+{
+    LOG((CLOG_DEBUG "fetched clipboard %d", m_id));
+    m_fetchConverters.clear();
+    if (m_fetchChanged) {
+        m_fetchChanged = false;
+        m_fetchEnded   = true;
+    }
+}
+
+void
+XWindowsClipboard::cancelFetch()
+{
+    if (m_fetch != NULL) {
+        LOG((CLOG_DEBUG1 "cancel background fetch of clipboard %d", m_id));
+        m_fetch->finish(m_display);
+        delete m_fetch;
+        m_fetch = NULL;
+        m_fetchData.clear();
+    }
+}
+
+void
+XWindowsClipboard::icccmSetTargets(Atom actualTarget, std::string& data)
+{
+    m_haveTargets = true;
+    m_targets.clear();
+
+    // note that some clipboard owners are broken and report TARGETS as
+    // the type of the TARGETS data instead of the correct type ATOM;
+    // allow either.
+    if (actualTarget != m_atomAtom && actualTarget != m_atomTargets) {
+        LOG((CLOG_DEBUG1 "selection doesn't support TARGETS"));
+        return;
     }
+
+    XWindowsUtil::convertAtomProperty(data);
+    const Atom* targets = reinterpret_cast<const Atom*>(data.data());
+    m_targets.assign(targets, targets + data.size() / sizeof(Atom));
+    LOG((CLOG_DEBUG "  available targets: %s", XWindowsUtil::atomsToString(m_display, m_targets.data(), m_targets.size()).c_str()));
 }
 
 bool
@@ -600,8 +848,16 @@ XWindowsClipboard::icccmGetTime() const
 {
     Atom actualTarget;
     std::string data;
-    if (icccmGetSelection(m_atomTimestamp, &actualTarget, &data) &&
-        actualTarget == m_atomInteger) {
+    if (!icccmGetSelection(m_atomTimestamp, &actualTarget, &data)) {
+        actualTarget = None;
+    }
+    return icccmGetTime(actualTarget, data);
+}
+
+IClipboard::Time
+XWindowsClipboard::icccmGetTime(Atom actualTarget, const std::string& data) const
+{
+    if (actualTarget == m_atomInteger && data.size() >= sizeof(Time)) {
         Time time = *reinterpret_cast<const Time*>(data.data());
         LOG((CLOG_DEBUG1 "got ICCCM time %d", time));
         return time;
@@ -692,9 +948,9 @@ XWindowsClipboard::motifOwnsClipboard() const
 }
 
 void
-XWindowsClipboard::motifFillCache()
+XWindowsClipboard::motifFillCache(EFormat clipboardFormat)
 {
-    LOG((CLOG_DEBUG "Motif fill clipboard %d", m_id));
+    LOG((CLOG_DEBUG "Motif fill clipboard %d format %d", m_id, clipboardFormat));
 
     // get the Motif clipboard header property from the root window
     Atom target;
@@ -780,8 +1036,9 @@ XWindowsClipboard::motifFillCache()
                                 index != m_converters.end(); ++index) {
         IXWindowsClipboardConverter* converter = *index;
 
-        // skip already handled targets
-        if (m_added[converter->getFormat()]) {
+        // skip other formats and already handled targets
+        if (converter->getFormat() != clipboardFormat ||
+            m_added[clipboardFormat]) {
             continue;
         }
 
@@ -806,10 +1063,8 @@ XWindowsClipboard::motifFillCache()
         }
 
         // add to clipboard and note we've done it
-        IClipboard::EFormat clipboard_format = converter->getFormat();
-        m_data[clipboard_format]  = converter->toIClipboard(targetData);
-        m_added[clipboard_format] = true;
-        LOG((CLOG_DEBUG "added format %d for target %s", clipboard_format,
+        addTargetData(converter, targetData);
+        LOG((CLOG_DEBUG "added format %d for target %s", clipboardFormat,
              XWindowsUtil::atomToString(m_display, target).c_str()));
     }
 }
@@ -890,7 +1145,9 @@ XWindowsClipboard::insertMultipleReply(Window requestor,
 
     // add reply for MULTIPLE request
     insertReply(new Reply(requestor, m_atomMultiple,
-                                time, property, std::string(), None, 32));
+                                time, property,
+                                std::make_shared<const std::string>(),
+                                None, 32));
 
     return true;
 }
@@ -1013,13 +1270,16 @@ XWindowsClipboard::sendReply(Reply* reply)
         LOG((CLOG_DEBUG1 "clipboard: setting property on 0x%08x,%d,%d", reply->m_requestor, reply->m_target, reply->m_property));
 
         // send using INCR if already sending incrementally or if reply
-        // is too large, otherwise just send it.
-        const std::uint32_t maxRequestSize = 3 * XMaxRequestSize(m_display);
-        const bool useINCR = (reply->m_data.size() > maxRequestSize);
+        // is too large, otherwise just send it.  chunks are as large as
+        // the server allows so a big transfer takes few round trips.
+        const std::string& data = *reply->m_data;
+        const std::uint32_t maxRequestSize =
+                                XWindowsUtil::getMaxPropertySize(m_display);
+        const bool useINCR = (data.size() > maxRequestSize);
 
         // send INCR reply if incremental and we haven't replied yet
         if (useINCR && !reply->m_replied) {
-            std::uint32_t size = reply->m_data.size();
+            std::uint32_t size = data.size();
             if (!XWindowsUtil::setWindowProperty(m_display,
                                 reply->m_requestor, reply->m_property,
                                 &size, 4, m_atomINCR, 32)) {
@@ -1030,14 +1290,14 @@ XWindowsClipboard::sendReply(Reply* reply)
         // send more INCR reply or entire non-incremental reply
         else {
             // how much more data should we send?
-            std::uint32_t size = reply->m_data.size() - reply->m_ptr;
+            std::uint32_t size = data.size() - reply->m_ptr;
             if (size > maxRequestSize)
                 size = maxRequestSize;
 
             // send it
             if (!XWindowsUtil::setWindowProperty(m_display,
                                 reply->m_requestor, reply->m_property,
-                                reply->m_data.data() + reply->m_ptr,
+                                data.data() + reply->m_ptr,
                                 size,
                                 reply->m_type, reply->m_format)) {
                 failed = true;
@@ -1096,7 +1356,7 @@ XWindowsClipboard::sendReply(Reply* reply)
         // log.  we've seen what appears to be a bug in lesstif and
         // knowing the properties may help design a workaround, if
         // it becomes necessary.
-        if (CLOG->getFilter() >= kDEBUG2) {
+        if (Log::isEnabled(INPUTLEAP_LOG_CATEGORY, kDEBUG2)) {
             XWindowsUtil::ErrorLock lock(m_display);
             int n;
             Atom* props = m_impl->XListProperties(m_display, reply->m_requestor,
@@ -1263,17 +1523,23 @@ Atom XWindowsClipboard::getTimestampData(std::string& data, int* format) const
 // XWindowsClipboard::CICCCMGetClipboard
 //
 
+XWindowsClipboard::CICCCMGetClipboard::WatchedWindows
+                    XWindowsClipboard::CICCCMGetClipboard::s_watched;
+
 XWindowsClipboard::CICCCMGetClipboard::CICCCMGetClipboard(
                 Window requestor, Time time, Atom property) :
     m_requestor(requestor),
     m_time(time),
     m_property(property),
+    m_selection(None),
+    m_target(None),
     m_incr(false),
     m_failed(false),
     m_done(false),
     m_reading(false),
     m_data(NULL),
     m_actualTarget(NULL),
+    m_watching(false),
     m_error(false)
 {
     // do nothing
@@ -1287,6 +1553,19 @@ XWindowsClipboard::CICCCMGetClipboard::~CICCCMGetClipboard()
 bool
 XWindowsClipboard::CICCCMGetClipboard::readClipboard(Display* display,
                 Atom selection, Atom target, Atom* actualTarget, std::string* data)
+{
+    start(display, selection, target, actualTarget, data);
+
+    // synchronize with server before we start following timeout countdown
+    XSync(display, False);
+
+    wait(display);
+    return finish(display);
+}
+
+void
+XWindowsClipboard::CICCCMGetClipboard::start(Display* display,
+                Atom selection, Atom target, Atom* actualTarget, std::string* data)
 {
     assert(actualTarget != NULL);
     assert(data         != NULL);
@@ -1297,6 +1576,8 @@ XWindowsClipboard::CICCCMGetClipboard::readClipboard(Display* display,
     m_atomIncr = XInternAtom(display, "INCR", False);
 
     // save output pointers
+    m_selection    = selection;
+    m_target       = target;
     m_actualTarget = actualTarget;
     m_data         = data;
 
@@ -1308,53 +1589,45 @@ XWindowsClipboard::CICCCMGetClipboard::readClipboard(Display* display,
     XDeleteProperty(display, m_requestor, m_property);
 
     // select window for property changes
-    XWindowAttributes attr;
-    XGetWindowAttributes(display, m_requestor, &attr);
-    XSelectInput(display, m_requestor,
-                                attr.your_event_mask | PropertyChangeMask);
+    watch(display);
 
     // request data conversion
     XConvertSelection(display, selection, target,
                                 m_property, m_requestor, m_time);
+    XFlush(display);
 
-    // synchronize with server before we start following timeout countdown
-    XSync(display, False);
+    m_timeout.reset();
+}
 
+void
+XWindowsClipboard::CICCCMGetClipboard::wait(Display* display)
+{
     // Xlib inexplicably omits the ability to wait for an event with
     // a timeout.  (it's inexplicable because there's no portable way
     // to do it.)  we'll poll until we have what we're looking for or
     // a timeout expires.  we use a timeout so we don't get locked up
-    // by badly behaved selection owners.
+    // by badly behaved selection owners.  the owner's progress doesn't
+    // extend the timeout so a slow INCR transfer can't stall us.
     XEvent xevent;
     std::vector<XEvent> events;
-    Stopwatch timeout(false);    // timer not stopped, not triggered
     static const double s_timeout = 0.25;    // FIXME -- is this too short?
-    bool noWait = false;
-    while (!m_done && !m_failed) {
+    m_timeout.reset();
+    while (!isFinished()) {
         // fail if timeout has expired
-        if (timeout.getTime() >= s_timeout) {
-            m_failed = true;
+        if (checkTimeout(s_timeout)) {
             break;
         }
 
-        // process events if any otherwise sleep
-        if (noWait || XPending(display) > 0) {
-            while (!m_done && !m_failed && (noWait || XPending(display) > 0)) {
+        // process events if any otherwise sleep.  we never block in
+        // XNextEvent() since a stalled owner would then never let the
+        // timeout expire.
+        if (XPending(display) > 0) {
+            while (!isFinished() && XPending(display) > 0) {
                 XNextEvent(display, &xevent);
                 if (!processEvent(display, &xevent)) {
                     // not processed so save it
                     events.push_back(xevent);
                 }
-                else {
-                    // reset timer since we've made some progress
-                    timeout.reset();
-
-                    // don't sleep anymore, just block waiting for events.
-                    // we're assuming here that the clipboard owner will
-                    // complete the protocol correctly.  if we continue to
-                    // sleep we'll get very bad performance.
-                    noWait = true;
-                }
             }
         }
         else {
@@ -1366,15 +1639,67 @@ XWindowsClipboard::CICCCMGetClipboard::readClipboard(Display* display,
     for (std::uint32_t i = events.size(); i > 0; --i) {
         XPutBackEvent(display, &events[i - 1]);
     }
+}
+
+bool
+XWindowsClipboard::CICCCMGetClipboard::checkTimeout(double timeout)
+{
+    if (!isFinished() && m_timeout.getTime() >= timeout) {
+        m_failed = true;
+    }
+    return m_failed;
+}
 
+bool
+XWindowsClipboard::CICCCMGetClipboard::isFinished() const
+{
+    return (m_done || m_failed);
+}
+
+bool
+XWindowsClipboard::CICCCMGetClipboard::finish(Display* display)
+{
     // restore mask
-    XSelectInput(display, m_requestor, attr.your_event_mask);
+    unwatch(display);
 
     // return success or failure
-    LOG((CLOG_DEBUG1 "request %s after %fs", m_failed ? "failed" : "succeeded", timeout.getTime()));
+    LOG((CLOG_DEBUG1 "request %s after %fs", m_failed ? "failed" : "succeeded", m_timeout.getTime()));
     return !m_failed;
 }
 
+void
+XWindowsClipboard::CICCCMGetClipboard::watch(Display* display)
+{
+    if (m_watching) {
+        return;
+    }
+    m_watching = true;
+
+    WatchedWindow& watched = s_watched[m_requestor];
+    if (watched.m_count++ == 0) {
+        XWindowAttributes attr;
+        XGetWindowAttributes(display, m_requestor, &attr);
+        watched.m_eventMask = attr.your_event_mask;
+        XSelectInput(display, m_requestor, watched.m_eventMask | PropertyChangeMask);
+    }
+}
+
+void
+XWindowsClipboard::CICCCMGetClipboard::unwatch(Display* display)
+{
+    if (!m_watching) {
+        return;
+    }
+    m_watching = false;
+
+    WatchedWindows::iterator index = s_watched.find(m_requestor);
+    assert(index != s_watched.end());
+    if (--index->second.m_count == 0) {
+        XSelectInput(display, m_requestor, index->second.m_eventMask);
+        s_watched.erase(index);
+    }
+}
+
 bool
 XWindowsClipboard::CICCCMGetClipboard::processEvent(
                 Display* display, XEvent* xevent)
@@ -1391,7 +1716,10 @@ XWindowsClipboard::CICCCMGetClipboard::processEvent(
         return false;
 
     case SelectionNotify:
-        if (xevent->xselection.requestor == m_requestor) {
+        // ignore notifications for other (e.g. abandoned) conversions
+        if (xevent->xselection.requestor == m_requestor &&
+            xevent->xselection.selection == m_selection &&
+            xevent->xselection.target    == m_target) {
             // done if we can't convert
             if (xevent->xselection.property == None ||
                 xevent->xselection.property == m_atomNone) {
@@ -1410,14 +1738,13 @@ XWindowsClipboard::CICCCMGetClipboard::processEvent(
         return false;
 
     case PropertyNotify:
-        // proceed if conversion successful and we're receiving more data
-        if (xevent->xproperty.window == m_requestor &&
+        // proceed if conversion successful and we're receiving more data.
+        // the owner sets the property before sending the SelectionNotify
+        // so until then the property is read when the notify arrives.
+        if (m_reading &&
+            xevent->xproperty.window == m_requestor &&
             xevent->xproperty.atom   == m_property &&
             xevent->xproperty.state  == PropertyNewValue) {
-            if (!m_reading) {
-                // we haven't gotten the SelectionNotify yet
-                return true;
-            }
             break;
         }
 
@@ -1507,7 +1834,7 @@ XWindowsClipboard::Reply::Reply(Window requestor, Atom target, ::Time time) :
     m_property(None),
     m_replied(false),
     m_done(false),
-    m_data(),
+    m_data(std::make_shared<const std::string>()),
     m_type(None),
     m_format(32),
     m_ptr(0)
@@ -1516,7 +1843,8 @@ XWindowsClipboard::Reply::Reply(Window requestor, Atom target, ::Time time) :
 }
 
 XWindowsClipboard::Reply::Reply(Window requestor, Atom target, ::Time time,
-                Atom property, const std::string& data, Atom type, int format) :
+                Atom property, const std::shared_ptr<const std::string>& data,
+                Atom type, int format) :
     m_requestor(requestor),
     m_target(target),
     m_time(time),
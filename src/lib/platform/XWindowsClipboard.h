@@ -20,12 +20,14 @@
 
 #include "inputleap/clipboard_types.h"
 #include "inputleap/IClipboard.h"
+#include "base/Stopwatch.h"
 #include "common/stdmap.h"
 #include "common/stdlist.h"
 #include "common/stdvector.h"
 #include "XWindowsImpl.h"
 
 #include <X11/Xlib.h>
+#include <memory>
 
 class IXWindowsClipboardConverter;
 
@@ -71,6 +73,50 @@ public:
     */
     bool                destroyRequest(Window requestor);
 
+    //! Fetch clipboard in the background
+    /*!
+    Starts asking the owner of the selection, owned by another client
+    since \c time, for its TIMESTAMP, its TARGETS and the data for each
+    format without blocking.  The transfer is driven by passing X events
+    to \c processFetchEvent().  The timestamp tells whether the cache is
+    still good, in which case only formats not yet fetched are asked
+    for.  Reading the clipboard never waits for the owner;  it returns
+    what has been fetched so far and \c checkFetched() says when the
+    fetch has added to that.
+    */
+    void                fetch(Time time);
+
+    //! Process background fetch event
+    /*!
+    Continues the background fetch, if any, with \c event.  Returns
+    true iff the event belonged to the fetch.
+    */
+    bool                processFetchEvent(XEvent* event);
+
+    //! Check background fetch
+    /*!
+    Abandons the background fetch if the selection owner hasn't
+    finished converting the current target within the fetch timeout.
+    Returns true iff a background fetch is still in progress.
+    */
+    bool                checkFetch();
+
+    //! Check for fetched data
+    /*!
+    Returns true iff a background fetch has ended since the last call
+    and changed the cached data.
+    */
+    bool                checkFetched();
+
+    //! Set fetch timeout
+    /*!
+    Sets how many seconds the selection owner gets to convert each
+    target during a background fetch.  The clock starts when the
+    conversion is requested and isn't restarted by the owner's
+    progress, so a slow INCR transfer can't hold a fetch up forever.
+    */
+    void                setFetchTimeout(double seconds);
+
     //! Get window
     /*!
     Returns the clipboard's window (passed the c'tor).
@@ -120,20 +166,44 @@ private:
     // clear it.  this has the side effect of updating m_timeOwned.
     void                checkCache() const;
 
-    // clear the cache, resetting the cached flag and the added flag for
+    // clear the cache, resetting the fetched flag and the added flag for
     // each format.
     void                clearCache() const;
     void                doClearCache();
 
-    // cache all formats of the selection
-    void                fillCache() const;
-    void                doFillCache();
+    // cache a format of a motif selection.  other selections are only
+    // cached by background fetches.
+    void                fillCache(EFormat) const;
+    void                doFillCache(EFormat);
+
+    // save data in the owner's target format for the converter's format.
+    // it's converted to the clipboard format when first asked for.
+    void                addTargetData(IXWindowsClipboardConverter*,
+                            const std::string& data);
+
+    // convert the target data saved for a format, if any
+    void                convertCache(EFormat) const;
+    void                doConvertCache(EFormat);
+
+    // background fetch methods.  the fetch converts TIMESTAMP, then
+    // TARGETS unless they're already cached and then the targets of
+    // each format that isn't cached yet, stopping at the first target
+    // of a format that converts.
+    void                startFetch(Atom target);
+    void                continueFetch();
+    void                startFetchData();
+    void                fetchNextData();
+    void                endFetch();
+    void                cancelFetch();
 
     //
     // helper classes
     //
 
-    // read an ICCCM conforming selection
+    // read an ICCCM conforming selection.  a conversion is started with
+    // start() and then driven by feeding X events to processEvent()
+    // until isFinished() returns true.  readClipboard() does this
+    // synchronously, which only reading motif clipboards still needs.
     class CICCCMGetClipboard {
     public:
         CICCCMGetClipboard(Window requestor, Time time, Atom property);
@@ -146,13 +216,54 @@ private:
                             Atom selection, Atom target,
                             Atom* actualTarget, std::string* data);
 
-    private:
+        // request conversion of the given selection to the given type
+        // and return without waiting for the selection owner.
+        void            start(Display* display,
+                            Atom selection, Atom target,
+                            Atom* actualTarget, std::string* data);
+
+        // block until the conversion started with start() completes
+        // or the selection owner stops responding.
+        void            wait(Display* display);
+
+        // process an event.  returns true iff the event belongs to
+        // this conversion.
         bool            processEvent(Display* display, XEvent* event);
 
+        // fail the conversion if it hasn't completed within \c timeout
+        // seconds of being started.  returns true iff it failed.
+        bool            checkTimeout(double timeout);
+
+        // true iff the conversion has completed or failed
+        bool            isFinished() const;
+
+        // stop following the conversion.  returns true iff the
+        // conversion was successful or cannot be performed, like
+        // readClipboard().
+        bool            finish(Display* display);
+
     private:
+        // select PropertyChangeMask on the requestor while converting.
+        // conversions can overlap on one window so the mask is counted
+        // and the original mask is restored by the last one to finish.
+        void            watch(Display* display);
+        void            unwatch(Display* display);
+
+    private:
+        class WatchedWindow {
+        public:
+            int            m_count;
+            long        m_eventMask;
+        };
+        typedef std::map<Window, WatchedWindow> WatchedWindows;
+
+        static WatchedWindows s_watched;
+
         Window            m_requestor;
         Time            m_time;
         Atom            m_property;
+        Atom            m_selection;
+        Atom            m_target;
         bool            m_incr;
         bool            m_failed;
         bool            m_done;
@@ -171,6 +282,12 @@ private:
         // selection owner cannot convert to the requested type.
         Atom*            m_actualTarget;
 
+        // true iff we've selected PropertyChangeMask on the requestor
+        bool            m_watching;
+
+        // time since the conversion was started
+        Stopwatch        m_timeout;
+
     public:
         // true iff the selection owner didn't follow ICCCM conventions
         bool            m_error;
@@ -220,7 +337,8 @@ private:
     class Reply {
     public:
         Reply(Window, Atom target, ::Time);
-        Reply(Window, Atom target, ::Time, Atom property, const std::string& data,
+        Reply(Window, Atom target, ::Time, Atom property,
+              const std::shared_ptr<const std::string>& data,
               Atom type, int format);
 
     public:
@@ -236,8 +354,9 @@ private:
         // true iff the reply has sent its last message
         bool            m_done;
 
-        // the data to send and its type and format
-        std::string m_data;
+        // the data to send and its type and format.  the data is
+        // shared with the clipboard and other replies for the target.
+        std::shared_ptr<const std::string> m_data;
         Atom            m_type;
         int                m_format;
 
@@ -249,15 +368,17 @@ private:
     typedef std::map<Window, long> ReplyEventMask;
 
     // ICCCM interoperability methods
-    void                icccmFillCache();
+    void                icccmSetTargets(Atom actualTarget, std::string& data);
     bool icccmGetSelection(Atom target, Atom* actualTarget, std::string* data) const;
     Time                icccmGetTime() const;
+    Time                icccmGetTime(Atom actualTarget,
+                            const std::string& data) const;
 
     // motif interoperability methods
     bool                motifLockClipboard() const;
     void                motifUnlockClipboard() const;
     bool                motifOwnsClipboard() const;
-    void                motifFillCache();
+    void                motifFillCache(EFormat);
     bool motifGetSelection(const MotifClipFormat*, Atom* actualTarget, std::string* data) const;
     Time                motifGetTime() const;
 
@@ -295,12 +416,42 @@ private:
     // true iff open and clipboard owned by a motif app
     mutable bool        m_motif;
 
-    // the added/cached clipboard data
+    // the added/cached clipboard data.  a format is fetched from the
+    // owner by a background fetch and m_fetched notes that we've tried.
+    // fetched data stays in the owner's target format, in
+    // m_targetData with the converter to use, until it's first read.
     mutable bool        m_checkCache;
-    bool                m_cached;
+    bool                m_fetched[kNumFormats];
     Time                m_cacheTime;
     bool                m_added[kNumFormats];
     std::string m_data[kNumFormats];
+    std::string m_targetData[kNumFormats];
+    IXWindowsClipboardConverter* m_targetConverter[kNumFormats];
+
+    // the targets the owner says it has, if we've asked.  like the data
+    // they're good until the cache is cleared.
+    bool                m_haveTargets;
+    std::vector<Atom>   m_targets;
+
+    // background fetch.  m_fetchIndex is 0 while converting TIMESTAMP,
+    // 1 while converting TARGETS and otherwise 2 more than the index in
+    // m_fetchConverters of the converter whose target is converting.
+    // m_fetchChanged notes that the fetch has changed the cache and
+    // m_fetchEnded that a fetch that did so has ended.
+    CICCCMGetClipboard* m_fetch;
+    double              m_fetchTimeout;
+    Time                m_fetchTime;
+    std::uint32_t       m_fetchIndex;
+    ConverterList       m_fetchConverters;
+    Atom                m_fetchTarget;
+    std::string         m_fetchData;
+    bool                m_fetchChanged;
+    bool                m_fetchEnded;
+
+    // the cached data converted to each target we've been asked for.
+    // this saves converting the data again for every request.
+    typedef std::map<Atom, std::shared_ptr<const std::string> > ConvertedMap;
+    ConvertedMap        m_converted;
 
     // conversion request replies
     ReplyMap            m_replies;
@@ -317,6 +468,7 @@ private:
     Atom                m_atomAtom;
     Atom                m_atomAtomPair;
     Atom                m_atomData;
+    Atom                m_atomFetchData;
     Atom                m_atomINCR;
     Atom                m_atomMotifClipLock;
     Atom                m_atomMotifClipHeader;
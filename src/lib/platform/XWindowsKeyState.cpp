@@ -40,6 +40,7 @@ XWindowsKeyState::XWindowsKeyState(IXWindowsImpl* impl,
         IEventQueue* events) :
     KeyState(events),
     m_display(display),
+    m_flushDeferred(false),
     m_modifierFromX(ModifiersFromXDefaultSize)
 {
      m_impl = impl;
@@ -52,6 +53,7 @@ XWindowsKeyState::XWindowsKeyState(IXWindowsImpl* impl,
     IEventQueue* events, inputleap::KeyMap& keyMap) :
     KeyState(events, keyMap),
     m_display(display),
+    m_flushDeferred(false),
     m_modifierFromX(ModifiersFromXDefaultSize)
 {
     m_impl = impl;
@@ -73,7 +75,7 @@ XWindowsKeyState::init(Display* display, bool useXKB)
     (void) display;
     (void) useXKB;
 
-    XGetKeyboardControl(m_display, &m_keyboardState);
+    m_impl->XGetKeyboardControl(m_display, &m_keyboardState);
 #if HAVE_XKB_EXTENSION
     if (useXKB) {
         m_xkb = m_impl->XkbGetMap(m_display,
@@ -110,6 +112,12 @@ XWindowsKeyState::setAutoRepeat(const XKeyboardState& state)
     m_keyboardState = state;
 }
 
+void
+XWindowsKeyState::setFlushDeferred(bool deferred)
+{
+    m_flushDeferred = deferred;
+}
+
 KeyModifierMask
 XWindowsKeyState::mapModifiersFromX(unsigned int state) const
 {
@@ -224,7 +232,7 @@ XWindowsKeyState::getKeyMap(inputleap::KeyMap& keyMap)
     // get autorepeat info.  we must use the global_auto_repeat told to
     // us because it may have modified by barrier.
     int oldGlobalAutoRepeat = m_keyboardState.global_auto_repeat;
-    XGetKeyboardControl(m_display, &m_keyboardState);
+    m_impl->XGetKeyboardControl(m_display, &m_keyboardState);
     m_keyboardState.global_auto_repeat = oldGlobalAutoRepeat;
 
 #if HAVE_XKB_EXTENSION
@@ -299,7 +307,9 @@ XWindowsKeyState::fakeKey(const Keystroke& keystroke)
         default:
             break;
     }
-    XFlush(m_display);
+    if (!m_flushDeferred) {
+        XFlush(m_display);
+    }
 }
 
 void
@@ -70,6 +70,14 @@ public:
     */
     void                setAutoRepeat(const XKeyboardState&);
 
+    //! Defer flushing of synthesized keys
+    /*!
+    While \p deferred is true, synthesized keystrokes are queued on the
+    display connection instead of being flushed one at a time.  The
+    caller is responsible for flushing the display when it clears it.
+    */
+    void                setFlushDeferred(bool deferred);
+
     //@}
     //! @name accessors
     //@{
@@ -142,6 +150,7 @@ private:
     IXWindowsImpl* m_impl;
 
     Display*            m_display;
+    bool                m_flushDeferred;
 #if HAVE_XKB_EXTENSION
     XkbDescPtr            m_xkb;
 #endif
@@ -25,6 +25,7 @@
 #include "platform/XWindowsUtil.h"
 #include "inputleap/Clipboard.h"
 #include "inputleap/KeyMap.h"
+#include "inputleap/LatencyTrace.h"
 #include "inputleap/XScreen.h"
 #include "arch/XArch.h"
 #include "arch/Arch.h"
@@ -84,9 +85,11 @@ XWindowsScreen::XWindowsScreen(
     m_ic(NULL),
     m_lastKeycode(0),
     m_sequenceNumber(0),
+    m_clipboardFetchTimer(NULL),
     m_screensaver(NULL),
     m_screensaverNotify(false),
     m_xtestIsXineramaUnaware(true),
+    m_fakeInputBatch(false),
     m_preserveFocus(false),
     m_xkb(false),
     m_xi2detected(false),
@@ -172,6 +175,10 @@ XWindowsScreen::~XWindowsScreen()
 
 	m_events->adoptBuffer(NULL);
 	m_events->removeHandler(Event::kSystem, m_events->getSystemTarget());
+	if (m_clipboardFetchTimer != NULL) {
+		m_events->removeHandler(Event::kTimer, m_clipboardFetchTimer);
+		m_events->deleteTimer(m_clipboardFetchTimer);
+	}
 	for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
 		delete m_clipboard[id];
 	}
@@ -466,7 +473,14 @@ XWindowsScreen::getClipboard(ClipboardID id, IClipboard* clipboard) const
 	Time timestamp = XWindowsUtil::getCurrentTime(
 								m_display, m_clipboard[id]->getWindow());
 
-	// copy the clipboard
+	// the selection may have changed hands without our knowing so check
+	// with its owner in the background.  we don't wait for the owner;
+	// if it has anything new we send a clipboard changed event.
+	if (!m_clipboard[id]->checkFetch()) {
+		const_cast<XWindowsScreen*>(this)->fetchClipboard(id, timestamp);
+	}
+
+	// copy what we've fetched of the clipboard
 	return Clipboard::copy(clipboard, m_clipboard[id], timestamp);
 }
 
@@ -747,13 +761,18 @@ void XWindowsScreen::unregisterHotKey(std::uint32_t id)
 void
 XWindowsScreen::fakeInputBegin()
 {
-	// FIXME -- not implemented
+	// queue up synthesized events until fakeInputEnd() so a burst of
+	// input costs a single flush instead of one per event
+	m_fakeInputBatch = true;
+	m_keyState->setFlushDeferred(true);
 }
 
 void
 XWindowsScreen::fakeInputEnd()
 {
-	// FIXME -- not implemented
+	m_fakeInputBatch = false;
+	m_keyState->setFlushDeferred(false);
+	m_impl->XFlush(m_display);
 }
 
 std::int32_t XWindowsScreen::getJumpZoneSize() const
@@ -791,7 +810,7 @@ XWindowsScreen::fakeMouseButton(ButtonID button, bool press)
 	if (xButton > 0 && xButton < 11) {
         m_impl->XTestFakeButtonEvent(m_display, xButton,
 							press ? True : False, CurrentTime);
-        m_impl->XFlush(m_display);
+        flushFakeInput();
 	}
 }
 
@@ -804,7 +823,7 @@ void XWindowsScreen::fakeMouseMove(std::int32_t x, std::int32_t y)
 		XTestFakeMotionEvent(m_display, DefaultScreen(m_display),
 							x, y, CurrentTime);
 	}
-    m_impl->XFlush(m_display);
+    flushFakeInput();
 }
 
 void XWindowsScreen::fakeMouseRelativeMove(std::int32_t dx, std::int32_t dy) const
@@ -816,7 +835,7 @@ void XWindowsScreen::fakeMouseRelativeMove(std::int32_t dx, std::int32_t dy) con
 	else {
         m_impl->XTestFakeRelativeMotionEvent(m_display, dx, dy, CurrentTime);
 	}
-    m_impl->XFlush(m_display);
+    flushFakeInput();
 }
 
 void XWindowsScreen::fakeMouseWheel(std::int32_t xDelta, std::int32_t yDelta) const
@@ -859,7 +878,7 @@ void XWindowsScreen::fakeMouseWheel(std::int32_t xDelta, std::int32_t yDelta) co
         m_impl->XTestFakeButtonEvent(m_display, xButton, False, CurrentTime);
 	}
 
-    m_impl->XFlush(m_display);
+    flushFakeInput();
 }
 
 Display*
@@ -1266,6 +1285,7 @@ XWindowsScreen::handleSystemEvent(const Event& event, void*)
 			ClipboardID id = getClipboardID(xevent->xselectionclear.selection);
 			if (id != kClipboardEnd) {
 				m_clipboard[id]->lost(xevent->xselectionclear.time);
+				fetchClipboard(id, xevent->xselectionclear.time);
 				sendClipboardEvent(m_events->forClipboard().clipboardGrabbed(), id);
 				return;
 			}
@@ -1273,10 +1293,14 @@ XWindowsScreen::handleSystemEvent(const Event& event, void*)
 		break;
 
 	case SelectionNotify:
-		// notification of selection transferred.  we shouldn't
-		// get this here because we handle them in the selection
-		// retrieval methods.  we'll just delete the property
-		// with the data (satisfying the usual ICCCM protocol).
+		// notification of selection transferred.  it's either for a
+		// background clipboard fetch or it's stale (synchronous
+		// retrievals handle their own), in which case we'll just
+		// delete the property with the data (satisfying the usual
+		// ICCCM protocol).
+		if (processClipboardFetch(xevent)) {
+			return;
+		}
 		if (xevent->xselection.property != None) {
             m_impl->XDeleteProperty(m_display,
 								xevent->xselection.requestor,
@@ -1302,6 +1326,11 @@ XWindowsScreen::handleSystemEvent(const Event& event, void*)
 		break;
 
 	case PropertyNotify:
+		// new property value may be part of a background fetch
+		if (processClipboardFetch(xevent)) {
+			return;
+		}
+
 		// property delete may be part of a selection conversion
 		if (xevent->xproperty.state == PropertyDelete) {
 			processClipboardRequest(xevent->xproperty.window,
@@ -1402,6 +1431,12 @@ XWindowsScreen::onKeyPress(XKeyEvent& xkey)
 	const KeyModifierMask mask = m_keyState->mapModifiersFromX(xkey.state);
 	KeyID key                  = mapKeyFromX(&xkey);
 	if (key != kKeyNone) {
+		// only keys going to a client are worth tracing
+		LatencyTrace* trace = LatencyTrace::getInstance();
+		if (trace != NULL && !m_isOnScreen) {
+			trace->captured();
+		}
+
 		// check for ctrl+alt+del emulation
 		if ((key == kKeyPause || key == kKeyBreak) &&
 			(mask & (KeyModifierControl | KeyModifierAlt)) ==
@@ -1607,6 +1642,9 @@ XWindowsScreen::onMouseMove(const XMotionEvent& xmotion)
 		// warping to the primary screen's enter position,
 		// effectively overriding it.
 		if (x != 0 || y != 0) {
+			if (LatencyTrace* trace = LatencyTrace::getInstance()) {
+				trace->captured();
+			}
 			sendEvent(m_events->forIPrimaryScreen().motionOnSecondary(), MotionInfo::alloc(x, y));
 		}
 	}
@@ -1703,6 +1741,75 @@ XWindowsScreen::destroyClipboardRequest(Window requestor)
 	}
 }
 
+void
+XWindowsScreen::fetchClipboard(ClipboardID id, Time time)
+{
+	m_clipboard[id]->fetch(time);
+
+	// watch for owners that stop responding
+	if (m_clipboardFetchTimer == NULL && m_clipboard[id]->checkFetch()) {
+		m_clipboardFetchTimer = m_events->newTimer(0.5, NULL);
+		m_events->adoptHandler(Event::kTimer, m_clipboardFetchTimer,
+							new TMethodEventJob<XWindowsScreen>(this,
+								&XWindowsScreen::handleClipboardFetchTimer));
+	}
+}
+
+bool
+XWindowsScreen::processClipboardFetch(XEvent* xevent)
+{
+	// a selection notify belongs to the clipboard it names.  other
+	// events are matched by property, which differs for each clipboard.
+	if (xevent->type == SelectionNotify) {
+		ClipboardID id = getClipboardID(xevent->xselection.selection);
+		if (id == kClipboardEnd ||
+			!m_clipboard[id]->processFetchEvent(xevent)) {
+			return false;
+		}
+		checkClipboardFetched(id);
+		return true;
+	}
+	for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
+		if (m_clipboard[id] != NULL &&
+			m_clipboard[id]->processFetchEvent(xevent)) {
+			checkClipboardFetched(id);
+			return true;
+		}
+	}
+	return false;
+}
+
+void
+XWindowsScreen::checkClipboardFetched(ClipboardID id)
+{
+	// clients read the clipboard when the screen leaves so they need to
+	// know when the data shows up later
+	if (m_clipboard[id]->checkFetched()) {
+		sendClipboardEvent(m_events->forClipboard().clipboardChanged(), id);
+	}
+}
+
+void
+XWindowsScreen::handleClipboardFetchTimer(const Event&, void*)
+{
+	bool fetching = false;
+	for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
+		if (m_clipboard[id] != NULL) {
+			if (m_clipboard[id]->checkFetch()) {
+				fetching = true;
+			}
+			checkClipboardFetched(id);
+		}
+	}
+
+	// stop watching when all fetches are done
+	if (!fetching) {
+		m_events->removeHandler(Event::kTimer, m_clipboardFetchTimer);
+		m_events->deleteTimer(m_clipboardFetchTimer);
+		m_clipboardFetchTimer = NULL;
+	}
+}
+
 void
 XWindowsScreen::onError()
 {
@@ -1880,6 +1987,15 @@ XWindowsScreen::mapButtonToX(ButtonID id) const
 	}
 }
 
+void
+XWindowsScreen::flushFakeInput() const
+{
+	// inside a fake input batch the flush happens in fakeInputEnd()
+	if (!m_fakeInputBatch) {
+        m_impl->XFlush(m_display);
+	}
+}
+
 void XWindowsScreen::warpCursorNoFlush(std::int32_t x, std::int32_t y)
 {
 	assert(m_window != None);
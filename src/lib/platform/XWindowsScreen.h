@@ -108,6 +108,12 @@ private:
     // terminate a selection request
     void                destroyClipboardRequest(Window window);
 
+    // background clipboard fetches
+    void                fetchClipboard(ClipboardID id, Time time);
+    bool                processClipboardFetch(XEvent* xevent);
+    void                checkClipboardFetched(ClipboardID id);
+    void                handleClipboardFetchTimer(const Event&, void*);
+
     // X I/O error handler
     void                onError();
     static int            ioErrorHandler(Display*);
@@ -152,6 +158,8 @@ private:
 
     void warpCursorNoFlush(std::int32_t x, std::int32_t y);
 
+    void                flushFakeInput() const;
+
     void                refreshKeyboard(XEvent*);
 
     static Bool            findKeyEvent(Display*, XEvent* xevent, XPointer arg);
@@ -224,6 +232,9 @@ private:
     XWindowsClipboard*    m_clipboard[kClipboardEnd];
     std::uint32_t m_sequenceNumber;
 
+    // watches background clipboard fetches for unresponsive owners
+    EventQueueTimer*    m_clipboardFetchTimer;
+
     // screen saver stuff
     XWindowsScreenSaver*    m_screensaver;
     bool                m_screensaverNotify;
@@ -242,6 +253,11 @@ private:
     bool                m_xtestIsXineramaUnaware;
     bool                m_xinerama;
 
+    // true while synthesized input is being batched between
+    // fakeInputBegin() and fakeInputEnd().  fake events are only
+    // flushed to the X server at the end of the batch.
+    bool                m_fakeInputBatch;
+
     // stuff to work around lost focus issues on certain systems
     // (ie: a MythTV front-end).
     bool                m_preserveFocus;
@@ -23,6 +23,9 @@
 #include "base/Log.h"
 #include "base/String.h"
 
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
 #include <X11/Xatom.h>
 #define XK_APL
 #define XK_ARABIC
@@ -79,7 +82,9 @@
 struct codepair {
     KeySym                keysym;
     std::uint32_t ucs4;
-} s_keymap[] = {
+};
+
+static constexpr codepair s_keymap[] = {
 { XK_Aogonek,                     0x0104 }, /* LATIN CAPITAL LETTER A WITH OGONEK */
 { XK_breve,                       0x02d8 }, /* BREVE */
 { XK_Lstroke,                     0x0141 }, /* LATIN CAPITAL LETTER L WITH STROKE */
@@ -1326,10 +1331,96 @@ static const KeySym s_map1009FF[] =
 };
 
 //
-// XWindowsUtil
+// s_keymap lookup tables
 //
+// the table above is kept in the order it was published.  at compile
+// time we index the legacy keysyms (0x100 to 0x20ff, almost all of the
+// table) directly by keysym and sort the rest for a binary search, so
+// nothing is built at runtime and the tables are read-only data.
+//
+
+namespace {
+
+template<std::size_t N>
+struct SortedKeymap {
+    codepair            m_pairs[N];
+};
+
+template<std::size_t N>
+constexpr SortedKeymap<N> sortKeymap(const codepair (&pairs)[N])
+{
+    // insertion sort.  the table is nearly sorted already.
+    SortedKeymap<N> result{};
+    for (std::size_t i = 0; i < N; ++i) {
+        codepair pair = { pairs[i].keysym, pairs[i].ucs4 };
+        std::size_t j = i;
+        for (; j > 0 && result.m_pairs[j - 1].keysym > pair.keysym; --j) {
+            result.m_pairs[j].keysym = result.m_pairs[j - 1].keysym;
+            result.m_pairs[j].ucs4   = result.m_pairs[j - 1].ucs4;
+        }
+        result.m_pairs[j].keysym = pair.keysym;
+        result.m_pairs[j].ucs4   = pair.ucs4;
+    }
+    return result;
+}
+
+template<std::size_t N>
+constexpr bool hasUniqueKeySyms(const SortedKeymap<N>& keymap)
+{
+    for (std::size_t i = 1; i < N; ++i) {
+        if (keymap.m_pairs[i - 1].keysym == keymap.m_pairs[i].keysym) {
+            return false;
+        }
+    }
+    return true;
+}
+
+constexpr KeySym s_firstLegacyKeySym = 0x0100;
+constexpr KeySym s_lastLegacyKeySym  = 0x20ff;
+
+// UCS-4 for each legacy keysym or zero if it's not in the table
+struct LegacyKeymap {
+    std::uint16_t        m_ucs4[s_lastLegacyKeySym - s_firstLegacyKeySym + 1];
+};
+
+template<std::size_t N>
+constexpr LegacyKeymap indexLegacyKeymap(const codepair (&pairs)[N])
+{
+    LegacyKeymap result{};
+    for (std::size_t i = 0; i < N; ++i) {
+        if (pairs[i].keysym >= s_firstLegacyKeySym &&
+            pairs[i].keysym <= s_lastLegacyKeySym) {
+            result.m_ucs4[pairs[i].keysym - s_firstLegacyKeySym] =
+                static_cast<std::uint16_t>(pairs[i].ucs4);
+        }
+    }
+    return result;
+}
+
+template<std::size_t N>
+constexpr bool fitsLegacyKeymap(const codepair (&pairs)[N])
+{
+    for (std::size_t i = 0; i < N; ++i) {
+        if (pairs[i].keysym >= s_firstLegacyKeySym &&
+            pairs[i].keysym <= s_lastLegacyKeySym &&
+            (pairs[i].ucs4 == 0 || pairs[i].ucs4 > 0xffff)) {
+            return false;
+        }
+    }
+    return true;
+}
 
-XWindowsUtil::KeySymMap    XWindowsUtil::s_keySymToUCS4;
+constexpr auto s_sortedKeymap = sortKeymap(s_keymap);
+static_assert(hasUniqueKeySyms(s_sortedKeymap), "duplicate keysym in s_keymap");
+
+constexpr LegacyKeymap s_legacyKeymap = indexLegacyKeymap(s_keymap);
+static_assert(fitsLegacyKeymap(s_keymap), "legacy keysym in s_keymap doesn't fit");
+
+} // namespace
+
+//
+// XWindowsUtil
+//
 
 bool XWindowsUtil::getWindowProperty(Display* display, Window window, Atom property,
                                      std::string* data, Atom* type, std::int32_t* format,
@@ -1422,7 +1513,7 @@ bool XWindowsUtil::setWindowProperty(Display* display, Window window, Atom prope
                                      const void* vdata, std::uint32_t size, Atom type,
                                      std::int32_t format)
 {
-    const std::uint32_t length = 4 * XMaxRequestSize(display);
+    const std::uint32_t length = getMaxPropertySize(display);
     const unsigned char* data = static_cast<const unsigned char*>(vdata);
     std::uint32_t datumSize = static_cast<std::uint32_t>(format / 8);
     // format 32 on 64bit systems is 8 bytes not 4.
@@ -1463,6 +1554,17 @@ bool XWindowsUtil::setWindowProperty(Display* display, Window window, Atom prope
     return !error;
 }
 
+std::uint32_t XWindowsUtil::getMaxPropertySize(Display* display)
+{
+    // request sizes are in 4 byte units.  use big requests if the server
+    // supports them and leave some room for the request header.
+    long maxRequestSize = XExtendedMaxRequestSize(display);
+    if (maxRequestSize == 0) {
+        maxRequestSize = XMaxRequestSize(display);
+    }
+    return static_cast<std::uint32_t>(4 * (maxRequestSize - 100));
+}
+
 Time
 XWindowsUtil::getCurrentTime(Display* display, Window window)
 {
@@ -1505,8 +1607,6 @@ XWindowsUtil::getCurrentTime(Display* display, Window window)
 KeyID
 XWindowsUtil::mapKeySymToKeyID(KeySym k)
 {
-    initKeyMaps();
-
     switch (k & 0xffffff00) {
     case 0x0000:
         // Latin-1
@@ -1589,9 +1689,18 @@ XWindowsUtil::mapKeySymToKeyID(KeySym k)
 
     default: {
         // lookup character in table
-        KeySymMap::const_iterator index = s_keySymToUCS4.find(k);
-        if (index != s_keySymToUCS4.end()) {
-            return static_cast<KeyID>(index->second);
+        if (k >= s_firstLegacyKeySym && k <= s_lastLegacyKeySym) {
+            std::uint16_t ucs4 = s_legacyKeymap.m_ucs4[k - s_firstLegacyKeySym];
+            return (ucs4 != 0) ? static_cast<KeyID>(ucs4) : kKeyNone;
+        }
+        const codepair* begin = std::begin(s_sortedKeymap.m_pairs);
+        const codepair* end   = std::end(s_sortedKeymap.m_pairs);
+        const codepair* index = std::lower_bound(begin, end, k,
+                                    [](const codepair& pair, KeySym keysym) {
+                                        return pair.keysym < keysym;
+                                    });
+        if (index != end && index->keysym == k) {
+            return static_cast<KeyID>(index->ucs4);
         }
 
         // unknown character
@@ -1734,16 +1843,6 @@ XWindowsUtil::propertyNotifyPredicate(Display*, XEvent* xevent, XPointer arg)
             xevent->xproperty.state  == PropertyNewValue) ? True : False;
 }
 
-void
-XWindowsUtil::initKeyMaps()
-{
-    if (s_keySymToUCS4.empty()) {
-        for (size_t i =0; i < sizeof(s_keymap) / sizeof(s_keymap[0]); ++i) {
-            s_keySymToUCS4[s_keymap[i].keysym] = s_keymap[i].ucs4;
-        }
-    }
-}
-
 
 //
 // XWindowsUtil::ErrorLock
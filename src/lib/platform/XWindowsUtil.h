@@ -51,6 +51,13 @@ public:
     static bool setWindowProperty(Display*, Window window, Atom property, const void* data,
                                   std::uint32_t size, Atom type, std::int32_t format);
 
+    //! Get maximum property request size
+    /*!
+    Returns the number of bytes of property data that fit in a single
+    request, taking the BIG-REQUESTS extension into account.
+    */
+    static std::uint32_t getMaxPropertySize(Display*);
+
     //! Get X server time
     /*!
     Returns the current X server time.
@@ -169,11 +176,4 @@ private:
 
     static Bool            propertyNotifyPredicate(Display*,
                             XEvent* xevent, XPointer arg);
-
-    static void            initKeyMaps();
-
-private:
-    typedef std::map<KeySym, std::uint32_t> KeySymMap;
-
-    static KeySymMap    s_keySymToUCS4;
 };
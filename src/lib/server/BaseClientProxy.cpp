@@ -25,7 +25,9 @@
 BaseClientProxy::BaseClientProxy(const std::string& name) :
     m_name(name),
     m_x(0),
-    m_y(0)
+    m_y(0),
+    m_screenID(~0u),
+    m_sessionToken(0)
 {
     // do nothing
 }
@@ -41,12 +43,47 @@ void BaseClientProxy::setJumpCursorPos(std::int32_t x, std::int32_t y)
     m_y = y;
 }
 
+void BaseClientProxy::setScreenID(std::uint32_t id)
+{
+    m_screenID = id;
+}
+
 void BaseClientProxy::getJumpCursorPos(std::int32_t& x, std::int32_t& y) const
 {
     x = m_x;
     y = m_y;
 }
 
+void BaseClientProxy::setSessionToken(std::uint64_t token)
+{
+    m_sessionToken = token;
+}
+
+bool BaseClientProxy::resumeSession(const BaseClientProxy*, const OptionsList&)
+{
+    return false;
+}
+
+std::uint32_t BaseClientProxy::getScreenID() const
+{
+    return m_screenID;
+}
+
+std::uint64_t BaseClientProxy::getSessionToken() const
+{
+    return m_sessionToken;
+}
+
+std::uint64_t BaseClientProxy::getResumeToken() const
+{
+    return 0;
+}
+
+bool BaseClientProxy::sendEncodedKey(const std::vector<std::uint8_t>&)
+{
+    return false;
+}
+
 std::string BaseClientProxy::getName() const
 {
     return m_name;
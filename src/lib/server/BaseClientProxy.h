@@ -19,6 +19,9 @@
 #pragma once
 
 #include "inputleap/IClient.h"
+#include "inputleap/option_types.h"
+
+#include <vector>
 
 namespace inputleap { class IStream; }
 
@@ -40,6 +43,30 @@ public:
     */
     void setJumpCursorPos(std::int32_t x, std::int32_t y);
 
+    //! Set screen id
+    /*!
+    Save the id of the client's screen in the server's ScreenTopology.
+    */
+    void setScreenID(std::uint32_t id);
+
+    //! Set session token
+    /*!
+    Save the token the server issued for the client's session, or 0 if
+    the session can't be resumed.
+    */
+    void setSessionToken(std::uint64_t token);
+
+    //! Answer a request to resume a session
+    /*!
+    Tells a client that asked to resume its session whether it did.
+    The session resumes if \c old, the proxy for the client's dropped
+    connection, is not NULL.  This proxy then takes over \c old's
+    session token, its record of the client's clipboards and \c options,
+    the options the client kept.  Returns true if the session resumed.
+    */
+    virtual bool        resumeSession(const BaseClientProxy* old,
+                            const OptionsList& options);
+
     //@}
     //! @name accessors
     //@{
@@ -50,6 +77,25 @@ public:
     */
     void getJumpCursorPos(std::int32_t& x, std::int32_t& y) const;
 
+    //! Get screen id
+    /*!
+    Get the id of the client's screen in the server's ScreenTopology.
+    */
+    std::uint32_t getScreenID() const;
+
+    //! Get session token
+    /*!
+    Get the token the server issued for the client's session.
+    */
+    std::uint64_t getSessionToken() const;
+
+    //! Get resume token
+    /*!
+    Get the token of the session the client asked to resume, or 0 if
+    it didn't ask.
+    */
+    virtual std::uint64_t getResumeToken() const;
+
     //! Get cursor position
     /*!
     Return if this proxy is for client or primary.
@@ -58,6 +104,17 @@ public:
 
     //@}
 
+    //! Send an encoded key message
+    /*!
+    Writes \c message, a kMsgDKeyDown or kMsgDKeyUp encoded once with
+    ProtocolUtil::encodef() for many clients, to the client.  Returns
+    false without sending anything if the client doesn't take messages
+    in that encoding, in which case the caller should use keyDown() or
+    keyUp() instead.
+    */
+    virtual bool        sendEncodedKey(const std::vector<std::uint8_t>& message);
+
+
     // IClient overrides
     virtual void sendDragInfo(std::uint32_t fileCount, const char* info, size_t size) = 0;
     virtual void fileChunkSending(std::uint8_t mark, char* data, size_t dataSize) = 0;
@@ -68,4 +125,6 @@ public:
 private:
     std::string m_name;
     std::int32_t m_x, m_y;
+    std::uint32_t m_screenID;
+    std::uint64_t m_sessionToken;
 };
@@ -0,0 +1,302 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/ClientOutputQueue.h"
+
+#include "inputleap/ProtocolUtil.h"
+#include "inputleap/protocol_types.h"
+#include "base/IEventQueue.h"
+#include "base/Log.h"
+#include "base/Metrics.h"
+
+#include <cstring>
+
+static MetricCounter&    s_coalesced = Metrics::getInstance().getCounter(
+    "inputleap_client_moves_coalesced_total",
+    "Mouse moves to slow clients replaced by or added to a later move.");
+
+// size of an encoded kMsgDMouseMove or kMsgDMouseRelMove
+static const std::uint32_t kMoveSize = 8;
+
+// size of an encoded kMsgDLatencyTrace
+static const std::uint32_t kTraceSize = 12;
+
+static bool
+fitsInt16(std::int32_t value)
+{
+    return (value >= -32768 && value <= 32767);
+}
+
+//
+// ClientOutputQueue
+//
+
+ClientOutputQueue::ClientOutputQueue(IEventQueue* events,
+                            inputleap::IStream* stream,
+                            std::uint32_t maxUnflushed, std::size_t maxQueued) :
+    StreamFilter(events, stream, true),
+    m_events(events),
+    m_maxUnflushed(maxUnflushed),
+    m_maxQueued(maxQueued),
+    m_unflushed(0),
+    m_queuedSize(0),
+    m_queuedBulkSize(0),
+    m_coalesced(0),
+    m_overflowed(false),
+    m_bulk(false),
+    m_traced(false),
+    m_traceID(0),
+    m_traceMicros(0)
+{
+    // do nothing
+}
+
+ClientOutputQueue::~ClientOutputQueue()
+{
+    // do nothing
+}
+
+void
+ClientOutputQueue::mouseMove(std::int32_t xAbs, std::int32_t yAbs)
+{
+    if (!isHolding()) {
+        writeMove(kMouseMove, xAbs, yAbs);
+    }
+    else if (!m_queue.empty() && m_queue.back().m_type == kMouseMove) {
+        // the client hasn't seen the old position yet so skip it
+        m_queue.back().m_x = xAbs;
+        m_queue.back().m_y = yAbs;
+        attachTrace(m_queue.back());
+        ++m_coalesced;
+        s_coalesced.add();
+    }
+    else {
+        hold(kMouseMove, xAbs, yAbs, NULL, kMoveSize);
+    }
+}
+
+void
+ClientOutputQueue::mouseRelativeMove(std::int32_t xRel, std::int32_t yRel)
+{
+    if (!isHolding()) {
+        writeMove(kMouseRelativeMove, xRel, yRel);
+        return;
+    }
+
+    if (!m_queue.empty() && m_queue.back().m_type == kMouseRelativeMove) {
+        Message& last = m_queue.back();
+        if (fitsInt16(last.m_x + xRel) && fitsInt16(last.m_y + yRel)) {
+            last.m_x += xRel;
+            last.m_y += yRel;
+            attachTrace(last);
+            ++m_coalesced;
+            s_coalesced.add();
+            return;
+        }
+    }
+    hold(kMouseRelativeMove, xRel, yRel, NULL, kMoveSize);
+}
+
+void
+ClientOutputQueue::latencyTrace(std::uint32_t id, std::uint32_t serverMicros)
+{
+    if (!isHolding()) {
+        writeTrace(id, serverMicros);
+        return;
+    }
+
+    // the mark goes with whatever message it ends up traveling with
+    m_traced      = true;
+    m_traceID     = id;
+    m_traceMicros = serverMicros;
+}
+
+void
+ClientOutputQueue::setBulk(bool bulk)
+{
+    m_bulk = bulk;
+}
+
+std::size_t
+ClientOutputQueue::getQueuedSize() const
+{
+    return m_queuedSize;
+}
+
+std::uint64_t
+ClientOutputQueue::getCoalesced() const
+{
+    return m_coalesced;
+}
+
+void
+ClientOutputQueue::close()
+{
+    m_queue.clear();
+    m_queuedSize     = 0;
+    m_queuedBulkSize = 0;
+    m_traced         = false;
+    StreamFilter::close();
+}
+
+void
+ClientOutputQueue::write(const void* buffer, std::uint32_t n)
+{
+    if (isHolding()) {
+        hold(m_bulk ? kBulkData : kData, 0, 0, buffer, n);
+    }
+    else {
+        m_unflushed += n;
+        StreamFilter::write(buffer, n);
+    }
+}
+
+void
+ClientOutputQueue::flush()
+{
+    writeQueued();
+    StreamFilter::flush();
+}
+
+void
+ClientOutputQueue::filterEvent(const Event& event)
+{
+    if (event.getType() == m_events->forIStream().outputFlushed()) {
+        // the socket caught up.  whatever was held goes now, merged
+        // down as far as it could be.
+        m_unflushed = 0;
+        writeQueued();
+    }
+
+    // pass event
+    StreamFilter::filterEvent(event);
+}
+
+bool
+ClientOutputQueue::isHolding() const
+{
+    return (!m_queue.empty() || m_unflushed > m_maxUnflushed);
+}
+
+void
+ClientOutputQueue::hold(EType type, std::int32_t x, std::int32_t y,
+                            const void* data, std::uint32_t n)
+{
+    // once overflowed the client is on its way out
+    if (m_overflowed) {
+        return;
+    }
+
+    if (type != kBulkData && m_queuedSize - m_queuedBulkSize + n > m_maxQueued) {
+        LOG((CLOG_WARN "client isn't keeping up, %u bytes waiting to be sent",
+                            static_cast<unsigned int>(m_queuedSize + m_unflushed)));
+        m_overflowed = true;
+        m_queue.clear();
+        m_queuedSize     = 0;
+        m_queuedBulkSize = 0;
+        m_traced         = false;
+        m_events->addEvent(Event(m_events->forIStream().outputError(),
+                            getEventTarget()));
+        return;
+    }
+
+    m_queue.push_back(Message());
+    Message& message = m_queue.back();
+    message.m_type   = type;
+    message.m_x      = x;
+    message.m_y      = y;
+    message.m_traced = false;
+    if (data != NULL) {
+        message.m_data.assign(static_cast<const std::uint8_t*>(data),
+                              static_cast<const std::uint8_t*>(data) + n);
+    }
+    m_queuedSize += n;
+    if (type == kBulkData) {
+        m_queuedBulkSize += n;
+    }
+    attachTrace(message);
+}
+
+void
+ClientOutputQueue::attachTrace(Message& message)
+{
+    if (!m_traced) {
+        return;
+    }
+
+    // a mark already on the message traced input that's been merged
+    // away.  the client never sees it.
+    if (!message.m_traced) {
+        m_queuedSize += kTraceSize;
+    }
+    message.m_traced      = true;
+    message.m_traceID     = m_traceID;
+    message.m_traceMicros = m_traceMicros;
+    m_traced = false;
+}
+
+void
+ClientOutputQueue::writeTrace(std::uint32_t id, std::uint32_t serverMicros)
+{
+    ProtocolUtil::writef(getStream(), kMsgDLatencyTrace, id, serverMicros);
+    m_unflushed += kTraceSize;
+}
+
+void
+ClientOutputQueue::writeMove(EType type, std::int32_t x, std::int32_t y)
+{
+    ProtocolUtil::writef(getStream(), type == kMouseMove ?
+                            kMsgDMouseMove : kMsgDMouseRelMove, x, y);
+    m_unflushed += kMoveSize;
+}
+
+void
+ClientOutputQueue::writeQueued()
+{
+    if (m_queue.empty()) {
+        return;
+    }
+
+    LOG((CLOG_DEBUG2 "sending %d held messages, %u bytes",
+                            static_cast<int>(m_queue.size()),
+                            static_cast<unsigned int>(m_queuedSize)));
+    for (const Message& message : m_queue) {
+        if (message.m_traced) {
+            ProtocolUtil::writef(getStream(), kMsgDLatencyTrace,
+                            message.m_traceID, message.m_traceMicros);
+        }
+        if (message.m_type == kData || message.m_type == kBulkData) {
+            getStream()->write(message.m_data.data(),
+                            static_cast<std::uint32_t>(message.m_data.size()));
+        }
+        else {
+            ProtocolUtil::writef(getStream(), message.m_type == kMouseMove ?
+                            kMsgDMouseMove : kMsgDMouseRelMove,
+                            message.m_x, message.m_y);
+        }
+    }
+    m_unflushed += static_cast<std::uint32_t>(m_queuedSize);
+    m_queue.clear();
+    m_queuedSize     = 0;
+    m_queuedBulkSize = 0;
+
+    // a mark for a message that's yet to come goes ahead of it
+    if (m_traced) {
+        m_traced = false;
+        writeTrace(m_traceID, m_traceMicros);
+    }
+}
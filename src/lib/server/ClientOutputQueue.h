@@ -0,0 +1,147 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "io/StreamFilter.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+class IEventQueue;
+
+//! Outbound messages for a client
+/*!
+Wraps the stream to a client.  Messages go straight through while the
+connection keeps up.  Once more than \c maxUnflushed bytes have been
+written since the stream last reported its output flushed, messages are
+held here instead until it does.  The stream reports that as soon as the
+system takes the bytes, so the server keeps the send buffers of client
+sockets small; otherwise a client that stops reading would leave a
+backlog of stale moves in the system that no merging here can reach.
+
+While messages are held a mouse move replaces an absolute move waiting
+at the end of the queue and a relative move is added to a relative move
+waiting there, so a client that falls behind gets the current pointer
+position rather than a backlog of stale ones.  Nothing else is dropped
+and moves are only merged with the message right before them, so clicks
+still land where they were made.  A latency trace mark stays with the
+message it traces, so a traced move merged into a held move carries its
+mark along and a mark that was already on the held move is dropped.
+
+If more than \c maxQueued bytes are held the client is presumed dead,
+the queue is discarded and an output error event is sent.  Bulk data,
+clipboard and file chunks, doesn't count toward \c maxQueued.  Their
+senders already pace them and a large transfer to a slow client is not a
+sign that it died.
+*/
+class ClientOutputQueue : public StreamFilter {
+public:
+    enum {
+        kMaxUnflushed = 1024,
+        kMaxQueued    = 16 * 1024 * 1024
+    };
+
+    ClientOutputQueue(IEventQueue* events, inputleap::IStream* adoptedStream,
+                      std::uint32_t maxUnflushed = kMaxUnflushed,
+                      std::size_t maxQueued = kMaxQueued);
+    ~ClientOutputQueue() override;
+
+    //! @name manipulators
+    //@{
+
+    //! Send an absolute mouse move
+    void mouseMove(std::int32_t xAbs, std::int32_t yAbs);
+
+    //! Send a relative mouse move
+    void mouseRelativeMove(std::int32_t xRel, std::int32_t yRel);
+
+    //! Send a latency trace mark
+    /*!
+    Sends a kMsgDLatencyTrace mark for the message written next.
+    */
+    void latencyTrace(std::uint32_t id, std::uint32_t serverMicros);
+
+    //! Mark writes as bulk data
+    /*!
+    While \p bulk is true, write() holds data as bulk data, which doesn't
+    count toward \c maxQueued.
+    */
+    void setBulk(bool bulk);
+
+    //@}
+    //! @name accessors
+    //@{
+
+    //! Get the number of bytes held
+    std::size_t getQueuedSize() const;
+
+    //! Get the number of moves replaced by or added to a later move
+    std::uint64_t getCoalesced() const;
+
+    //@}
+
+    // IStream overrides
+    void close() override;
+    void write(const void* buffer, std::uint32_t n) override;
+    void flush() override;
+
+protected:
+    // StreamFilter overrides
+    void filterEvent(const Event&) override;
+
+private:
+    enum EType { kData, kBulkData, kMouseMove, kMouseRelativeMove };
+
+    class Message {
+    public:
+        EType            m_type;
+        std::int32_t     m_x;
+        std::int32_t     m_y;
+        std::vector<std::uint8_t> m_data;
+        bool             m_traced;
+        std::uint32_t    m_traceID;
+        std::uint32_t    m_traceMicros;
+    };
+
+    bool                isHolding() const;
+    void                hold(EType type, std::int32_t x, std::int32_t y,
+                            const void* data, std::uint32_t n);
+    void                attachTrace(Message&);
+    void                writeTrace(std::uint32_t id, std::uint32_t serverMicros);
+    void                writeMove(EType type, std::int32_t x, std::int32_t y);
+    void                writeQueued();
+
+private:
+    IEventQueue*        m_events;
+    std::uint32_t       m_maxUnflushed;
+    std::size_t         m_maxQueued;
+    std::uint32_t       m_unflushed;
+    std::size_t         m_queuedSize;
+    std::size_t         m_queuedBulkSize;
+    std::uint64_t       m_coalesced;
+    bool                m_overflowed;
+    bool                m_bulk;
+    std::deque<Message> m_queue;
+
+    // a trace mark waiting for the next message while holding
+    bool                m_traced;
+    std::uint32_t       m_traceID;
+    std::uint32_t       m_traceMicros;
+};
@@ -18,6 +18,8 @@
 
 #include "server/ClientProxy.h"
 
+#include "server/ClientOutputQueue.h"
+#include "inputleap/PacketStreamFilter.h"
 #include "inputleap/ProtocolUtil.h"
 #include "io/IStream.h"
 #include "base/Log.h"
@@ -27,10 +29,18 @@
 // ClientProxy
 //
 
-ClientProxy::ClientProxy(const std::string& name, inputleap::IStream* stream) :
+ClientProxy::ClientProxy(const std::string& name, inputleap::IStream* stream,
+                         IEventQueue* events) :
     BaseClientProxy(name),
-    m_stream(stream)
+    m_stream(NULL)
 {
+    // count the client's traffic under its name
+    PacketStreamFilter* filter = dynamic_cast<PacketStreamFilter*>(stream);
+    if (filter != NULL) {
+        filter->setMetricsPeer(name);
+    }
+
+    m_stream = new ClientOutputQueue(events, stream);
 }
 
 ClientProxy::~ClientProxy()
@@ -54,6 +64,12 @@ ClientProxy::getStream() const
     return m_stream;
 }
 
+ClientOutputQueue*
+ClientProxy::getOutputQueue() const
+{
+    return m_stream;
+}
+
 void*
 ClientProxy::getEventTarget() const
 {
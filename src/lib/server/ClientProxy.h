@@ -22,15 +22,19 @@
 #include "base/Event.h"
 #include "base/EventTypes.h"
 
+class ClientOutputQueue;
+class IEventQueue;
 namespace inputleap { class IStream; }
 
 //! Generic proxy for client
 class ClientProxy : public BaseClientProxy {
 public:
     /*!
-    \c name is the name of the client.
+    \c name is the name of the client.  Writes to \c adoptedStream go
+    through a ClientOutputQueue.
     */
-    ClientProxy(const std::string& name, inputleap::IStream* adoptedStream);
+    ClientProxy(const std::string& name, inputleap::IStream* adoptedStream,
+                IEventQueue* events);
     ~ClientProxy();
 
     //! @name manipulators
@@ -48,15 +52,22 @@ public:
 
     //! Get stream
     /*!
-    Returns the original stream passed to the c'tor.
+    Returns the output queue wrapping the stream passed to the c'tor.
     */
     inputleap::IStream* getStream() const override;
 
+    //! Get output queue
+    /*!
+    Returns the queue that holds messages while the client falls behind.
+    Mouse moves sent through it can be merged with ones not yet sent.
+    */
+    ClientOutputQueue*    getOutputQueue() const;
+
     //@}
 
     // IScreen
     void* getEventTarget() const override;
 
 private:
-    inputleap::IStream* m_stream;
+    ClientOutputQueue*    m_stream;
 };
@@ -17,7 +17,8 @@
  */
 
 #include "server/ClientProxy1_0.h"
-
+#include "server/ClientOutputQueue.h"
+#include "inputleap/LatencyTrace.h"
 #include "inputleap/ProtocolUtil.h"
 #include "inputleap/XBarrier.h"
 #include "io/IStream.h"
@@ -33,30 +34,32 @@
 
 ClientProxy1_0::ClientProxy1_0(const std::string& name, inputleap::IStream* stream,
                                IEventQueue* events) :
-    ClientProxy(name, stream),
+    ClientProxy(name, stream, events),
     m_heartbeatTimer(NULL),
     m_parser(&ClientProxy1_0::parseHandshakeMessage),
-    m_events(events)
+    m_events(events),
+    m_traceLatency(false),
+    m_resumeToken(0)
 {
     // install event handlers
     m_events->adoptHandler(m_events->forIStream().inputReady(),
-                            stream->getEventTarget(),
+                            getStream()->getEventTarget(),
                             new TMethodEventJob<ClientProxy1_0>(this,
                                 &ClientProxy1_0::handleData, NULL));
     m_events->adoptHandler(m_events->forIStream().outputError(),
-                            stream->getEventTarget(),
+                            getStream()->getEventTarget(),
                             new TMethodEventJob<ClientProxy1_0>(this,
                                 &ClientProxy1_0::handleWriteError, NULL));
     m_events->adoptHandler(m_events->forIStream().inputShutdown(),
-                            stream->getEventTarget(),
+                            getStream()->getEventTarget(),
                             new TMethodEventJob<ClientProxy1_0>(this,
                                 &ClientProxy1_0::handleDisconnect, NULL));
     m_events->adoptHandler(m_events->forIStream().inputFormatError(),
-                           stream->getEventTarget(),
+                           getStream()->getEventTarget(),
                            new TMethodEventJob<ClientProxy1_0>(this,
                                 &ClientProxy1_0::handleDisconnect, NULL));
     m_events->adoptHandler(m_events->forIStream().outputShutdown(),
-                            stream->getEventTarget(),
+                            getStream()->getEventTarget(),
                             new TMethodEventJob<ClientProxy1_0>(this,
                                 &ClientProxy1_0::handleWriteError, NULL));
     m_events->adoptHandler(Event::kTimer, this,
@@ -185,6 +188,9 @@ bool ClientProxy1_0::parseHandshakeMessage(const std::uint8_t* code)
         LOG((CLOG_DEBUG2 "no-op from", getName().c_str()));
         return true;
     }
+    else if (memcmp(code, kMsgCResume, 4) == 0) {
+        return recvResume();
+    }
     else if (memcmp(code, kMsgDInfo, 4) == 0) {
         // future messages get parsed by parseMessage
         // NOTE: we're taking address of virtual function here,
@@ -220,6 +226,9 @@ bool ClientProxy1_0::parseMessage(const std::uint8_t* code)
     else if (memcmp(code, kMsgDClipboard, 4) == 0) {
         return recvClipboard();
     }
+    else if (memcmp(code, kMsgDLatencyTraceAck, 4) == 0) {
+        return recvLatencyTraceAck();
+    }
     return false;
 }
 
@@ -315,6 +324,7 @@ void
 ClientProxy1_0::keyDown(KeyID key, KeyModifierMask mask, KeyButton)
 {
     LOG((CLOG_DEBUG1 "send key down to \"%s\" id=%d, mask=0x%04x", getName().c_str(), key, mask));
+    sendLatencyTrace();
     ProtocolUtil::writef(getStream(), kMsgDKeyDown1_0, key, mask);
 }
 
@@ -348,7 +358,8 @@ ClientProxy1_0::mouseUp(ButtonID button)
 void ClientProxy1_0::mouseMove(std::int32_t xAbs, std::int32_t yAbs)
 {
     LOG((CLOG_DEBUG2 "send mouse move to \"%s\" %d,%d", getName().c_str(), xAbs, yAbs));
-    ProtocolUtil::writef(getStream(), kMsgDMouseMove, xAbs, yAbs);
+    sendLatencyTrace();
+    getOutputQueue()->mouseMove(xAbs, yAbs);
 }
 
 void ClientProxy1_0::mouseRelativeMove(std::int32_t, std::int32_t)
@@ -407,8 +418,48 @@ ClientProxy1_0::setOptions(const OptionsList& options)
 {
     LOG((CLOG_DEBUG1 "send set options to \"%s\" size=%d", getName().c_str(), options.size()));
     ProtocolUtil::writef(getStream(), kMsgDSetOptions, &options);
+    applyOptions(options);
+}
+
+bool
+ClientProxy1_0::resumeSession(const BaseClientProxy* old, const OptionsList& options)
+{
+    if (m_resumeToken == 0) {
+        return false;
+    }
+    m_resumeToken = 0;
+
+    const ClientProxy1_0* session = dynamic_cast<const ClientProxy1_0*>(old);
+    if (session == NULL) {
+        LOG((CLOG_DEBUG1 "send new session to \"%s\"", getName().c_str()));
+        ProtocolUtil::writef(getStream(), kMsgCResume, 0, 0);
+        return false;
+    }
+
+    LOG((CLOG_DEBUG1 "send resume session to \"%s\"", getName().c_str()));
+    std::uint64_t token = session->getSessionToken();
+    setSessionToken(token);
+    ProtocolUtil::writef(getStream(), kMsgCResume,
+                         static_cast<std::uint32_t>(token >> 32),
+                         static_cast<std::uint32_t>(token));
+
+    // the client still has what the old connection sent it
+    for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
+        m_clipboard[id] = session->m_clipboard[id];
+    }
+    applyOptions(options);
+    return true;
+}
 
-    // check options
+std::uint64_t
+ClientProxy1_0::getResumeToken() const
+{
+    return m_resumeToken;
+}
+
+void
+ClientProxy1_0::applyOptions(const OptionsList& options)
+{
     for (std::uint32_t i = 0, n = static_cast<std::uint32_t>(options.size()); i < n; i += 2) {
         if (options[i] == kOptionHeartbeat) {
             double rate = 1.0e-3 * static_cast<double>(options[i + 1]);
@@ -422,6 +473,48 @@ ClientProxy1_0::setOptions(const OptionsList& options)
     }
 }
 
+void
+ClientProxy1_0::sendLatencyTrace()
+{
+    LatencyTrace* trace = LatencyTrace::getInstance();
+    std::uint32_t id, serverMicros;
+    if (m_traceLatency && trace != NULL && trace->sending(id, serverMicros)) {
+        LOG((CLOG_DEBUG2 "send latency trace %u to \"%s\"", id, getName().c_str()));
+        getOutputQueue()->latencyTrace(id, serverMicros);
+    }
+}
+
+bool
+ClientProxy1_0::recvLatencyTraceAck()
+{
+    std::uint32_t id, clientMicros;
+    if (!ProtocolUtil::readf(getStream(), kMsgDLatencyTraceAck + 4, &id, &clientMicros)) {
+        return false;
+    }
+
+    // id 0 says the client can trace
+    if (id == 0) {
+        LOG((CLOG_DEBUG "client \"%s\" supports latency tracing", getName().c_str()));
+        m_traceLatency = true;
+    }
+    else if (LatencyTrace* trace = LatencyTrace::getInstance()) {
+        trace->acknowledged(id, clientMicros);
+    }
+    return true;
+}
+
+bool
+ClientProxy1_0::recvResume()
+{
+    std::uint32_t high, low;
+    if (!ProtocolUtil::readf(getStream(), kMsgCResume + 4, &high, &low)) {
+        return false;
+    }
+    m_resumeToken = (static_cast<std::uint64_t>(high) << 32) | low;
+    LOG((CLOG_DEBUG1 "client \"%s\" asked to resume its session", getName().c_str()));
+    return true;
+}
+
 bool
 ClientProxy1_0::recvInfo()
 {
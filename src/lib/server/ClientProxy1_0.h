@@ -59,6 +59,10 @@ public:
     void sendDragInfo(std::uint32_t fileCount, const char* info, size_t size) override;
     void fileChunkSending(std::uint8_t mark, char* data, size_t dataSize) override;
 
+    // BaseClientProxy overrides
+    bool resumeSession(const BaseClientProxy* old, const OptionsList& options) override;
+    std::uint64_t getResumeToken() const override;
+
 protected:
     virtual bool parseHandshakeMessage(const std::uint8_t* code);
     virtual bool parseMessage(const std::uint8_t* code);
@@ -69,6 +73,7 @@ protected:
     virtual void        addHeartbeatTimer();
     virtual void        removeHeartbeatTimer();
     virtual bool        recvClipboard();
+    void                sendLatencyTrace();
 private:
     void                disconnect();
     void                removeHandlers();
@@ -78,8 +83,12 @@ private:
     void                handleWriteError(const Event&, void*);
     void                handleFlatline(const Event&, void*);
 
+    void                applyOptions(const OptionsList& options);
+
     bool                recvInfo();
     bool                recvGrabClipboard();
+    bool                recvLatencyTraceAck();
+    bool                recvResume();
 
 protected:
     struct ClientClipboard {
@@ -102,4 +111,6 @@ private:
     EventQueueTimer*    m_heartbeatTimer;
     MessageParser        m_parser;
     IEventQueue*        m_events;
+    bool                m_traceLatency;
+    std::uint64_t        m_resumeToken;
 };
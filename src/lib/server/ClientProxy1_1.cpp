@@ -43,6 +43,7 @@ void
 ClientProxy1_1::keyDown(KeyID key, KeyModifierMask mask, KeyButton button)
 {
     LOG((CLOG_DEBUG1 "send key down to \"%s\" id=%d, mask=0x%04x, button=0x%04x", getName().c_str(), key, mask, button));
+    sendLatencyTrace();
     ProtocolUtil::writef(getStream(), kMsgDKeyDown, key, mask, button);
 }
 
@@ -59,3 +60,14 @@ ClientProxy1_1::keyUp(KeyID key, KeyModifierMask mask, KeyButton button)
     LOG((CLOG_DEBUG1 "send key up to \"%s\" id=%d, mask=0x%04x, button=0x%04x", getName().c_str(), key, mask, button));
     ProtocolUtil::writef(getStream(), kMsgDKeyUp, key, mask, button);
 }
+
+bool
+ClientProxy1_1::sendEncodedKey(const std::vector<std::uint8_t>& message)
+{
+    LOG((CLOG_DEBUG2 "send encoded key to \"%s\"", getName().c_str()));
+    if (memcmp(message.data(), kMsgDKeyDown, 4) == 0) {
+        sendLatencyTrace();
+    }
+    ProtocolUtil::write(getStream(), message);
+    return true;
+}
@@ -30,4 +30,7 @@ public:
     void keyDown(KeyID, KeyModifierMask, KeyButton) override;
     void keyRepeat(KeyID, KeyModifierMask, std::int32_t count, KeyButton) override;
     void keyUp(KeyID, KeyModifierMask, KeyButton) override;
+
+    // BaseClientProxy overrides
+    bool sendEncodedKey(const std::vector<std::uint8_t>& message) override;
 };
@@ -18,7 +18,7 @@
 
 #include "server/ClientProxy1_2.h"
 
-#include "inputleap/ProtocolUtil.h"
+#include "server/ClientOutputQueue.h"
 #include "base/Log.h"
 
 //
@@ -40,5 +40,6 @@ ClientProxy1_2::~ClientProxy1_2()
 void ClientProxy1_2::mouseRelativeMove(std::int32_t xRel, std::int32_t yRel)
 {
     LOG((CLOG_DEBUG2 "send mouse relative move to \"%s\" %d,%d", getName().c_str(), xRel, yRel));
-    ProtocolUtil::writef(getStream(), kMsgDMouseRelMove, xRel, yRel);
+    sendLatencyTrace();
+    getOutputQueue()->mouseRelativeMove(xRel, yRel);
 }
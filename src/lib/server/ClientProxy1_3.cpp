@@ -19,10 +19,15 @@
 #include "server/ClientProxy1_3.h"
 
 #include "inputleap/ProtocolUtil.h"
+#include "inputleap/option_types.h"
 #include "base/Log.h"
 #include "base/IEventQueue.h"
+#include "base/Metrics.h"
+#include "base/Probes.h"
+#include "base/Time.h"
 #include "base/TMethodEventJob.h"
 
+#include <cmath>
 #include <cstring>
 #include <memory>
 
@@ -35,9 +40,23 @@ ClientProxy1_3::ClientProxy1_3(const std::string& name, inputleap::IStream* stre
     ClientProxy1_2(name, stream, events),
     m_keepAliveRate(kKeepAliveRate),
     m_keepAliveTimer(NULL),
-    m_events(events)
+    m_events(events),
+    m_ping(false),
+    m_adaptKeepAlive(true),
+    m_link(kKeepAliveRate),
+    m_reportedRTT(0.0)
 {
     setHeartbeatRate(kKeepAliveRate, kKeepAliveRate * kKeepAlivesUntilDeath);
+    m_adaptKeepAlive = true;
+
+    Metrics& metrics  = Metrics::getInstance();
+    std::string label = Metrics::label("peer", name);
+    m_rttGauge         = &metrics.getGauge("inputleap_link_rtt_microseconds",
+                            "Smoothed round trip time to the client.", label);
+    m_clockOffsetGauge = &metrics.getGauge("inputleap_link_clock_offset_microseconds",
+                            "Client's wall clock less the server's.", label);
+    m_pingsLost        = &metrics.getCounter("inputleap_link_pings_lost_total",
+                            "Pings not answered before the next was sent.", label);
 }
 
 ClientProxy1_3::~ClientProxy1_3()
@@ -60,6 +79,9 @@ bool ClientProxy1_3::parseMessage(const std::uint8_t* code)
         resetHeartbeatTimer();
         return true;
     }
+    else if (memcmp(code, kMsgCPong, 4) == 0) {
+        return recvPong();
+    }
     else {
         return ClientProxy1_2::parseMessage(code);
     }
@@ -69,12 +91,14 @@ void
 ClientProxy1_3::resetHeartbeatRate()
 {
     setHeartbeatRate(kKeepAliveRate, kKeepAliveRate * kKeepAlivesUntilDeath);
+    m_adaptKeepAlive = true;
 }
 
 void
 ClientProxy1_3::setHeartbeatRate(double rate, double)
 {
-    m_keepAliveRate = rate;
+    m_keepAliveRate  = rate;
+    m_adaptKeepAlive = false;
     ClientProxy1_2::setHeartbeatRate(rate, rate * kKeepAlivesUntilDeath);
 }
 
@@ -94,7 +118,7 @@ ClientProxy1_3::addHeartbeatTimer()
         m_keepAliveTimer = m_events->newTimer(m_keepAliveRate, NULL);
         m_events->adoptHandler(Event::kTimer, m_keepAliveTimer,
                             new TMethodEventJob<ClientProxy1_3>(this,
-                                &ClientProxy1_3::handleKeepAlive, NULL));
+                                &ClientProxy1_3::handleKeepAliveTimer, NULL));
     }
 
     // superclass does the alarm
@@ -126,3 +150,107 @@ ClientProxy1_3::keepAlive()
 {
     ProtocolUtil::writef(getStream(), kMsgCKeepAlive);
 }
+
+const LinkQuality&
+ClientProxy1_3::getLinkQuality() const
+{
+    return m_link;
+}
+
+void
+ClientProxy1_3::handleKeepAliveTimer(const Event& event, void*)
+{
+    handleKeepAlive(event, NULL);
+    if (m_ping) {
+        sendPing();
+    }
+}
+
+void
+ClientProxy1_3::sendPing()
+{
+    std::uint32_t lost = m_link.getLost();
+    std::uint32_t id   = m_link.sending(inputleap::current_time_seconds());
+    if (m_link.getLost() != lost) {
+        LOG((CLOG_DEBUG "ping to \"%s\" went unanswered", getName().c_str()));
+        m_pingsLost->add();
+        adaptKeepAliveRate();
+    }
+    LOG((CLOG_DEBUG2 "send ping %u to \"%s\"", id, getName().c_str()));
+    ProtocolUtil::writef(getStream(), kMsgCPing, id, LinkQuality::getClockMicros());
+}
+
+bool
+ClientProxy1_3::recvPong()
+{
+    std::uint32_t id, serverMicros, clientMicros;
+    if (!ProtocolUtil::readf(getStream(), kMsgCPong + 4,
+                            &id, &serverMicros, &clientMicros)) {
+        return false;
+    }
+    resetHeartbeatTimer();
+
+    // id 0 says the client answers pings.  ping right away to get a
+    // first estimate.
+    if (id == 0) {
+        LOG((CLOG_DEBUG "client \"%s\" supports pings", getName().c_str()));
+        m_ping = true;
+        sendPing();
+        return true;
+    }
+
+    std::int32_t clockDelta = static_cast<std::int32_t>(clientMicros - serverMicros);
+    if (!m_link.received(id, inputleap::current_time_seconds(), clockDelta)) {
+        LOG((CLOG_DEBUG2 "ignored late pong %u from \"%s\"", id, getName().c_str()));
+        return true;
+    }
+
+    double rtt    = m_link.getRTT();
+    double offset = m_link.getClockOffset();
+    LOG((CLOG_DEBUG1 "pong %u from \"%s\": rtt %.3f ms, smoothed %.3f ms +/- %.3f ms, clock offset %+.3f ms",
+                            id, getName().c_str(), 1.0e+3 * m_link.getLastRTT(),
+                            1.0e+3 * rtt, 1.0e+3 * m_link.getRTTVariation(),
+                            1.0e+3 * offset));
+    INPUTLEAP_PROBE3(ping_rtt, this,
+                            static_cast<std::uint32_t>(1.0e+6 * m_link.getLastRTT()),
+                            static_cast<std::int32_t>(1.0e+6 * offset));
+    m_rttGauge->set(static_cast<std::int64_t>(1.0e+6 * rtt));
+    m_clockOffsetGauge->set(static_cast<std::int64_t>(1.0e+6 * offset));
+
+    // report the first estimate and then whenever it's changed a lot
+    if (m_reportedRTT == 0.0 ||
+        std::fabs(rtt - m_reportedRTT) > 0.5 * m_reportedRTT + 1.0e-3) {
+        m_reportedRTT = rtt;
+        LOG((CLOG_INFO "link to \"%s\": round trip %.1f ms, clock offset %+.1f ms",
+                            getName().c_str(), 1.0e+3 * rtt, 1.0e+3 * offset));
+    }
+
+    adaptKeepAliveRate();
+    return true;
+}
+
+void
+ClientProxy1_3::adaptKeepAliveRate()
+{
+    if (!m_adaptKeepAlive || m_keepAliveRate <= 0.0) {
+        return;
+    }
+
+    // ignore small changes
+    double rate = m_link.getKeepAliveRate();
+    if (std::fabs(rate - m_keepAliveRate) < 0.25 * m_keepAliveRate) {
+        return;
+    }
+    LOG((CLOG_INFO "keep alive rate for \"%s\" now %.1f s", getName().c_str(), rate));
+
+    // tell the client first so its alarm doesn't fire early
+    OptionsList options;
+    options.push_back(kOptionHeartbeat);
+    options.push_back(static_cast<std::uint32_t>(1.0e+3 * rate));
+    ProtocolUtil::writef(getStream(), kMsgDSetOptions, &options);
+
+    m_keepAliveRate = rate;
+    ClientProxy1_2::setHeartbeatRate(rate, rate * kKeepAlivesUntilDeath);
+    removeHeartbeatTimer();
+    addHeartbeatTimer();
+}
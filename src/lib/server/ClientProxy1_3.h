@@ -19,6 +19,10 @@
 #pragma once
 
 #include "server/ClientProxy1_2.h"
+#include "inputleap/LinkQuality.h"
+
+class MetricCounter;
+class MetricGauge;
 
 //! Proxy for client implementing protocol version 1.3
 class ClientProxy1_3 : public ClientProxy1_2 {
@@ -31,6 +35,12 @@ public:
 
     void                handleKeepAlive(const Event&, void*);
 
+    //! Get the estimated quality of the link to the client
+    /*!
+    Only measured if the client answers pings.
+    */
+    const LinkQuality&    getLinkQuality() const;
+
 protected:
     // ClientProxy overrides
     bool parseMessage(const std::uint8_t* code) override;
@@ -41,8 +51,24 @@ protected:
     void removeHeartbeatTimer() override;
     virtual void        keepAlive();
 
+private:
+    void                handleKeepAliveTimer(const Event&, void*);
+    void                sendPing();
+    bool                recvPong();
+    void                adaptKeepAliveRate();
+
 private:
     double                m_keepAliveRate;
     EventQueueTimer*    m_keepAliveTimer;
     IEventQueue*        m_events;
+
+    // link measurements.  the keep alive rate follows the link unless
+    // the heartbeat option set it.
+    bool                m_ping;
+    bool                m_adaptKeepAlive;
+    LinkQuality            m_link;
+    double                m_reportedRTT;
+    MetricGauge*        m_rttGauge;
+    MetricGauge*        m_clockOffsetGauge;
+    MetricCounter*        m_pingsLost;
 };
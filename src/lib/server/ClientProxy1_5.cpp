@@ -17,6 +17,7 @@
 
 #include "server/ClientProxy1_5.h"
 
+#include "server/ClientOutputQueue.h"
 #include "server/Server.h"
 #include "inputleap/FileChunk.h"
 #include "inputleap/StreamChunker.h"
@@ -57,7 +58,10 @@ void ClientProxy1_5::sendDragInfo(std::uint32_t fileCount, const char* info, siz
 
 void ClientProxy1_5::fileChunkSending(std::uint8_t mark, char* data, size_t dataSize)
 {
+    // a file can take a slow client a while but it isn't stalled
+    getOutputQueue()->setBulk(true);
     FileChunk::send(getStream(), mark, data, dataSize);
+    getOutputQueue()->setBulk(false);
 }
 
 bool ClientProxy1_5::parseMessage(const std::uint8_t* code)
@@ -17,10 +17,12 @@
 
 #include "server/ClientProxy1_6.h"
 
+#include "server/ClientOutputQueue.h"
 #include "server/Server.h"
 #include "inputleap/ProtocolUtil.h"
 #include "inputleap/StreamChunker.h"
 #include "inputleap/ClipboardChunk.h"
+#include "mt/Thread.h"
 #include "io/IStream.h"
 #include "base/TMethodEventJob.h"
 #include "base/Log.h"
@@ -32,7 +34,8 @@
 ClientProxy1_6::ClientProxy1_6(const std::string& name, inputleap::IStream* stream, Server* server,
                                IEventQueue* events) :
     ClientProxy1_5(name, stream, server, events),
-    m_events(events)
+    m_events(events),
+    m_clipboardStopping(false)
 {
     m_events->adoptHandler(m_events->forClipboard().clipboardSending(),
                                 this,
@@ -42,6 +45,16 @@ ClientProxy1_6::ClientProxy1_6(const std::string& name, inputleap::IStream* stre
 
 ClientProxy1_6::~ClientProxy1_6()
 {
+    // the thread's chunks are addressed to us so wait for it.  it stops
+    // after the clipboard it's on, dropping any others.
+    if (m_clipboardThread) {
+        {
+            std::lock_guard<std::mutex> lock(m_clipboardMutex);
+            m_clipboardStopping = true;
+        }
+        m_clipboardCond.notify_one();
+        m_clipboardThread->wait();
+    }
 }
 
 void
@@ -53,19 +66,64 @@ ClientProxy1_6::setClipboard(ClipboardID id, const IClipboard* clipboard)
         m_clipboard[id].m_dirty = false;
         Clipboard::copy(&m_clipboard[id].m_clipboard, clipboard);
 
-        std::string data = m_clipboard[id].m_clipboard.marshall();
-
-        size_t size = data.size();
         LOG((CLOG_DEBUG "sending clipboard %d to \"%s\"", id, getName().c_str()));
 
-        StreamChunker::sendClipboard(data, size, id, 0, m_events, this);
+        // queue it for the thread.  a newer copy replaces one that's
+        // still waiting.
+        {
+            std::lock_guard<std::mutex> lock(m_clipboardMutex);
+            ClipboardJob* job = NULL;
+            for (ClipboardJob& queued : m_clipboardJobs) {
+                if (queued.m_id == id) {
+                    job = &queued;
+                }
+            }
+            if (job == NULL) {
+                m_clipboardJobs.emplace_back();
+                job = &m_clipboardJobs.back();
+                job->m_id = id;
+            }
+            job->m_clipboard = m_clipboard[id].m_clipboard;
+        }
+        if (!m_clipboardThread) {
+            m_clipboardThread.reset(new Thread([this]() { clipboardThread(); }));
+        }
+        m_clipboardCond.notify_one();
+    }
+}
+
+void
+ClientProxy1_6::clipboardThread()
+{
+    std::unique_lock<std::mutex> lock(m_clipboardMutex);
+    for (;;) {
+        m_clipboardCond.wait(lock, [this]() {
+            return m_clipboardStopping || !m_clipboardJobs.empty();
+        });
+        if (m_clipboardStopping) {
+            return;
+        }
+
+        ClipboardJob job = std::move(m_clipboardJobs.front());
+        m_clipboardJobs.pop_front();
+        lock.unlock();
+
+        // chunks of consecutive clipboards don't interleave because
+        // they're all sent from here
+        std::string data = job.m_clipboard.marshall();
+        StreamChunker::sendClipboard(data, data.size(), job.m_id, 0, m_events, this);
+
+        lock.lock();
     }
 }
 
 void
 ClientProxy1_6::handleClipboardSendingEvent(const Event& event, void*)
 {
+    // a large clipboard can take a slow client a while to read
+    getOutputQueue()->setBulk(true);
     ClipboardChunk::send(getStream(), event.getData());
+    getOutputQueue()->setBulk(false);
 }
 
 bool
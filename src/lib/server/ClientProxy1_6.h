@@ -18,9 +18,16 @@
 #pragma once
 
 #include "server/ClientProxy1_5.h"
+#include "inputleap/Clipboard.h"
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
 
 class Server;
 class IEventQueue;
+class Thread;
 
 //! Proxy for client implementing protocol version 1.6
 class ClientProxy1_6 : public ClientProxy1_5 {
@@ -34,7 +41,23 @@ public:
 
 private:
     void                handleClipboardSendingEvent(const Event&, void*);
+    void                clipboardThread();
 
 private:
+    class ClipboardJob {
+    public:
+        ClipboardID        m_id;
+        Clipboard        m_clipboard;
+    };
+
     IEventQueue*        m_events;
+
+    // marshalls and chunks the clipboards we send, in order, like the
+    // server's file send thread, so a large clipboard doesn't hold up
+    // input.  it's started with the first clipboard.
+    std::unique_ptr<Thread> m_clipboardThread;
+    std::mutex            m_clipboardMutex;
+    std::condition_variable m_clipboardCond;
+    std::deque<ClipboardJob> m_clipboardJobs;
+    bool                m_clipboardStopping;
 };
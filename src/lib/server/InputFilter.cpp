@@ -19,6 +19,7 @@
 #include "server/InputFilter.h"
 #include "server/Server.h"
 #include "server/PrimaryClient.h"
+#include "inputleap/InputTraceWriter.h"
 #include "inputleap/KeyMap.h"
 #include "base/EventQueue.h"
 #include "base/Log.h"
@@ -26,6 +27,12 @@
 
 #include <cstdlib>
 #include <cstring>
+#include <utility>
+
+// modifiers that can't be combined with a mouse button
+static const KeyModifierMask s_buttonIgnoreMask =
+    KeyModifierAltGr | KeyModifierCapsLock |
+    KeyModifierNumLock | KeyModifierScrollLock;
 
 // -----------------------------------------------------------------------------
 // Input Filter Condition Classes
@@ -40,6 +47,12 @@ InputFilter::Condition::~Condition()
     // do nothing
 }
 
+InputFilter::EIndex
+InputFilter::Condition::getIndex(std::uint64_t&) const
+{
+    return kIndexNone;
+}
+
 void
 InputFilter::Condition::enablePrimary(PrimaryClient*)
 {
@@ -128,6 +141,13 @@ InputFilter::KeystrokeCondition::match(const Event& event)
     return status;
 }
 
+InputFilter::EIndex
+InputFilter::KeystrokeCondition::getIndex(std::uint64_t& key) const
+{
+    key = m_id;
+    return kIndexHotKey;
+}
+
 void
 InputFilter::KeystrokeCondition::enablePrimary(PrimaryClient* primary)
 {
@@ -191,13 +211,15 @@ std::string InputFilter::MouseButtonCondition::format() const
     return inputleap::string::sprintf("mousebutton(%s%d)", key.c_str(), m_button);
 }
 
+std::uint64_t
+InputFilter::MouseButtonCondition::getIndexKey(ButtonID button, KeyModifierMask mask)
+{
+    return (static_cast<std::uint64_t>(button) << 32) | (mask & ~s_buttonIgnoreMask);
+}
+
 InputFilter::EFilterStatus
 InputFilter::MouseButtonCondition::match(const Event& event)
 {
-    static const KeyModifierMask s_ignoreMask =
-        KeyModifierAltGr | KeyModifierCapsLock |
-        KeyModifierNumLock | KeyModifierScrollLock;
-
     EFilterStatus status;
 
     // check for hotkey events
@@ -217,13 +239,25 @@ InputFilter::MouseButtonCondition::match(const Event& event)
     IPlatformScreen::ButtonInfo* minfo =
         static_cast<IPlatformScreen::ButtonInfo*>(event.getData());
     if (minfo->m_button != m_button ||
-        (minfo->m_mask & ~s_ignoreMask) != m_mask) {
+        (minfo->m_mask & ~s_buttonIgnoreMask) != m_mask) {
         return kNoMatch;
     }
 
     return status;
 }
 
+InputFilter::EIndex
+InputFilter::MouseButtonCondition::getIndex(std::uint64_t& key) const
+{
+    // a mask with ignored modifiers never matches so it can't be found
+    // under the event's key
+    key = getIndexKey(m_button, m_mask);
+    if ((m_mask & s_buttonIgnoreMask) != 0) {
+        key = ~static_cast<std::uint64_t>(0);
+    }
+    return kIndexButton;
+}
+
 InputFilter::ScreenConnectedCondition::ScreenConnectedCondition(IEventQueue* events,
                                                                 const std::string& screen) :
     m_screen(screen),
@@ -681,6 +715,18 @@ InputFilter::Rule::Rule(const Rule& rule) :
     copy(rule);
 }
 
+// moving keeps the condition itself, and with it any hot key the
+// condition has registered, where copying would clone it
+InputFilter::Rule::Rule(Rule&& rule) noexcept :
+    m_condition(rule.m_condition),
+    m_activateActions(std::move(rule.m_activateActions)),
+    m_deactivateActions(std::move(rule.m_deactivateActions))
+{
+    rule.m_condition = NULL;
+    rule.m_activateActions.clear();
+    rule.m_deactivateActions.clear();
+}
+
 InputFilter::Rule::~Rule()
 {
     clear();
@@ -695,6 +741,21 @@ InputFilter::Rule::operator=(const Rule& rule)
     return *this;
 }
 
+InputFilter::Rule&
+InputFilter::Rule::operator=(Rule&& rule) noexcept
+{
+    if (&rule != this) {
+        clear();
+        m_condition         = rule.m_condition;
+        m_activateActions   = std::move(rule.m_activateActions);
+        m_deactivateActions = std::move(rule.m_deactivateActions);
+        rule.m_condition = NULL;
+        rule.m_activateActions.clear();
+        rule.m_deactivateActions.clear();
+    }
+    return *this;
+}
+
 void
 InputFilter::Rule::clear()
 {
@@ -896,7 +957,8 @@ const InputFilter::Action& InputFilter::Rule::getAction(bool onActivation,
 // -----------------------------------------------------------------------------
 InputFilter::InputFilter(IEventQueue* events) :
     m_primaryClient(NULL),
-    m_events(events)
+    m_events(events),
+    m_compiled(false)
 {
     // do nothing
 }
@@ -904,7 +966,8 @@ InputFilter::InputFilter(IEventQueue* events) :
 InputFilter::InputFilter(const InputFilter& x) :
     m_ruleList(x.m_ruleList),
     m_primaryClient(NULL),
-    m_events(x.m_events)
+    m_events(x.m_events),
+    m_compiled(false)
 {
     setPrimaryClient(x.m_primaryClient);
 }
@@ -918,12 +981,47 @@ InputFilter&
 InputFilter::operator=(const InputFilter& x)
 {
     if (&x != this) {
-        PrimaryClient* oldClient = m_primaryClient;
-        setPrimaryClient(NULL);
+        // keep the rules that are in both filters, along with any hot
+        // keys they've registered, so reloading a configuration only
+        // touches the rules that changed.  rules are matched by their
+        // formatted text.
+        RuleList oldRules;
+        oldRules.swap(m_ruleList);
+        std::unordered_multimap<std::string, std::size_t> oldIndex;
+        for (std::size_t i = 0; i < oldRules.size(); ++i) {
+            oldIndex.insert(std::make_pair(oldRules[i].format(), i));
+        }
+
+        std::vector<std::size_t> kept(x.m_ruleList.size(), oldRules.size());
+        for (std::size_t i = 0; i < x.m_ruleList.size(); ++i) {
+            auto match = oldIndex.find(x.m_ruleList[i].format());
+            if (match != oldIndex.end()) {
+                kept[i] = match->second;
+                oldIndex.erase(match);
+            }
+        }
 
-        m_ruleList = x.m_ruleList;
+        // disable the rules we're dropping before enabling new ones in
+        // case they want the same hot keys
+        if (m_primaryClient != NULL) {
+            for (const auto& dropped : oldIndex) {
+                oldRules[dropped.second].disable(m_primaryClient);
+            }
+        }
 
-        setPrimaryClient(oldClient);
+        m_ruleList.reserve(x.m_ruleList.size());
+        for (std::size_t i = 0; i < x.m_ruleList.size(); ++i) {
+            if (kept[i] != oldRules.size()) {
+                m_ruleList.push_back(std::move(oldRules[kept[i]]));
+            }
+            else {
+                m_ruleList.push_back(x.m_ruleList[i]);
+                if (m_primaryClient != NULL) {
+                    m_ruleList.back().enable(m_primaryClient);
+                }
+            }
+        }
+        m_compiled = false;
     }
     return *this;
 }
@@ -935,6 +1033,7 @@ InputFilter::addFilterRule(const Rule& rule)
     if (m_primaryClient != NULL) {
         m_ruleList.back().enable(m_primaryClient);
     }
+    m_compiled = false;
 }
 
 void InputFilter::removeFilterRule(std::uint32_t index)
@@ -943,10 +1042,13 @@ void InputFilter::removeFilterRule(std::uint32_t index)
         m_ruleList[index].disable(m_primaryClient);
     }
     m_ruleList.erase(m_ruleList.begin() + index);
+    m_compiled = false;
 }
 
 InputFilter::Rule& InputFilter::getRule(std::uint32_t index)
 {
+    // the caller may change the condition
+    m_compiled = false;
     return m_ruleList[index];
 }
 
@@ -1022,6 +1124,12 @@ InputFilter::setPrimaryClient(PrimaryClient* client)
             rule->enable(m_primaryClient);
         }
     }
+
+    // hot key ids have changed
+    m_compiled = false;
+    if (m_primaryClient != NULL) {
+        compileRules();
+    }
 }
 
 std::string InputFilter::format(const std::string& linePrefix) const
@@ -1041,6 +1149,97 @@ std::uint32_t InputFilter::getNumRules() const
     return static_cast<std::uint32_t>(m_ruleList.size());
 }
 
+bool
+InputFilter::applyRules(const Event& event)
+{
+    if (!m_compiled) {
+        compileRules();
+    }
+
+    // only the rules indexed under the event and the rules that can't be
+    // indexed might match.  try those, in the order they were added,
+    // until one does.
+    const RuleIndices& indexed = findRules(event);
+    RuleIndices::const_iterator i = indexed.begin();
+    RuleIndices::const_iterator j = m_otherRules.begin();
+    while (i != indexed.end() || j != m_otherRules.end()) {
+        std::uint32_t index;
+        if (j == m_otherRules.end() || (i != indexed.end() && *i < *j)) {
+            index = *i++;
+        }
+        else {
+            index = *j++;
+        }
+        if (m_ruleList[index].handleEvent(event)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void
+InputFilter::compileRules()
+{
+    m_hotKeyRules.clear();
+    m_buttonRules.clear();
+    m_otherRules.clear();
+    for (std::uint32_t i = 0; i < m_ruleList.size(); ++i) {
+        // NULL condition never matches
+        const Condition* condition = m_ruleList[i].getCondition();
+        if (condition == NULL) {
+            continue;
+        }
+
+        std::uint64_t key;
+        switch (condition->getIndex(key)) {
+        case kIndexHotKey:
+            m_hotKeyRules[key].push_back(i);
+            break;
+
+        case kIndexButton:
+            m_buttonRules[key].push_back(i);
+            break;
+
+        default:
+            m_otherRules.push_back(i);
+            break;
+        }
+    }
+
+    // looking up event types takes a lock so do it once here
+    m_hotKeyDown = m_events->forIPrimaryScreen().hotKeyDown();
+    m_hotKeyUp   = m_events->forIPrimaryScreen().hotKeyUp();
+    m_buttonDown = m_events->forIPrimaryScreen().buttonDown();
+    m_buttonUp   = m_events->forIPrimaryScreen().buttonUp();
+    m_compiled   = true;
+}
+
+const InputFilter::RuleIndices&
+InputFilter::findRules(const Event& event) const
+{
+    static const RuleIndices s_noRules;
+
+    const RuleIndex* index;
+    std::uint64_t key;
+    Event::Type type = event.getType();
+    if (type == m_hotKeyDown || type == m_hotKeyUp) {
+        index = &m_hotKeyRules;
+        key   = static_cast<IPrimaryScreen::HotKeyInfo*>(event.getData())->m_id;
+    }
+    else if (type == m_buttonDown || type == m_buttonUp) {
+        IPrimaryScreen::ButtonInfo* info =
+            static_cast<IPrimaryScreen::ButtonInfo*>(event.getData());
+        index = &m_buttonRules;
+        key   = MouseButtonCondition::getIndexKey(info->m_button, info->m_mask);
+    }
+    else {
+        return s_noRules;
+    }
+
+    RuleIndex::const_iterator i = index->find(key);
+    return (i == index->end()) ? s_noRules : i->second;
+}
+
 bool
 InputFilter::operator==(const InputFilter& x) const
 {
@@ -1074,18 +1273,19 @@ InputFilter::operator!=(const InputFilter& x) const
 void
 InputFilter::handleEvent(const Event& event, void*)
 {
+    // record the input as the screen reported it, before any rule
+    if (InputTraceWriter* trace = InputTraceWriter::getInstance()) {
+        trace->recordEvent(m_events, event);
+    }
+
     // copy event and adjust target
     Event myEvent(event.getType(), this, event.getData(),
                                 event.getFlags() | Event::kDontFreeData |
                                 Event::kDeliverImmediately);
 
-    // let each rule try to match the event until one does
-    for (RuleList::iterator rule  = m_ruleList.begin();
-                             rule != m_ruleList.end(); ++rule) {
-        if (rule->handleEvent(myEvent)) {
-            // handled
-            return;
-        }
+    if (applyRules(myEvent)) {
+        // handled
+        return;
     }
 
     // not handled so pass through
@@ -25,6 +25,8 @@
 #include "common/stdmap.h"
 #include "common/stdset.h"
 
+#include <unordered_map>
+
 class PrimaryClient;
 class Event;
 class IEventQueue;
@@ -40,6 +42,13 @@ public:
         kDeactivate
     };
 
+    // the kinds of event rules are indexed by
+    enum EIndex {
+        kIndexNone,
+        kIndexHotKey,
+        kIndexButton
+    };
+
     class Condition {
     public:
         Condition();
@@ -50,6 +59,11 @@ public:
 
         virtual EFilterStatus    match(const Event&) = 0;
 
+        // the events the condition can match.  returns kIndexNone if
+        // any event might match, otherwise the kind of event with \c key
+        // set to pick out the ones of that kind that match.
+        virtual EIndex            getIndex(std::uint64_t& key) const;
+
         virtual void            enablePrimary(PrimaryClient*);
         virtual void            disablePrimary(PrimaryClient*);
     };
@@ -68,6 +82,7 @@ public:
         Condition* clone() const override;
         std::string format() const override;
         EFilterStatus match(const Event&) override;
+        EIndex getIndex(std::uint64_t& key) const override;
         void enablePrimary(PrimaryClient*) override;
         void disablePrimary(PrimaryClient*) override;
 
@@ -88,10 +103,14 @@ public:
         ButtonID                getButton() const;
         KeyModifierMask            getMask() const;
 
+        // the key a button event with \c button and \c mask is indexed by
+        static std::uint64_t    getIndexKey(ButtonID button, KeyModifierMask mask);
+
         // Condition overrides
         Condition* clone() const override;
         std::string format() const override;
         EFilterStatus match(const Event&) override;
+        EIndex getIndex(std::uint64_t& key) const override;
 
     private:
         ButtonID                m_button;
@@ -275,9 +294,11 @@ public:
         Rule();
         Rule(Condition* adopted);
         Rule(const Rule&);
+        Rule(Rule&&) noexcept;
         ~Rule();
 
         Rule& operator=(const Rule&);
+        Rule& operator=(Rule&&) noexcept;
 
         // replace the condition
         void            setCondition(Condition* adopted);
@@ -333,7 +354,7 @@ public:
     virtual ~InputFilter();
 
 #ifdef INPUTLEAP_TEST_ENV
-    InputFilter() : m_primaryClient(NULL) { }
+    InputFilter() : m_primaryClient(NULL), m_compiled(false) { }
 #endif
 
     InputFilter&        operator=(const InputFilter&);
@@ -357,17 +378,41 @@ public:
     // get number of rules
     std::uint32_t getNumRules() const;
 
+    // perform the actions of the first rule that matches the event.
+    // returns false if no rule matches.
+    bool                applyRules(const Event&);
+
     //! Compare filters
     bool                operator==(const InputFilter&) const;
     //! Compare filters
     bool                operator!=(const InputFilter&) const;
 
 private:
+    typedef std::vector<std::uint32_t> RuleIndices;
+    typedef std::unordered_map<std::uint64_t, RuleIndices> RuleIndex;
+
     // event handling
     void                handleEvent(const Event&, void*);
 
+    // index the rules by the events they match
+    void                compileRules();
+
+    // get the indexed rules that might match the event
+    const RuleIndices&    findRules(const Event&) const;
+
 private:
     RuleList            m_ruleList;
     PrimaryClient*        m_primaryClient;
     IEventQueue*        m_events;
+
+    // rules matching hot keys by id, buttons by button and modifiers,
+    // and the rest, each in the order added
+    bool                m_compiled;
+    RuleIndex            m_hotKeyRules;
+    RuleIndex            m_buttonRules;
+    RuleIndices            m_otherRules;
+    Event::Type            m_hotKeyDown;
+    Event::Type            m_hotKeyUp;
+    Event::Type            m_buttonDown;
+    Event::Type            m_buttonUp;
 };
@@ -0,0 +1,139 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/ScreenTopology.h"
+
+#include "server/Config.h"
+
+#include <algorithm>
+#include <cassert>
+
+//
+// ScreenTopology
+//
+
+const ScreenTopology::ScreenID ScreenTopology::kNoScreen = ~0u;
+
+ScreenTopology::ScreenTopology() :
+    m_sides(1, 0)
+{
+    // do nothing
+}
+
+ScreenTopology::ScreenTopology(const Config& config)
+{
+    // number the screens
+    for (Config::const_iterator i = config.begin(); i != config.end(); ++i) {
+        m_ids[*i] = static_cast<ScreenID>(m_names.size());
+        m_names.push_back(*i);
+    }
+    for (Config::all_const_iterator i = config.beginAll();
+                            i != config.endAll(); ++i) {
+        IDMap::const_iterator id = m_ids.find(i->second);
+        if (id != m_ids.end()) {
+            m_ids.insert(std::make_pair(i->first, id->second));
+        }
+    }
+
+    // copy the links.  the config keeps each screen's links sorted by
+    // side and then by position so we can take them in order.
+    m_sides.reserve(kNumDirections * m_names.size() + 1);
+    m_sides.push_back(0);
+    for (const std::string& name : m_names) {
+        Config::link_const_iterator link = config.beginNeighbor(name);
+        Config::link_const_iterator end  = config.endNeighbor(name);
+        for (int side = kFirstDirection; side <= kLastDirection; ++side) {
+            for (; link != end && link->first.getSide() == side; ++link) {
+                Config::Interval src = link->first.getInterval();
+                Config::Interval dst = link->second.getInterval();
+                Link compiled;
+                compiled.m_start     = src.first;
+                compiled.m_end       = src.second;
+                compiled.m_length    = src.second - src.first;
+                compiled.m_dstStart  = dst.first;
+                compiled.m_dstLength = dst.second - dst.first;
+                compiled.m_dst       = getScreenID(link->second.getName());
+                m_links.push_back(compiled);
+            }
+            m_sides.push_back(static_cast<std::uint32_t>(m_links.size()));
+        }
+        assert(link == end);
+    }
+}
+
+std::uint32_t
+ScreenTopology::getNumScreens() const
+{
+    return static_cast<std::uint32_t>(m_names.size());
+}
+
+ScreenTopology::ScreenID
+ScreenTopology::getScreenID(const std::string& name) const
+{
+    IDMap::const_iterator i = m_ids.find(name);
+    if (i == m_ids.end()) {
+        return kNoScreen;
+    }
+    return i->second;
+}
+
+const std::string&
+ScreenTopology::getName(ScreenID id) const
+{
+    assert(id < m_names.size());
+    return m_names[id];
+}
+
+bool
+ScreenTopology::hasNeighbor(ScreenID id, EDirection side) const
+{
+    assert(id < m_names.size());
+    assert(side >= kFirstDirection && side <= kLastDirection);
+
+    std::size_t j = kNumDirections * id + (side - kFirstDirection);
+    return m_sides[j] != m_sides[j + 1];
+}
+
+ScreenTopology::ScreenID
+ScreenTopology::getNeighbor(ScreenID id, EDirection side,
+                            float position, float* positionOut) const
+{
+    assert(id < m_names.size());
+    assert(side >= kFirstDirection && side <= kLastDirection);
+
+    // find the last link starting at or before position
+    std::size_t j = kNumDirections * id + (side - kFirstDirection);
+    const Link* begin = m_links.data() + m_sides[j];
+    const Link* end   = m_links.data() + m_sides[j + 1];
+    const Link* link  = std::upper_bound(begin, end, position,
+                            [](float x, const Link& l) { return x < l.m_start; });
+    if (link == begin) {
+        return kNoScreen;
+    }
+    --link;
+    if (position < link->m_start || position >= link->m_end) {
+        return kNoScreen;
+    }
+
+    // same arithmetic as Config::CellEdge::transform() and
+    // inverseTransform() so we get the same answer
+    if (positionOut != NULL) {
+        *positionOut = ((position - link->m_start) / link->m_length) *
+                            link->m_dstLength + link->m_dstStart;
+    }
+    return link->m_dst;
+}
@@ -0,0 +1,114 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "inputleap/protocol_types.h"
+#include "base/String.h"
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+class Config;
+
+//! Compiled screen layout
+/*!
+The links between screens from a Config, compiled for routing the
+cursor.  Screens are numbered from 0 in the order of their canonical
+names so the server can keep per screen state in arrays.  Each side of
+each screen has its links in an array sorted by position along the
+side, and each link holds what it needs to map a position to the
+neighbor.  Looking up a neighbor is then a binary search with no string
+comparisons or allocations.
+
+A topology doesn't change after it's built.  The server builds a new one
+whenever its configuration changes.
+*/
+class ScreenTopology {
+public:
+    //! Screen number
+    typedef std::uint32_t ScreenID;
+
+    //! The id of no screen
+    static const ScreenID kNoScreen;
+
+    //! Create a topology with no screens
+    ScreenTopology();
+
+    //! Compile the screens and links in \p config
+    explicit ScreenTopology(const Config& config);
+
+    //! @name accessors
+    //@{
+
+    //! Get the number of screens
+    std::uint32_t        getNumScreens() const;
+
+    //! Get a screen's id
+    /*!
+    \p name may be a canonical name or an alias and case is ignored.
+    Returns kNoScreen if there's no such screen.
+    */
+    ScreenID            getScreenID(const std::string& name) const;
+
+    //! Get a screen's canonical name
+    const std::string&    getName(ScreenID id) const;
+
+    //! Test for a neighbor
+    /*!
+    Returns true iff any part of side \p side of screen \p id is linked
+    to a neighbor.
+    */
+    bool                hasNeighbor(ScreenID id, EDirection side) const;
+
+    //! Get a neighbor
+    /*!
+    Returns the screen linked to side \p side of screen \p id at
+    \p position, which goes from 0 at the left or top to 1 at the right
+    or bottom.  Returns kNoScreen if there's no link there or the link
+    goes to an unknown screen.  If \p positionOut isn't NULL it's set to
+    the position on the neighbor's opposite side.  This matches
+    Config::getNeighbor().
+    */
+    ScreenID            getNeighbor(ScreenID id, EDirection side,
+                            float position, float* positionOut) const;
+
+    //@}
+
+private:
+    class Link {
+    public:
+        float            m_start;
+        float            m_end;
+        float            m_length;
+        float            m_dstStart;
+        float            m_dstLength;
+        ScreenID        m_dst;
+    };
+    typedef std::map<std::string, ScreenID,
+                            inputleap::string::CaselessCmp> IDMap;
+
+    std::vector<std::string> m_names;
+    IDMap                m_ids;
+
+    // the links on side s of screen i are m_links[m_sides[j]] up to but
+    // not including m_links[m_sides[j + 1]] where j = i * 4 + s
+    std::vector<Link>    m_links;
+    std::vector<std::uint32_t> m_sides;
+};
@@ -31,6 +31,9 @@
 #include "inputleap/XBarrier.h"
 #include "inputleap/StreamChunker.h"
 #include "inputleap/KeyState.h"
+#include "inputleap/InputTraceWriter.h"
+#include "inputleap/LatencyTrace.h"
+#include "inputleap/ProtocolUtil.h"
 #include "inputleap/Screen.h"
 #include "inputleap/PacketStreamFilter.h"
 #include "net/TCPSocket.h"
@@ -41,6 +44,7 @@
 #include "arch/Arch.h"
 #include "base/IEventQueue.h"
 #include "base/Log.h"
+#include "base/Probes.h"
 #include "base/Time.h"
 #include "base/TMethodEventJob.h"
 
@@ -50,6 +54,7 @@
 #include <fstream>
 #include <ctime>
 #include <stdexcept>
+#include <random>
 //
 // Server
 //
@@ -69,6 +74,7 @@ Server::Server(
 	m_xDelta2(0),
 	m_yDelta2(0),
 	m_config(&config),
+	m_keyTargetsValid(false),
 	m_inputFilter(config.getInputFilter()),
 	m_activeSaver(NULL),
 	m_switchDir(kNoDirection),
@@ -260,6 +266,9 @@ Server::~Server()
 		m_events->removeHandler(m_events->forClientProxy().disconnected(), client);
 		delete client;
 	}
+	while (!m_detachedClients.empty()) {
+		removeDetachedClient(m_detachedClients.begin()->first);
+	}
 
 	// remove input filter
 	m_inputFilter->setPrimaryClient(NULL);
@@ -282,6 +291,7 @@ Server::setConfig(const Config& config)
 	closeClients(config);
 
 	// cut over
+	compileTopology();
 	processOptions();
 
 	// add ScrollLock as a hotkey to lock to the screen.  this was a
@@ -302,11 +312,18 @@ Server::setConfig(const Config& config)
 	// tell primary screen about reconfiguration
 	m_primaryClient->reconfigure(getActivePrimarySides());
 
-	// tell all (connected) clients about current options
+	// tell (connected) clients about current options.  only clients
+	// whose options changed hear about it so a reload doesn't disturb
+	// the other screens.
 	for (ClientList::const_iterator index = m_clients.begin();
 								index != m_clients.end(); ++index) {
 		BaseClientProxy* client = index->second;
-		sendOptions(client);
+		OptionsList optionsList;
+		getOptions(client, optionsList);
+		SentOptions::const_iterator sent = m_sentOptions.find(client);
+		if (sent == m_sentOptions.end() || sent->second != optionsList) {
+			sendOptions(client, optionsList);
+		}
 	}
 
 	return true;
@@ -329,6 +346,19 @@ Server::adoptClient(BaseClientProxy* client)
 		return;
 	}
 
+	// a client that lost its connection can reconnect before we notice.
+	// if it's resuming the session of the client we think is connected
+	// then that connection is the one that dropped.
+	std::uint64_t resumeToken = client->getResumeToken();
+	if (resumeToken != 0) {
+		ClientList::const_iterator index = m_clients.find(getName(client));
+		if (index != m_clients.end() &&
+			index->second->getSessionToken() == resumeToken) {
+			LOG((CLOG_NOTE "client \"%s\" has reconnected", getName(client).c_str()));
+			detachClient(index->second);
+		}
+	}
+
 	// add client to client list
 	if (!addClient(client)) {
 		// can only have one screen with a given name at any given time
@@ -338,8 +368,14 @@ Server::adoptClient(BaseClientProxy* client)
 	}
 	LOG((CLOG_NOTE "client \"%s\" has connected", getName(client).c_str()));
 
-	// send configuration options to client
-	sendOptions(client);
+	// pick up where the client left off if it's resuming its session,
+	// otherwise start a new one and send configuration options
+	if (!resumeClient(client)) {
+		client->setSessionToken(newSessionToken());
+		OptionsList optionsList;
+		getOptions(client, optionsList);
+		sendOptions(client, optionsList);
+	}
 
 	// activate screen saver on new client if active on the primary screen
 	if (m_activeSaver != NULL) {
@@ -458,6 +494,10 @@ void Server::switchScreen(BaseClientProxy* dst, std::int32_t x, std::int32_t y,
 	assert(m_active != NULL);
 
 	LOG((CLOG_INFO "switch from \"%s\" to \"%s\" at %d,%d", getName(m_active).c_str(), getName(dst).c_str(), x, y));
+	if (InputTraceWriter* trace = InputTraceWriter::getInstance()) {
+		trace->recordSwitch(getName(dst), x, y);
+	}
+	INPUTLEAP_PROBE4(screen_switch, getName(m_active).c_str(), getName(dst).c_str(), x, y);
 
 	// stop waiting to switch
 	stopSwitch();
@@ -587,7 +627,8 @@ Server::hasAnyNeighbor(BaseClientProxy* client, EDirection dir) const
 {
 	assert(client != NULL);
 
-	return m_config->hasNeighbor(getName(client), dir);
+	ScreenTopology::ScreenID id = client->getScreenID();
+	return id != ScreenTopology::kNoScreen && m_topology.hasNeighbor(id, dir);
 }
 
 BaseClientProxy* Server::getNeighbor(BaseClientProxy* src, EDirection dir, std::int32_t& x,
@@ -597,10 +638,12 @@ BaseClientProxy* Server::getNeighbor(BaseClientProxy* src, EDirection dir, std::
 
 	assert(src != NULL);
 
-	// get source screen name
-    std::string srcName = getName(src);
-	assert(!srcName.empty());
-	LOG((CLOG_DEBUG2 "find neighbor on %s of \"%s\"", Config::dirName(dir), srcName.c_str()));
+	// get source screen
+	ScreenTopology::ScreenID srcID = src->getScreenID();
+	if (srcID == ScreenTopology::kNoScreen) {
+		return NULL;
+	}
+	LOG((CLOG_DEBUG2 "find neighbor on %s of \"%s\"", Config::dirName(dir), m_topology.getName(srcID).c_str()));
 
 	// convert position to fraction
 	float t = mapToFraction(src, dir, x, y);
@@ -608,29 +651,29 @@ BaseClientProxy* Server::getNeighbor(BaseClientProxy* src, EDirection dir, std::
 	// search for the closest neighbor that exists in direction dir
 	float tTmp;
 	for (;;) {
-        std::string dstName(m_config->getNeighbor(srcName, dir, t, &tTmp));
+		ScreenTopology::ScreenID dstID = m_topology.getNeighbor(srcID, dir, t, &tTmp);
 
 		// if nothing in that direction then return NULL. if the
 		// destination is the source then we can make no more
 		// progress in this direction.  since we haven't found a
 		// connected neighbor we return NULL.
-		if (dstName.empty()) {
-			LOG((CLOG_DEBUG2 "no neighbor on %s of \"%s\"", Config::dirName(dir), srcName.c_str()));
+		if (dstID == ScreenTopology::kNoScreen) {
+			LOG((CLOG_DEBUG2 "no neighbor on %s of \"%s\"", Config::dirName(dir), m_topology.getName(srcID).c_str()));
 			return NULL;
 		}
 
 		// look up neighbor cell.  if the screen is connected and
 		// ready then we can stop.
-		ClientList::const_iterator index = m_clients.find(dstName);
-		if (index != m_clients.end()) {
-			LOG((CLOG_DEBUG2 "\"%s\" is on %s of \"%s\" at %f", dstName.c_str(), Config::dirName(dir), srcName.c_str(), t));
-			mapToPixel(index->second, dir, tTmp, x, y);
-			return index->second;
+		BaseClientProxy* dst = m_screenClients[dstID];
+		if (dst != NULL) {
+			LOG((CLOG_DEBUG2 "\"%s\" is on %s of \"%s\" at %f", m_topology.getName(dstID).c_str(), Config::dirName(dir), m_topology.getName(srcID).c_str(), t));
+			mapToPixel(dst, dir, tTmp, x, y);
+			return dst;
 		}
 
 		// skip over unconnected screen
-		LOG((CLOG_DEBUG2 "ignored \"%s\" on %s of \"%s\"", dstName.c_str(), Config::dirName(dir), srcName.c_str()));
-		srcName = dstName;
+		LOG((CLOG_DEBUG2 "ignored \"%s\" on %s of \"%s\"", m_topology.getName(dstID).c_str(), Config::dirName(dir), m_topology.getName(srcID).c_str()));
+		srcID = dstID;
 
 		// use position on skipped screen
 		t = tTmp;
@@ -745,6 +788,61 @@ BaseClientProxy* Server::mapToNeighbor(BaseClientProxy* src, EDirection srcSide,
 	return dst;
 }
 
+void
+Server::compileTopology()
+{
+	m_topology = ScreenTopology(*m_config);
+	m_screenClients.assign(m_topology.getNumScreens(), NULL);
+	m_keyTargetsValid = false;
+	for (ClientList::const_iterator index = m_clients.begin();
+								index != m_clients.end(); ++index) {
+		BaseClientProxy* client = index->second;
+		ScreenTopology::ScreenID id = m_topology.getScreenID(client->getName());
+		client->setScreenID(id);
+		if (id != ScreenTopology::kNoScreen) {
+			m_screenClients[id] = client;
+		}
+	}
+}
+
+const std::vector<ScreenTopology::ScreenID>&
+Server::getKeyTargets(const char* screens)
+{
+	assert(screens != NULL);
+
+	if (!m_keyTargetsValid || m_keyTargetsScreens != screens) {
+		m_keyTargetsScreens = screens;
+		m_keyTargets.clear();
+		for (ScreenTopology::ScreenID id = 0; id < m_topology.getNumScreens(); ++id) {
+			if (IKeyState::KeyInfo::contains(screens, m_topology.getName(id))) {
+				m_keyTargets.push_back(id);
+			}
+		}
+		m_keyTargetsValid = true;
+	}
+	return m_keyTargets;
+}
+
+void
+Server::sendKeyToTargets(const std::vector<ScreenTopology::ScreenID>& targets,
+				bool down, KeyID id, KeyModifierMask mask, KeyButton button)
+{
+	ProtocolUtil::encodef(m_keyMessage, down ? kMsgDKeyDown : kMsgDKeyUp,
+							id, mask, button);
+	for (ScreenTopology::ScreenID target : targets) {
+		BaseClientProxy* client = m_screenClients[target];
+		if (client != NULL && !client->sendEncodedKey(m_keyMessage)) {
+			// the primary screen and old clients
+			if (down) {
+				client->keyDown(id, mask, button);
+			}
+			else {
+				client->keyUp(id, mask, button);
+			}
+		}
+	}
+}
+
 void Server::avoidJumpZone(BaseClientProxy* dst, EDirection dir, std::int32_t& x,
                            std::int32_t& y) const
 {
@@ -753,7 +851,10 @@ void Server::avoidJumpZone(BaseClientProxy* dst, EDirection dir, std::int32_t& x
 		return;
 	}
 
-    const std::string dstName(getName(dst));
+	ScreenTopology::ScreenID dstID = dst->getScreenID();
+	if (dstID == ScreenTopology::kNoScreen) {
+		return;
+	}
 	std::int32_t dx, dy, dw, dh;
 	dst->getShape(dx, dy, dw, dh);
 	float t = mapToFraction(dst, dir, x, y);
@@ -764,25 +865,25 @@ void Server::avoidJumpZone(BaseClientProxy* dst, EDirection dir, std::int32_t& x
 	// don't need to move inwards because that side can't provoke a jump.
 	switch (dir) {
 	case kLeft:
-		if (!m_config->getNeighbor(dstName, kRight, t, NULL).empty() &&
+		if (m_topology.getNeighbor(dstID, kRight, t, NULL) != ScreenTopology::kNoScreen &&
 			x > dx + dw - 1 - z)
 			x = dx + dw - 1 - z;
 		break;
 
 	case kRight:
-		if (!m_config->getNeighbor(dstName, kLeft, t, NULL).empty() &&
+		if (m_topology.getNeighbor(dstID, kLeft, t, NULL) != ScreenTopology::kNoScreen &&
 			x < dx + z)
 			x = dx + z;
 		break;
 
 	case kTop:
-		if (!m_config->getNeighbor(dstName, kBottom, t, NULL).empty() &&
+		if (m_topology.getNeighbor(dstID, kBottom, t, NULL) != ScreenTopology::kNoScreen &&
 			y > dy + dh - 1 - z)
 			y = dy + dh - 1 - z;
 		break;
 
 	case kBottom:
-		if (!m_config->getNeighbor(dstName, kTop, t, NULL).empty() &&
+		if (m_topology.getNeighbor(dstID, kTop, t, NULL) != ScreenTopology::kNoScreen &&
 			y < dy + z)
 			y = dy + z;
 		break;
@@ -1087,9 +1188,9 @@ Server::stopRelativeMoves()
 }
 
 void
-Server::sendOptions(BaseClientProxy* client) const
+Server::getOptions(BaseClientProxy* client, OptionsList& optionsList) const
 {
-	OptionsList optionsList;
+	optionsList.clear();
 
 	// look up options for client
 	const Config::ScreenOptions* options =
@@ -1116,9 +1217,32 @@ Server::sendOptions(BaseClientProxy* client) const
 		}
 	}
 
-	// send the options
+	// ask clients that can to help trace latency
+	if (LatencyTrace::getInstance() != NULL) {
+		optionsList.push_back(kOptionLatencyTrace);
+		optionsList.push_back(1);
+	}
+
+	// ask clients that can to answer pings so we can measure the link
+	optionsList.push_back(kOptionPing);
+	optionsList.push_back(1);
+
+	// give clients that can resume their session the token to do it
+	std::uint64_t token = client->getSessionToken();
+	if (token != 0) {
+		optionsList.push_back(kOptionSessionHigh);
+		optionsList.push_back(static_cast<std::uint32_t>(token >> 32));
+		optionsList.push_back(kOptionSessionLow);
+		optionsList.push_back(static_cast<std::uint32_t>(token));
+	}
+}
+
+void
+Server::sendOptions(BaseClientProxy* client, const OptionsList& optionsList)
+{
 	client->resetOptions();
 	client->setOptions(optionsList);
+	m_sentOptions[client] = optionsList;
 }
 
 void
@@ -1139,18 +1263,25 @@ Server::processOptions()
 		const OptionID id       = index->first;
 		const OptionValue value = index->second;
 		if (id == kOptionScreenSwitchDelay) {
-			m_switchWaitDelay = 1.0e-3 * static_cast<double>(value);
-			if (m_switchWaitDelay < 0.0) {
-				m_switchWaitDelay = 0.0;
+			double delay = 1.0e-3 * static_cast<double>(value);
+			if (delay < 0.0) {
+				delay = 0.0;
+			}
+			// leave a pending switch alone unless its delay changed
+			if (delay != m_switchWaitDelay) {
+				m_switchWaitDelay = delay;
+				stopSwitchWait();
 			}
-			stopSwitchWait();
 		}
 		else if (id == kOptionScreenSwitchTwoTap) {
-			m_switchTwoTapDelay = 1.0e-3 * static_cast<double>(value);
-			if (m_switchTwoTapDelay < 0.0) {
-				m_switchTwoTapDelay = 0.0;
+			double delay = 1.0e-3 * static_cast<double>(value);
+			if (delay < 0.0) {
+				delay = 0.0;
+			}
+			if (delay != m_switchTwoTapDelay) {
+				m_switchTwoTapDelay = delay;
+				stopSwitchTwoTap();
 			}
-			stopSwitchTwoTap();
 		}
 		else if (id == kOptionScreenSwitchNeedsControl) {
 			m_switchNeedsControl = (value != 0);
@@ -1321,6 +1452,9 @@ Server::handleButtonUpEvent(const Event& event, void*)
 void
 Server::handleMotionPrimaryEvent(const Event& event, void*)
 {
+	if (InputTraceWriter* trace = InputTraceWriter::getInstance()) {
+		trace->recordEvent(m_events, event);
+	}
 	IPlatformScreen::MotionInfo* info =
 		static_cast<IPlatformScreen::MotionInfo*>(event.getData());
 	onMouseMovePrimary(info->m_x, info->m_y);
@@ -1329,6 +1463,9 @@ Server::handleMotionPrimaryEvent(const Event& event, void*)
 void
 Server::handleMotionSecondaryEvent(const Event& event, void*)
 {
+	if (InputTraceWriter* trace = InputTraceWriter::getInstance()) {
+		trace->recordEvent(m_events, event);
+	}
 	IPlatformScreen::MotionInfo* info =
 		static_cast<IPlatformScreen::MotionInfo*>(event.getData());
 	onMouseMoveSecondary(info->m_x, info->m_y);
@@ -1337,6 +1474,9 @@ Server::handleMotionSecondaryEvent(const Event& event, void*)
 void
 Server::handleWheelEvent(const Event& event, void*)
 {
+	if (InputTraceWriter* trace = InputTraceWriter::getInstance()) {
+		trace->recordEvent(m_events, event);
+	}
 	IPlatformScreen::WheelInfo* info =
 		static_cast<IPlatformScreen::WheelInfo*>(event.getData());
 	onMouseWheel(info->m_xDelta, info->m_yDelta);
@@ -1373,7 +1513,12 @@ Server::handleClientDisconnected(const Event&, void* vclient)
 {
 	// client has disconnected.  it might be an old client or an
 	// active client.  we don't care so just handle it both ways.
+	// an active client with a session might come right back, though.
 	BaseClientProxy* client = static_cast<BaseClientProxy*>(vclient);
+	if (client->getSessionToken() != 0 && m_clientSet.count(client) != 0) {
+		detachClient(client);
+		return;
+	}
 	removeActiveClient(client);
 	removeOldClient(client);
 
@@ -1391,6 +1536,15 @@ Server::handleClientCloseTimeout(const Event&, void* vclient)
 	delete client;
 }
 
+void
+Server::handleDetachedClientTimeout(const Event&, void* vclient)
+{
+	// client didn't come back in time.  forget its session.
+	BaseClientProxy* client = static_cast<BaseClientProxy*>(vclient);
+	LOG((CLOG_DEBUG "session of client \"%s\" expired", getName(client).c_str()));
+	removeDetachedClient(getName(client));
+}
+
 void
 Server::handleSwitchToScreenEvent(const Event& event, void*)
 {
@@ -1635,6 +1789,10 @@ Server::onKeyDown(KeyID id, KeyModifierMask mask, KeyButton button,
 	LOG((CLOG_DEBUG1 "onKeyDown id=%d mask=0x%04x button=0x%04x", id, mask, button));
 	assert(m_active != NULL);
 
+	if (LatencyTrace* trace = LatencyTrace::getInstance()) {
+		trace->dispatched();
+	}
+
 	// relay
 	if (!m_keyboardBroadcasting && IKeyState::KeyInfo::isDefault(screens)) {
 		m_active->keyDown(id, mask, button);
@@ -1646,12 +1804,7 @@ Server::onKeyDown(KeyID id, KeyModifierMask mask, KeyButton button,
 				screens = "*";
 			}
 		}
-		for (ClientList::const_iterator index = m_clients.begin();
-								index != m_clients.end(); ++index) {
-			if (IKeyState::KeyInfo::contains(screens, index->first)) {
-				index->second->keyDown(id, mask, button);
-			}
-		}
+		sendKeyToTargets(getKeyTargets(screens), true, id, mask, button);
 	}
 }
 
@@ -1673,12 +1826,7 @@ Server::onKeyUp(KeyID id, KeyModifierMask mask, KeyButton button,
 				screens = "*";
 			}
 		}
-		for (ClientList::const_iterator index = m_clients.begin();
-								index != m_clients.end(); ++index) {
-			if (IKeyState::KeyInfo::contains(screens, index->first)) {
-				index->second->keyUp(id, mask, button);
-			}
-		}
+		sendKeyToTargets(getKeyTargets(screens), false, id, mask, button);
 	}
 }
 
@@ -1734,6 +1882,7 @@ Server::onMouseUp(ButtonID id)
 bool Server::onMouseMovePrimary(std::int32_t x, std::int32_t y)
 {
 	LOG((CLOG_DEBUG4 "onMouseMovePrimary %d,%d", x, y));
+	INPUTLEAP_PROBE2(mouse_move_primary, x, y);
 
 	// mouse move on primary (server's) screen
 	if (m_active != m_primaryClient) {
@@ -1894,6 +2043,10 @@ void Server::onMouseMoveSecondary(std::int32_t dx, std::int32_t dy)
 		return;
 	}
 
+	if (LatencyTrace* trace = LatencyTrace::getInstance()) {
+		trace->dispatched();
+	}
+
 	// if doing relative motion on secondary screens and we're locked
 	// to the screen (which activates relative moves) then send a
 	// relative mouse motion.  when we're doing this we pretend as if
@@ -2117,6 +2270,11 @@ Server::addClient(BaseClientProxy* client)
 	// add to list
 	m_clientSet.insert(client);
 	m_clients.insert(std::make_pair(name, client));
+	ScreenTopology::ScreenID id = m_topology.getScreenID(name);
+	client->setScreenID(id);
+	if (id != ScreenTopology::kNoScreen) {
+		m_screenClients[id] = client;
+	}
 
 	// initialize client data
 	std::int32_t x, y;
@@ -2149,6 +2307,12 @@ Server::removeClient(BaseClientProxy* client)
 	// remove from list
 	m_clients.erase(getName(client));
 	m_clientSet.erase(i);
+	m_sentOptions.erase(client);
+	ScreenTopology::ScreenID id = client->getScreenID();
+	if (id != ScreenTopology::kNoScreen && m_screenClients[id] == client) {
+		m_screenClients[id] = NULL;
+	}
+	client->setScreenID(ScreenTopology::kNoScreen);
 
 	return true;
 }
@@ -2241,6 +2405,117 @@ Server::removeOldClient(BaseClientProxy* client)
 	}
 }
 
+void
+Server::detachClient(BaseClientProxy* client)
+{
+	std::string name = getName(client);
+	removeDetachedClient(name);
+
+	// note what the client had so we can tell what changed if it
+	// resumes its session
+	DetachedClient& detached = m_detachedClients[name];
+	detached.m_client = client;
+	SentOptions::const_iterator sent = m_sentOptions.find(client);
+	if (sent != m_sentOptions.end()) {
+		detached.m_options = sent->second;
+	}
+	for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
+		detached.m_clipboardOwner[id] = m_clipboards[id].m_clipboardOwner;
+		detached.m_clipboardData[id]  = m_clipboards[id].m_clipboardData;
+	}
+	detached.m_wasActive = (client == m_active);
+	detached.m_x         = m_x;
+	detached.m_y         = m_y;
+
+	// the cursor can't stay on a screen we can't reach
+	removeActiveClient(client);
+	detached.m_primaryX = m_x;
+	detached.m_primaryY = m_y;
+	detached.m_seqNum   = m_seqNum;
+
+	detached.m_timer = m_events->newOneShotTimer(kResumeGracePeriod, NULL);
+	m_events->adoptHandler(Event::kTimer, detached.m_timer,
+							new TMethodEventJob<Server>(this,
+								&Server::handleDetachedClientTimeout, client));
+	LOG((CLOG_DEBUG "holding session of client \"%s\" for %.0f seconds", name.c_str(), kResumeGracePeriod));
+}
+
+void
+Server::removeDetachedClient(const std::string& name)
+{
+	DetachedClients::iterator index = m_detachedClients.find(name);
+	if (index != m_detachedClients.end()) {
+		m_events->removeHandler(Event::kTimer, index->second.m_timer);
+		m_events->deleteTimer(index->second.m_timer);
+		delete index->second.m_client;
+		m_detachedClients.erase(index);
+	}
+}
+
+bool
+Server::resumeClient(BaseClientProxy* client)
+{
+	std::string name = getName(client);
+	std::uint64_t token = client->getResumeToken();
+	DetachedClients::iterator index = m_detachedClients.find(name);
+	if (token == 0 || index == m_detachedClients.end() ||
+		index->second.m_client->getSessionToken() != token) {
+		// tell the client if it asked for a session we don't have
+		client->resumeSession(NULL, OptionsList());
+		return false;
+	}
+
+	const DetachedClient& detached = index->second;
+	if (!client->resumeSession(detached.m_client, detached.m_options)) {
+		return false;
+	}
+	LOG((CLOG_NOTE "client \"%s\" has resumed its session", name.c_str()));
+
+	// send the options only if they changed while the client was away
+	OptionsList optionsList;
+	getOptions(client, optionsList);
+	if (optionsList != detached.m_options) {
+		sendOptions(client, optionsList);
+	}
+	else {
+		m_sentOptions[client] = optionsList;
+	}
+
+	// tell the client about clipboards that changed meanwhile
+	for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
+		if (m_clipboards[id].m_clipboardOwner != detached.m_clipboardOwner[id] ||
+			m_clipboards[id].m_clipboardData != detached.m_clipboardData[id]) {
+			client->grabClipboard(id);
+		}
+	}
+
+	// put the cursor back if it was on the client and nobody has
+	// touched it since
+	if (detached.m_wasActive && m_active == m_primaryClient &&
+		m_activeSaver == NULL && m_seqNum == detached.m_seqNum &&
+		m_x == detached.m_primaryX && m_y == detached.m_primaryY) {
+		switchScreen(client, detached.m_x, detached.m_y, false);
+	}
+
+	removeDetachedClient(name);
+	return true;
+}
+
+std::uint64_t
+Server::newSessionToken()
+{
+	// anyone who can guess a token can take over the session so draw
+	// each one straight from the system's entropy source.  0 means no
+	// session.
+	std::random_device entropy;
+	std::uint64_t token;
+	do {
+		token = (static_cast<std::uint64_t>(entropy()) << 32) |
+				static_cast<std::uint32_t>(entropy());
+	} while (token == 0);
+	return token;
+}
+
 void
 Server::forceLeaveClient(BaseClientProxy* client)
 {
@@ -19,6 +19,7 @@
 #pragma once
 
 #include "server/Config.h"
+#include "server/ScreenTopology.h"
 #include "inputleap/clipboard_types.h"
 #include "inputleap/Clipboard.h"
 #include "inputleap/key_types.h"
@@ -111,7 +112,7 @@ public:
     ~Server();
 
 #ifdef INPUTLEAP_TEST_ENV
-    Server() : m_mock(true), m_config(NULL) { }
+    Server() : m_mock(true), m_config(NULL), m_keyTargetsValid(false) { }
     void setActive(BaseClientProxy* active) {    m_active = active; }
 #endif
 
@@ -231,6 +232,23 @@ private:
     BaseClientProxy* mapToNeighbor(BaseClientProxy*, EDirection, std::int32_t& x,
                                    std::int32_t& y) const;
 
+    // rebuild the screen topology from the configuration and number
+    // the connected clients' screens
+    void                compileTopology();
+
+    // get the screens a keystroke for \c screens (see
+    // IKeyState::KeyInfo) goes to.  the last answer is kept so this
+    // is cheap while the same screens, e.g. the broadcast screens, are
+    // asked for again.
+    const std::vector<ScreenTopology::ScreenID>&
+                        getKeyTargets(const char* screens);
+
+    // send a key down or up to each client in \c targets, encoding the
+    // message once for all of them
+    void                sendKeyToTargets(const std::vector<ScreenTopology::ScreenID>& targets,
+                            bool down, KeyID id, KeyModifierMask mask,
+                            KeyButton button);
+
     // adjusts x and y or neither to avoid ending up in a jump zone
     // after entering the client in the given direction.
     void avoidJumpZone(BaseClientProxy*, EDirection, std::int32_t& x, std::int32_t& y) const;
@@ -280,8 +298,13 @@ private:
     // stop relative mouse moves
     void                stopRelativeMoves();
 
-    // send screen options to \c client
-    void                sendOptions(BaseClientProxy* client) const;
+    // get the screen options for \c client
+    void                getOptions(BaseClientProxy* client,
+                            OptionsList& optionsList) const;
+
+    // send screen options to \c client and remember what was sent
+    void                sendOptions(BaseClientProxy* client,
+                            const OptionsList& optionsList);
 
     // process options from configuration
     void                processOptions();
@@ -303,6 +326,7 @@ private:
     void                handleSwitchWaitTimeout(const Event&, void*);
     void                handleClientDisconnected(const Event&, void*);
     void                handleClientCloseTimeout(const Event&, void*);
+    void                handleDetachedClientTimeout(const Event&, void*);
     void                handleSwitchToScreenEvent(const Event&, void*);
     void                handleToggleScreenEvent(const Event&, void*);
     void                handleSwitchInDirectionEvent(const Event&, void*);
@@ -349,6 +373,20 @@ private:
     void                removeActiveClient(BaseClientProxy*);
     void                removeOldClient(BaseClientProxy*);
 
+    // remove a client whose connection dropped but hold on to it for a
+    // while in case it resumes its session
+    void                detachClient(BaseClientProxy*);
+
+    // discard the session held for the client named \p name, if any
+    void                removeDetachedClient(const std::string& name);
+
+    // resume the session \p client asked to resume, if we still have
+    // it.  returns true if the session resumed.
+    bool                resumeClient(BaseClientProxy*);
+
+    // make up a token for a new session
+    std::uint64_t        newSessionToken();
+
     // force the cursor off of \p client
     void                forceLeaveClient(BaseClientProxy* client);
 
@@ -388,10 +426,31 @@ private:
     ClientList            m_clients;
     ClientSet            m_clientSet;
 
+    // the options last sent to each client
+    typedef std::map<BaseClientProxy*, OptionsList> SentOptions;
+    SentOptions            m_sentOptions;
+
     // all old connections that we're waiting to hangup
     typedef std::map<BaseClientProxy*, EventQueueTimer*> OldClients;
     OldClients            m_oldClients;
 
+    // clients whose connection dropped, indexed by name, with what we
+    // need to resume their sessions
+    class DetachedClient {
+    public:
+        BaseClientProxy*    m_client;
+        EventQueueTimer*    m_timer;
+        OptionsList            m_options;
+        std::string            m_clipboardOwner[kClipboardEnd];
+        std::string            m_clipboardData[kClipboardEnd];
+        bool                m_wasActive;
+        std::int32_t        m_x, m_y;
+        std::int32_t        m_primaryX, m_primaryY;
+        std::uint32_t        m_seqNum;
+    };
+    typedef std::map<std::string, DetachedClient> DetachedClients;
+    DetachedClients        m_detachedClients;
+
     // the client with focus
     BaseClientProxy*    m_active;
 
@@ -412,6 +471,18 @@ private:
     // current configuration
     Config*                m_config;
 
+    // the screen layout from m_config and the connected client on each
+    // screen, indexed by screen id
+    ScreenTopology        m_topology;
+    std::vector<BaseClientProxy*> m_screenClients;
+
+    // the screens keystrokes last went to (see getKeyTargets()) and a
+    // buffer for encoding key messages
+    bool                m_keyTargetsValid;
+    std::string            m_keyTargetsScreens;
+    std::vector<ScreenTopology::ScreenID> m_keyTargets;
+    std::vector<std::uint8_t> m_keyMessage;
+
     // input filter (from m_config);
     InputFilter*        m_inputFilter;
 
@@ -0,0 +1,127 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/Config.h"
+#include "server/ScreenTopology.h"
+#include "base/EventQueue.h"
+
+#include <benchmark/benchmark.h>
+
+namespace {
+
+std::string
+screenName(int x, int y)
+{
+    return "screen" + std::to_string(y) + "x" + std::to_string(x);
+}
+
+// a grid of screens, each linked to its neighbors on all four sides
+// with each edge split in two
+void
+addGrid(Config& config, int size)
+{
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            config.addScreen(screenName(x, y));
+        }
+    }
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            std::string name = screenName(x, y);
+            int left  = (x + size - 1) % size;
+            int right = (x + 1) % size;
+            int up    = (y + size - 1) % size;
+            int down  = (y + 1) % size;
+            config.connect(name, kLeft,   0.0f, 0.5f, screenName(left, y),  0.0f, 1.0f);
+            config.connect(name, kLeft,   0.5f, 1.0f, screenName(left, down), 0.0f, 1.0f);
+            config.connect(name, kRight,  0.0f, 1.0f, screenName(right, y), 0.0f, 1.0f);
+            config.connect(name, kTop,    0.0f, 1.0f, screenName(x, up),    0.0f, 1.0f);
+            config.connect(name, kBottom, 0.0f, 1.0f, screenName(x, down),  0.0f, 1.0f);
+        }
+    }
+}
+
+} // namespace
+
+// crossing a screen edge
+static void
+BM_Config_getNeighbor(benchmark::State& state)
+{
+    const int size = static_cast<int>(state.range(0));
+    EventQueue events;
+    Config config(&events);
+    addGrid(config, size);
+
+    std::vector<std::string> names;
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            names.push_back(screenName(x, y));
+        }
+    }
+
+    static const EDirection s_directions[] = { kLeft, kRight, kTop, kBottom };
+    std::size_t i = 0;
+    float position;
+    for (auto _ : state) {
+        const std::string& name = names[i % names.size()];
+        EDirection dir = s_directions[i & 3];
+        benchmark::DoNotOptimize(config.getNeighbor(name, dir, 0.75f, &position));
+        ++i;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Config_getNeighbor)->Arg(2)->Arg(8)->Arg(10);
+
+// crossing a screen edge in the compiled layout the server routes with
+static void
+BM_ScreenTopology_getNeighbor(benchmark::State& state)
+{
+    const int size = static_cast<int>(state.range(0));
+    EventQueue events;
+    Config config(&events);
+    addGrid(config, size);
+    ScreenTopology topology(config);
+
+    static const EDirection s_directions[] = { kLeft, kRight, kTop, kBottom };
+    const ScreenTopology::ScreenID n = topology.getNumScreens();
+    std::size_t i = 0;
+    float position;
+    for (auto _ : state) {
+        ScreenTopology::ScreenID id = static_cast<ScreenTopology::ScreenID>(i % n);
+        EDirection dir = s_directions[i & 3];
+        benchmark::DoNotOptimize(topology.getNeighbor(id, dir, 0.75f, &position));
+        ++i;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ScreenTopology_getNeighbor)->Arg(2)->Arg(8)->Arg(10);
+
+// compiling the layout, done on each configuration change
+static void
+BM_ScreenTopology_compile(benchmark::State& state)
+{
+    const int size = static_cast<int>(state.range(0));
+    EventQueue events;
+    Config config(&events);
+    addGrid(config, size);
+
+    for (auto _ : state) {
+        ScreenTopology topology(config);
+        benchmark::DoNotOptimize(topology.getNumScreens());
+    }
+}
+BENCHMARK(BM_ScreenTopology_compile)->Arg(10);
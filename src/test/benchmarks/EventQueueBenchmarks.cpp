@@ -0,0 +1,64 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "base/EventQueue.h"
+#include "base/TMethodEventJob.h"
+#include "base/EventTypes.h"
+
+#include <benchmark/benchmark.h>
+
+namespace {
+
+class Counter {
+public:
+    void handle(const Event&, void*) { ++m_count; }
+
+    std::uint64_t m_count = 0;
+};
+
+} // namespace
+
+// an event added, fetched and handled, with the number of other
+// targets that have handlers given by the argument
+static void
+BM_EventQueue_addDispatch(benchmark::State& state)
+{
+    EventQueue events;
+    Counter counter;
+    Event::Type type = events.forIStream().inputReady();
+    std::vector<int> targets(static_cast<std::size_t>(state.range(0)));
+    for (int& target : targets) {
+        events.adoptHandler(type, &target,
+                            new TMethodEventJob<Counter>(&counter, &Counter::handle));
+    }
+    events.adoptHandler(type, &counter,
+                        new TMethodEventJob<Counter>(&counter, &Counter::handle));
+
+    Event event;
+    for (auto _ : state) {
+        events.addEvent(Event(type, &counter));
+        events.getEvent(event, 0.0);
+        events.dispatchEvent(event);
+    }
+    state.SetItemsProcessed(state.iterations());
+
+    for (int& target : targets) {
+        events.removeHandlers(&target);
+    }
+    events.removeHandlers(&counter);
+}
+BENCHMARK(BM_EventQueue_addDispatch)->Arg(0)->Arg(256);
@@ -0,0 +1,116 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/InputFilter.h"
+#include "server/PrimaryClient.h"
+#include "inputleap/Screen.h"
+#include "platform/VirtualScreen.h"
+#include "base/EventQueue.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdlib>
+
+namespace {
+
+// a primary screen with a filter holding \c n hot keys, like a macro pad
+// has, and \c n mouse button combinations, each rule with no actions
+class Filter {
+public:
+    explicit Filter(int n) :
+        m_screen(new VirtualScreen(&m_events, true, 0, 0, 800, 600), &m_events),
+        m_primary("server", &m_screen),
+        m_filter(&m_events)
+    {
+        for (int i = 0; i < n; ++i) {
+            m_filter.addFilterRule(InputFilter::Rule(
+                new InputFilter::KeystrokeCondition(&m_events,
+                            static_cast<KeyID>(kKeyF1 + i % 24),
+                            static_cast<KeyModifierMask>(i / 24 + 1))));
+            m_filter.addFilterRule(InputFilter::Rule(
+                new InputFilter::MouseButtonCondition(&m_events,
+                            static_cast<ButtonID>(i % 5 + 1),
+                            static_cast<KeyModifierMask>(i / 5 + 1))));
+        }
+        m_filter.setPrimaryClient(&m_primary);
+    }
+
+    ~Filter()
+    {
+        m_filter.setPrimaryClient(NULL);
+    }
+
+public:
+    EventQueue            m_events;
+    inputleap::Screen    m_screen;
+    PrimaryClient        m_primary;
+    InputFilter            m_filter;
+};
+
+} // namespace
+
+// an ordinary key press, which no rule matches
+static void
+BM_InputFilter_keyDown(benchmark::State& state)
+{
+    Filter filter(static_cast<int>(state.range(0)));
+    IKeyState::KeyInfo* info = IKeyState::KeyInfo::alloc('a', 0, 38, 1);
+    Event event(filter.m_events.forIKeyState().keyDown(), NULL, info,
+                Event::kDontFreeData);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(filter.m_filter.applyRules(event));
+    }
+    state.SetItemsProcessed(state.iterations());
+    std::free(info);
+}
+BENCHMARK(BM_InputFilter_keyDown)->Arg(10)->Arg(500);
+
+// the hot key of the last rule added
+static void
+BM_InputFilter_hotKeyDown(benchmark::State& state)
+{
+    const int n = static_cast<int>(state.range(0));
+    Filter filter(n);
+    IPrimaryScreen::HotKeyInfo info;
+    info.m_id = static_cast<std::uint32_t>(n);
+    Event event(filter.m_events.forIPrimaryScreen().hotKeyDown(), NULL, &info,
+                Event::kDontFreeData);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(filter.m_filter.applyRules(event));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_InputFilter_hotKeyDown)->Arg(10)->Arg(500);
+
+// a click that no rule matches
+static void
+BM_InputFilter_buttonDown(benchmark::State& state)
+{
+    Filter filter(static_cast<int>(state.range(0)));
+    IPrimaryScreen::ButtonInfo* info = IPrimaryScreen::ButtonInfo::alloc(kButtonLeft, 0);
+    Event event(filter.m_events.forIPrimaryScreen().buttonDown(), NULL, info,
+                Event::kDontFreeData);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(filter.m_filter.applyRules(event));
+    }
+    state.SetItemsProcessed(state.iterations());
+    std::free(info);
+}
+BENCHMARK(BM_InputFilter_buttonDown)->Arg(10)->Arg(500);
@@ -0,0 +1,128 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "inputleap/KeyMap.h"
+
+#include <benchmark/benchmark.h>
+
+namespace {
+
+// a US layout:  letters and digits, their shifted forms and the modifiers
+void
+addUSLayout(inputleap::KeyMap& keyMap)
+{
+    inputleap::KeyMap::KeyItem item;
+    item.m_group     = 0;
+    item.m_required  = 0;
+    item.m_generates = 0;
+    item.m_dead      = false;
+    item.m_lock      = false;
+    item.m_client    = 0;
+
+    static const char s_digitsShifted[] = ")!@#$%^&*(";
+    KeyButton button = 10;
+    for (int i = 0; i < 26; ++i, ++button) {
+        item.m_button    = button;
+        item.m_sensitive = KeyModifierShift | KeyModifierCapsLock;
+        item.m_id        = 'a' + i;
+        item.m_required  = 0;
+        keyMap.addKeyEntry(item);
+        item.m_id        = 'A' + i;
+        item.m_required  = KeyModifierShift;
+        keyMap.addKeyEntry(item);
+    }
+    for (int i = 0; i < 10; ++i, ++button) {
+        item.m_button    = button;
+        item.m_sensitive = KeyModifierShift;
+        item.m_id        = '0' + i;
+        item.m_required  = 0;
+        keyMap.addKeyEntry(item);
+        item.m_id        = static_cast<KeyID>(s_digitsShifted[i]);
+        item.m_required  = KeyModifierShift;
+        keyMap.addKeyEntry(item);
+    }
+
+    static const struct { KeyID m_id; KeyModifierMask m_mask; bool m_lock; } s_modifiers[] = {
+        { kKeyShift_L,   KeyModifierShift,    false },
+        { kKeyShift_R,   KeyModifierShift,    false },
+        { kKeyControl_L, KeyModifierControl,  false },
+        { kKeyControl_R, KeyModifierControl,  false },
+        { kKeyAlt_L,     KeyModifierAlt,      false },
+        { kKeySuper_L,   KeyModifierSuper,    false },
+        { kKeyCapsLock,  KeyModifierCapsLock, true  }
+    };
+    item.m_required  = 0;
+    item.m_sensitive = 0;
+    for (const auto& modifier : s_modifiers) {
+        item.m_button    = button++;
+        item.m_id        = modifier.m_id;
+        item.m_generates = modifier.m_mask;
+        item.m_lock      = modifier.m_lock;
+        keyMap.addKeyEntry(item);
+    }
+
+    keyMap.finish();
+}
+
+} // namespace
+
+// typing text:  keys that need no modifiers and keys that need shift
+static void
+BM_KeyMap_mapKey(benchmark::State& state)
+{
+    inputleap::KeyMap keyMap;
+    addUSLayout(keyMap);
+
+    static const char s_text[] = "The Quick Brown Fox Jumps Over 13 Lazy Dogs!";
+    inputleap::KeyMap::Keystrokes keys;
+    inputleap::KeyMap::ModifierToKeys activeModifiers;
+    std::size_t i = 0;
+    for (auto _ : state) {
+        KeyID id = static_cast<KeyID>(s_text[i]);
+        if (++i == sizeof(s_text) - 1) {
+            i = 0;
+        }
+        if (id == ' ') {
+            continue;
+        }
+        KeyModifierMask currentState = 0;
+        keys.clear();
+        benchmark::DoNotOptimize(keyMap.mapKey(keys, id, 0, activeModifiers,
+                                               currentState, 0, false));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_KeyMap_mapKey);
+
+// a key that isn't in the map
+static void
+BM_KeyMap_mapKeyMissing(benchmark::State& state)
+{
+    inputleap::KeyMap keyMap;
+    addUSLayout(keyMap);
+
+    inputleap::KeyMap::Keystrokes keys;
+    inputleap::KeyMap::ModifierToKeys activeModifiers;
+    for (auto _ : state) {
+        KeyModifierMask currentState = 0;
+        keys.clear();
+        benchmark::DoNotOptimize(keyMap.mapKey(keys, 0x20ac, 0, activeModifiers,
+                                               currentState, 0, false));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_KeyMap_mapKeyMissing);
@@ -0,0 +1,45 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "arch/Arch.h"
+#include "base/Log.h"
+
+#include <benchmark/benchmark.h>
+
+//
+// run with --benchmark_format=json (or --benchmark_out=<file>
+// --benchmark_out_format=json) for results that can be compared between
+// builds, e.g. with the compare.py tool that comes with Google Benchmark.
+//
+
+int
+main(int argc, char** argv)
+{
+    Arch arch;
+    arch.init();
+
+    // only errors, so logging calls cost what they do in normal use
+    Log log;
+    log.setFilter(kERROR);
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
@@ -0,0 +1,55 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "io/IStream.h"
+#include "io/StreamBuffer.h"
+
+#include <cstring>
+
+//! Loopback stream for benchmarks
+/*!
+Everything written can be read back.  There are no events so this
+stands in for a socket that's always ready.
+*/
+class MemoryStream : public inputleap::IStream {
+public:
+    void close() override { m_buffer.pop(m_buffer.getSize()); }
+    std::uint32_t read(void* buffer, std::uint32_t n) override
+    {
+        std::uint32_t size = m_buffer.getSize();
+        if (n > size) {
+            n = size;
+        }
+        if (buffer != NULL && n > 0) {
+            std::memcpy(buffer, m_buffer.peek(n), n);
+        }
+        m_buffer.pop(n);
+        return n;
+    }
+    void write(const void* buffer, std::uint32_t n) override { m_buffer.write(buffer, n); }
+    void flush() override { }
+    void shutdownInput() override { }
+    void shutdownOutput() override { }
+    void* getEventTarget() const override { return const_cast<MemoryStream*>(this); }
+    bool isReady() const override { return m_buffer.getSize() > 0; }
+    std::uint32_t getSize() const override { return m_buffer.getSize(); }
+
+private:
+    StreamBuffer        m_buffer;
+};
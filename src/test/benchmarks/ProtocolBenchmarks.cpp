@@ -0,0 +1,162 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "inputleap/IKeyState.h"
+#include "inputleap/ProtocolUtil.h"
+#include "inputleap/protocol_types.h"
+#include "test/benchmarks/MemoryStream.h"
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+
+namespace {
+
+// screens for broadcasting keystrokes to the given number of clients
+class Broadcast {
+public:
+    explicit Broadcast(int n) : m_streams(n)
+    {
+        m_screens = ":";
+        for (int i = 0; i < n; ++i) {
+            m_names.push_back("screen" + std::to_string(i));
+            m_screens += m_names.back() + ":";
+        }
+    }
+
+    void drain()
+    {
+        for (MemoryStream& stream : m_streams) {
+            stream.read(NULL, stream.getSize());
+        }
+    }
+
+public:
+    std::vector<std::string> m_names;
+    std::string m_screens;
+    std::vector<MemoryStream> m_streams;
+};
+
+} // namespace
+
+// the most common message:  a mouse move written and parsed
+static void
+BM_ProtocolUtil_mouseMove(benchmark::State& state)
+{
+    MemoryStream stream;
+    std::int16_t x, y;
+    std::int16_t i = 0;
+    for (auto _ : state) {
+        ProtocolUtil::writef(&stream, kMsgDMouseMove, i, i);
+        stream.read(NULL, 4);
+        ProtocolUtil::readf(&stream, kMsgDMouseMove + 4, &x, &y);
+        benchmark::DoNotOptimize(x);
+        ++i;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ProtocolUtil_mouseMove);
+
+// a key press with all three arguments
+static void
+BM_ProtocolUtil_writefKeyDown(benchmark::State& state)
+{
+    MemoryStream stream;
+    for (auto _ : state) {
+        ProtocolUtil::writef(&stream, kMsgDKeyDown, 0x61, 0x0001, 38);
+        stream.read(NULL, stream.getSize());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ProtocolUtil_writefKeyDown);
+
+// a broadcast key press matched against the screens and formatted for
+// each client, as the server used to do
+static void
+BM_ProtocolUtil_broadcastKeyPerClient(benchmark::State& state)
+{
+    Broadcast broadcast(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < broadcast.m_names.size(); ++i) {
+            if (IKeyState::KeyInfo::contains(broadcast.m_screens.c_str(),
+                                             broadcast.m_names[i])) {
+                ProtocolUtil::writef(&broadcast.m_streams[i], kMsgDKeyDown, 0x61, 0x0001, 38);
+            }
+        }
+        broadcast.drain();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ProtocolUtil_broadcastKeyPerClient)->Arg(30);
+
+// a broadcast key press to targets resolved in advance, encoded once
+static void
+BM_ProtocolUtil_broadcastKeyEncodeOnce(benchmark::State& state)
+{
+    Broadcast broadcast(static_cast<int>(state.range(0)));
+    std::vector<MemoryStream*> targets;
+    for (MemoryStream& stream : broadcast.m_streams) {
+        targets.push_back(&stream);
+    }
+    std::vector<std::uint8_t> message;
+    for (auto _ : state) {
+        ProtocolUtil::encodef(message, kMsgDKeyDown, 0x61, 0x0001, 38);
+        for (MemoryStream* stream : targets) {
+            ProtocolUtil::write(stream, message);
+        }
+        broadcast.drain();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ProtocolUtil_broadcastKeyEncodeOnce)->Arg(30);
+
+// a clipboard chunk of the given size written and parsed
+static void
+BM_ProtocolUtil_clipboardChunk(benchmark::State& state)
+{
+    MemoryStream stream;
+    std::string data(static_cast<std::size_t>(state.range(0)), 'x');
+    std::uint8_t id, mark;
+    std::uint32_t sequence;
+    std::string result;
+    for (auto _ : state) {
+        ProtocolUtil::writef(&stream, kMsgDClipboard, 0, 1, 2, &data);
+        stream.read(NULL, 4);
+        ProtocolUtil::readf(&stream, kMsgDClipboard + 4, &id, &sequence, &mark, &result);
+        benchmark::DoNotOptimize(result.data());
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ProtocolUtil_clipboardChunk)->Arg(64)->Arg(32 * 1024);
+
+// the options sent when a client connects
+static void
+BM_ProtocolUtil_setOptions(benchmark::State& state)
+{
+    MemoryStream stream;
+    std::vector<std::uint32_t> options(32, 0x48415254);
+    std::vector<std::uint32_t> result;
+    for (auto _ : state) {
+        ProtocolUtil::writef(&stream, kMsgDSetOptions, &options);
+        stream.read(NULL, 4);
+        result.clear();
+        ProtocolUtil::readf(&stream, kMsgDSetOptions + 4, &result);
+        benchmark::DoNotOptimize(result.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ProtocolUtil_setOptions);
@@ -0,0 +1,110 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "inputleap/PacketStreamFilter.h"
+#include "inputleap/ProtocolUtil.h"
+#include "inputleap/protocol_types.h"
+#include "io/StreamBuffer.h"
+#include "base/EventQueue.h"
+#include "test/benchmarks/MemoryStream.h"
+
+#include <benchmark/benchmark.h>
+
+// messages written and consumed one at a time, as on a busy socket
+static void
+BM_StreamBuffer_writePop(benchmark::State& state)
+{
+    StreamBuffer buffer;
+    std::vector<std::uint8_t> data(static_cast<std::size_t>(state.range(0)), 0x55);
+    std::uint32_t size = static_cast<std::uint32_t>(data.size());
+    for (auto _ : state) {
+        buffer.write(data.data(), size);
+        benchmark::DoNotOptimize(buffer.peek(size));
+        buffer.pop(size);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StreamBuffer_writePop)->Arg(12)->Arg(4096);
+
+// a backlog written in small pieces and drained in large ones
+static void
+BM_StreamBuffer_backlog(benchmark::State& state)
+{
+    StreamBuffer buffer;
+    std::uint8_t message[12] = { };
+    for (auto _ : state) {
+        for (int i = 0; i < 1024; ++i) {
+            buffer.write(message, sizeof(message));
+        }
+        while (buffer.getSize() > 0) {
+            std::uint32_t n = buffer.getSize() < 4096 ? buffer.getSize() : 4096;
+            benchmark::DoNotOptimize(buffer.peek(n));
+            buffer.pop(n);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * 1024);
+}
+BENCHMARK(BM_StreamBuffer_backlog);
+
+// mouse moves framed by the packet filter
+static void
+BM_PacketStreamFilter_writeMouseMove(benchmark::State& state)
+{
+    EventQueue events;
+    MemoryStream stream;
+    PacketStreamFilter filter(&events, &stream, false);
+    std::int16_t i = 0;
+    for (auto _ : state) {
+        ProtocolUtil::writef(&filter, kMsgDMouseMove, i, i);
+        stream.read(NULL, stream.getSize());
+        ++i;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PacketStreamFilter_writeMouseMove);
+
+// a read's worth of mouse moves unframed and parsed
+static void
+BM_PacketStreamFilter_readMouseMoves(benchmark::State& state)
+{
+    static const int kMessages = 64;
+
+    EventQueue events;
+    MemoryStream stream;
+    PacketStreamFilter filter(&events, &stream, false);
+    MemoryStream framed;
+    PacketStreamFilter framer(&events, &framed, false);
+    for (int i = 0; i < kMessages; ++i) {
+        ProtocolUtil::writef(&framer, kMsgDMouseMove, i, i);
+    }
+    std::vector<std::uint8_t> packets(framed.getSize());
+    framed.read(packets.data(), static_cast<std::uint32_t>(packets.size()));
+
+    Event inputReady(events.forIStream().inputReady(), stream.getEventTarget());
+    std::uint8_t code[4];
+    std::int16_t x, y;
+    for (auto _ : state) {
+        stream.write(packets.data(), static_cast<std::uint32_t>(packets.size()));
+        events.dispatchEvent(inputReady);
+        while (filter.read(code, 4) == 4) {
+            ProtocolUtil::readf(&filter, kMsgDMouseMove + 4, &x, &y);
+        }
+        benchmark::DoNotOptimize(x);
+    }
+    state.SetItemsProcessed(state.iterations() * kMessages);
+}
+BENCHMARK(BM_PacketStreamFilter_readMouseMoves);
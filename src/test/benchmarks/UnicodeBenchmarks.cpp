@@ -0,0 +1,93 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "base/Unicode.h"
+
+#include <benchmark/benchmark.h>
+
+namespace {
+
+std::string
+asciiText(std::size_t size)
+{
+    static const char s_text[] = "The quick brown fox jumps over the lazy dog. ";
+    std::string text;
+    while (text.size() < size) {
+        text += s_text;
+    }
+    text.resize(size);
+    return text;
+}
+
+std::string
+mixedText(std::size_t size)
+{
+    static const char s_text[] = "Gr\xc3\xbc\xc3\x9f" "e aus K\xc3\xb6ln, "
+                                 "\xe6\x97\xa5\xe6\x9c\xac\xe8\xaa\x9e \xf0\x9f\x98\x80 ";
+    std::string text;
+    while (text.size() < size) {
+        text += s_text;
+    }
+    return text;
+}
+
+} // namespace
+
+// clipboard text as sent to and from Windows clients
+static void
+BM_Unicode_UTF8ToUTF16_ascii(benchmark::State& state)
+{
+    std::string text = asciiText(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Unicode::UTF8ToUTF16(text));
+    }
+    state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_Unicode_UTF8ToUTF16_ascii)->Arg(64)->Arg(64 * 1024);
+
+static void
+BM_Unicode_UTF8ToUTF16_mixed(benchmark::State& state)
+{
+    std::string text = mixedText(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Unicode::UTF8ToUTF16(text));
+    }
+    state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_Unicode_UTF8ToUTF16_mixed)->Arg(64 * 1024);
+
+static void
+BM_Unicode_UTF16ToUTF8_ascii(benchmark::State& state)
+{
+    std::string text = Unicode::UTF8ToUTF16(asciiText(static_cast<std::size_t>(state.range(0))));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Unicode::UTF16ToUTF8(text));
+    }
+    state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_Unicode_UTF16ToUTF8_ascii)->Arg(64)->Arg(64 * 1024);
+
+static void
+BM_Unicode_UTF16ToUTF8_mixed(benchmark::State& state)
+{
+    std::string text = Unicode::UTF8ToUTF16(mixedText(static_cast<std::size_t>(state.range(0))));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Unicode::UTF16ToUTF8(text));
+    }
+    state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_Unicode_UTF16ToUTF8_mixed)->Arg(64 * 1024);
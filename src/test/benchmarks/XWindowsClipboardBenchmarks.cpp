@@ -0,0 +1,289 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+
+#if WINAPI_XWINDOWS
+
+#include "platform/XWindowsClipboard.h"
+#include "platform/XWindowsImpl.h"
+#include "platform/XWindowsUtil.h"
+
+#include <benchmark/benchmark.h>
+
+#include <X11/Xatom.h>
+#include <climits>
+#include <cstdlib>
+#include <poll.h>
+#include <string>
+#include <vector>
+
+//
+// pastes from an XWindowsClipboard to other X clients.  needs an X
+// server, so these are skipped unless DISPLAY is set.
+//
+
+namespace {
+
+// a window asking for the clipboard, which it reads the way ICCCM
+// clients do, INCR or not
+class Requestor {
+public:
+    Window                m_window;
+    bool                m_incr;
+    bool                m_done;
+    std::size_t            m_bytes;
+};
+
+// the clipboard's owner and the requestors, on their own connections
+class Paste {
+public:
+    Paste(Display* owner, Display* requestors, std::size_t size, int count) :
+        m_owner(owner),
+        m_requestors(requestors),
+        m_clipboard(NULL),
+        m_failed(false)
+    {
+        Window root = DefaultRootWindow(m_owner);
+        m_window = XCreateWindow(m_owner, root, 0, 0, 1, 1, 0, 0,
+                                 InputOnly, CopyFromParent, 0, NULL);
+        m_clipboard = new XWindowsClipboard(&m_impl, m_owner, m_window,
+                                            kClipboardClipboard);
+        Time time = XWindowsUtil::getCurrentTime(m_owner, m_window);
+        m_clipboard->open(time);
+        m_clipboard->empty();
+        m_clipboard->add(IClipboard::kText, std::string(size, 'x'));
+        m_clipboard->close();
+
+        m_selection = XInternAtom(m_requestors, "CLIPBOARD", False);
+        m_target    = XInternAtom(m_requestors, "UTF8_STRING", False);
+        m_property  = XInternAtom(m_requestors, "INPUTLEAP_BENCHMARK", False);
+        m_incr      = XInternAtom(m_requestors, "INCR", False);
+        root = DefaultRootWindow(m_requestors);
+        m_windows.resize(count);
+        for (Requestor& requestor : m_windows) {
+            requestor.m_window = XCreateWindow(m_requestors, root, 0, 0, 1, 1, 0, 0,
+                                               InputOnly, CopyFromParent, 0, NULL);
+            XSelectInput(m_requestors, requestor.m_window, PropertyChangeMask);
+        }
+        XSync(m_requestors, False);
+    }
+
+    ~Paste()
+    {
+        for (Requestor& requestor : m_windows) {
+            XDestroyWindow(m_requestors, requestor.m_window);
+        }
+        XSync(m_requestors, False);
+        delete m_clipboard;
+        XDestroyWindow(m_owner, m_window);
+        XSync(m_owner, False);
+    }
+
+    //! Paste to every requestor at once, returning the bytes they got
+    std::size_t            run()
+    {
+        for (Requestor& requestor : m_windows) {
+            requestor.m_incr  = false;
+            requestor.m_done  = false;
+            requestor.m_bytes = 0;
+            XConvertSelection(m_requestors, m_selection, m_target, m_property,
+                              requestor.m_window, CurrentTime);
+        }
+        XFlush(m_requestors);
+
+        std::size_t done = 0;
+        while (done < m_windows.size() && !m_failed) {
+            XEvent event;
+            bool idle = true;
+            while (XPending(m_owner) > 0) {
+                XNextEvent(m_owner, &event);
+                handleOwnerEvent(event);
+                idle = false;
+            }
+            while (XPending(m_requestors) > 0) {
+                XNextEvent(m_requestors, &event);
+                done += handleRequestorEvent(event);
+                idle = false;
+            }
+            XFlush(m_owner);
+            XFlush(m_requestors);
+            if (idle) {
+                pollfd fds[2] = {
+                    { ConnectionNumber(m_owner), POLLIN, 0 },
+                    { ConnectionNumber(m_requestors), POLLIN, 0 }
+                };
+                if (poll(fds, 2, 5000) == 0) {
+                    m_failed = true;
+                }
+            }
+        }
+
+        std::size_t bytes = 0;
+        for (const Requestor& requestor : m_windows) {
+            bytes += requestor.m_bytes;
+        }
+        return m_failed ? 0 : bytes;
+    }
+
+private:
+    // what XWindowsScreen does with the owner's events
+    void                handleOwnerEvent(XEvent& event)
+    {
+        switch (event.type) {
+        case SelectionRequest:
+            m_clipboard->addRequest(event.xselectionrequest.owner,
+                                    event.xselectionrequest.requestor,
+                                    event.xselectionrequest.target,
+                                    event.xselectionrequest.time,
+                                    event.xselectionrequest.property);
+            break;
+
+        case PropertyNotify:
+            if (event.xproperty.state == PropertyDelete) {
+                m_clipboard->processRequest(event.xproperty.window,
+                                            event.xproperty.time,
+                                            event.xproperty.atom);
+            }
+            break;
+
+        case DestroyNotify:
+            m_clipboard->destroyRequest(event.xdestroywindow.window);
+            break;
+        }
+    }
+
+    // returns 1 when a requestor has all the data
+    int                    handleRequestorEvent(XEvent& event)
+    {
+        Requestor* requestor = NULL;
+        for (Requestor& candidate : m_windows) {
+            if (candidate.m_window == event.xany.window) {
+                requestor = &candidate;
+            }
+        }
+        if (requestor == NULL || requestor->m_done) {
+            return 0;
+        }
+
+        if (event.type == SelectionNotify) {
+            if (event.xselection.property == None) {
+                m_failed = true;
+                return 0;
+            }
+            std::size_t bytes;
+            Atom type = readProperty(requestor->m_window, bytes);
+            if (type == m_incr) {
+                requestor->m_incr = true;
+                return 0;
+            }
+            requestor->m_bytes = bytes;
+            requestor->m_done  = true;
+            return 1;
+        }
+        if (event.type == PropertyNotify && requestor->m_incr &&
+            event.xproperty.state == PropertyNewValue &&
+            event.xproperty.atom == m_property) {
+            std::size_t bytes;
+            readProperty(requestor->m_window, bytes);
+            if (bytes == 0) {
+                requestor->m_done = true;
+                return 1;
+            }
+            requestor->m_bytes += bytes;
+        }
+        return 0;
+    }
+
+    Atom                readProperty(Window window, std::size_t& bytes)
+    {
+        Atom type;
+        int format;
+        unsigned long items, after;
+        unsigned char* data = NULL;
+        bytes = 0;
+        if (XGetWindowProperty(m_requestors, window, m_property, 0, LONG_MAX / 4,
+                               True, AnyPropertyType, &type, &format,
+                               &items, &after, &data) != Success) {
+            m_failed = true;
+            return None;
+        }
+        bytes = items * (format / 8);
+        XFree(data);
+        return type;
+    }
+
+private:
+    XWindowsImpl        m_impl;
+    Display*            m_owner;
+    Display*            m_requestors;
+    Window                m_window;
+    XWindowsClipboard*    m_clipboard;
+    Atom                m_selection;
+    Atom                m_target;
+    Atom                m_property;
+    Atom                m_incr;
+    std::vector<Requestor> m_windows;
+    bool                m_failed;
+};
+
+} // namespace
+
+// state.range(0) bytes to state.range(1) requestors at once
+static void
+BM_XWindowsClipboard_paste(benchmark::State& state)
+{
+    if (std::getenv("DISPLAY") == NULL) {
+        state.SkipWithError("no DISPLAY");
+        return;
+    }
+    Display* owner      = XOpenDisplay(NULL);
+    Display* requestors = XOpenDisplay(NULL);
+    if (owner == NULL || requestors == NULL) {
+        state.SkipWithError("can't open DISPLAY");
+        if (owner != NULL) {
+            XCloseDisplay(owner);
+        }
+        if (requestors != NULL) {
+            XCloseDisplay(requestors);
+        }
+        return;
+    }
+
+    const std::size_t size = static_cast<std::size_t>(state.range(0));
+    const int count = static_cast<int>(state.range(1));
+    {
+        Paste paste(owner, requestors, size, count);
+        for (auto _ : state) {
+            if (paste.run() != size * count) {
+                state.SkipWithError("paste failed");
+                break;
+            }
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * size * count);
+
+    XCloseDisplay(requestors);
+    XCloseDisplay(owner);
+}
+BENCHMARK(BM_XWindowsClipboard_paste)
+    ->Args({ 4 << 20, 1 })
+    ->Args({ 4 << 20, 4 })
+    ->Args({ 16 << 20, 4 })
+    ->Unit(benchmark::kMillisecond);
+
+#endif
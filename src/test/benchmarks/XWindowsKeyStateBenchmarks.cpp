@@ -0,0 +1,41 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+
+#if WINAPI_XWINDOWS && HAVE_XKB_EXTENSION
+
+#include "test/mock/platform/FakeXkbKeyboard.h"
+#include "platform/XWindowsKeyState.h"
+
+#include <benchmark/benchmark.h>
+
+// rebuilding the key map from XKB, as on every keyboard mapping change.
+// the X server round trip to fetch the map isn't included.
+static void
+BM_XWindowsKeyState_updateKeyMap(benchmark::State& state)
+{
+    FakeXkbKeyboard keyboard;
+    inputleap::KeyMap keyMap;
+    XWindowsKeyState keyState(&keyboard, NULL, true, NULL, keyMap);
+    for (auto _ : state) {
+        keyState.updateKeyMap();
+    }
+}
+BENCHMARK(BM_XWindowsKeyState_updateKeyMap);
+
+#endif
@@ -0,0 +1,44 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#if WINAPI_XWINDOWS
+
+#include "platform/XWindowsUtil.h"
+
+#include <benchmark/benchmark.h>
+
+#include <X11/keysym.h>
+
+// keysyms that go through the character table:  Latin-2, Cyrillic,
+// Greek, Hebrew and Arabic letters and a few technical symbols
+static void
+BM_XWindowsUtil_mapKeySymToKeyID(benchmark::State& state)
+{
+    static const KeySym s_keysyms[] = {
+        0x01a1, 0x01b3, 0x01e6, 0x06c1, 0x06d7, 0x06e9, 0x07c1, 0x07e4,
+        0x0ce0, 0x0cf2, 0x05c7, 0x05e6, 0x08bc, 0x08fb, 0x1000174, 0x1001e0a
+    };
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(XWindowsUtil::mapKeySymToKeyID(s_keysyms[i]));
+        i = (i + 1) % (sizeof(s_keysyms) / sizeof(s_keysyms[0]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_XWindowsUtil_mapKeySymToKeyID);
+
+#endif
@@ -0,0 +1,279 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// include first so gtest's use of None isn't broken by X11's macro
+#include "test/global/gtest.h"
+
+#include "platform/XWindowsClipboard.h"
+#include "platform/XWindowsImpl.h"
+#include "platform/XWindowsUtil.h"
+#include "base/Time.h"
+#include "base/Stopwatch.h"
+
+#include <X11/Xatom.h>
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+
+//
+// background fetches of a selection owned by another X client that
+// sends its data with INCR, one chunk at a time, and takes its time
+// about it.  needs an X server.
+//
+
+class XWindowsClipboardFetchTests : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        const char* displayName = std::getenv("DISPLAY");
+        if (displayName == NULL) {
+            displayName = ":0.0";
+        }
+        m_window      = None;
+        m_ownerWindow = None;
+        m_clipboard   = NULL;
+        m_display     = XOpenDisplay(displayName);
+        m_owner       = XOpenDisplay(displayName);
+        ASSERT_TRUE(m_display != NULL);
+        ASSERT_TRUE(m_owner != NULL);
+
+        m_window      = createWindow(m_display);
+        m_ownerWindow = createWindow(m_owner);
+        m_clipboard   = new XWindowsClipboard(&m_impl, m_display, m_window,
+                                              kClipboardSelection);
+
+        m_atomTargets = XInternAtom(m_owner, "TARGETS", False);
+        m_atomUTF8    = XInternAtom(m_owner, "UTF8_STRING", False);
+        m_atomINCR    = XInternAtom(m_owner, "INCR", False);
+        m_requestor   = None;
+        m_sent        = 0;
+        m_pending     = false;
+        m_chunkSize   = 4096;
+        m_chunkDelay  = 0.0;
+
+        // the owner takes the selection
+        Time time = XWindowsUtil::getCurrentTime(m_owner, m_ownerWindow);
+        XSetSelectionOwner(m_owner, XA_PRIMARY, m_ownerWindow, time);
+        XSync(m_owner, False);
+    }
+
+    void TearDown() override
+    {
+        delete m_clipboard;
+        if (m_owner != NULL) {
+            if (m_ownerWindow != None) {
+                XDestroyWindow(m_owner, m_ownerWindow);
+            }
+            XCloseDisplay(m_owner);
+        }
+        if (m_display != NULL) {
+            if (m_window != None) {
+                XDestroyWindow(m_display, m_window);
+            }
+            XCloseDisplay(m_display);
+        }
+    }
+
+    Window createWindow(Display* display)
+    {
+        XSetWindowAttributes attr;
+        attr.override_redirect = True;
+        return XCreateWindow(display, DefaultRootWindow(display),
+                             0, 0, 1, 1, 0, 0, InputOnly, CopyFromParent,
+                             CWOverrideRedirect, &attr);
+    }
+
+    void startFetch()
+    {
+        m_clipboard->fetch(XWindowsUtil::getCurrentTime(m_display, m_window));
+    }
+
+    // handle whatever the owner and the clipboard have to do.  returns
+    // false once the fetch has ended.
+    bool pump()
+    {
+        XEvent event;
+        while (XPending(m_owner) > 0) {
+            XNextEvent(m_owner, &event);
+            handleOwnerEvent(event);
+        }
+        if (m_pending && m_chunkTimer.getTime() >= m_chunkDelay) {
+            sendChunk();
+        }
+        XFlush(m_owner);
+
+        while (XPending(m_display) > 0) {
+            XNextEvent(m_display, &event);
+            m_clipboard->processFetchEvent(&event);
+        }
+        bool fetching = m_clipboard->checkFetch();
+        inputleap::this_thread_sleep(0.001);
+        return fetching;
+    }
+
+    // pump until the fetch ends or \c timeout seconds pass.  returns
+    // how long it took.
+    double pumpUntilFetched(double timeout)
+    {
+        Stopwatch timer;
+        while (pump() && timer.getTime() < timeout) {
+            // keep going
+        }
+        return timer.getTime();
+    }
+
+    void handleOwnerEvent(const XEvent& event)
+    {
+        if (event.type == SelectionRequest) {
+            const XSelectionRequestEvent& request = event.xselectionrequest;
+            Atom property = request.property;
+            if (request.target == m_atomTargets) {
+                Atom targets[] = { m_atomTargets, m_atomUTF8 };
+                XChangeProperty(m_owner, request.requestor, property, XA_ATOM,
+                                32, PropModeReplace,
+                                reinterpret_cast<unsigned char*>(targets), 2);
+            }
+            else if (request.target == m_atomUTF8) {
+                // announce an INCR transfer and send chunks as the
+                // requestor deletes the property
+                long size = static_cast<long>(m_data.size());
+                XSelectInput(m_owner, request.requestor, PropertyChangeMask);
+                XChangeProperty(m_owner, request.requestor, property,
+                                m_atomINCR, 32, PropModeReplace,
+                                reinterpret_cast<unsigned char*>(&size), 1);
+                m_requestor = request.requestor;
+                m_property  = property;
+                m_sent      = 0;
+                m_pending   = false;
+                m_chunkTimer.reset();
+            }
+            else {
+                // no TIMESTAMP or anything else
+                property = None;
+            }
+
+            XEvent notify;
+            notify.xselection.type      = SelectionNotify;
+            notify.xselection.display   = m_owner;
+            notify.xselection.requestor = request.requestor;
+            notify.xselection.selection = request.selection;
+            notify.xselection.target    = request.target;
+            notify.xselection.property  = property;
+            notify.xselection.time      = request.time;
+            XSendEvent(m_owner, request.requestor, False, 0, &notify);
+        }
+        else if (event.type == PropertyNotify &&
+                 event.xproperty.state  == PropertyDelete &&
+                 event.xproperty.window == m_requestor &&
+                 event.xproperty.atom   == m_property &&
+                 m_sent <= m_data.size()) {
+            // the requestor wants the next chunk
+            m_pending = true;
+        }
+    }
+
+    void sendChunk()
+    {
+        // the last chunk is empty
+        std::size_t size = std::min(m_chunkSize, m_data.size() - m_sent);
+        XChangeProperty(m_owner, m_requestor, m_property, m_atomUTF8, 8,
+                        PropModeReplace,
+                        reinterpret_cast<const unsigned char*>(
+                            m_data.data() + m_sent),
+                        static_cast<int>(size));
+        m_sent    += (size == 0) ? 1 : size;
+        m_pending  = false;
+        m_chunkTimer.reset();
+    }
+
+    std::string text(std::size_t size)
+    {
+        std::string data(size, 'a');
+        for (std::size_t i = 0; i < size; ++i) {
+            data[i] = static_cast<char>('a' + i % 26);
+        }
+        return data;
+    }
+
+    XWindowsImpl m_impl;
+    Display* m_display;
+    Display* m_owner;
+    Window m_window;
+    Window m_ownerWindow;
+    XWindowsClipboard* m_clipboard;
+
+    Atom m_atomTargets;
+    Atom m_atomUTF8;
+    Atom m_atomINCR;
+
+    // the owner's transfer
+    std::string m_data;
+    Window m_requestor;
+    Atom m_property;
+    std::size_t m_sent;
+    bool m_pending;
+    std::size_t m_chunkSize;
+    double m_chunkDelay;
+    Stopwatch m_chunkTimer;
+};
+
+TEST_F(XWindowsClipboardFetchTests, fetch_slowIncrOwner_readsDoNotWait)
+{
+    m_data       = text(64 * 1024);
+    m_chunkDelay = 0.02;
+    startFetch();
+
+    // read while the owner is in the middle of sending
+    Stopwatch timer;
+    while (m_sent == 0 && timer.getTime() < 5.0) {
+        pump();
+    }
+    ASSERT_LT(0u, m_sent);
+    ASSERT_GT(m_data.size(), m_sent);
+
+    timer.reset();
+    ASSERT_TRUE(m_clipboard->open(0));
+    EXPECT_FALSE(m_clipboard->has(IClipboard::kText));
+    m_clipboard->close();
+    EXPECT_GT(0.05, timer.getTime());
+
+    // the data is there when the fetch says so
+    pumpUntilFetched(5.0);
+    EXPECT_TRUE(m_clipboard->checkFetched());
+    ASSERT_TRUE(m_clipboard->open(0));
+    EXPECT_EQ(m_data, m_clipboard->get(IClipboard::kText));
+    m_clipboard->close();
+}
+
+TEST_F(XWindowsClipboardFetchTests, fetch_slowIncrOwner_timesOutPerTarget)
+{
+    // the owner makes progress every 50ms but would take 2s in all
+    m_data       = text(40 * 4096);
+    m_chunkDelay = 0.05;
+    m_clipboard->setFetchTimeout(0.3);
+    startFetch();
+
+    double elapsed = pumpUntilFetched(5.0);
+    EXPECT_GT(1.0, elapsed);
+    EXPECT_GT(m_data.size(), m_sent);
+
+    // the cache was cleared for the new owner so the fetch still changed it
+    EXPECT_TRUE(m_clipboard->checkFetched());
+    ASSERT_TRUE(m_clipboard->open(0));
+    EXPECT_FALSE(m_clipboard->has(IClipboard::kText));
+    m_clipboard->close();
+}
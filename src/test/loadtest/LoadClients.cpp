@@ -0,0 +1,178 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "test/loadtest/LoadClients.h"
+#include "test/loadtest/LoadScreen.h"
+#include "test/loadtest/LoadStats.h"
+#include "client/Client.h"
+#include "inputleap/ClientArgs.h"
+#include "inputleap/Screen.h"
+#include "net/TCPSocketFactory.h"
+#include "base/IEventQueue.h"
+#include "base/Log.h"
+#include "base/Time.h"
+#include "base/TMethodEventJob.h"
+
+// how long to keep trying to reach the server
+static const double s_connectTimeout = 10.0;
+
+// how long to wait between tries
+static const double s_retryInterval = 0.1;
+
+//
+// LoadClients
+//
+
+LoadClients::LoadClients(IEventQueue* events, SocketMultiplexer* multiplexer,
+                LoadStats* stats, const NetworkAddress& server,
+                int first, int count, bool tls) :
+    m_events(events),
+    m_stats(stats),
+    m_giveUpTime(inputleap::current_time_seconds() + s_connectTimeout)
+{
+    ClientArgs args;
+    args.m_enableCrypto = tls;
+
+    // create all the clients before connecting any so the vector
+    // doesn't move while handlers point into it
+    m_clients.resize(count);
+    for (int i = 0; i < count; ++i) {
+        LoadClient& client = m_clients[i];
+        client.m_index      = first + i;
+        client.m_screen     = new inputleap::Screen(
+                                new LoadScreen(m_events, m_stats, first + i), m_events);
+        client.m_client     = new Client(m_events, clientName(first + i), server,
+                                new TCPSocketFactory(m_events, multiplexer),
+                                client.m_screen, args);
+        client.m_retryTimer = NULL;
+        client.m_connected  = false;
+        client.m_done       = false;
+    }
+
+    for (LoadClient& client : m_clients) {
+        void* target = client.m_client->getEventTarget();
+        m_events->adoptHandler(m_events->forClient().connected(), target,
+                            new TMethodEventJob<LoadClients>(this,
+                                &LoadClients::handleConnected, &client));
+        m_events->adoptHandler(m_events->forClient().connectionFailed(), target,
+                            new TMethodEventJob<LoadClients>(this,
+                                &LoadClients::handleConnectionFailed, &client));
+        m_events->adoptHandler(m_events->forClient().disconnected(), target,
+                            new TMethodEventJob<LoadClients>(this,
+                                &LoadClients::handleDisconnected, &client));
+
+        // drag and drop is off so nothing else wants these
+        m_events->adoptHandler(m_events->forFile().fileRecieveCompleted(), client.m_client,
+                            new TMethodEventJob<LoadClients>(this,
+                                &LoadClients::handleFileReceived, &client));
+        client.m_client->connect();
+    }
+}
+
+LoadClients::~LoadClients()
+{
+    for (LoadClient& client : m_clients) {
+        void* target = client.m_client->getEventTarget();
+        m_events->removeHandler(m_events->forClient().connected(), target);
+        m_events->removeHandler(m_events->forClient().connectionFailed(), target);
+        m_events->removeHandler(m_events->forClient().disconnected(), target);
+        m_events->removeHandler(m_events->forFile().fileRecieveCompleted(), client.m_client);
+        if (client.m_retryTimer != NULL) {
+            m_events->removeHandler(Event::kTimer, client.m_retryTimer);
+            m_events->deleteTimer(client.m_retryTimer);
+        }
+        delete client.m_client;
+        delete client.m_screen;
+    }
+}
+
+std::string
+LoadClients::clientName(int index)
+{
+    return "client" + std::to_string(index);
+}
+
+void
+LoadClients::handleConnected(const Event&, void* vclient)
+{
+    LoadClient* client = static_cast<LoadClient*>(vclient);
+    client->m_connected = true;
+    m_stats->m_clients[client->m_index].m_connected.store(true);
+    LOG((CLOG_DEBUG "%s connected", clientName(client->m_index).c_str()));
+}
+
+void
+LoadClients::handleConnectionFailed(const Event& event, void* vclient)
+{
+    LoadClient* client = static_cast<LoadClient*>(vclient);
+    Client::FailInfo* info = static_cast<Client::FailInfo*>(event.getData());
+
+    if (inputleap::current_time_seconds() < m_giveUpTime) {
+        LOG((CLOG_DEBUG1 "%s failed to connect: %s", clientName(client->m_index).c_str(), info->m_what.c_str()));
+        client->m_retryTimer = m_events->newOneShotTimer(s_retryInterval, NULL);
+        m_events->adoptHandler(Event::kTimer, client->m_retryTimer,
+                            new TMethodEventJob<LoadClients>(this,
+                                &LoadClients::handleRetry, client));
+    }
+    else {
+        LOG((CLOG_ERR "%s failed to connect: %s", clientName(client->m_index).c_str(), info->m_what.c_str()));
+        client->m_done = true;
+        checkDone();
+    }
+    delete info;
+}
+
+void
+LoadClients::handleDisconnected(const Event&, void* vclient)
+{
+    LoadClient* client = static_cast<LoadClient*>(vclient);
+    m_stats->m_clients[client->m_index].m_connected.store(false);
+    LOG((CLOG_DEBUG "%s disconnected", clientName(client->m_index).c_str()));
+    if (client->m_connected) {
+        client->m_done = true;
+        checkDone();
+    }
+}
+
+void
+LoadClients::handleRetry(const Event&, void* vclient)
+{
+    LoadClient* client = static_cast<LoadClient*>(vclient);
+    m_events->removeHandler(Event::kTimer, client->m_retryTimer);
+    m_events->deleteTimer(client->m_retryTimer);
+    client->m_retryTimer = NULL;
+    client->m_client->connect();
+}
+
+void
+LoadClients::handleFileReceived(const Event&, void* vclient)
+{
+    LoadClient* client = static_cast<LoadClient*>(vclient);
+    m_stats->m_clients[client->m_index].m_fileBytes.fetch_add(
+                            client->m_client->getReceivedFileData().size());
+}
+
+void
+LoadClients::checkDone()
+{
+    for (const LoadClient& client : m_clients) {
+        if (!client.m_done) {
+            return;
+        }
+    }
+    m_events->addEvent(Event(Event::kQuit));
+}
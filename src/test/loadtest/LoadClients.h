@@ -0,0 +1,85 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "net/NetworkAddress.h"
+
+#include <string>
+#include <vector>
+
+class Client;
+class Event;
+class EventQueueTimer;
+class IEventQueue;
+class LoadStats;
+class SocketMultiplexer;
+namespace inputleap { class Screen; }
+
+//! Synthetic clients for load testing
+/*!
+Connects a range of clients, each with a LoadScreen, to the load test
+server.  Connections that fail are retried for a while since the
+server may not be listening yet.  Sends Event::kQuit once every client
+has connected and then disconnected again, or if some client never
+connects.
+*/
+class LoadClients {
+public:
+    /*!
+    Connects clients \p first to \p first + \p count - 1.  Client i is
+    named clientName(i) and is measured in slot i of \p stats.
+    */
+    LoadClients(IEventQueue* events, SocketMultiplexer* multiplexer,
+                LoadStats* stats, const NetworkAddress& server,
+                int first, int count, bool tls);
+    LoadClients(const LoadClients&) = delete;
+    LoadClients& operator=(const LoadClients&) = delete;
+    ~LoadClients();
+
+    //! @name accessors
+    //@{
+
+    //! Get the screen name of client \p index
+    static std::string    clientName(int index);
+
+    //@}
+
+private:
+    class LoadClient {
+    public:
+        int                    m_index;
+        inputleap::Screen*    m_screen;
+        Client*                m_client;
+        EventQueueTimer*    m_retryTimer;
+        bool                m_connected;
+        bool                m_done;
+    };
+
+    void                handleConnected(const Event&, void*);
+    void                handleConnectionFailed(const Event&, void*);
+    void                handleDisconnected(const Event&, void*);
+    void                handleRetry(const Event&, void*);
+    void                handleFileReceived(const Event&, void*);
+    void                checkDone();
+
+private:
+    IEventQueue*        m_events;
+    LoadStats*            m_stats;
+    std::vector<LoadClient> m_clients;
+    double                m_giveUpTime;
+};
@@ -0,0 +1,140 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "test/loadtest/LoadScreen.h"
+#include "test/loadtest/LoadStats.h"
+#include "base/IEventQueue.h"
+
+//
+// LoadScreen
+//
+
+LoadScreen::LoadScreen(IEventQueue* events, LoadStats* stats, int client) :
+    VirtualScreen(events, client < 0, 0, 0, kWidth, kHeight),
+    m_stats(stats),
+    m_client(client)
+{
+}
+
+LoadScreen::~LoadScreen()
+{
+    // do nothing
+}
+
+void
+LoadScreen::injectMotion(std::int32_t dx, std::int32_t dy)
+{
+    m_events->addEvent(Event(m_events->forIPrimaryScreen().motionOnSecondary(),
+                            getEventTarget(), MotionInfo::alloc(dx, dy)));
+}
+
+void
+LoadScreen::injectKey(KeyID id, KeyButton button)
+{
+    m_events->addEvent(Event(m_events->forIKeyState().keyDown(), getEventTarget(),
+                            KeyInfo::alloc(id, 0, button, 1)));
+    m_events->addEvent(Event(m_events->forIKeyState().keyUp(), getEventTarget(),
+                            KeyInfo::alloc(id, 0, button, 1)));
+}
+
+void
+LoadScreen::injectClipboard(const std::string& text)
+{
+    m_injected.open(0);
+    m_injected.empty();
+    m_injected.add(IClipboard::kText, text);
+    m_injected.close();
+    VirtualScreen::setClipboard(kClipboardClipboard, &m_injected);
+    sendClipboardEvent(m_events->forClipboard().clipboardGrabbed(), kClipboardClipboard);
+    sendClipboardEvent(m_events->forClipboard().clipboardChanged(), kClipboardClipboard);
+}
+
+void
+LoadScreen::fakeMouseMove(std::int32_t x, std::int32_t y)
+{
+    std::int32_t oldX, oldY;
+    getCursorPos(oldX, oldY);
+    VirtualScreen::fakeMouseMove(x, y);
+    if (m_client < 0) {
+        return;
+    }
+
+    LoadStats::ClientStats& stats = m_stats->m_clients[m_client];
+    stats.m_motions.fetch_add(1, std::memory_order_relaxed);
+
+    // motion is horizontal except for the one the server injects after
+    // letting the client go from a stall, so the motions before that
+    // one are those that piled up while it was stopped
+    if (stats.m_resumed.load() != 0 && stats.m_caughtUp.load() == 0) {
+        if (y != oldY) {
+            stats.m_caughtUp.store(LoadStats::now());
+        }
+        else {
+            stats.m_staleMotions.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // each stamp is used once since positions repeat
+    std::int32_t position = x - (kWidth / 2 - LoadStats::kMotionSpan);
+    if (position >= 0 && position < LoadStats::kMotionPositions) {
+        std::int64_t sent = stats.m_motionTimes[position].exchange(0);
+        if (sent != 0) {
+            stats.m_motionLatency.record(LoadStats::now() - sent);
+        }
+    }
+}
+
+void
+LoadScreen::fakeKeyDown(KeyID id, KeyModifierMask mask, KeyButton button)
+{
+    VirtualScreen::fakeKeyDown(id, mask, button);
+    if (m_client < 0) {
+        return;
+    }
+
+    // every client gets each key so stamps are left for the others
+    LoadStats::ClientStats& stats = m_stats->m_clients[m_client];
+    stats.m_keys.fetch_add(1, std::memory_order_relaxed);
+    std::int64_t sent = m_stats->m_keyTimes[button].load(std::memory_order_relaxed);
+    if (sent != 0) {
+        stats.m_keyLatency.record(LoadStats::now() - sent);
+    }
+}
+
+bool
+LoadScreen::setClipboard(ClipboardID id, const IClipboard* clipboard)
+{
+    VirtualScreen::setClipboard(id, clipboard);
+    if (clipboard == NULL || m_client < 0) {
+        return true;
+    }
+
+    std::uint64_t size = 0;
+    if (clipboard->open(0)) {
+        if (clipboard->has(IClipboard::kText)) {
+            size = clipboard->get(IClipboard::kText).size();
+        }
+        clipboard->close();
+    }
+    // entering a screen sends empty clipboards too
+    if (size > 0) {
+        LoadStats::ClientStats& stats = m_stats->m_clients[m_client];
+        stats.m_clipboards.fetch_add(1, std::memory_order_relaxed);
+        stats.m_clipboardBytes.fetch_add(size, std::memory_order_relaxed);
+    }
+    return true;
+}
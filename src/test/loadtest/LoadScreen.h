@@ -0,0 +1,66 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "platform/VirtualScreen.h"
+
+class LoadStats;
+
+//! Screen without a display for load testing
+/*!
+As a primary screen it reports whatever input the load generator
+injects.  As a secondary screen it counts the input it's asked to
+synthesize and measures its latency in LoadStats.
+*/
+class LoadScreen : public VirtualScreen {
+public:
+    //! Screen width and height
+    static const std::int32_t kWidth  = 1920;
+    static const std::int32_t kHeight = 1080;
+
+    /*!
+    \p client is the index of the client's measurements in \p stats,
+    or -1 for the primary screen.
+    */
+    LoadScreen(IEventQueue* events, LoadStats* stats, int client);
+    ~LoadScreen() override;
+
+    //! @name manipulators
+    //@{
+
+    //! Inject a relative mouse motion
+    void                injectMotion(std::int32_t dx, std::int32_t dy);
+
+    //! Inject a key press and release
+    void                injectKey(KeyID id, KeyButton button);
+
+    //! Copy \p text to the clipboard
+    void                injectClipboard(const std::string& text);
+
+    //@}
+
+    // VirtualScreen overrides
+    void fakeMouseMove(std::int32_t x, std::int32_t y) override;
+    void fakeKeyDown(KeyID id, KeyModifierMask mask, KeyButton button) override;
+    bool setClipboard(ClipboardID, const IClipboard*) override;
+
+private:
+    LoadStats*            m_stats;
+    int                    m_client;
+    Clipboard            m_injected;
+};
@@ -0,0 +1,464 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "test/loadtest/LoadServer.h"
+#include "test/loadtest/LoadClients.h"
+#include "test/loadtest/LoadScreen.h"
+#include "test/loadtest/LoadStats.h"
+#include "server/ClientListener.h"
+#include "server/ClientProxy.h"
+#include "server/Config.h"
+#include "server/PrimaryClient.h"
+#include "server/Server.h"
+#include "inputleap/Screen.h"
+#include "inputleap/ServerArgs.h"
+#include "net/SocketMultiplexerPool.h"
+#include "net/TCPSocketFactory.h"
+#include "base/IEventQueue.h"
+#include "base/Log.h"
+#include "base/Time.h"
+#include "base/TMethodEventJob.h"
+
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <sys/resource.h>
+#include <unistd.h>
+
+static const char* const s_serverName = "server";
+
+// how often to inject input
+static const double s_tickInterval = 0.002;
+
+// how long to wait for clients to connect
+static const double s_connectTimeout = 15.0;
+
+// how long to let input in flight arrive after injecting stops
+static const double s_drainTime = 0.5;
+
+// how long to wait for clients to disconnect
+static const double s_disconnectTimeout = 3.0;
+
+//
+// LoadServer::Workload
+//
+
+LoadServer::Workload::Workload() :
+    m_duration(10.0),
+    m_motionRate(1000.0),
+    m_keyRate(50.0),
+    m_switchInterval(0.5),
+    m_clipboardSize(0),
+    m_fileSize(0),
+    m_stall(0.0)
+{
+}
+
+//
+// LoadServer
+//
+
+LoadServer::LoadServer(IEventQueue* events, SocketMultiplexer* multiplexer,
+                SocketMultiplexerPool* ioThreads, LoadStats* stats,
+                const NetworkAddress& address,
+                int clients, bool tls, const Workload& workload) :
+    m_events(events),
+    m_stats(stats),
+    m_numClients(clients),
+    m_numIOThreads(ioThreads == NULL ? 0 : static_cast<int>(ioThreads->getSize())),
+    m_workload(workload),
+    m_timer(NULL),
+    m_ready(false),
+    m_state(kConnecting),
+    m_stateTime(inputleap::current_time_seconds()),
+    m_startTime(0.0),
+    m_elapsed(0.0),
+    m_startCPU(0.0),
+    m_cpu(0.0),
+    m_turn(0),
+    m_turnTime(0.0),
+    m_motions(0),
+    m_keys(0),
+    m_clipboards(0),
+    m_button(0),
+    m_x(clients, LoadScreen::kWidth / 2),
+    m_dx(clients, 1),
+    m_stallPid(0),
+    m_stallState(kStallPending),
+    m_stallTime(0.0)
+{
+    // the file to send, if any
+    if (m_workload.m_fileSize > 0) {
+        char path[] = "/tmp/inputleap-loadtest-XXXXXX";
+        int fd = mkstemp(path);
+        if (fd != -1) {
+            std::vector<char> data(m_workload.m_fileSize, 'x');
+            ssize_t n = write(fd, data.data(), data.size());
+            close(fd);
+            m_filePath = path;
+            if (n != static_cast<ssize_t>(data.size())) {
+                LOG((CLOG_WARN "couldn't write %s, not sending files", path));
+                m_workload.m_fileSize = 0;
+            }
+        }
+        else {
+            LOG((CLOG_WARN "couldn't create a file to send, not sending files"));
+            m_workload.m_fileSize = 0;
+        }
+    }
+
+    // one screen per client and no links between them, so the only
+    // way to change screens is the switch events sent from here
+    m_config = new Config(m_events);
+    m_config->addScreen(s_serverName);
+    for (int i = 0; i < clients; ++i) {
+        m_config->addScreen(LoadClients::clientName(i));
+    }
+
+    ServerArgs args;
+    args.m_enableDragDrop = (m_workload.m_fileSize > 0);
+
+    m_primaryScreen = new LoadScreen(m_events, m_stats, -1);
+    m_screen        = new inputleap::Screen(m_primaryScreen, m_events);
+    m_primaryClient = new PrimaryClient(s_serverName, m_screen);
+    m_listener      = new ClientListener(address,
+                            new TCPSocketFactory(m_events, multiplexer, ioThreads), m_events,
+                            tls ? ConnectionSecurityLevel::ENCRYPTED :
+                                  ConnectionSecurityLevel::PLAINTEXT);
+    m_server        = new Server(*m_config, m_primaryClient, m_screen, m_events, args);
+    m_listener->setServer(m_server);
+    m_server->setListener(m_listener);
+
+    m_events->adoptHandler(m_events->forClientListener().connected(), m_listener,
+                            new TMethodEventJob<LoadServer>(this,
+                                &LoadServer::handleClientConnected));
+    m_events->adoptHandler(m_events->forServer().disconnected(), m_server,
+                            new TMethodEventJob<LoadServer>(this,
+                                &LoadServer::handleDisconnected));
+
+    // the screens to visit.  the primary screen only needs a turn to
+    // copy to the clipboard.
+    if (m_workload.m_clipboardSize > 0) {
+        m_turns.push_back(-1);
+    }
+    for (int i = 0; i < clients; ++i) {
+        m_turns.push_back(i);
+    }
+}
+
+LoadServer::~LoadServer()
+{
+    if (m_timer != NULL) {
+        m_events->removeHandler(Event::kTimer, m_timer);
+        m_events->deleteTimer(m_timer);
+    }
+    m_events->removeHandler(m_events->forClientListener().connected(), m_listener);
+    m_events->removeHandler(m_events->forServer().disconnected(), m_server);
+    delete m_server;
+    delete m_listener;
+    delete m_primaryClient;
+    delete m_screen;
+    delete m_config;
+    if (!m_filePath.empty()) {
+        unlink(m_filePath.c_str());
+    }
+}
+
+bool
+LoadServer::run()
+{
+    m_timer = m_events->newTimer(s_tickInterval, NULL);
+    m_events->adoptHandler(Event::kTimer, m_timer,
+                            new TMethodEventJob<LoadServer>(this,
+                                &LoadServer::handleTick));
+    m_events->loop();
+    return m_ready;
+}
+
+void
+LoadServer::setStallProcess(pid_t pid)
+{
+    m_stallPid = pid;
+}
+
+void
+LoadServer::report(bool inProcess) const
+{
+    if (!m_ready || m_elapsed <= 0.0) {
+        return;
+    }
+
+    std::printf("%-10s %10s %9s %9s %9s %9s %9s %9s %10s %10s\n",
+                "client", "motions/s", "p50 ms", "p99 ms", "keys/s",
+                "p50 ms", "p99 ms", "max ms", "clipboards", "file KiB");
+    for (int i = 0; i < m_numClients; ++i) {
+        const LoadStats::ClientStats& stats = m_stats->m_clients[i];
+        std::printf("%-10s %10.0f %9.3f %9.3f %9.0f %9.3f %9.3f %9.3f %10llu %10llu\n",
+                    LoadClients::clientName(i).c_str(),
+                    stats.m_motions.load() / m_elapsed,
+                    stats.m_motionLatency.getPercentile(50.0) / 1000.0,
+                    stats.m_motionLatency.getPercentile(99.0) / 1000.0,
+                    stats.m_keys.load() / m_elapsed,
+                    stats.m_keyLatency.getPercentile(50.0) / 1000.0,
+                    stats.m_keyLatency.getPercentile(99.0) / 1000.0,
+                    stats.m_keyLatency.getMax() / 1000.0,
+                    static_cast<unsigned long long>(stats.m_clipboards.load()),
+                    static_cast<unsigned long long>(stats.m_fileBytes.load() / 1024));
+    }
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+    long peakKiB = usage.ru_maxrss / 1024;
+#else
+    long peakKiB = usage.ru_maxrss;
+#endif
+    std::printf("\ninjected %.0f motions/s and %.0f keys/s over %.1f s to %d clients\n",
+                m_motions / m_elapsed, m_keys / m_elapsed, m_elapsed, m_numClients);
+    std::printf("server sockets on %d I/O threads\n", m_numIOThreads);
+    std::printf("%s CPU %.1f%% of one core, peak RSS %ld KiB\n",
+                inProcess ? "process" : "server",
+                100.0 * m_cpu / m_elapsed, peakKiB);
+
+    if (m_stallState == kStallDone) {
+        const LoadStats::ClientStats& stats = m_stats->m_clients[0];
+        std::printf("%s stalled for %.1f s, then got %llu stale motions "
+                    "and the current position after %.1f ms\n",
+                    LoadClients::clientName(0).c_str(), m_workload.m_stall,
+                    static_cast<unsigned long long>(stats.m_staleMotions.load()),
+                    (stats.m_caughtUp.load() - stats.m_resumed.load()) / 1000.0);
+    }
+    else if (m_stallState != kStallPending) {
+        std::printf("%s stalled for %.1f s and didn't get the current position "
+                    "before the end (%llu stale motions)\n",
+                    LoadClients::clientName(0).c_str(), m_workload.m_stall,
+                    static_cast<unsigned long long>(
+                        m_stats->m_clients[0].m_staleMotions.load()));
+    }
+}
+
+void
+LoadServer::handleClientConnected(const Event&, void*)
+{
+    ClientProxy* client = m_listener->getNextClient();
+    if (client != NULL) {
+        m_server->adoptClient(client);
+    }
+}
+
+void
+LoadServer::handleTick(const Event&, void*)
+{
+    double now = inputleap::current_time_seconds();
+    switch (m_state) {
+    case kConnecting: {
+        bool connected = (m_server->getNumClients() ==
+                            static_cast<std::uint32_t>(m_numClients + 1));
+        for (int i = 0; connected && i < m_numClients; ++i) {
+            connected = m_stats->m_clients[i].m_connected.load();
+        }
+        if (connected) {
+            start(now);
+        }
+        else if (now - m_stateTime > s_connectTimeout) {
+            LOG((CLOG_ERR "only %d of %d clients connected",
+                m_server->getNumClients() - 1, m_numClients));
+            stop();
+        }
+        break;
+    }
+
+    case kRunning:
+        inject(now);
+        if (now - m_startTime >= m_workload.m_duration) {
+            m_elapsed   = now - m_startTime;
+            m_state     = kDraining;
+            m_stateTime = now;
+        }
+        break;
+
+    case kDraining:
+        if (now - m_stateTime >= s_drainTime) {
+            m_cpu = getCPUTime() - m_startCPU;
+            stop();
+        }
+        break;
+
+    case kDisconnecting:
+        if (now - m_stateTime >= s_disconnectTimeout) {
+            LOG((CLOG_WARN "clients didn't disconnect"));
+            m_events->addEvent(Event(Event::kQuit));
+        }
+        break;
+    }
+}
+
+void
+LoadServer::handleDisconnected(const Event&, void*)
+{
+    m_events->addEvent(Event(Event::kQuit));
+}
+
+void
+LoadServer::start(double now)
+{
+    LOG((CLOG_NOTE "%d clients connected, starting", m_numClients));
+    m_ready = true;
+    m_events->addEvent(Event(m_events->forServer().keyboardBroadcast(),
+                            m_config->getInputFilter(),
+                            Server::KeyboardBroadcastInfo::alloc(
+                                Server::KeyboardBroadcastInfo::kOn)));
+
+    m_stats->reset();
+    m_state     = kRunning;
+    m_stateTime = now;
+    m_startTime = now;
+    m_startCPU  = getCPUTime();
+    m_turn      = 0;
+    switchScreen(now);
+}
+
+void
+LoadServer::inject(double now)
+{
+    const double elapsed = now - m_startTime;
+    const std::int32_t base = LoadScreen::kWidth / 2 - LoadStats::kMotionSpan;
+    const int active = m_turns[m_turn];
+
+    // motion zig-zags over the positions that have stamps
+    auto motions = static_cast<std::uint64_t>(elapsed * m_workload.m_motionRate);
+    for (; m_motions < motions; ++m_motions) {
+        if (active < 0) {
+            continue;
+        }
+        std::int32_t x = m_x[active] + m_dx[active];
+        if (x < base || x >= base + LoadStats::kMotionPositions) {
+            m_dx[active] = -m_dx[active];
+            x = m_x[active] + m_dx[active];
+        }
+        m_x[active] = x;
+        m_stats->m_clients[active].m_motionTimes[x - base].store(LoadStats::now());
+        m_primaryScreen->injectMotion(m_dx[active], 0);
+    }
+
+    // key presses cycle through the buttons, skipping 0
+    auto keys = static_cast<std::uint64_t>(elapsed * m_workload.m_keyRate);
+    for (; m_keys < keys; ++m_keys) {
+        if (++m_button == 0) {
+            ++m_button;
+        }
+        m_stats->m_keyTimes[m_button].store(LoadStats::now());
+        m_primaryScreen->injectKey(static_cast<KeyID>('a' + m_keys % 26), m_button);
+    }
+
+    if (!stall(now, active) && now - m_turnTime >= m_workload.m_switchInterval) {
+        m_turn = (m_turn + 1) % m_turns.size();
+        switchScreen(now);
+    }
+}
+
+bool
+LoadServer::stall(double now, int active)
+{
+    LoadStats::ClientStats& stats = m_stats->m_clients[0];
+    switch (m_stallState) {
+    case kStallPending:
+        // stop the first client while it's active, about halfway through
+        if (m_stallPid > 0 && active == 0 &&
+            now - m_startTime >= (m_workload.m_duration - m_workload.m_stall) / 2) {
+            LOG((CLOG_NOTE "stalling %s", LoadClients::clientName(0).c_str()));
+            kill(m_stallPid, SIGSTOP);
+            m_stallState = kStalled;
+            m_stallTime  = now;
+            return true;
+        }
+        return false;
+
+    case kStalled:
+        if (now - m_stallTime >= m_workload.m_stall) {
+            LOG((CLOG_NOTE "resuming %s", LoadClients::clientName(0).c_str()));
+            stats.m_resumed.store(LoadStats::now());
+            kill(m_stallPid, SIGCONT);
+            m_primaryScreen->injectMotion(0, 1);
+            m_stallState = kCatchingUp;
+        }
+        return true;
+
+    case kCatchingUp:
+        // keep moving on its screen until it gets the motion after the
+        // stall
+        if (stats.m_caughtUp.load() == 0) {
+            return true;
+        }
+        m_stallState = kStallDone;
+        return false;
+
+    case kStallDone:
+        break;
+    }
+    return false;
+}
+
+void
+LoadServer::switchScreen(double now)
+{
+    const int screen = m_turns[m_turn];
+    m_turnTime = now;
+
+    std::string name = (screen < 0) ? s_serverName : LoadClients::clientName(screen);
+    m_events->addEvent(Event(m_events->forServer().switchToScreen(),
+                            m_config->getInputFilter(),
+                            Server::SwitchToScreenInfo::alloc(name)));
+
+    if (screen < 0) {
+        if (m_workload.m_clipboardSize > 0) {
+            std::string text(m_workload.m_clipboardSize, 'a' + m_clipboards % 26);
+            m_primaryScreen->injectClipboard(text);
+            ++m_clipboards;
+        }
+    }
+    else {
+        // entering moves the cursor to where it was, which isn't a
+        // motion that was injected
+        const std::int32_t base = LoadScreen::kWidth / 2 - LoadStats::kMotionSpan;
+        m_stats->m_clients[screen].m_motionTimes[m_x[screen] - base].store(0);
+
+        if (m_workload.m_fileSize > 0) {
+            m_server->sendFileToClient(m_filePath.c_str());
+        }
+    }
+}
+
+void
+LoadServer::stop()
+{
+    if (m_stallState == kStalled) {
+        kill(m_stallPid, SIGCONT);
+    }
+    m_state     = kDisconnecting;
+    m_stateTime = inputleap::current_time_seconds();
+    m_server->disconnect();
+}
+
+double
+LoadServer::getCPUTime()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1.0e6 +
+           usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1.0e6;
+}
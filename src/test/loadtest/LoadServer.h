@@ -0,0 +1,172 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "inputleap/key_types.h"
+#include "net/NetworkAddress.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+class ClientListener;
+class Config;
+class Event;
+class EventQueueTimer;
+class IEventQueue;
+class LoadScreen;
+class LoadStats;
+class PrimaryClient;
+class Server;
+class SocketMultiplexer;
+class SocketMultiplexerPool;
+namespace inputleap { class Screen; }
+
+//! Load test server and workload generator
+/*!
+Runs a server whose primary screen is a LoadScreen and, once all the
+clients have connected, injects input on it at fixed rates.  Key
+presses are broadcast to every client.  Motion goes to the active
+client, which changes every so often; when a clipboard is used the
+primary screen takes a turn too and copies to the clipboard, so each
+client gets the clipboard when it's next entered.  A file can also be
+sent to each client as it's entered.
+
+The process running the first client can be stopped for a while, as if
+it hung, while the cursor moves on its screen.  The cursor stays there
+until the client, once let go, gets a motion injected after that.
+*/
+class LoadServer {
+public:
+    //! What to inject
+    class Workload {
+    public:
+        Workload();
+
+    public:
+        double            m_duration;            //!< Seconds to measure for
+        double            m_motionRate;        //!< Motions per second
+        double            m_keyRate;            //!< Key presses per second
+        double            m_switchInterval;    //!< Seconds on each screen
+        std::size_t        m_clipboardSize;    //!< Bytes to copy, 0 for none
+        std::size_t        m_fileSize;            //!< Bytes to send, 0 for none
+        double            m_stall;            //!< Seconds to stop a client for
+    };
+
+    /*!
+    Listens on \p address for \p clients clients, named as by
+    LoadClients::clientName().  Accepted connections use the
+    multiplexers in \p ioThreads if it's not NULL.
+    */
+    LoadServer(IEventQueue* events, SocketMultiplexer* multiplexer,
+                SocketMultiplexerPool* ioThreads, LoadStats* stats, const NetworkAddress& address,
+                int clients, bool tls, const Workload& workload);
+    LoadServer(const LoadServer&) = delete;
+    LoadServer& operator=(const LoadServer&) = delete;
+    ~LoadServer();
+
+    //! @name manipulators
+    //@{
+
+    //! Run the workload
+    /*!
+    Runs the event loop until the workload is done and the clients are
+    disconnected.  Returns false if the clients didn't all connect.
+    */
+    bool                run();
+
+    //! Set the process to stall
+    /*!
+    \p pid runs the first client and is stopped for Workload::m_stall
+    seconds about halfway through the run.
+    */
+    void                setStallProcess(pid_t pid);
+
+    //@}
+    //! @name accessors
+    //@{
+
+    //! Print the results
+    /*!
+    \p inProcess says whether the clients ran in this process, in which
+    case the CPU time and memory include theirs.
+    */
+    void                report(bool inProcess) const;
+
+    //@}
+
+private:
+    enum EState { kConnecting, kRunning, kDraining, kDisconnecting };
+    enum EStall { kStallPending, kStalled, kCatchingUp, kStallDone };
+
+    void                handleClientConnected(const Event&, void*);
+    void                handleTick(const Event&, void*);
+    void                handleDisconnected(const Event&, void*);
+    void                start(double now);
+    void                inject(double now);
+    void                switchScreen(double now);
+    bool                stall(double now, int active);
+    void                stop();
+
+    static double        getCPUTime();
+
+private:
+    IEventQueue*        m_events;
+    LoadStats*            m_stats;
+    int                    m_numClients;
+    int                    m_numIOThreads;
+    Workload            m_workload;
+    Config*                m_config;
+    LoadScreen*            m_primaryScreen;
+    inputleap::Screen*    m_screen;
+    PrimaryClient*        m_primaryClient;
+    ClientListener*        m_listener;
+    Server*                m_server;
+    EventQueueTimer*    m_timer;
+    std::string            m_filePath;
+    bool                m_ready;
+
+    EState                m_state;
+    double                m_stateTime;
+    double                m_startTime;
+    double                m_elapsed;
+    double                m_startCPU;
+    double                m_cpu;
+
+    // the screens to visit in turn, -1 being the primary screen
+    std::vector<int>    m_turns;
+    std::size_t            m_turn;
+    double                m_turnTime;
+
+    // what's been injected
+    std::uint64_t        m_motions;
+    std::uint64_t        m_keys;
+    std::uint64_t        m_clipboards;
+    KeyButton            m_button;
+
+    // where each client's cursor is, as the server will see it
+    std::vector<std::int32_t> m_x;
+    std::vector<std::int32_t> m_dx;
+
+    // the first client's stall
+    pid_t                m_stallPid;
+    EStall                m_stallState;
+    double                m_stallTime;
+};
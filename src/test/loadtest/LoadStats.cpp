@@ -0,0 +1,83 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "test/loadtest/LoadStats.h"
+#include "base/Time.h"
+
+#include <new>
+#include <sys/mman.h>
+
+//
+// LoadStats
+//
+
+LoadStats::LoadStats()
+{
+    for (auto& stamp : m_keyTimes) {
+        stamp.store(0, std::memory_order_relaxed);
+    }
+    for (auto& client : m_clients) {
+        client.m_connected.store(false, std::memory_order_relaxed);
+        for (auto& stamp : client.m_motionTimes) {
+            stamp.store(0, std::memory_order_relaxed);
+        }
+    }
+    reset();
+}
+
+LoadStats*
+LoadStats::create()
+{
+    void* memory = mmap(NULL, sizeof(LoadStats), PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        return NULL;
+    }
+    return new(memory) LoadStats;
+}
+
+void
+LoadStats::destroy(LoadStats* stats)
+{
+    if (stats != NULL) {
+        stats->~LoadStats();
+        munmap(stats, sizeof(LoadStats));
+    }
+}
+
+void
+LoadStats::reset()
+{
+    for (auto& client : m_clients) {
+        client.m_motions.store(0, std::memory_order_relaxed);
+        client.m_keys.store(0, std::memory_order_relaxed);
+        client.m_clipboards.store(0, std::memory_order_relaxed);
+        client.m_clipboardBytes.store(0, std::memory_order_relaxed);
+        client.m_fileBytes.store(0, std::memory_order_relaxed);
+        client.m_resumed.store(0, std::memory_order_relaxed);
+        client.m_caughtUp.store(0, std::memory_order_relaxed);
+        client.m_staleMotions.store(0, std::memory_order_relaxed);
+        client.m_motionLatency.reset();
+        client.m_keyLatency.reset();
+    }
+}
+
+std::int64_t
+LoadStats::now()
+{
+    return static_cast<std::int64_t>(inputleap::current_time_seconds() * 1.0e6);
+}
@@ -0,0 +1,108 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "base/Histogram.h"
+
+#include <atomic>
+#include <cstdint>
+
+//! Measurements shared by the load test processes
+/*!
+The load generator stamps each event it injects with the time it was
+injected and the screens that receive the event look the stamp up to
+get the latency.  Everything lives in one block of shared memory so
+that clients running in other processes can use it too.  Only atomics
+and histograms live here, since those work across processes.
+*/
+class LoadStats {
+public:
+    //! Most clients that can be measured
+    static const int    kMaxClients = 128;
+
+    //! Cursor positions used for motion
+    /*!
+    The cursor zig-zags over this many pixels each side of the center
+    of a client screen.  Each position has its own stamp.
+    */
+    static const int    kMotionSpan = 256;
+    static const int    kMotionPositions = 2 * kMotionSpan + 1;
+
+    //! Measurements for one client
+    class ClientStats {
+    public:
+        std::atomic<bool>            m_connected;
+        std::atomic<std::uint64_t>    m_motions;
+        std::atomic<std::uint64_t>    m_keys;
+        std::atomic<std::uint64_t>    m_clipboards;
+        std::atomic<std::uint64_t>    m_clipboardBytes;
+        std::atomic<std::uint64_t>    m_fileBytes;
+        Histogram                    m_motionLatency;
+        Histogram                    m_keyLatency;
+
+        // when each cursor position was injected, in microseconds
+        std::atomic<std::int64_t>    m_motionTimes[kMotionPositions];
+        // when the client was let go after a stall, when it then got the
+        // first motion injected after that and how many older ones it got
+        // first
+        std::atomic<std::int64_t>    m_resumed;
+        std::atomic<std::int64_t>    m_caughtUp;
+        std::atomic<std::uint64_t>    m_staleMotions;
+    };
+
+    //! Create in shared memory
+    /*!
+    Returns NULL if the memory can't be mapped.  The memory is shared
+    with processes forked later.
+    */
+    static LoadStats*    create();
+
+    //! Destroy what create() returned
+    static void            destroy(LoadStats*);
+
+    //! @name manipulators
+    //@{
+
+    //! Zero the counters and histograms
+    /*!
+    Doesn't touch the stamps or connection flags.
+    */
+    void                reset();
+
+    //@}
+    //! @name accessors
+    //@{
+
+    //! Get the time for stamps
+    /*!
+    Returns microseconds on a clock shared by all processes.
+    */
+    static std::int64_t    now();
+
+    //@}
+
+public:
+    // when each key press was injected, in microseconds, by button
+    std::atomic<std::int64_t>    m_keyTimes[65536];
+
+    ClientStats            m_clients[kMaxClients];
+
+private:
+    LoadStats();
+    ~LoadStats() = default;
+};
@@ -0,0 +1,286 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "test/loadtest/LoadClients.h"
+#include "test/loadtest/LoadServer.h"
+#include "test/loadtest/LoadStats.h"
+#include "arch/Arch.h"
+#include "base/EventQueue.h"
+#include "base/Log.h"
+#include "base/XBase.h"
+#include "common/DataDirectories.h"
+#include "io/filesystem.h"
+#include "net/FingerprintDatabase.h"
+#include "net/SecureUtils.h"
+#include "net/SocketMultiplexer.h"
+#include "net/SocketMultiplexerPool.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+//
+// loadtest -- drives one server with synthetic clients over loopback
+// and reports what each client received.  no display is needed.
+//
+
+static const char* const s_usage =
+"usage: loadtest [options]\n"
+"  --clients <n>           number of clients (default 4)\n"
+"  --processes <n>         run the clients in <n> other processes instead\n"
+"                          of this one, so the CPU time is the server's alone\n"
+"  --duration <seconds>    how long to measure for (default 10)\n"
+"  --motion-rate <n>       mouse motions per second (default 1000)\n"
+"  --key-rate <n>          key presses per second (default 50)\n"
+"  --switch-interval <s>   seconds on each screen (default 0.5)\n"
+"  --clipboard-size <n>    bytes to copy once per round of screens\n"
+"  --file-size <n>         bytes to send to each screen entered\n"
+"  --port <n>              loopback port to use (default 24900)\n"
+"  --tls                   encrypt the connections\n"
+"  --io-threads <n>        service the server's connections on n threads,\n"
+"                          0 for the main socket thread (default as barriers)\n"
+"  --stall <seconds>       stop the first client's process this long halfway\n"
+"                          through and report how soon it gets the current\n"
+"                          position after; needs --processes\n"
+"  -d, --debug <level>     log level (default WARNING)\n";
+
+namespace {
+
+class Options {
+public:
+    int                    m_clients = 4;
+    int                    m_processes = 0;
+    int                    m_port = 24900;
+    int                    m_ioThreads = -1;
+    bool                m_tls = false;
+    const char*            m_logLevel = "WARNING";
+    LoadServer::Workload m_workload;
+};
+
+bool
+parseOptions(int argc, char** argv, Options& options)
+{
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        if (std::strcmp(arg, "--tls") == 0) {
+            options.m_tls = true;
+            continue;
+        }
+        if (i + 1 == argc) {
+            return false;
+        }
+        const char* value = argv[++i];
+        if (std::strcmp(arg, "--clients") == 0) {
+            options.m_clients = std::atoi(value);
+        }
+        else if (std::strcmp(arg, "--processes") == 0) {
+            options.m_processes = std::atoi(value);
+        }
+        else if (std::strcmp(arg, "--duration") == 0) {
+            options.m_workload.m_duration = std::atof(value);
+        }
+        else if (std::strcmp(arg, "--motion-rate") == 0) {
+            options.m_workload.m_motionRate = std::atof(value);
+        }
+        else if (std::strcmp(arg, "--key-rate") == 0) {
+            options.m_workload.m_keyRate = std::atof(value);
+        }
+        else if (std::strcmp(arg, "--switch-interval") == 0) {
+            options.m_workload.m_switchInterval = std::atof(value);
+        }
+        else if (std::strcmp(arg, "--clipboard-size") == 0) {
+            options.m_workload.m_clipboardSize = std::strtoul(value, NULL, 10);
+        }
+        else if (std::strcmp(arg, "--file-size") == 0) {
+            options.m_workload.m_fileSize = std::strtoul(value, NULL, 10);
+        }
+        else if (std::strcmp(arg, "--io-threads") == 0) {
+            options.m_ioThreads = std::atoi(value);
+        }
+        else if (std::strcmp(arg, "--stall") == 0) {
+            options.m_workload.m_stall = std::atof(value);
+        }
+        else if (std::strcmp(arg, "--port") == 0) {
+            options.m_port = std::atoi(value);
+        }
+        else if (std::strcmp(arg, "-d") == 0 || std::strcmp(arg, "--debug") == 0) {
+            options.m_logLevel = value;
+        }
+        else {
+            return false;
+        }
+    }
+    return (options.m_clients > 0 &&
+            options.m_clients <= LoadStats::kMaxClients &&
+            options.m_processes >= 0 &&
+            options.m_processes <= options.m_clients &&
+            options.m_workload.m_duration > 0.0 &&
+            options.m_workload.m_switchInterval > 0.0 &&
+            options.m_workload.m_stall >= 0.0 &&
+            options.m_workload.m_stall < options.m_workload.m_duration &&
+            (options.m_workload.m_stall == 0.0 || options.m_processes > 0));
+}
+
+// a certificate for the server that the clients trust, in a profile
+// directory of its own
+bool
+setupTLS(const inputleap::fs::path& profile)
+{
+    using inputleap::DataDirectories;
+    try {
+        DataDirectories::profile(profile);
+        inputleap::fs::create_directories(DataDirectories::ssl_fingerprints_path());
+        std::string cert = DataDirectories::ssl_certificate_path().u8string();
+        inputleap::generate_pem_self_signed_cert(cert);
+
+        inputleap::FingerprintDatabase db;
+        db.add_trusted(inputleap::get_pem_file_cert_fingerprint(cert,
+                                            inputleap::FingerprintType::SHA256));
+        db.write(DataDirectories::trusted_servers_ssl_fingerprints_path());
+        return true;
+    }
+    catch (const std::exception& e) {
+        std::fprintf(stderr, "loadtest: can't set up TLS: %s\n", e.what());
+        return false;
+    }
+}
+
+int
+runClients(LoadStats* stats, const Options& options, int first, int count)
+{
+    Arch arch;
+    arch.init();
+    Log log;
+    log.setFilter(options.m_logLevel);
+
+    EventQueue events;
+    SocketMultiplexer multiplexer;
+    NetworkAddress address("127.0.0.1", options.m_port);
+    address.resolve();
+
+    LoadClients clients(&events, &multiplexer, stats, address, first, count, options.m_tls);
+    events.loop();
+    return 0;
+}
+
+int
+runServer(LoadStats* stats, const Options& options, pid_t stallPid)
+{
+    Arch arch;
+    arch.init();
+    Log log;
+    log.setFilter(options.m_logLevel);
+
+    EventQueue events;
+    SocketMultiplexer multiplexer;
+    NetworkAddress address("127.0.0.1", options.m_port);
+    address.resolve();
+
+    SocketMultiplexerPool ioThreads(options.m_ioThreads < 0 ?
+                                    SocketMultiplexerPool::getDefaultSize() :
+                                    static_cast<std::size_t>(options.m_ioThreads));
+
+    std::unique_ptr<LoadServer> server;
+    try {
+        server.reset(new LoadServer(&events, &multiplexer, &ioThreads, stats, address,
+                                    options.m_clients, options.m_tls,
+                                    options.m_workload));
+    }
+    catch (XBase& e) {
+        LOG((CLOG_ERR "can't start server: %s", e.what()));
+        return 1;
+    }
+
+    if (options.m_workload.m_stall > 0.0) {
+        server->setStallProcess(stallPid);
+    }
+
+    std::unique_ptr<LoadClients> clients;
+    if (options.m_processes == 0) {
+        clients.reset(new LoadClients(&events, &multiplexer, stats, address,
+                                      0, options.m_clients, options.m_tls));
+    }
+
+    if (!server->run()) {
+        return 1;
+    }
+    server->report(options.m_processes == 0);
+    return 0;
+}
+
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::fputs(s_usage, stderr);
+        return 2;
+    }
+
+    LoadStats* stats = LoadStats::create();
+    if (stats == NULL) {
+        std::fprintf(stderr, "loadtest: can't map shared memory\n");
+        return 1;
+    }
+
+    inputleap::fs::path profile;
+    if (options.m_tls) {
+        char dir[] = "/tmp/inputleap-loadtest-XXXXXX";
+        if (mkdtemp(dir) == NULL || !setupTLS(dir)) {
+            LoadStats::destroy(stats);
+            return 1;
+        }
+        profile = dir;
+    }
+
+    // fork before anything starts a thread
+    std::vector<pid_t> children;
+    for (int i = 0; i < options.m_processes; ++i) {
+        int first = options.m_clients * i / options.m_processes;
+        int last  = options.m_clients * (i + 1) / options.m_processes;
+        pid_t pid = fork();
+        if (pid == 0) {
+            std::exit(runClients(stats, options, first, last - first));
+        }
+        else if (pid == -1) {
+            std::perror("loadtest: fork");
+        }
+        else {
+            children.push_back(pid);
+        }
+    }
+
+    int result = runServer(stats, options, children.empty() ? 0 : children.front());
+    for (pid_t pid : children) {
+        int status;
+        waitpid(pid, &status, 0);
+    }
+
+    if (!profile.empty()) {
+        std::error_code error;
+        inputleap::fs::remove_all(profile, error);
+    }
+    LoadStats::destroy(stats);
+    return result;
+}
@@ -33,4 +33,6 @@ public:
     MOCK_METHOD0(resetOptions, void());
     MOCK_METHOD1(setOptions, void(const OptionsList&));
     MOCK_METHOD0(enable, void());
+    MOCK_METHOD0(fakeInputBegin, void());
+    MOCK_METHOD0(fakeInputEnd, void());
 };
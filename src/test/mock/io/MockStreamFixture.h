@@ -0,0 +1,223 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "inputleap/ProtocolUtil.h"
+#include "base/EventTypes.h"
+#include "base/IEventJob.h"
+#include "test/mock/inputleap/MockEventQueue.h"
+#include "test/mock/io/MockStream.h"
+
+#include "test/global/gtest.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+//! Mock connection
+/*!
+A mock stream that reads what the test put in \c m_input and records
+what's written in \c m_written.  The stream is handed to the code under
+test, which usually takes ownership of it.
+*/
+class MockConnection {
+public:
+    MockConnection() : m_stream(new ::testing::NiceMock<MockStream>)
+    {
+        using ::testing::_;
+        using ::testing::Invoke;
+        using ::testing::Return;
+
+        ON_CALL(*m_stream, getEventTarget()).WillByDefault(Return(m_stream));
+        ON_CALL(*m_stream, read(_, _)).WillByDefault(Invoke(
+            [this](void* buffer, std::uint32_t n) {
+                n = std::min(n, static_cast<std::uint32_t>(m_input.size()));
+                std::memcpy(buffer, m_input.data(), n);
+                m_input.erase(0, n);
+                return n;
+            }));
+        ON_CALL(*m_stream, getSize()).WillByDefault(Invoke(
+            [this]() { return static_cast<std::uint32_t>(m_input.size()); }));
+        ON_CALL(*m_stream, write(_, _)).WillByDefault(Invoke(
+            [this](const void* buffer, std::uint32_t n) {
+                m_written.append(static_cast<const char*>(buffer), n);
+            }));
+    }
+
+public:
+    ::testing::NiceMock<MockStream>* m_stream;
+    std::string m_input;
+    std::string m_written;
+};
+
+//! Mock stream test fixture
+/*!
+Runs tests against a mock event queue.  The queue keeps the handlers
+the code under test adopts so the test can deliver events to them with
+dispatch(), received() and flushed().  It records the events added in
+\c m_added and hands out distinct timers, recording them in \c m_timers.
+*/
+class MockStreamFixture : public ::testing::Test {
+public:
+    MockStreamFixture() : m_nextType(Event::kLast), m_nextTimer(0)
+    {
+        using ::testing::_;
+        using ::testing::Invoke;
+        using ::testing::ReturnRef;
+
+        m_clientProxyEvents.setEvents(&m_events);
+        m_clipboardEvents.setEvents(&m_events);
+        m_fileEvents.setEvents(&m_events);
+        m_keyStateEvents.setEvents(&m_events);
+        m_primaryScreenEvents.setEvents(&m_events);
+        m_screenEvents.setEvents(&m_events);
+        m_serverEvents.setEvents(&m_events);
+        m_streamEvents.setEvents(&m_events);
+        ON_CALL(m_events, registerTypeOnce(_, _)).WillByDefault(Invoke(
+            [this](Event::Type& type, const char*) {
+                if (type == Event::kUnknown) {
+                    type = m_nextType++;
+                }
+                return type;
+            }));
+        ON_CALL(m_events, forClientProxy()).WillByDefault(ReturnRef(m_clientProxyEvents));
+        ON_CALL(m_events, forClipboard()).WillByDefault(ReturnRef(m_clipboardEvents));
+        ON_CALL(m_events, forFile()).WillByDefault(ReturnRef(m_fileEvents));
+        ON_CALL(m_events, forIKeyState()).WillByDefault(ReturnRef(m_keyStateEvents));
+        ON_CALL(m_events, forIPrimaryScreen()).WillByDefault(ReturnRef(m_primaryScreenEvents));
+        ON_CALL(m_events, forIScreen()).WillByDefault(ReturnRef(m_screenEvents));
+        ON_CALL(m_events, forServer()).WillByDefault(ReturnRef(m_serverEvents));
+        ON_CALL(m_events, forIStream()).WillByDefault(ReturnRef(m_streamEvents));
+        ON_CALL(m_events, adoptHandler(_, _, _)).WillByDefault(Invoke(
+            [this](Event::Type type, void* target, IEventJob* job) {
+                m_handlers[std::make_pair(type, target)].reset(job);
+            }));
+        ON_CALL(m_events, removeHandler(_, _)).WillByDefault(Invoke(
+            [this](Event::Type type, void* target) {
+                // a handler may remove itself while it runs
+                Handlers::iterator index = m_handlers.find(std::make_pair(type, target));
+                if (index != m_handlers.end()) {
+                    m_removed.push_back(std::move(index->second));
+                    m_handlers.erase(index);
+                }
+            }));
+        ON_CALL(m_events, removeHandlers(_)).WillByDefault(Invoke(
+            [this](void* target) {
+                for (Handlers::iterator index = m_handlers.begin();
+                                        index != m_handlers.end(); ) {
+                    if (index->first.second == target) {
+                        m_removed.push_back(std::move(index->second));
+                        index = m_handlers.erase(index);
+                    }
+                    else {
+                        ++index;
+                    }
+                }
+            }));
+        ON_CALL(m_events, getHandler(_, _)).WillByDefault(Invoke(
+            [this](Event::Type type, void* target) { return getHandler(type, target); }));
+        ON_CALL(m_events, dispatchEvent(_)).WillByDefault(Invoke(
+            [this](const Event& event) { return dispatch(event); }));
+        ON_CALL(m_events, addEvent(_)).WillByDefault(Invoke(
+            [this](const Event& event) { m_added.push_back(event.getType()); }));
+        ON_CALL(m_events, newTimer(_, _)).WillByDefault(Invoke(
+            [this](double, void*) { return newTimer(); }));
+        ON_CALL(m_events, newOneShotTimer(_, _)).WillByDefault(Invoke(
+            [this](double, void*) { return newTimer(); }));
+    }
+
+    // run the handler for \p event as the event queue would.  returns
+    // false if there's no such handler.
+    bool dispatch(const Event& event)
+    {
+        IEventJob* job = getHandler(event.getType(), event.getTarget());
+        if (job == NULL) {
+            job = getHandler(Event::kUnknown, event.getTarget());
+        }
+        if (job == NULL) {
+            return false;
+        }
+        job->run(event);
+        return true;
+    }
+
+    bool dispatch(Event::Type type, void* target, void* data = NULL)
+    {
+        return dispatch(Event(type, target, data, Event::kDontFreeData));
+    }
+
+    IEventJob* getHandler(Event::Type type, void* target) const
+    {
+        Handlers::const_iterator index = m_handlers.find(std::make_pair(type, target));
+        return (index == m_handlers.end()) ? NULL : index->second.get();
+    }
+
+    // the peer on \p connection says \p input
+    void received(MockConnection& connection, const std::string& input)
+    {
+        connection.m_input += input;
+        dispatch(m_streamEvents.inputReady(), connection.m_stream);
+    }
+
+    // \p connection's socket reports everything sent
+    void flushed(MockConnection& connection)
+    {
+        dispatch(m_streamEvents.outputFlushed(), connection.m_stream);
+    }
+
+    template <typename... Args>
+    static std::string encode(const char* fmt, Args... args)
+    {
+        std::vector<std::uint8_t> buffer;
+        ProtocolUtil::encodef(buffer, fmt, args...);
+        return std::string(buffer.begin(), buffer.end());
+    }
+
+private:
+    EventQueueTimer* newTimer()
+    {
+        // timers are opaque so any distinct address will do
+        EventQueueTimer* timer = reinterpret_cast<EventQueueTimer*>(++m_nextTimer);
+        m_timers.push_back(timer);
+        return timer;
+    }
+
+public:
+    typedef std::map<std::pair<Event::Type, void*>, std::unique_ptr<IEventJob>> Handlers;
+
+    Event::Type m_nextType;
+    std::intptr_t m_nextTimer;
+    ::testing::NiceMock<MockEventQueue> m_events;
+    ClientProxyEvents m_clientProxyEvents;
+    ClipboardEvents m_clipboardEvents;
+    FileEvents m_fileEvents;
+    IKeyStateEvents m_keyStateEvents;
+    IPrimaryScreenEvents m_primaryScreenEvents;
+    IScreenEvents m_screenEvents;
+    ServerEvents m_serverEvents;
+    IStreamEvents m_streamEvents;
+    Handlers m_handlers;
+    std::vector<std::unique_ptr<IEventJob>> m_removed;
+    std::vector<Event::Type> m_added;
+    std::vector<EventQueueTimer*> m_timers;
+};
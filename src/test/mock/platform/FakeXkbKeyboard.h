@@ -0,0 +1,223 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "platform/XWindowsImpl.h"
+
+#include <X11/XKBlib.h>
+#include <X11/keysym.h>
+
+#include <cstring>
+#include <initializer_list>
+#include <vector>
+
+//! An XKB keyboard without an X server
+/*!
+Stands in for the X server when XWindowsKeyState builds its key map.
+XkbGetMap() returns a US keyboard with a Cyrillic second group that
+lives in this object, the keyboard control and state queries succeed
+without a display and everything else goes to Xlib as usual.
+*/
+class FakeXkbKeyboard : public XWindowsImpl {
+public:
+    enum EType { kOneLevel, kTwoLevel, kAlphabetic, kNumTypes };
+
+    FakeXkbKeyboard()
+    {
+        std::memset(&m_desc, 0, sizeof(m_desc));
+        std::memset(&m_map, 0, sizeof(m_map));
+        std::memset(&m_server, 0, sizeof(m_server));
+        std::memset(m_types, 0, sizeof(m_types));
+        std::memset(m_typeMaps, 0, sizeof(m_typeMaps));
+        m_symMap.resize(256);
+        m_modmap.resize(256);
+        m_keyActs.resize(256);
+        m_behaviors.resize(256);
+        m_acts.resize(1);
+
+        m_types[kOneLevel].num_levels      = 1;
+        m_types[kTwoLevel].mods.mask       = ShiftMask;
+        m_types[kTwoLevel].num_levels      = 2;
+        m_types[kTwoLevel].map_count       = 1;
+        m_types[kTwoLevel].map             = m_typeMaps;
+        m_types[kAlphabetic].mods.mask     = ShiftMask | LockMask;
+        m_types[kAlphabetic].num_levels    = 2;
+        m_types[kAlphabetic].map_count     = 2;
+        m_types[kAlphabetic].map           = m_typeMaps + 1;
+        m_typeMaps[0].active = m_typeMaps[1].active = m_typeMaps[2].active = True;
+        m_typeMaps[0].level  = m_typeMaps[1].level  = m_typeMaps[2].level  = 1;
+        m_typeMaps[0].mods.mask = m_typeMaps[1].mods.mask = ShiftMask;
+        m_typeMaps[2].mods.mask = LockMask;
+
+        static const char s_digits[]  = "1234567890";
+        static const char s_shifted[] = "!@#$%^&*()";
+        for (int i = 0; i < 10; ++i) {
+            addKey(10 + i, kTwoLevel, { KeySym(s_digits[i]), KeySym(s_shifted[i]) },
+                                      { KeySym(s_digits[i]), KeySym(s_shifted[i]) });
+        }
+        static const struct { KeyCode m_first; const char* m_letters; } s_rows[] = {
+            { 24, "qwertyuiop" }, { 38, "asdfghjkl" }, { 52, "zxcvbnm" }
+        };
+        KeySym cyrillic = XK_Cyrillic_yu;
+        for (const auto& row : s_rows) {
+            for (int i = 0; row.m_letters[i] != '\0'; ++i, ++cyrillic) {
+                KeySym letter = row.m_letters[i];
+                addKey(row.m_first + i, kAlphabetic, { letter, letter - 'a' + 'A' },
+                                                     { cyrillic, cyrillic + 0x20 });
+            }
+        }
+        static const struct { KeyCode m_key; KeySym m_sym, m_shifted; } s_punctuation[] = {
+            { 20, XK_minus, XK_underscore },   { 21, XK_equal, XK_plus },
+            { 34, XK_bracketleft, XK_braceleft }, { 35, XK_bracketright, XK_braceright },
+            { 47, XK_semicolon, XK_colon },    { 48, XK_apostrophe, XK_quotedbl },
+            { 49, XK_grave, XK_asciitilde },   { 51, XK_backslash, XK_bar },
+            { 59, XK_comma, XK_less },         { 60, XK_period, XK_greater },
+            { 61, XK_slash, XK_question }
+        };
+        for (const auto& key : s_punctuation) {
+            addKey(key.m_key, kTwoLevel, { key.m_sym, key.m_shifted });
+        }
+        static const struct { KeyCode m_key; KeySym m_sym; } s_single[] = {
+            { 9, XK_Escape },  { 22, XK_BackSpace }, { 23, XK_Tab },    { 36, XK_Return },
+            { 65, XK_space },  { 95, XK_F11 },       { 96, XK_F12 },    { 110, XK_Home },
+            { 111, XK_Up },    { 112, XK_Prior },    { 113, XK_Left },  { 114, XK_Right },
+            { 115, XK_End },   { 116, XK_Down },     { 117, XK_Next },  { 118, XK_Insert },
+            { 119, XK_Delete }, { 135, XK_Menu },
+            // one level with a case pair gets both cases
+            { 94, XK_eacute }
+        };
+        for (const auto& key : s_single) {
+            addKey(key.m_key, kOneLevel, { key.m_sym });
+        }
+        for (int i = 0; i < 10; ++i) {
+            addKey(67 + i, kOneLevel, { KeySym(XK_F1 + i) });
+        }
+        static const KeyCode s_keypad[] = { 90, 87, 88, 89, 83, 84, 85, 79, 80, 81 };
+        for (int i = 0; i < 10; ++i) {
+            addKey(s_keypad[i], kOneLevel, { KeySym(XK_KP_0 + i) });
+        }
+
+        static const struct { KeyCode m_key; KeySym m_sym; unsigned char m_mask; bool m_lock; } s_modifiers[] = {
+            { 50, XK_Shift_L, ShiftMask, false },   { 62, XK_Shift_R, ShiftMask, false },
+            { 37, XK_Control_L, ControlMask, false }, { 105, XK_Control_R, ControlMask, false },
+            { 64, XK_Alt_L, Mod1Mask, false },      { 108, XK_Alt_R, Mod1Mask, false },
+            { 133, XK_Super_L, Mod4Mask, false },   { 66, XK_Caps_Lock, LockMask, true },
+            { 77, XK_Num_Lock, Mod2Mask, true }
+        };
+        for (const auto& modifier : s_modifiers) {
+            addKey(modifier.m_key, kOneLevel, { modifier.m_sym });
+            m_modmap[modifier.m_key] = modifier.m_mask;
+            XkbAction action;
+            std::memset(&action, 0, sizeof(action));
+            action.mods.type  = modifier.m_lock ? XkbSA_LockMods : XkbSA_SetMods;
+            action.mods.flags = XkbSA_UseModMapMods;
+            addAction(modifier.m_key, action);
+        }
+        // num lock is half-duplex
+        m_behaviors[77].type = XkbKB_Lock;
+
+        // a group switch, which isn't a key to map
+        addKey(203, kOneLevel, { XK_ISO_Next_Group });
+        XkbAction action;
+        std::memset(&action, 0, sizeof(action));
+        action.group.type  = XkbSA_LockGroup;
+        action.group.flags = XkbSA_GroupAbsolute;
+        XkbSASetGroup(&action.group, 1);
+        addAction(203, action);
+
+        m_map.num_types    = kNumTypes;
+        m_map.size_types   = kNumTypes;
+        m_map.types        = m_types;
+        m_map.num_syms     = static_cast<unsigned short>(m_syms.size());
+        m_map.size_syms    = m_map.num_syms;
+        m_map.syms         = m_syms.data();
+        m_map.key_sym_map  = m_symMap.data();
+        m_map.modmap       = m_modmap.data();
+        m_server.num_acts  = static_cast<unsigned short>(m_acts.size());
+        m_server.size_acts = m_server.num_acts;
+        m_server.acts      = m_acts.data();
+        m_server.key_acts  = m_keyActs.data();
+        m_server.behaviors = m_behaviors.data();
+        m_desc.min_key_code = 8;
+        m_desc.max_key_code = 255;
+        m_desc.map          = &m_map;
+        m_desc.server       = &m_server;
+    }
+
+    // XWindowsImpl overrides
+    int XGetKeyboardControl(Display*, XKeyboardState* value_return) override
+    {
+        std::memset(value_return, 0, sizeof(*value_return));
+        return 1;
+    }
+
+    void XkbFreeKeyboard(XkbDescPtr, unsigned int, Bool) override
+    {
+        // the map belongs to us
+    }
+
+    XkbDescPtr XkbGetMap(Display*, unsigned int, unsigned int) override
+    {
+        return &m_desc;
+    }
+
+    Status XkbGetState(Display*, unsigned int, XkbStatePtr rtrnState) override
+    {
+        std::memset(rtrnState, 0, sizeof(*rtrnState));
+        return Success;
+    }
+
+    Status XkbGetUpdatedMap(Display*, unsigned int, XkbDescPtr) override
+    {
+        return Success;
+    }
+
+private:
+    void                addKey(KeyCode key, EType type,
+                            std::initializer_list<KeySym> group0,
+                            std::initializer_list<KeySym> group1 = {})
+    {
+        XkbSymMapRec& symMap = m_symMap[key];
+        int groups = (group1.size() == 0) ? 1 : 2;
+        symMap.kt_index[0] = symMap.kt_index[1] = static_cast<unsigned char>(type);
+        symMap.group_info  = XkbSetNumGroups(0, groups);
+        symMap.width       = static_cast<unsigned char>(group0.size());
+        symMap.offset      = static_cast<unsigned short>(m_syms.size());
+        m_syms.insert(m_syms.end(), group0);
+        m_syms.insert(m_syms.end(), group1);
+    }
+
+    void                addAction(KeyCode key, const XkbAction& action)
+    {
+        m_keyActs[key] = static_cast<unsigned short>(m_acts.size());
+        m_acts.push_back(action);
+    }
+
+private:
+    XkbDescRec            m_desc;
+    XkbClientMapRec        m_map;
+    XkbServerMapRec        m_server;
+    XkbKeyTypeRec        m_types[kNumTypes];
+    XkbKTMapEntryRec    m_typeMaps[3];
+    std::vector<KeySym> m_syms;
+    std::vector<XkbSymMapRec> m_symMap;
+    std::vector<unsigned char> m_modmap;
+    std::vector<XkbAction> m_acts;
+    std::vector<unsigned short> m_keyActs;
+    std::vector<XkbBehavior> m_behaviors;
+};
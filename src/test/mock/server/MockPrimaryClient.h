@@ -36,5 +36,6 @@ public:
     MOCK_METHOD0(disable, void());
     MOCK_METHOD2(registerHotKey, std::uint32_t(KeyID, KeyModifierMask));
     MOCK_CONST_METHOD0(getToggleMask, KeyModifierMask());
+    MOCK_CONST_METHOD2(getClipboard, bool(ClipboardID, IClipboard*));
     MOCK_METHOD1(unregisterHotKey, void(std::uint32_t));
 };
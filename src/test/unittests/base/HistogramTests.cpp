@@ -0,0 +1,81 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "base/Histogram.h"
+
+#include "test/global/gtest.h"
+
+TEST(HistogramTests, getPercentile_empty_zero)
+{
+    Histogram histogram;
+
+    EXPECT_EQ(0u, histogram.getCount());
+    EXPECT_EQ(0u, histogram.getPercentile(50.0));
+    EXPECT_EQ(0u, histogram.getMax());
+}
+
+TEST(HistogramTests, getPercentile_smallValues_exact)
+{
+    Histogram histogram;
+    for (std::uint64_t i = 1; i <= 10; ++i) {
+        histogram.record(i);
+    }
+
+    EXPECT_EQ(10u, histogram.getCount());
+    EXPECT_EQ(55u, histogram.getSum());
+    EXPECT_EQ(5u, histogram.getPercentile(50.0));
+    EXPECT_EQ(10u, histogram.getPercentile(99.0));
+    EXPECT_EQ(10u, histogram.getMax());
+}
+
+TEST(HistogramTests, getPercentile_largeValues_withinBucketError)
+{
+    Histogram histogram;
+    for (std::uint64_t i = 1; i <= 1000; ++i) {
+        histogram.record(i * 1000);
+    }
+
+    std::uint64_t p50 = histogram.getPercentile(50.0);
+    std::uint64_t p99 = histogram.getPercentile(99.0);
+    EXPECT_GE(p50, 500000u);
+    EXPECT_LE(p50, 500000u + 500000u / 16);
+    EXPECT_GE(p99, 990000u);
+    EXPECT_LE(p99, 1000000u);
+    EXPECT_EQ(1000000u, histogram.getMax());
+}
+
+TEST(HistogramTests, getBucketLimit_everyBucket_increasing)
+{
+    for (std::size_t i = 1; i < Histogram::getNumBuckets(); ++i) {
+        ASSERT_LT(Histogram::getBucketLimit(i - 1), Histogram::getBucketLimit(i));
+    }
+    EXPECT_EQ(~std::uint64_t(0),
+                Histogram::getBucketLimit(Histogram::getNumBuckets() - 1));
+}
+
+TEST(HistogramTests, reset_recorded_empty)
+{
+    Histogram histogram;
+    histogram.record(42);
+    histogram.record(~std::uint64_t(0));
+
+    histogram.reset();
+
+    EXPECT_EQ(0u, histogram.getCount());
+    EXPECT_EQ(0u, histogram.getMax());
+    EXPECT_EQ(0u, histogram.getPercentile(100.0));
+}
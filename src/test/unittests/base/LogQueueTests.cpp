@@ -0,0 +1,111 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "base/LogQueue.h"
+
+#include "test/global/gtest.h"
+
+#include <cstring>
+#include <thread>
+#include <vector>
+
+static bool
+pushMessage(LogQueue& queue, const char* message)
+{
+    return queue.push(kINFO, 0, NULL, 0, message, std::strlen(message));
+}
+
+TEST(LogQueueTests, pop_emptyQueue_returnsFalse)
+{
+    LogQueue queue(4);
+    LogQueue::Record record;
+
+    EXPECT_FALSE(queue.pop(record));
+}
+
+TEST(LogQueueTests, pop_pushedRecords_returnsInOrder)
+{
+    LogQueue queue(4);
+    LogQueue::Record record;
+
+    queue.push(kDEBUG, 42, "file.cpp", 7, "first", 5);
+    pushMessage(queue, "second");
+
+    ASSERT_TRUE(queue.pop(record));
+    EXPECT_EQ(kDEBUG, record.m_priority);
+    EXPECT_EQ(42, record.m_time);
+    EXPECT_STREQ("file.cpp", record.m_file);
+    EXPECT_EQ(7, record.m_line);
+    EXPECT_EQ("first", record.m_message);
+    ASSERT_TRUE(queue.pop(record));
+    EXPECT_EQ("second", record.m_message);
+    EXPECT_FALSE(queue.pop(record));
+}
+
+TEST(LogQueueTests, push_fullQueue_dropsAndCounts)
+{
+    LogQueue queue(2);
+    LogQueue::Record record;
+
+    EXPECT_TRUE(pushMessage(queue, "a"));
+    EXPECT_TRUE(pushMessage(queue, "b"));
+    EXPECT_FALSE(pushMessage(queue, "c"));
+    EXPECT_EQ(1u, queue.getDropped());
+
+    // room again after a pop
+    ASSERT_TRUE(queue.pop(record));
+    EXPECT_TRUE(pushMessage(queue, "d"));
+    ASSERT_TRUE(queue.pop(record));
+    EXPECT_EQ("b", record.m_message);
+    ASSERT_TRUE(queue.pop(record));
+    EXPECT_EQ("d", record.m_message);
+}
+
+TEST(LogQueueTests, push_manyThreads_everyRecordPoppedOrDropped)
+{
+    const int kThreads = 4;
+    const int kPerThread = 10000;
+    LogQueue queue(64);
+
+    std::vector<std::thread> producers;
+    for (int t = 0; t < kThreads; ++t) {
+        producers.emplace_back([&queue]() {
+            for (int n = 0; n < kPerThread; ++n) {
+                pushMessage(queue, "message");
+            }
+        });
+    }
+
+    std::uint64_t popped = 0;
+    LogQueue::Record record;
+    auto drain = [&]() {
+        while (queue.pop(record)) {
+            EXPECT_EQ("message", record.m_message);
+            ++popped;
+        }
+    };
+    for (int n = 0; n < 1000; ++n) {
+        drain();
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    drain();
+
+    EXPECT_EQ(static_cast<std::uint64_t>(kThreads * kPerThread),
+                popped + queue.getDropped());
+}
@@ -0,0 +1,117 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "base/Log.h"
+
+#include "test/global/gtest.h"
+
+#include <csignal>
+
+// restores the log filter when a test finishes
+class LogTests : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        for (int i = 0; i < kNumLogCategories; ++i) {
+            m_filter[i] = CLOG->getFilter(static_cast<ELogCategory>(i));
+        }
+    }
+
+    void TearDown() override
+    {
+        for (int i = 0; i < kNumLogCategories; ++i) {
+            CLOG->setFilter(static_cast<ELogCategory>(i), m_filter[i]);
+        }
+    }
+
+private:
+    int m_filter[kNumLogCategories];
+};
+
+TEST_F(LogTests, getPriority_levelFormat_returnsLevel)
+{
+    EXPECT_EQ(kDEBUG2, Log::getPriority(LOG_FORMAT(CLOG_DEBUG2 "message")));
+    EXPECT_EQ(kPRINT, Log::getPriority(LOG_FORMAT(CLOG_PRINT "message")));
+    EXPECT_EQ(kINFO, Log::getPriority("message"));
+}
+
+TEST_F(LogTests, setFilter_levelName_setsEveryCategory)
+{
+    EXPECT_TRUE(CLOG->setFilter("DEBUG1"));
+
+    EXPECT_EQ(kDEBUG1, CLOG->getFilter());
+    EXPECT_EQ(kDEBUG1, CLOG->getFilter(kLogX11));
+    EXPECT_TRUE(Log::isEnabled(kLogNet, kDEBUG1));
+    EXPECT_FALSE(Log::isEnabled(kLogNet, kDEBUG2));
+}
+
+TEST_F(LogTests, setFilter_categoryLevels_setsThoseCategories)
+{
+    EXPECT_TRUE(CLOG->setFilter("WARNING,protocol=DEBUG2,x11=INFO"));
+
+    EXPECT_EQ(kWARNING, CLOG->getFilter());
+    EXPECT_EQ(kDEBUG2, CLOG->getFilter(kLogProtocol));
+    EXPECT_EQ(kINFO, CLOG->getFilter(kLogX11));
+    EXPECT_EQ(kWARNING, CLOG->getFilter(kLogServer));
+    EXPECT_TRUE(Log::isEnabled(kLogProtocol, kDEBUG2));
+    EXPECT_FALSE(Log::isEnabled(kLogServer, kINFO));
+}
+
+TEST_F(LogTests, getMaxFilter_categoryLevels_mostVerbose)
+{
+    EXPECT_TRUE(CLOG->setFilter("INFO,protocol=DEBUG2"));
+
+    EXPECT_EQ(kINFO, CLOG->getFilter());
+    EXPECT_EQ(kDEBUG2, CLOG->getMaxFilter());
+
+    CLOG->setFilter(kWARNING);
+    EXPECT_EQ(kWARNING, CLOG->getMaxFilter());
+}
+
+TEST_F(LogTests, setFilter_unknownCategory_changesNothing)
+{
+    CLOG->setFilter(kINFO);
+
+    EXPECT_FALSE(CLOG->setFilter("DEBUG,keyboard=DEBUG2"));
+    EXPECT_FALSE(CLOG->setFilter("DEBUG,net=LOUD"));
+
+    EXPECT_EQ(kINFO, CLOG->getFilter());
+    EXPECT_EQ(kINFO, CLOG->getFilter(kLogNet));
+}
+
+TEST_F(LogTests, log_filteredMessage_argumentsNotEvaluated)
+{
+    CLOG->setFilter(kINFO);
+    int evaluated = 0;
+
+    LOG((CLOG_DEBUG2 "%d", ++evaluated));
+
+    EXPECT_EQ(0, evaluated);
+}
+
+#if SYSAPI_UNIX
+TEST_F(LogTests, setAsync_fatalSignal_queueWritten)
+{
+    EXPECT_DEATH({
+        CLOG->setAsync(true);
+        for (int i = 0; i < 1000; ++i) {
+            LOG((CLOG_WARN "queued %d", i));
+        }
+        raise(SIGSEGV);
+    }, "queued 999");
+}
+#endif
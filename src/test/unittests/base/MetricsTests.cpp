@@ -0,0 +1,74 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "base/Metrics.h"
+
+#include "test/global/gtest.h"
+
+TEST(MetricsTests, getCounter_sameNameAndLabels_sameCounter)
+{
+    Metrics metrics;
+
+    MetricCounter& a = metrics.getCounter("test_total", "help", "peer=\"a\"");
+    MetricCounter& b = metrics.getCounter("test_total", "help", "peer=\"b\"");
+    a.add(3);
+
+    EXPECT_EQ(&a, &metrics.getCounter("test_total", "help", "peer=\"a\""));
+    EXPECT_NE(&a, &b);
+    EXPECT_EQ(3u, a.get());
+    EXPECT_EQ(0u, b.get());
+}
+
+TEST(MetricsTests, format_counterAndGauge_prometheusText)
+{
+    Metrics metrics;
+    metrics.getCounter("test_total", "A counter.", Metrics::label("peer", "a")).add(7);
+    metrics.getGauge("test_depth", "A gauge.").set(-2);
+
+    EXPECT_EQ("# HELP test_depth A gauge.\n"
+              "# TYPE test_depth gauge\n"
+              "test_depth -2\n"
+              "# HELP test_total A counter.\n"
+              "# TYPE test_total counter\n"
+              "test_total{peer=\"a\"} 7\n",
+              metrics.format());
+}
+
+TEST(MetricsTests, format_histogram_cumulativeBuckets)
+{
+    Metrics metrics;
+    Histogram& histogram = metrics.getHistogram("test_seconds", "A histogram.", 1.0e-6);
+    histogram.record(1);
+    histogram.record(3);
+    histogram.record(1000);
+
+    std::string text = metrics.format();
+
+    EXPECT_NE(std::string::npos, text.find("# TYPE test_seconds histogram\n"));
+    EXPECT_NE(std::string::npos, text.find("test_seconds_bucket{le=\"1e-06\"} 0\n"));
+    EXPECT_NE(std::string::npos, text.find("test_seconds_bucket{le=\"2e-06\"} 1\n"));
+    EXPECT_NE(std::string::npos, text.find("test_seconds_bucket{le=\"4e-06\"} 2\n"));
+    EXPECT_NE(std::string::npos, text.find("test_seconds_bucket{le=\"0.001024\"} 3\n"));
+    EXPECT_NE(std::string::npos, text.find("test_seconds_bucket{le=\"+Inf\"} 3\n"));
+    EXPECT_NE(std::string::npos, text.find("test_seconds_sum 0.001004\n"));
+    EXPECT_NE(std::string::npos, text.find("test_seconds_count 3\n"));
+}
+
+TEST(MetricsTests, label_specialCharacters_escaped)
+{
+    EXPECT_EQ("peer=\"a\\\"b\\\\c\\nd\"", Metrics::label("peer", "a\"b\\c\nd"));
+}
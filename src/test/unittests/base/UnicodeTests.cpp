@@ -0,0 +1,104 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "base/Unicode.h"
+
+#include "test/global/gtest.h"
+
+namespace {
+
+// UTF-16 in native byte order
+std::string utf16(const std::u16string& src)
+{
+    return std::string(reinterpret_cast<const char*>(src.data()), 2 * src.size());
+}
+
+// UCS-4 in native byte order
+std::string ucs4(const std::u32string& src)
+{
+    return std::string(reinterpret_cast<const char*>(src.data()), 4 * src.size());
+}
+
+} // namespace
+
+TEST(UnicodeTests, UTF8ToUTF16_longAsciiWithTail_widened)
+{
+    // long enough for block copies plus a tail
+    std::string text = "The quick brown fox jumps over the lazy dog. 0123456789";
+    std::u16string expected(text.begin(), text.end());
+    bool errors = true;
+
+    EXPECT_EQ(utf16(expected), Unicode::UTF8ToUTF16(text, &errors));
+    EXPECT_FALSE(errors);
+}
+
+TEST(UnicodeTests, UTF8ToUCS4_mixedText_convertsEachRun)
+{
+    std::string text = "abcdefghijklmnopqrstu\xc3\xa9vwxyz\xe6\x97\xa5\xe6\x9c\xac" "0123456789abcdefg";
+    std::u32string expected = U"abcdefghijklmnopqrstuévwxyz日本0123456789abcdefg";
+
+    EXPECT_EQ(ucs4(expected), Unicode::UTF8ToUCS4(text));
+}
+
+TEST(UnicodeTests, UTF8ToUTF16_invalidAfterAscii_replaced)
+{
+    std::string text = "0123456789abcdefghij\xff" "klmnopqrstuvwxyz";
+    std::u16string expected = u"0123456789abcdefghij�klmnopqrstuvwxyz";
+
+    EXPECT_EQ(utf16(expected), Unicode::UTF8ToUTF16(text));
+    EXPECT_FALSE(Unicode::isUTF8(text));
+    EXPECT_TRUE(Unicode::isUTF8("0123456789abcdefghij\xc3\xa9klmnopqrstuvwxyz"));
+}
+
+TEST(UnicodeTests, UTF16ToUTF8_roundTrip_sameText)
+{
+    std::string text = "0123456789abcdefghijklmnopqrstuvwxyz\xc3\xa9\xe6\x97\xa5"
+                       "\xf0\x9f\x98\x80 ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    bool errors = true;
+
+    EXPECT_EQ(text, Unicode::UTF16ToUTF8(Unicode::UTF8ToUTF16(text), &errors));
+    EXPECT_FALSE(errors);
+}
+
+TEST(UnicodeTests, UTF16ToUTF8_byteSwapped_narrowed)
+{
+    std::string text = "0123456789abcdefghijklmnopqrstuvwxyz";
+    std::string swapped = utf16(u"\ufffe");
+    for (char c : text) {
+        swapped.push_back('\0');
+        swapped.push_back(c);
+    }
+
+    EXPECT_EQ(text, Unicode::UTF16ToUTF8(swapped));
+}
+
+TEST(UnicodeTests, UTF16ToUTF8_unpairedSurrogate_replaced)
+{
+    bool errors = false;
+
+    std::string result = Unicode::UTF16ToUTF8(utf16(u"ab\xd800" u"cd"), &errors);
+
+    EXPECT_EQ("ab\xef\xbf\xbd" "cd", result);
+    EXPECT_TRUE(errors);
+}
+
+TEST(UnicodeTests, UCS4ToUTF8_roundTrip_sameText)
+{
+    std::string text = "0123456789abcdefghijklmnopqrstuvwxyz\xc3\xa9 ABCDEFGH";
+
+    EXPECT_EQ(text, Unicode::UCS4ToUTF8(Unicode::UTF8ToUCS4(text)));
+}
@@ -278,6 +278,54 @@ TEST(GenericArgsParsingTests, parseGenericArgs_ipcCmd_enableIpcTrue)
     EXPECT_EQ(1, i);
 }
 
+TEST(GenericArgsParsingTests, parseGenericArgs_asyncLogCmd_asyncLogTrue)
+{
+    int i = 1;
+    const int argc = 2;
+    const char* kAsyncLogCmd[argc] = { "stub", "--async-log" };
+
+    ArgParser argParser(NULL);
+    ArgsBase argsBase;
+    argParser.setArgsBase(argsBase);
+
+    argParser.parseGenericArgs(argc, kAsyncLogCmd, i);
+
+    EXPECT_EQ(true, argsBase.m_asyncLog);
+    EXPECT_EQ(1, i);
+}
+
+TEST(GenericArgsParsingTests, parseGenericArgs_traceLatencyCmd_traceLatencyTrue)
+{
+    int i = 1;
+    const int argc = 2;
+    const char* kTraceLatencyCmd[argc] = { "stub", "--trace-latency" };
+
+    ArgParser argParser(NULL);
+    ArgsBase argsBase;
+    argParser.setArgsBase(argsBase);
+
+    argParser.parseGenericArgs(argc, kTraceLatencyCmd, i);
+
+    EXPECT_EQ(true, argsBase.m_traceLatency);
+    EXPECT_EQ(1, i);
+}
+
+TEST(GenericArgsParsingTests, parseGenericArgs_metricsPortCmd_metricsPortSet)
+{
+    int i = 1;
+    const int argc = 3;
+    const char* kMetricsPortCmd[argc] = { "stub", "--metrics-port", "9184" };
+
+    ArgParser argParser(NULL);
+    ArgsBase argsBase;
+    argParser.setArgsBase(argsBase);
+
+    argParser.parseGenericArgs(argc, kMetricsPortCmd, i);
+
+    EXPECT_EQ(9184, argsBase.m_metricsPort);
+    EXPECT_EQ(2, i);
+}
+
 #ifndef  WINAPI_XWINDOWS
 TEST(GenericArgsParsingTests, parseGenericArgs_dragDropCmdOnNonLinux_enableDragDropTrue)
 {
@@ -313,3 +361,23 @@ TEST(GenericArgsParsingTests, parseGenericArgs_dragDropCmdOnLinux_enableDragDrop
     EXPECT_EQ(1, i);
 }
 #endif
+
+TEST(GenericArgsParsingTests, parseGenericArgs_virtualScreenCmd_saveShape)
+{
+    int i = 1;
+    const int argc = 3;
+    const char* kVirtualScreenCmd[argc] = { "stub", "--virtual-screen", "1280x720+100+50" };
+
+    ArgParser argParser(NULL);
+    ArgsBase argsBase;
+    argParser.setArgsBase(argsBase);
+
+    argParser.parseGenericArgs(argc, kVirtualScreenCmd, i);
+
+    EXPECT_TRUE(argsBase.m_virtualScreen);
+    EXPECT_EQ(100, argsBase.m_virtualX);
+    EXPECT_EQ(50, argsBase.m_virtualY);
+    EXPECT_EQ(1280, argsBase.m_virtualWidth);
+    EXPECT_EQ(720, argsBase.m_virtualHeight);
+    EXPECT_EQ(2, i);
+}
@@ -0,0 +1,130 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "inputleap/InputTraceReader.h"
+#include "inputleap/InputTraceWriter.h"
+#include "inputleap/IPlatformScreen.h"
+#include "base/EventQueue.h"
+
+#include "test/global/gtest.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+const char* const kTracePath = "InputTraceTests.trace";
+
+void
+recordAndFree(InputTraceWriter& writer, IEventQueue& events, const Event& event)
+{
+    writer.recordEvent(&events, event);
+    Event::deleteData(event);
+}
+
+std::string
+readFile(const char* path)
+{
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    std::ostringstream data;
+    data << file.rdbuf();
+    return data.str();
+}
+
+} // namespace
+
+TEST(InputTraceTests, getInstance_opened_isThis)
+{
+    EXPECT_EQ(NULL, InputTraceWriter::getInstance());
+    {
+        InputTraceWriter writer;
+        EXPECT_EQ(&writer, InputTraceWriter::getInstance());
+    }
+    EXPECT_EQ(NULL, InputTraceWriter::getInstance());
+}
+
+TEST(InputTraceTests, recordEvent_inputAndSwitch_readBack)
+{
+    EventQueue events;
+    {
+        InputTraceWriter writer;
+        ASSERT_TRUE(writer.open(kTracePath));
+        recordAndFree(writer, events, Event(events.forIPrimaryScreen().motionOnPrimary(),
+                            NULL, IPlatformScreen::MotionInfo::alloc(10, -20)));
+        recordAndFree(writer, events, Event(events.forIKeyState().keyRepeat(),
+                            NULL, IPlatformScreen::KeyInfo::alloc('a', KeyModifierShift, 38, 3)));
+        recordAndFree(writer, events, Event(events.forIPrimaryScreen().hotKeyDown(),
+                            NULL, IPlatformScreen::HotKeyInfo::alloc(7)));
+        writer.recordEvent(&events, Event(Event::kTimer));
+        writer.recordSwitch("laptop", 0, 5);
+    }
+
+    InputTraceReader reader;
+    std::string error;
+    ASSERT_TRUE(reader.load(kTracePath, error)) << error;
+    std::remove(kTracePath);
+
+    const InputTraceReader::RecordList& records = reader.getRecords();
+    ASSERT_EQ(4u, records.size());
+    EXPECT_EQ(InputTrace::kMotionPrimary, records[0].m_type);
+    EXPECT_EQ(10, records[0].m_x);
+    EXPECT_EQ(-20, records[0].m_y);
+    EXPECT_EQ(InputTrace::kKeyRepeat, records[1].m_type);
+    EXPECT_EQ(static_cast<KeyID>('a'), records[1].m_key);
+    EXPECT_EQ(KeyModifierShift, records[1].m_mask);
+    EXPECT_EQ(38, records[1].m_button);
+    EXPECT_EQ(3, records[1].m_count);
+    EXPECT_EQ(InputTrace::kHotKeyDown, records[2].m_type);
+    EXPECT_EQ(7u, records[2].m_id);
+    EXPECT_EQ(InputTrace::kSwitch, records[3].m_type);
+    EXPECT_EQ("laptop", records[3].m_screen);
+    EXPECT_EQ(5, records[3].m_y);
+    EXPECT_LE(records[0].m_time, records[1].m_time);
+    EXPECT_LE(records[2].m_time, records[3].m_time);
+}
+
+TEST(InputTraceTests, parse_truncated_keepsWholeRecords)
+{
+    EventQueue events;
+    {
+        InputTraceWriter writer;
+        ASSERT_TRUE(writer.open(kTracePath));
+        recordAndFree(writer, events, Event(events.forIPrimaryScreen().wheel(),
+                            NULL, IPlatformScreen::WheelInfo::alloc(0, 120)));
+        recordAndFree(writer, events, Event(events.forIPrimaryScreen().wheel(),
+                            NULL, IPlatformScreen::WheelInfo::alloc(0, -120)));
+    }
+    std::string data = readFile(kTracePath);
+    std::remove(kTracePath);
+
+    InputTraceReader reader;
+    std::string error;
+    ASSERT_TRUE(reader.parse(data.substr(0, data.size() - 1), error)) << error;
+
+    ASSERT_EQ(1u, reader.getRecords().size());
+    EXPECT_EQ(120, reader.getRecords()[0].m_y);
+}
+
+TEST(InputTraceTests, parse_notATrace_fails)
+{
+    InputTraceReader reader;
+    std::string error;
+
+    EXPECT_FALSE(reader.parse("move 1 2\n", error));
+    EXPECT_EQ("not an input trace", error);
+}
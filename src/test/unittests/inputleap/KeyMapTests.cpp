@@ -215,4 +215,113 @@ TEST(KeyMapTests, isCommand_superMask_returnTrue)
     EXPECT_EQ(true, keyMap.isCommand(mask));
 }
 
+namespace {
+
+// 'a' and 'A' on one button plus a left and right shift
+void addShiftLayout(KeyMap& keyMap, KeyButton letterButton)
+{
+    KeyMap::KeyItem item;
+    item.m_group     = 0;
+    item.m_generates = 0;
+    item.m_dead      = false;
+    item.m_lock      = false;
+    item.m_client    = 0;
+
+    item.m_button    = letterButton;
+    item.m_sensitive = KeyModifierShift;
+    item.m_id        = 'a';
+    item.m_required  = 0;
+    keyMap.addKeyEntry(item);
+    item.m_id        = 'A';
+    item.m_required  = KeyModifierShift;
+    keyMap.addKeyEntry(item);
+
+    item.m_required  = 0;
+    item.m_sensitive = 0;
+    item.m_generates = KeyModifierShift;
+    item.m_button    = 50;
+    item.m_id        = kKeyShift_L;
+    keyMap.addKeyEntry(item);
+    item.m_button    = 51;
+    item.m_id        = kKeyShift_R;
+    keyMap.addKeyEntry(item);
+
+    keyMap.finish();
+}
+
+std::vector<KeyButton> getButtons(const KeyMap::Keystrokes& keys)
+{
+    std::vector<KeyButton> buttons;
+    for (const KeyMap::Keystroke& key : keys) {
+        buttons.push_back(key.m_data.m_button.m_button);
+    }
+    return buttons;
+}
+
+} // namespace
+
+TEST(KeyMapTests, mapKey_sameKeyTwice_sameKeystrokes)
+{
+    KeyMap keyMap;
+    addShiftLayout(keyMap, 10);
+
+    std::vector<KeyButton> expected = { 50, 10, 50 };
+    for (int i = 0; i < 2; ++i) {
+        KeyMap::Keystrokes keys;
+        KeyMap::ModifierToKeys activeModifiers;
+        KeyModifierMask currentState = 0;
+        const KeyMap::KeyItem* item = keyMap.mapKey(keys, 'A', 0, activeModifiers,
+                                                    currentState, 0, false);
+
+        ASSERT_TRUE(item != NULL);
+        EXPECT_EQ(10, item->m_button);
+        EXPECT_EQ(expected, getButtons(keys));
+        EXPECT_EQ(0u, currentState);
+        EXPECT_TRUE(activeModifiers.empty());
+    }
+}
+
+TEST(KeyMapTests, mapKey_otherShiftDown_releasesThatShift)
+{
+    KeyMap keyMap;
+    addShiftLayout(keyMap, 10);
+
+    for (KeyID id : { kKeyShift_L, kKeyShift_R }) {
+        KeyMap::Keystrokes keys;
+        KeyMap::ModifierToKeys activeModifiers;
+        KeyModifierMask currentState = 0;
+        keyMap.mapKey(keys, id, 0, activeModifiers, currentState, 0, false);
+        KeyButton shift = keys.back().m_data.m_button.m_button;
+
+        keys.clear();
+        keyMap.mapKey(keys, 'a', 0, activeModifiers, currentState, 0, false);
+
+        std::vector<KeyButton> expected = { shift, 10, shift };
+        EXPECT_EQ(expected, getButtons(keys));
+        EXPECT_EQ(KeyModifierShift, currentState);
+    }
+}
+
+TEST(KeyMapTests, mapKey_mapReplaced_usesNewMap)
+{
+    KeyMap keyMap;
+    addShiftLayout(keyMap, 10);
+    KeyMap::Keystrokes keys;
+    KeyMap::ModifierToKeys activeModifiers;
+    KeyModifierMask currentState = 0;
+    keyMap.mapKey(keys, 'a', 0, activeModifiers, currentState, 0, false);
+
+    KeyMap newMap;
+    addShiftLayout(newMap, 20);
+    keyMap.swap(newMap);
+    keyMap.finish();
+    keys.clear();
+    const KeyMap::KeyItem* item = keyMap.mapKey(keys, 'a', 0, activeModifiers,
+                                                currentState, 0, false);
+
+    ASSERT_TRUE(item != NULL);
+    EXPECT_EQ(20, item->m_button);
+    EXPECT_EQ(std::vector<KeyButton>{ 20 }, getButtons(keys));
+}
+
 }
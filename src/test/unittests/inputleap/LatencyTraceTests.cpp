@@ -0,0 +1,117 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "inputleap/LatencyTrace.h"
+#include "base/Metrics.h"
+
+#include "test/global/gtest.h"
+
+TEST(LatencyTraceTests, getInstance_constructed_isThis)
+{
+    EXPECT_EQ(NULL, LatencyTrace::getInstance());
+    {
+        LatencyTrace trace;
+        EXPECT_EQ(&trace, LatencyTrace::getInstance());
+    }
+    EXPECT_EQ(NULL, LatencyTrace::getInstance());
+}
+
+TEST(LatencyTraceTests, sending_notDispatched_false)
+{
+    LatencyTrace trace;
+    std::uint32_t id, serverMicros;
+
+    trace.captured();
+
+    EXPECT_FALSE(trace.sending(id, serverMicros));
+}
+
+TEST(LatencyTraceTests, sending_capturedAndDispatched_newTrace)
+{
+    LatencyTrace trace;
+    std::uint32_t id = 0, serverMicros;
+
+    trace.captured();
+    trace.dispatched();
+
+    EXPECT_TRUE(trace.sending(id, serverMicros));
+    EXPECT_NE(0u, id);
+    EXPECT_EQ(1u, trace.getHistogram(LatencyTrace::kQueued).getCount());
+    EXPECT_EQ(1u, trace.getHistogram(LatencyTrace::kServer).getCount());
+
+    // the next event isn't traced
+    EXPECT_FALSE(trace.sending(id, serverMicros));
+}
+
+TEST(LatencyTraceTests, captured_tooSoon_noTrace)
+{
+    LatencyTrace trace(60.0);
+    std::uint32_t id, serverMicros;
+    trace.captured();
+    trace.dispatched();
+    trace.sending(id, serverMicros);
+
+    trace.captured();
+    trace.dispatched();
+
+    EXPECT_FALSE(trace.sending(id, serverMicros));
+}
+
+TEST(LatencyTraceTests, acknowledged_inFlight_recordsClientAndTotal)
+{
+    LatencyTrace trace;
+    std::uint32_t id, serverMicros;
+    trace.captured();
+    trace.dispatched();
+    trace.sending(id, serverMicros);
+
+    trace.acknowledged(id, 1500);
+
+    EXPECT_EQ(1u, trace.getHistogram(LatencyTrace::kNetwork).getCount());
+    EXPECT_EQ(1500u, trace.getHistogram(LatencyTrace::kClient).getMax());
+    EXPECT_LE(1500u, trace.getHistogram(LatencyTrace::kTotal).getMax());
+
+    // a second ack for the same trace is ignored
+    trace.acknowledged(id, 1500);
+    EXPECT_EQ(1u, trace.getHistogram(LatencyTrace::kClient).getCount());
+}
+
+TEST(LatencyTraceTests, report_recorded_clears)
+{
+    LatencyTrace trace;
+    trace.injected(250);
+
+    trace.report();
+
+    EXPECT_EQ(0u, trace.getHistogram(LatencyTrace::kClient).getCount());
+}
+
+TEST(LatencyTraceTests, report_recorded_keepsMetric)
+{
+    Histogram& metric = Metrics::getInstance().getHistogram(
+                            "inputleap_latency_seconds", "", 1.0e-6,
+                            Metrics::label("stage", "client"));
+    std::uint64_t count = metric.getCount();
+    LatencyTrace trace;
+    trace.injected(250);
+
+    trace.report();
+
+    EXPECT_EQ(count + 1, metric.getCount());
+    EXPECT_NE(std::string::npos, Metrics::getInstance().format().find(
+                            "inputleap_latency_seconds_count{stage=\"client\"}"));
+}
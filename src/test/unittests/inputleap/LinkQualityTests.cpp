@@ -0,0 +1,106 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "inputleap/LinkQuality.h"
+
+#include "test/global/gtest.h"
+
+TEST(LinkQualityTests, received_firstPong_setsEstimates)
+{
+    LinkQuality link(3.0);
+
+    std::uint32_t id = link.sending(10.0);
+
+    EXPECT_NE(0u, id);
+    EXPECT_TRUE(link.received(id, 10.02, 1010000));
+    EXPECT_EQ(1u, link.getSamples());
+    EXPECT_NEAR(0.02, link.getRTT(), 1.0e-9);
+    EXPECT_NEAR(0.01, link.getRTTVariation(), 1.0e-9);
+    EXPECT_NEAR(1.0, link.getClockOffset(), 1.0e-9);
+}
+
+TEST(LinkQualityTests, received_wrongID_ignored)
+{
+    LinkQuality link(3.0);
+
+    std::uint32_t id = link.sending(10.0);
+
+    EXPECT_FALSE(link.received(id + 1, 10.02, 0));
+    EXPECT_FALSE(link.received(0, 10.02, 0));
+    EXPECT_EQ(0u, link.getSamples());
+
+    // only the first pong counts
+    EXPECT_TRUE(link.received(id, 10.02, 0));
+    EXPECT_FALSE(link.received(id, 10.03, 0));
+    EXPECT_EQ(1u, link.getSamples());
+}
+
+TEST(LinkQualityTests, received_steadyLink_converges)
+{
+    LinkQuality link(3.0);
+
+    double now = 0.0;
+    for (int i = 0; i < 50; ++i) {
+        std::uint32_t id = link.sending(now);
+        link.received(id, now + 0.004, -2000);
+        now += 3.0;
+    }
+
+    EXPECT_NEAR(0.004, link.getRTT(), 1.0e-9);
+    EXPECT_NEAR(0.0, link.getRTTVariation(), 1.0e-5);
+    EXPECT_NEAR(-0.004, link.getClockOffset(), 1.0e-9);
+    EXPECT_DOUBLE_EQ(3.0, link.getKeepAliveRate());
+}
+
+TEST(LinkQualityTests, getKeepAliveRate_slowLink_lengthened)
+{
+    LinkQuality link(3.0);
+
+    std::uint32_t id = link.sending(0.0);
+    link.received(id, 1.0, 0);
+
+    // 4 * (1s + 4 * 0.5s), capped at four times the base rate
+    EXPECT_DOUBLE_EQ(12.0, link.getKeepAliveRate());
+}
+
+TEST(LinkQualityTests, sending_unanswered_countsLostAndBacksOff)
+{
+    LinkQuality link(3.0);
+
+    link.sending(0.0);
+    link.sending(3.0);
+    EXPECT_EQ(1u, link.getLost());
+    EXPECT_DOUBLE_EQ(6.0, link.getKeepAliveRate());
+
+    std::uint32_t id = link.sending(9.0);
+    EXPECT_EQ(2u, link.getLost());
+    EXPECT_DOUBLE_EQ(12.0, link.getKeepAliveRate());
+
+    // an answer ends the back off
+    link.received(id, 9.001, 0);
+    EXPECT_DOUBLE_EQ(3.0, link.getKeepAliveRate());
+}
+
+TEST(LinkQualityTests, getKeepAliveRate_disabled_unchanged)
+{
+    LinkQuality link(-1.0);
+
+    link.sending(0.0);
+    link.sending(3.0);
+
+    EXPECT_DOUBLE_EQ(-1.0, link.getKeepAliveRate());
+}
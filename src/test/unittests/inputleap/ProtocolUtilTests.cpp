@@ -0,0 +1,71 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "inputleap/ProtocolUtil.h"
+#include "inputleap/protocol_types.h"
+#include "test/mock/io/MockStream.h"
+
+#include "test/global/gtest.h"
+
+using ::testing::_;
+using ::testing::Invoke;
+
+namespace {
+
+// collects everything written to a mock stream
+void
+expectWrites(MockStream& stream, std::string& written)
+{
+    EXPECT_CALL(stream, write(_, _)).WillRepeatedly(Invoke(
+        [&written](const void* buffer, std::uint32_t n) {
+            written.append(static_cast<const char*>(buffer), n);
+        }));
+}
+
+} // namespace
+
+TEST(ProtocolUtilTests, encodef_keyDown_sameAsWritef)
+{
+    MockStream stream;
+    std::string written;
+    expectWrites(stream, written);
+    std::vector<std::uint8_t> buffer;
+
+    ProtocolUtil::encodef(buffer, kMsgDKeyDown, 0x61, 0x0001, 38);
+    ProtocolUtil::writef(&stream, kMsgDKeyDown, 0x61, 0x0001, 38);
+
+    EXPECT_EQ(std::string("DKDN\x00\x61\x00\x01\x00\x26", 10),
+              std::string(buffer.begin(), buffer.end()));
+    EXPECT_EQ(std::string(buffer.begin(), buffer.end()), written);
+}
+
+TEST(ProtocolUtilTests, write_encodedTwice_writtenTwice)
+{
+    MockStream stream;
+    std::string written;
+    expectWrites(stream, written);
+    std::vector<std::uint8_t> buffer(100, 'x');
+
+    // encoding replaces what was in the buffer
+    ProtocolUtil::encodef(buffer, kMsgDKeyUp, 0x61, 0x0001, 38);
+    ProtocolUtil::write(&stream, buffer);
+    ProtocolUtil::write(&stream, buffer);
+
+    EXPECT_EQ(10u, buffer.size());
+    EXPECT_EQ(std::string("DKUP\x00\x61\x00\x01\x00\x26" "DKUP\x00\x61\x00\x01\x00\x26", 20),
+              written);
+}
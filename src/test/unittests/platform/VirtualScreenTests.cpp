@@ -0,0 +1,161 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "platform/VirtualScreen.h"
+#include "base/EventQueue.h"
+#include "base/IEventJob.h"
+#include "test/mock/inputleap/MockEventQueue.h"
+
+#include "test/global/gtest.h"
+#include "test/global/gmock.h"
+
+#include <memory>
+#include <sstream>
+#include <vector>
+
+using ::testing::_;
+using ::testing::AnyNumber;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+using ::testing::ReturnRef;
+
+namespace {
+
+VirtualInputScript
+parseScript(const std::string& text)
+{
+    std::istringstream input(text);
+    std::string error;
+    VirtualInputScript script;
+    EXPECT_TRUE(script.parse(input, error)) << error;
+    return script;
+}
+
+} // namespace
+
+TEST(VirtualInputScriptTests, parse_keyAndClick_pressAndRelease)
+{
+    VirtualInputScript script = parseScript(
+        "# comment\n"
+        "\n"
+        "key Control+a\n"
+        "click 3\n"
+        "clipboard hello world\n");
+
+    const VirtualInputScript::StepList& steps = script.getSteps();
+    ASSERT_EQ(5u, steps.size());
+    EXPECT_EQ(VirtualInputScript::kKeyDown, steps[0].m_type);
+    EXPECT_EQ(static_cast<KeyID>('a'), steps[0].m_key);
+    EXPECT_EQ(KeyModifierControl, steps[0].m_mask);
+    EXPECT_EQ(VirtualInputScript::kKeyUp, steps[1].m_type);
+    EXPECT_EQ(VirtualInputScript::kButtonDown, steps[2].m_type);
+    EXPECT_EQ(kButtonRight, steps[2].m_button);
+    EXPECT_EQ(VirtualInputScript::kButtonUp, steps[3].m_type);
+    EXPECT_EQ("hello world", steps[4].m_text);
+}
+
+TEST(VirtualInputScriptTests, parse_badLine_reportsLineAndKeepsNothing)
+{
+    std::istringstream input("move 1 2\nmove 1\n");
+    std::string error;
+    VirtualInputScript script;
+
+    EXPECT_FALSE(script.parse(input, error));
+    EXPECT_EQ("line 2: move needs two numbers", error);
+    EXPECT_TRUE(script.getSteps().empty());
+}
+
+TEST(VirtualScreenTests, fakeInput_secondary_recorded)
+{
+    EventQueue events;
+    std::ostringstream recorder;
+    VirtualScreen screen(&events, false, 0, 0, 800, 600);
+    screen.setRecorder(&recorder);
+
+    screen.enter();
+    screen.fakeMouseMove(10, 20);
+    screen.fakeMouseButton(kButtonLeft, true);
+    screen.fakeMouseButton(kButtonLeft, false);
+    screen.fakeKeyDown('a', KeyModifierShift, 38);
+    std::uint32_t button;
+    EXPECT_FALSE(screen.isAnyMouseButtonDown(button));
+    EXPECT_TRUE(screen.isKeyDown(38));
+    EXPECT_TRUE(screen.fakeKeyUp(38));
+    EXPECT_FALSE(screen.fakeKeyUp(38));
+
+    EXPECT_EQ("enter\n"
+              "move 10 20\n"
+              "buttondown 1\n"
+              "buttonup 1\n"
+              "keydown Shift+a\n"
+              "keyup Shift+a\n", recorder.str());
+    std::int32_t x, y;
+    screen.getCursorPos(x, y);
+    EXPECT_EQ(10, x);
+    EXPECT_EQ(20, y);
+}
+
+TEST(VirtualScreenTests, enable_primaryWithScript_oneStepPerTimer)
+{
+    NiceMock<MockEventQueue> eventQueue;
+    IPrimaryScreenEvents primaryScreenEvents;
+    primaryScreenEvents.setEvents(&eventQueue);
+    Event::Type nextType = Event::kLast;
+    ON_CALL(eventQueue, registerTypeOnce(_, _)).WillByDefault(Invoke(
+        [&nextType](Event::Type& type, const char*) {
+            if (type == Event::kUnknown) {
+                type = nextType++;
+            }
+            return type;
+        }));
+    ON_CALL(eventQueue, forIPrimaryScreen()).WillByDefault(ReturnRef(primaryScreenEvents));
+    std::vector<Event> added;
+    ON_CALL(eventQueue, addEvent(_)).WillByDefault(Invoke(
+        [&added](const Event& event) { added.push_back(event); }));
+    std::vector<std::unique_ptr<IEventJob>> timerJobs;
+    ON_CALL(eventQueue, adoptHandler(Event::kTimer, _, _)).WillByDefault(Invoke(
+        [&timerJobs](Event::Type, void*, IEventJob* job) { timerJobs.emplace_back(job); }));
+    EXPECT_CALL(eventQueue, newOneShotTimer(_, _)).Times(AnyNumber());
+    EXPECT_CALL(eventQueue, newOneShotTimer(60.0, _)).Times(1);
+
+    VirtualScreen screen(&eventQueue, true, 0, 0, 800, 600);
+    screen.setScript(parseScript(
+        "move 5000 10\n"
+        "click 1\n"
+        "wait 60\n"
+        "move 1 1\n"));
+    screen.enable();
+
+    ASSERT_EQ(1u, added.size());
+    EXPECT_EQ(primaryScreenEvents.motionOnPrimary(), added[0].getType());
+    IPrimaryScreen::MotionInfo* motion =
+        static_cast<IPrimaryScreen::MotionInfo*>(added[0].getData());
+    EXPECT_EQ(799, motion->m_x);
+    EXPECT_EQ(10, motion->m_y);
+
+    // fire the timers up to the wait
+    for (std::size_t i = 0; i < 3; ++i) {
+        ASSERT_EQ(i + 1, timerJobs.size());
+        timerJobs.back()->run(Event(Event::kTimer));
+    }
+    ASSERT_EQ(3u, added.size());
+    EXPECT_EQ(primaryScreenEvents.buttonDown(), added[1].getType());
+    EXPECT_EQ(primaryScreenEvents.buttonUp(), added[2].getType());
+    for (const Event& event : added) {
+        Event::deleteData(event);
+    }
+}
@@ -0,0 +1,116 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+
+#if HAVE_XKB_EXTENSION
+
+// gtest goes first since X11 defines macros like None
+#include "test/global/gtest.h"
+
+#include "test/mock/platform/FakeXkbKeyboard.h"
+#include "platform/XWindowsKeyState.h"
+
+namespace {
+
+class MappedKey {
+public:
+    KeyID                m_id;
+    std::int32_t        m_group;
+    inputleap::KeyMap::KeyItem m_item;
+};
+
+std::vector<MappedKey>
+getMappedKeys(inputleap::KeyMap& keyMap)
+{
+    std::vector<MappedKey> keys;
+    keyMap.foreachKey([](KeyID id, std::int32_t group, inputleap::KeyMap::KeyItem& item,
+                         void* vkeys) {
+        static_cast<std::vector<MappedKey>*>(vkeys)->push_back(MappedKey{ id, group, item });
+    }, &keys);
+    return keys;
+}
+
+const MappedKey*
+findKey(const std::vector<MappedKey>& keys, KeyID id, std::int32_t group,
+        KeyModifierMask required)
+{
+    for (const MappedKey& key : keys) {
+        if (key.m_id == id && key.m_group == group && key.m_item.m_required == required) {
+            return &key;
+        }
+    }
+    return NULL;
+}
+
+} // namespace
+
+TEST(XWindowsKeyStateTests, updateKeyMap_xkb_mapsEveryGroupAndLevel)
+{
+    FakeXkbKeyboard keyboard;
+    inputleap::KeyMap keyMap;
+    XWindowsKeyState keyState(&keyboard, NULL, true, NULL, keyMap);
+
+    keyState.updateKeyMap();
+    std::vector<MappedKey> keys = getMappedKeys(keyMap);
+
+    const MappedKey* key = findKey(keys, 'q', 0, 0);
+    ASSERT_TRUE(key != NULL);
+    EXPECT_EQ(24, key->m_item.m_button);
+    EXPECT_EQ(KeyModifierShift | KeyModifierCapsLock, key->m_item.m_sensitive);
+    key = findKey(keys, 'Q', 0, KeyModifierShift);
+    ASSERT_TRUE(key != NULL);
+    EXPECT_EQ(24, key->m_item.m_button);
+    EXPECT_TRUE(findKey(keys, 'Q', 0, KeyModifierCapsLock) != NULL);
+    key = findKey(keys, 0x044e, 1, 0);    // Cyrillic small yu
+    ASSERT_TRUE(key != NULL);
+    EXPECT_EQ(24, key->m_item.m_button);
+    EXPECT_TRUE(findKey(keys, '!', 0, KeyModifierShift) != NULL);
+
+    // one level with a case pair gets both cases
+    key = findKey(keys, 0x00c9, 0, KeyModifierShift);
+    ASSERT_TRUE(key != NULL);
+    EXPECT_EQ(94, key->m_item.m_button);
+
+    key = findKey(keys, kKeyShift_L, 0, 0);
+    ASSERT_TRUE(key != NULL);
+    EXPECT_EQ(KeyModifierShift, key->m_item.m_generates);
+    key = findKey(keys, kKeyCapsLock, 0, 0);
+    ASSERT_TRUE(key != NULL);
+    EXPECT_EQ(KeyModifierCapsLock, key->m_item.m_generates);
+    EXPECT_TRUE(key->m_item.m_lock);
+    EXPECT_TRUE(keyMap.isHalfDuplex(kKeyNumLock, 77));
+    EXPECT_FALSE(keyMap.isHalfDuplex(kKeyCapsLock, 66));
+
+    // group switches aren't keys to map
+    for (const MappedKey& mapped : keys) {
+        EXPECT_NE(203, mapped.m_item.m_button);
+    }
+
+    EXPECT_EQ(KeyModifierShift | KeyModifierControl | KeyModifierAlt,
+              keyState.mapModifiersFromX(ShiftMask | ControlMask | Mod1Mask));
+    EXPECT_EQ(KeyModifierSuper, keyState.mapModifiersFromX(XkbBuildCoreState(Mod4Mask, 1)));
+    unsigned int x = 0;
+    EXPECT_TRUE(keyState.mapModifiersToX(KeyModifierShift | KeyModifierNumLock, x));
+    EXPECT_EQ(static_cast<unsigned int>(ShiftMask | Mod2Mask), x);
+
+    XWindowsKeyState::KeycodeList keycodes;
+    keyState.mapKeyToKeycodes(kKeyShift_L, keycodes);
+    EXPECT_EQ(XWindowsKeyState::KeycodeList{ 50 }, keycodes);
+}
+
+#endif
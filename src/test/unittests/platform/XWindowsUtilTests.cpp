@@ -0,0 +1,44 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// gtest must come before the X headers, which define None
+#include "test/global/gtest.h"
+
+#include "platform/XWindowsUtil.h"
+#include "inputleap/key_types.h"
+
+TEST(XWindowsUtilTests, mapKeySymToKeyID_legacyKeySyms_mapped)
+{
+    EXPECT_EQ(0x0104u, XWindowsUtil::mapKeySymToKeyID(0x01a1));  // Aogonek
+    EXPECT_EQ(0x0430u, XWindowsUtil::mapKeySymToKeyID(0x06c1));  // Cyrillic_a
+    EXPECT_EQ(0x2193u, XWindowsUtil::mapKeySymToKeyID(0x08fe));  // downarrow
+    EXPECT_EQ(0x0152u, XWindowsUtil::mapKeySymToKeyID(0x13bc));  // OE
+    EXPECT_EQ(0x20acu, XWindowsUtil::mapKeySymToKeyID(0x20ac));  // EuroSign
+}
+
+TEST(XWindowsUtilTests, mapKeySymToKeyID_unicodeKeySyms_mapped)
+{
+    EXPECT_EQ(0x0174u, XWindowsUtil::mapKeySymToKeyID(0x1000174));  // Wcircumflex
+    EXPECT_EQ(0x1e0au, XWindowsUtil::mapKeySymToKeyID(0x1001e0a));  // Babovedot
+}
+
+TEST(XWindowsUtilTests, mapKeySymToKeyID_notInTable_none)
+{
+    EXPECT_EQ(kKeyNone, XWindowsUtil::mapKeySymToKeyID(0x0100));
+    EXPECT_EQ(kKeyNone, XWindowsUtil::mapKeySymToKeyID(0x20ff));
+    EXPECT_EQ(kKeyNone, XWindowsUtil::mapKeySymToKeyID(0x1000175 + 0x100000));
+}
@@ -0,0 +1,181 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/ClientOutputQueue.h"
+#include "inputleap/ProtocolUtil.h"
+#include "inputleap/protocol_types.h"
+#include "test/mock/io/MockStreamFixture.h"
+
+#include "test/global/gtest.h"
+
+#include <memory>
+
+namespace {
+
+// an output queue over a mock connection
+class ClientOutputQueueTests : public MockStreamFixture {
+public:
+    std::unique_ptr<ClientOutputQueue> newQueue(std::uint32_t maxUnflushed,
+                                                std::size_t maxQueued = 1024)
+    {
+        return std::unique_ptr<ClientOutputQueue>(
+            new ClientOutputQueue(&m_events, m_connection.m_stream, maxUnflushed, maxQueued));
+    }
+
+    // the socket reports everything sent
+    void flushed()
+    {
+        MockStreamFixture::flushed(m_connection);
+    }
+
+public:
+    MockConnection m_connection;
+};
+
+} // namespace
+
+TEST_F(ClientOutputQueueTests, mouseMove_keepingUp_writtenThrough)
+{
+    std::unique_ptr<ClientOutputQueue> queue = newQueue(16);
+
+    queue->mouseMove(1, 1);
+    queue->mouseMove(2, 2);
+    flushed();
+    queue->mouseMove(3, 3);
+
+    EXPECT_EQ(encode(kMsgDMouseMove, 1, 1) + encode(kMsgDMouseMove, 2, 2) +
+              encode(kMsgDMouseMove, 3, 3), m_connection.m_written);
+    EXPECT_EQ(0u, queue->getQueuedSize());
+}
+
+TEST_F(ClientOutputQueueTests, mouseMove_fallenBehind_onlyLatestSent)
+{
+    std::unique_ptr<ClientOutputQueue> queue = newQueue(0);
+    queue->mouseMove(1, 1);
+
+    queue->mouseMove(2, 2);
+    queue->mouseMove(3, 3);
+    queue->mouseMove(4, 4);
+
+    EXPECT_EQ(encode(kMsgDMouseMove, 1, 1), m_connection.m_written);
+    EXPECT_EQ(8u, queue->getQueuedSize());
+    EXPECT_EQ(2u, queue->getCoalesced());
+    flushed();
+    EXPECT_EQ(encode(kMsgDMouseMove, 1, 1) + encode(kMsgDMouseMove, 4, 4), m_connection.m_written);
+    EXPECT_EQ(0u, queue->getQueuedSize());
+}
+
+TEST_F(ClientOutputQueueTests, mouseRelativeMove_fallenBehind_summedUpToOtherMessages)
+{
+    std::unique_ptr<ClientOutputQueue> queue = newQueue(0);
+    std::vector<std::uint8_t> key;
+    ProtocolUtil::encodef(key, kMsgDKeyDown, 0x61, 0, 38);
+    queue->write(key.data(), static_cast<std::uint32_t>(key.size()));
+
+    queue->mouseRelativeMove(1, 2);
+    queue->mouseRelativeMove(3, 4);
+    queue->write(key.data(), static_cast<std::uint32_t>(key.size()));
+    queue->mouseRelativeMove(5, 6);
+    queue->mouseRelativeMove(32767, 0);
+    flushed();
+
+    std::string keyDown(key.begin(), key.end());
+    EXPECT_EQ(keyDown + encode(kMsgDMouseRelMove, 4, 6) + keyDown +
+              encode(kMsgDMouseRelMove, 5, 6) + encode(kMsgDMouseRelMove, 32767, 0),
+              m_connection.m_written);
+    EXPECT_EQ(1u, queue->getCoalesced());
+}
+
+TEST_F(ClientOutputQueueTests, flush_fallenBehind_heldMessagesWritten)
+{
+    std::unique_ptr<ClientOutputQueue> queue = newQueue(0);
+    queue->mouseMove(1, 1);
+    queue->mouseMove(2, 2);
+
+    queue->flush();
+
+    EXPECT_EQ(encode(kMsgDMouseMove, 1, 1) + encode(kMsgDMouseMove, 2, 2), m_connection.m_written);
+}
+
+TEST_F(ClientOutputQueueTests, write_tooMuchHeld_outputError)
+{
+    std::unique_ptr<ClientOutputQueue> queue = newQueue(0, 20);
+    const char message[] = "DKDN012345";
+    queue->write(message, 10);
+
+    queue->write(message, 10);
+    queue->write(message, 10);
+    ASSERT_TRUE(m_added.empty());
+    queue->write(message, 10);
+
+    ASSERT_EQ(1u, m_added.size());
+    EXPECT_EQ(m_streamEvents.outputError(), m_added[0]);
+    EXPECT_EQ(0u, queue->getQueuedSize());
+    flushed();
+    EXPECT_EQ(std::string(message, 10), m_connection.m_written);
+}
+
+TEST_F(ClientOutputQueueTests, latencyTrace_fallenBehind_markMovesWithMergedMove)
+{
+    std::unique_ptr<ClientOutputQueue> queue = newQueue(0);
+    queue->mouseMove(1, 1);
+    queue->mouseMove(2, 2);
+
+    queue->latencyTrace(7, 100);
+    queue->mouseMove(3, 3);
+    flushed();
+
+    EXPECT_EQ(encode(kMsgDMouseMove, 1, 1) + encode(kMsgDLatencyTrace, 7, 100) +
+              encode(kMsgDMouseMove, 3, 3), m_connection.m_written);
+    EXPECT_EQ(1u, queue->getCoalesced());
+}
+
+TEST_F(ClientOutputQueueTests, latencyTrace_markedMoveMerged_staleMarkDropped)
+{
+    std::unique_ptr<ClientOutputQueue> queue = newQueue(0);
+    queue->mouseRelativeMove(1, 1);
+    queue->latencyTrace(7, 100);
+    queue->mouseRelativeMove(2, 2);
+
+    queue->latencyTrace(8, 200);
+    queue->mouseRelativeMove(3, 3);
+    EXPECT_EQ(20u, queue->getQueuedSize());
+    flushed();
+
+    EXPECT_EQ(encode(kMsgDMouseRelMove, 1, 1) + encode(kMsgDLatencyTrace, 8, 200) +
+              encode(kMsgDMouseRelMove, 5, 5), m_connection.m_written);
+}
+
+TEST_F(ClientOutputQueueTests, write_bulkDataHeld_notCountedTowardLimit)
+{
+    std::unique_ptr<ClientOutputQueue> queue = newQueue(0, 20);
+    const char message[] = "DKDN012345";
+    queue->write(message, 10);
+
+    queue->setBulk(true);
+    queue->write(message, 10);
+    queue->write(message, 10);
+    queue->write(message, 10);
+    queue->setBulk(false);
+    queue->write(message, 10);
+    queue->write(message, 10);
+    ASSERT_TRUE(m_added.empty());
+    queue->write(message, 10);
+
+    ASSERT_EQ(1u, m_added.size());
+    EXPECT_EQ(m_streamEvents.outputError(), m_added[0]);
+}
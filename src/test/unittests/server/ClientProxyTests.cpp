@@ -0,0 +1,97 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/ClientProxy1_0.h"
+#include "inputleap/protocol_types.h"
+#include "test/mock/io/MockStreamFixture.h"
+
+#include "test/global/gtest.h"
+
+#include <memory>
+
+using ::testing::NiceMock;
+
+namespace {
+
+// a version 1.0 proxy over a mock connection
+class ClientProxyTests : public MockStreamFixture {
+public:
+    ClientProxyTests() :
+        m_proxy(new ClientProxy1_0("client", m_connection.m_stream, &m_events)) { }
+
+    // the client answers the handshake, asking to resume \c token
+    void handshake(std::uint64_t token)
+    {
+        received(m_connection, resume(token) +
+                 encode(kMsgDInfo, 0, 0, 1920, 1080, 0, 10, 10));
+        m_connection.m_written.clear();
+    }
+
+    static std::string resume(std::uint64_t token)
+    {
+        return encode(kMsgCResume, static_cast<std::uint32_t>(token >> 32),
+                      static_cast<std::uint32_t>(token));
+    }
+
+public:
+    MockConnection m_connection;
+    std::unique_ptr<ClientProxy1_0> m_proxy;
+};
+
+// stands in for the proxy of a dropped connection
+class DroppedProxy : public ClientProxy1_0 {
+public:
+    DroppedProxy(IEventQueue* events) :
+        ClientProxy1_0("client", new NiceMock<MockStream>, events) { }
+};
+
+} // namespace
+
+TEST_F(ClientProxyTests, resumeSession_sessionHeld_acceptedWithToken)
+{
+    const std::uint64_t token = 0x123456789abcdef0;
+    handshake(token);
+    EXPECT_EQ(token, m_proxy->getResumeToken());
+    DroppedProxy old(&m_events);
+    old.setSessionToken(token);
+
+    EXPECT_TRUE(m_proxy->resumeSession(&old, OptionsList()));
+
+    EXPECT_EQ(resume(token), m_connection.m_written);
+    EXPECT_EQ(token, m_proxy->getSessionToken());
+    EXPECT_EQ(0u, m_proxy->getResumeToken());
+}
+
+TEST_F(ClientProxyTests, resumeSession_sessionNotHeld_refused)
+{
+    handshake(1234);
+
+    EXPECT_FALSE(m_proxy->resumeSession(NULL, OptionsList()));
+
+    EXPECT_EQ(resume(0), m_connection.m_written);
+}
+
+TEST_F(ClientProxyTests, resumeSession_notAsked_nothingSent)
+{
+    received(m_connection, encode(kMsgDInfo, 0, 0, 1920, 1080, 0, 10, 10));
+    m_connection.m_written.clear();
+
+    EXPECT_FALSE(m_proxy->resumeSession(NULL, OptionsList()));
+
+    EXPECT_EQ(0u, m_proxy->getResumeToken());
+    EXPECT_EQ("", m_connection.m_written);
+}
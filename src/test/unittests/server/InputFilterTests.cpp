@@ -0,0 +1,182 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/InputFilter.h"
+#include "server/PrimaryClient.h"
+#include "inputleap/Screen.h"
+#include "platform/VirtualScreen.h"
+#include "base/EventQueue.h"
+
+#include "test/global/gtest.h"
+
+#include <cstdlib>
+
+namespace {
+
+// records which rule's actions ran
+class RecordAction : public InputFilter::Action {
+public:
+    RecordAction(const std::string& name, std::vector<std::string>* performed) :
+        m_name(name), m_performed(performed) { }
+
+    Action* clone() const override { return new RecordAction(m_name, m_performed); }
+    std::string format() const override { return m_name; }
+    void perform(const Event&) override { m_performed->push_back(m_name); }
+
+private:
+    std::string m_name;
+    std::vector<std::string>* m_performed;
+};
+
+// matches every event
+class AnyCondition : public InputFilter::Condition {
+public:
+    Condition* clone() const override { return new AnyCondition; }
+    std::string format() const override { return "any()"; }
+    InputFilter::EFilterStatus match(const Event&) override { return InputFilter::kActivate; }
+};
+
+class InputFilterTests : public ::testing::Test {
+public:
+    InputFilterTests() :
+        m_screen(new VirtualScreen(&m_events, true, 0, 0, 800, 600), &m_events),
+        m_primary("server", &m_screen),
+        m_filter(&m_events)
+    {
+    }
+
+    ~InputFilterTests()
+    {
+        m_filter.setPrimaryClient(NULL);
+    }
+
+    void addRule(InputFilter::Condition* condition, const std::string& name)
+    {
+        InputFilter::Rule rule(condition);
+        rule.adoptAction(new RecordAction(name, &m_performed), true);
+        m_filter.addFilterRule(rule);
+    }
+
+    bool hotKeyDown(std::uint32_t id)
+    {
+        IPrimaryScreen::HotKeyInfo* info = IPrimaryScreen::HotKeyInfo::alloc(id);
+        bool result = m_filter.applyRules(Event(m_events.forIPrimaryScreen().hotKeyDown(),
+                                                NULL, info));
+        std::free(info);
+        return result;
+    }
+
+    bool buttonDown(ButtonID button, KeyModifierMask mask)
+    {
+        IPrimaryScreen::ButtonInfo* info = IPrimaryScreen::ButtonInfo::alloc(button, mask);
+        bool result = m_filter.applyRules(Event(m_events.forIPrimaryScreen().buttonDown(),
+                                                NULL, info));
+        std::free(info);
+        return result;
+    }
+
+public:
+    EventQueue            m_events;
+    inputleap::Screen    m_screen;
+    PrimaryClient        m_primary;
+    InputFilter            m_filter;
+    std::vector<std::string> m_performed;
+};
+
+} // namespace
+
+TEST_F(InputFilterTests, applyRules_indexedAndUnindexed_firstAddedMatchRuns)
+{
+    // the virtual screen numbers hot keys from 1 in the order registered
+    addRule(new InputFilter::KeystrokeCondition(&m_events, kKeyF1, KeyModifierControl), "f1");
+    addRule(new AnyCondition, "any");
+    addRule(new InputFilter::KeystrokeCondition(&m_events, kKeyF2, KeyModifierControl), "f2");
+    m_filter.setPrimaryClient(&m_primary);
+
+    EXPECT_TRUE(hotKeyDown(1));
+    EXPECT_TRUE(hotKeyDown(2));
+
+    ASSERT_EQ(2u, m_performed.size());
+    EXPECT_EQ("f1", m_performed[0]);
+    EXPECT_EQ("any", m_performed[1]);
+}
+
+TEST_F(InputFilterTests, applyRules_buttonWithLockModifier_matched)
+{
+    addRule(new InputFilter::MouseButtonCondition(&m_events, kButtonLeft, 0), "left");
+    addRule(new InputFilter::MouseButtonCondition(&m_events, kButtonLeft, KeyModifierShift),
+            "shiftLeft");
+    m_filter.setPrimaryClient(&m_primary);
+
+    EXPECT_TRUE(buttonDown(kButtonLeft, KeyModifierShift | KeyModifierCapsLock));
+    EXPECT_TRUE(buttonDown(kButtonLeft, KeyModifierNumLock));
+    EXPECT_FALSE(buttonDown(kButtonRight, 0));
+    EXPECT_FALSE(buttonDown(kButtonLeft, KeyModifierControl));
+
+    ASSERT_EQ(2u, m_performed.size());
+    EXPECT_EQ("shiftLeft", m_performed[0]);
+    EXPECT_EQ("left", m_performed[1]);
+}
+
+TEST_F(InputFilterTests, applyRules_ruleRemoved_noLongerMatched)
+{
+    m_filter.setPrimaryClient(&m_primary);
+    addRule(new InputFilter::KeystrokeCondition(&m_events, kKeyF1, KeyModifierControl), "f1");
+    EXPECT_TRUE(hotKeyDown(1));
+
+    m_filter.removeFilterRule(0);
+
+    EXPECT_FALSE(hotKeyDown(1));
+    ASSERT_EQ(1u, m_performed.size());
+}
+
+TEST_F(InputFilterTests, addFilterRule_manyWhileEnabled_earlierHotKeysStillMatch)
+{
+    m_filter.setPrimaryClient(&m_primary);
+    addRule(new InputFilter::KeystrokeCondition(&m_events, kKeyF1, KeyModifierControl), "f1");
+    for (KeyID key = kKeyF2; key <= kKeyF12; ++key) {
+        addRule(new InputFilter::KeystrokeCondition(&m_events, key, KeyModifierControl), "other");
+    }
+
+    EXPECT_TRUE(hotKeyDown(1));
+    ASSERT_EQ(1u, m_performed.size());
+    EXPECT_EQ("f1", m_performed[0]);
+}
+
+TEST_F(InputFilterTests, assign_overlappingRules_keepsUnchangedHotKeys)
+{
+    addRule(new InputFilter::KeystrokeCondition(&m_events, kKeyF1, KeyModifierControl), "f1");
+    addRule(new InputFilter::KeystrokeCondition(&m_events, kKeyF2, KeyModifierControl), "f2");
+    m_filter.setPrimaryClient(&m_primary);
+
+    InputFilter other(&m_events);
+    for (KeyID key : { kKeyF3, kKeyF2 }) {
+        InputFilter::Rule rule(new InputFilter::KeystrokeCondition(&m_events, key,
+                                                                    KeyModifierControl));
+        rule.adoptAction(new RecordAction(key == kKeyF2 ? "f2" : "f3", &m_performed), true);
+        other.addFilterRule(rule);
+    }
+    m_filter = other;
+
+    // f2 keeps hot key 2, f3 gets the next one and f1's is gone
+    EXPECT_TRUE(hotKeyDown(2));
+    EXPECT_TRUE(hotKeyDown(3));
+    EXPECT_FALSE(hotKeyDown(1));
+    ASSERT_EQ(2u, m_performed.size());
+    EXPECT_EQ("f2", m_performed[0]);
+    EXPECT_EQ("f3", m_performed[1]);
+}
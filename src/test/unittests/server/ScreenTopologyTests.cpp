@@ -0,0 +1,119 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/ScreenTopology.h"
+#include "server/Config.h"
+
+#include "test/global/gtest.h"
+
+namespace {
+
+// a over b and c side by side, with b's right linked back to a
+void
+addLayout(Config& config)
+{
+    config.addScreen("a");
+    config.addScreen("b");
+    config.addScreen("c");
+    config.addAlias("b", "laptop");
+    config.connect("a", kBottom, 0.0f, 0.5f, "b", 0.0f, 1.0f);
+    config.connect("a", kBottom, 0.5f, 1.0f, "C", 0.25f, 0.75f);
+    config.connect("b", kTop,    0.0f, 1.0f, "a", 0.0f, 0.5f);
+    config.connect("b", kRight,  0.0f, 1.0f, "a", 0.0f, 1.0f);
+    config.connect("c", kLeft,   0.2f, 0.4f, "gone", 0.0f, 1.0f);
+}
+
+} // namespace
+
+TEST(ScreenTopologyTests, getScreenID_namesAndAliases_found)
+{
+    Config config(NULL);
+    addLayout(config);
+
+    ScreenTopology topology(config);
+
+    ASSERT_EQ(3u, topology.getNumScreens());
+    ScreenTopology::ScreenID b = topology.getScreenID("b");
+    ASSERT_NE(ScreenTopology::kNoScreen, b);
+    EXPECT_EQ("b", topology.getName(b));
+    EXPECT_EQ(b, topology.getScreenID("B"));
+    EXPECT_EQ(b, topology.getScreenID("Laptop"));
+    EXPECT_EQ(ScreenTopology::kNoScreen, topology.getScreenID("gone"));
+}
+
+TEST(ScreenTopologyTests, getNeighbor_sameAsConfig)
+{
+    Config config(NULL);
+    addLayout(config);
+
+    ScreenTopology topology(config);
+
+    for (Config::const_iterator i = config.begin(); i != config.end(); ++i) {
+        ScreenTopology::ScreenID id = topology.getScreenID(*i);
+        for (int side = kFirstDirection; side <= kLastDirection; ++side) {
+            EDirection dir = static_cast<EDirection>(side);
+            EXPECT_EQ(config.hasNeighbor(*i, dir), topology.hasNeighbor(id, dir));
+            for (float t = 0.0f; t <= 1.0f; t += 0.0625f) {
+                float expected = -1.0f, position = -1.0f;
+                std::string name = config.getNeighbor(*i, dir, t, &expected);
+                ScreenTopology::ScreenID neighbor =
+                    topology.getNeighbor(id, dir, t, &position);
+                if (name.empty()) {
+                    EXPECT_EQ(ScreenTopology::kNoScreen, neighbor);
+                }
+                else {
+                    ASSERT_NE(ScreenTopology::kNoScreen, neighbor);
+                    EXPECT_EQ(name, topology.getName(neighbor));
+                    EXPECT_EQ(expected, position);
+                }
+            }
+        }
+    }
+}
+
+TEST(ScreenTopologyTests, getNeighbor_linkToUnknownScreen_none)
+{
+    Config config(NULL);
+    addLayout(config);
+
+    ScreenTopology topology(config);
+    ScreenTopology::ScreenID c = topology.getScreenID("c");
+
+    EXPECT_TRUE(topology.hasNeighbor(c, kLeft));
+    EXPECT_EQ(ScreenTopology::kNoScreen, topology.getNeighbor(c, kLeft, 0.3f, NULL));
+}
+
+TEST(ScreenTopologyTests, getNeighbor_mapsPosition)
+{
+    Config config(NULL);
+    addLayout(config);
+
+    ScreenTopology topology(config);
+    float position;
+
+    EXPECT_EQ(topology.getScreenID("c"),
+              topology.getNeighbor(topology.getScreenID("a"), kBottom, 0.75f, &position));
+    EXPECT_FLOAT_EQ(0.5f, position);
+}
+
+TEST(ScreenTopologyTests, constructor_empty_noScreens)
+{
+    ScreenTopology topology;
+
+    EXPECT_EQ(0u, topology.getNumScreens());
+    EXPECT_EQ(ScreenTopology::kNoScreen, topology.getScreenID("a"));
+}
@@ -0,0 +1,193 @@
+/*
+    InputLeap -- mouse and keyboard sharing utility
+    Copyright (C) InputLeap contributors
+
+    This package is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    found in the file LICENSE that should have accompanied this file.
+
+    This package is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "test/mock/io/MockStreamFixture.h"
+#include "test/mock/inputleap/MockScreen.h"
+#include "test/mock/server/MockConfig.h"
+#include "test/mock/server/MockInputFilter.h"
+#include "test/mock/server/MockPrimaryClient.h"
+#include "server/Server.h"
+#include "server/ClientProxy1_0.h"
+#include "inputleap/IClipboard.h"
+#include "inputleap/ServerArgs.h"
+#include "inputleap/option_types.h"
+#include "inputleap/protocol_types.h"
+
+#include "test/global/gtest.h"
+
+#include <list>
+#include <memory>
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+using ::testing::Return;
+
+namespace {
+
+// a server with a mock primary screen and clients named "client" on
+// mock connections
+class ServerTests : public MockStreamFixture {
+public:
+    ServerTests()
+    {
+        ON_CALL(m_config, isScreen(_)).WillByDefault(Return(true));
+        ON_CALL(m_config, getInputFilter()).WillByDefault(Return(&m_inputFilter));
+        m_server.reset(new Server(m_config, &m_primaryClient, &m_screen, &m_events, m_args));
+    }
+
+    // a client on a new connection answers the handshake, asking to
+    // resume \p token unless it's 0, and the server takes it
+    ClientProxy1_0* connect(std::uint64_t token)
+    {
+        m_connections.emplace_back();
+        MockConnection& connection = m_connections.back();
+        ClientProxy1_0* client = new ClientProxy1_0("client", connection.m_stream, &m_events);
+        received(connection, (token != 0 ? resume(token) : std::string()) +
+                             encode(kMsgDInfo, 0, 0, 1920, 1080, 0, 10, 10));
+        connection.m_written.clear();
+        m_server->adoptClient(client);
+        return client;
+    }
+
+    // what the server sent on the newest connection since the handshake
+    const std::string& written() const
+    {
+        return m_connections.back().m_written;
+    }
+
+    // \p client's connection drops
+    void disconnect(ClientProxy1_0* client)
+    {
+        ASSERT_TRUE(dispatch(m_clientProxyEvents.disconnected(), client));
+    }
+
+    static std::string resume(std::uint64_t token)
+    {
+        return encode(kMsgCResume, static_cast<std::uint32_t>(token >> 32),
+                      static_cast<std::uint32_t>(token));
+    }
+
+    // what the server sends to set a client's options to \p options
+    // followed by the session \p token
+    static std::string setOptions(OptionsList options, std::uint64_t token)
+    {
+        options.push_back(kOptionPing);
+        options.push_back(1);
+        options.push_back(kOptionSessionHigh);
+        options.push_back(static_cast<std::uint32_t>(token >> 32));
+        options.push_back(kOptionSessionLow);
+        options.push_back(static_cast<std::uint32_t>(token));
+        return encode(kMsgCResetOptions) + encode(kMsgDSetOptions, &options);
+    }
+
+public:
+    NiceMock<MockPrimaryClient> m_primaryClient;
+    NiceMock<MockInputFilter> m_inputFilter;
+    NiceMock<MockConfig> m_config;
+    NiceMock<MockScreen> m_screen;
+    ServerArgs m_args;
+    std::list<MockConnection> m_connections;
+    std::unique_ptr<Server> m_server;
+};
+
+} // namespace
+
+TEST_F(ServerTests, adoptClient_newClient_sessionStarted)
+{
+    ClientProxy1_0* client = connect(0);
+
+    std::uint64_t token = client->getSessionToken();
+    EXPECT_NE(0u, token);
+    EXPECT_EQ(setOptions(OptionsList(), token), written());
+}
+
+TEST_F(ServerTests, resumeClient_sessionHeld_nothingChangedSent)
+{
+    ClientProxy1_0* first = connect(0);
+    std::uint64_t token = first->getSessionToken();
+    disconnect(first);
+    EXPECT_EQ(1u, m_server->getNumClients());
+
+    ClientProxy1_0* second = connect(token);
+
+    EXPECT_EQ(resume(token), written());
+    EXPECT_EQ(token, second->getSessionToken());
+    EXPECT_EQ(2u, m_server->getNumClients());
+}
+
+TEST_F(ServerTests, resumeClient_optionsAndClipboardChanged_changesSent)
+{
+    ClientProxy1_0* first = connect(0);
+    std::uint64_t token = first->getSessionToken();
+    disconnect(first);
+    m_config.addOption("", kOptionScreenSaverSync, 1);
+    ON_CALL(m_primaryClient, getClipboard(_, _)).WillByDefault(Invoke(
+        [](ClipboardID, IClipboard* clipboard) {
+            clipboard->open(0);
+            clipboard->empty();
+            clipboard->add(IClipboard::kText, "copied");
+            clipboard->close();
+            return true;
+        }));
+    IScreen::ClipboardInfo info = { kClipboardClipboard, 0 };
+    ASSERT_TRUE(dispatch(m_clipboardEvents.clipboardChanged(),
+                         m_primaryClient.getEventTarget(), &info));
+
+    connect(token);
+
+    OptionsList options;
+    options.push_back(kOptionScreenSaverSync);
+    options.push_back(1);
+    EXPECT_EQ(resume(token) + setOptions(options, token) +
+              encode(kMsgCClipboard, kClipboardClipboard, 0), written());
+}
+
+TEST_F(ServerTests, resumeClient_unknownToken_newSessionStarted)
+{
+    ClientProxy1_0* client = connect(0x1234);
+
+    std::uint64_t token = client->getSessionToken();
+    EXPECT_NE(0u, token);
+    EXPECT_NE(0x1234u, token);
+    EXPECT_EQ(resume(0) + setOptions(OptionsList(), token), written());
+}
+
+TEST_F(ServerTests, resumeClient_gracePeriodOver_newSessionStarted)
+{
+    ClientProxy1_0* first = connect(0);
+    std::uint64_t token = first->getSessionToken();
+    disconnect(first);
+    ASSERT_TRUE(dispatch(Event::kTimer, m_timers.back()));
+
+    ClientProxy1_0* second = connect(token);
+
+    EXPECT_NE(token, second->getSessionToken());
+    EXPECT_EQ(resume(0) + setOptions(OptionsList(), second->getSessionToken()),
+              written());
+}
+
+TEST_F(ServerTests, adoptClient_reconnectedBeforeDisconnect_sessionResumed)
+{
+    ClientProxy1_0* first = connect(0);
+    std::uint64_t token = first->getSessionToken();
+
+    connect(token);
+
+    EXPECT_EQ(resume(token), written());
+    EXPECT_EQ(2u, m_server->getNumClients());
+}